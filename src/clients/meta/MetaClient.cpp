@@ -35,6 +35,10 @@ DEFINE_int32(meta_client_retry_interval_secs, 1, "meta client sleep interval bet
 DEFINE_int32(meta_client_timeout_ms, 60 * 1000, "meta client timeout");
 DEFINE_string(cluster_id_path, "cluster.id", "file path saved clusterId");
 DEFINE_int32(check_plan_killed_frequency, 8, "check plan killed every 1<<n times");
+DEFINE_int32(stats_cache_refresh_interval_secs,
+             60,
+             "Interval in seconds to refresh the cached space statistics used by the optimizer's "
+             "cost model, 0 means disable the cache");
 DEFINE_uint32(failed_login_attempts,
               0,
               "how many consecutive incorrect passwords input to a SINGLE graph service node cause "
@@ -177,6 +181,10 @@ void MetaClient::stop() {
     bgThread_->wait();
     bgThread_.reset();
   }
+  if (statsLoading_.has_value()) {
+    statsLoading_->wait();
+    statsLoading_.reset();
+  }
 }
 
 void MetaClient::heartBeatThreadFunc() {
@@ -197,6 +205,75 @@ void MetaClient::heartBeatThreadFunc() {
   // if MetaServer has some changes, refresh the localCache_
   loadData();
   loadCfg();
+  if (options_.role_ == cpp2::HostRole::GRAPH) {
+    loadStats();
+  }
+}
+
+bool MetaClient::loadStats() {
+  memory::MemoryCheckOffGuard g;
+  if (FLAGS_stats_cache_refresh_interval_secs <= 0) {
+    return true;
+  }
+  if (statsLoading_.has_value() && !statsLoading_->isReady()) {
+    // The last loading is still in flight
+    return true;
+  }
+  auto now = time::WallClock::fastNowInSec();
+  if (now - statsLastLoadTime_ < FLAGS_stats_cache_refresh_interval_secs) {
+    return true;
+  }
+  statsLastLoadTime_ = now;
+
+  // The stats of all spaces are fetched concurrently and cached when they're all returned, so the
+  // heartbeat is not blocked however many spaces there are
+  std::vector<GraphSpaceID> spaceIds;
+  std::vector<folly::Future<StatusOr<cpp2::StatsItem>>> futures;
+  for (const auto& spaceInfo : localCache_) {
+    spaceIds.emplace_back(spaceInfo.first);
+    futures.emplace_back(getStats(spaceInfo.first));
+  }
+  statsLoading_ =
+      folly::collectAll(futures)
+          .via(ioThreadPool_.get())
+          .thenValue([this, spaceIds = std::move(spaceIds)](
+                         std::vector<folly::Try<StatusOr<cpp2::StatsItem>>>&& results) {
+            memory::MemoryCheckOffGuard guard;
+            decltype(spaceStats_) spaceStats;
+            for (size_t i = 0; i < results.size(); ++i) {
+              auto spaceId = spaceIds[i];
+              if (results[i].hasException()) {
+                VLOG(2) << "Get stats of space " << spaceId
+                        << " failed: " << results[i].exception().what();
+                continue;
+              }
+              auto& ret = results[i].value();
+              if (!ret.ok()) {
+                // The stats job may have never been submitted in this space, the optimizer will
+                // fall back to the default estimation.
+                VLOG(2) << "Get stats of space " << spaceId << " failed, status: " << ret.status();
+                continue;
+              }
+              spaceStats.emplace(spaceId,
+                                 std::make_shared<const cpp2::StatsItem>(std::move(ret).value()));
+            }
+            folly::SharedMutex::WriteHolder holder(statsLock_);
+            spaceStats_ = std::move(spaceStats);
+          });
+  return true;
+}
+
+StatusOr<std::shared_ptr<const cpp2::StatsItem>> MetaClient::getStatsFromCache(
+    GraphSpaceID spaceId) {
+  if (!ready_) {
+    return Status::Error("Not ready!");
+  }
+  folly::SharedMutex::ReadHolder holder(statsLock_);
+  auto iter = spaceStats_.find(spaceId);
+  if (iter == spaceStats_.end()) {
+    return Status::Error("No stats of space %d in cache", spaceId);
+  }
+  return iter->second;
 }
 
 bool MetaClient::loadUsersAndRoles() {
@@ -286,11 +363,12 @@ bool MetaClient::loadData() {
     return false;
   }
 
-  auto ret = listSpaces().get();
+  auto ret = listSpacesWithUpdateTime().get();
   if (!ret.ok()) {
     LOG(ERROR) << "List space failed, status:" << ret.status();
     return false;
   }
+  const auto& spaceUpdateTimes = ret.value().get_space_update_times();
 
   decltype(localCache_) cache;
   decltype(spaceIndexByName_) spaceIndexByName;
@@ -301,8 +379,11 @@ bool MetaClient::loadData() {
   decltype(spaceEdgeIndexByType_) spaceEdgeIndexByType;
   decltype(spaceTagIndexById_) spaceTagIndexById;
   decltype(spaceAllEdgeMap_) spaceAllEdgeMap;
+  decltype(spaceLastUpdateTime_) spaceLastUpdateTime;
+  // The spaces whose schemas, indexes and listeners are not changed since the last load
+  std::unordered_set<GraphSpaceID> unchangedSpaces;
 
-  for (auto space : ret.value()) {
+  for (auto space : toSpaceIdName(ret.value().get_spaces())) {
     auto spaceId = space.first;
     MetaClient::PartTerms partTerms;
     auto r = getPartsAlloc(spaceId, &partTerms).get();
@@ -312,7 +393,21 @@ bool MetaClient::loadData() {
       return false;
     }
 
-    auto spaceCache = std::make_shared<SpaceInfoCache>();
+    std::shared_ptr<SpaceInfoCache> spaceCache;
+    auto timeIter = spaceUpdateTimes.find(spaceId);
+    if (timeIter != spaceUpdateTimes.end()) {
+      spaceLastUpdateTime.emplace(spaceId, timeIter->second);
+      auto lastTimeIter = spaceLastUpdateTime_.find(spaceId);
+      auto oldCacheIter = localCache_.find(spaceId);
+      if (lastTimeIter != spaceLastUpdateTime_.end() && lastTimeIter->second == timeIter->second &&
+          oldCacheIter != localCache_.end()) {
+        spaceCache = std::make_shared<SpaceInfoCache>(*oldCacheIter->second);
+        unchangedSpaces.emplace(spaceId);
+      }
+    }
+    if (spaceCache == nullptr) {
+      spaceCache = std::make_shared<SpaceInfoCache>();
+    }
     auto partsAlloc = r.value();
     auto& spaceName = space.second;
     spaceCache->partsOnHost_ = reverse(partsAlloc);
@@ -320,28 +415,32 @@ bool MetaClient::loadData() {
     spaceCache->termOfPartition_ = std::move(partTerms);
     VLOG(2) << "Load space " << spaceId << ", parts num:" << spaceCache->partsAlloc_.size();
 
-    // loadSchemas
-    if (!loadSchemas(spaceId,
-                     spaceCache,
-                     spaceTagIndexByName,
-                     spaceTagIndexById,
-                     spaceEdgeIndexByName,
-                     spaceEdgeIndexByType,
-                     spaceNewestTagVerMap,
-                     spaceNewestEdgeVerMap,
-                     spaceAllEdgeMap)) {
-      LOG(ERROR) << "Load Schemas Failed";
-      return false;
-    }
+    if (unchangedSpaces.count(spaceId) != 0) {
+      VLOG(2) << "Schemas of space " << spaceId << " not changed, skip loading them";
+    } else {
+      // loadSchemas
+      if (!loadSchemas(spaceId,
+                       spaceCache,
+                       spaceTagIndexByName,
+                       spaceTagIndexById,
+                       spaceEdgeIndexByName,
+                       spaceEdgeIndexByType,
+                       spaceNewestTagVerMap,
+                       spaceNewestEdgeVerMap,
+                       spaceAllEdgeMap)) {
+        LOG(ERROR) << "Load Schemas Failed";
+        return false;
+      }
 
-    if (!loadIndexes(spaceId, spaceCache)) {
-      LOG(ERROR) << "Load Indexes Failed";
-      return false;
-    }
+      if (!loadIndexes(spaceId, spaceCache)) {
+        LOG(ERROR) << "Load Indexes Failed";
+        return false;
+      }
 
-    if (!loadListeners(spaceId, spaceCache)) {
-      LOG(ERROR) << "Load Listeners Failed";
-      return false;
+      if (!loadListeners(spaceId, spaceCache)) {
+        LOG(ERROR) << "Load Listeners Failed";
+        return false;
+      }
     }
 
     // get space properties
@@ -357,6 +456,27 @@ bool MetaClient::loadData() {
     spaceIndexByName.emplace(space.second, spaceId);
   }
 
+  // Keep the schema names of the unchanged spaces
+  auto keepUnchanged = [&unchangedSpaces](const auto& oldMap, auto& newMap) {
+    for (const auto& entry : oldMap) {
+      if (unchangedSpaces.count(entry.first.first) != 0) {
+        newMap.emplace(entry);
+      }
+    }
+  };
+  keepUnchanged(spaceTagIndexByName_, spaceTagIndexByName);
+  keepUnchanged(spaceTagIndexById_, spaceTagIndexById);
+  keepUnchanged(spaceEdgeIndexByName_, spaceEdgeIndexByName);
+  keepUnchanged(spaceEdgeIndexByType_, spaceEdgeIndexByType);
+  keepUnchanged(spaceNewestTagVerMap_, spaceNewestTagVerMap);
+  keepUnchanged(spaceNewestEdgeVerMap_, spaceNewestEdgeVerMap);
+  for (auto spaceId : unchangedSpaces) {
+    auto iter = spaceAllEdgeMap_.find(spaceId);
+    if (iter != spaceAllEdgeMap_.end()) {
+      spaceAllEdgeMap.emplace(*iter);
+    }
+  }
+
   auto hostsRet = listHosts().get();
   if (!hostsRet.ok()) {
     LOG(ERROR) << "List hosts failed, status:" << hostsRet.status();
@@ -381,6 +501,7 @@ bool MetaClient::loadData() {
     spaceEdgeIndexByType_ = std::move(spaceEdgeIndexByType);
     spaceTagIndexById_ = std::move(spaceTagIndexById);
     spaceAllEdgeMap_ = std::move(spaceAllEdgeMap);
+    spaceLastUpdateTime_ = std::move(spaceLastUpdateTime);
     storageHosts_ = std::move(hosts);
   }
 
@@ -388,15 +509,26 @@ bool MetaClient::loadData() {
 
   localDataLastUpdateTime_.store(metadLastUpdateTime_.load());
   auto newMetaData = new MetaData();
+  // Only loadData replaces the metadata, so it's safe to read the current one here
+  const auto& curMetaData = *metadata_.load();
 
   for (auto& spaceInfo : localCache_) {
     GraphSpaceID spaceId = spaceInfo.first;
     std::shared_ptr<SpaceInfoCache> info = spaceInfo.second;
     std::shared_ptr<SpaceInfoCache> infoDeepCopy = std::make_shared<SpaceInfoCache>(*info);
-    infoDeepCopy->tagSchemas_ = buildTagSchemas(infoDeepCopy->tagItemVec_);
-    infoDeepCopy->edgeSchemas_ = buildEdgeSchemas(infoDeepCopy->edgeItemVec_);
-    infoDeepCopy->tagIndexes_ = buildIndexes(infoDeepCopy->tagIndexItemVec_);
-    infoDeepCopy->edgeIndexes_ = buildIndexes(infoDeepCopy->edgeIndexItemVec_);
+    auto curIter = curMetaData.localCache_.find(spaceId);
+    if (unchangedSpaces.count(spaceId) != 0 && curIter != curMetaData.localCache_.end()) {
+      // The schemas and indexes built are immutable, so share them with the current metadata
+      infoDeepCopy->tagSchemas_ = curIter->second->tagSchemas_;
+      infoDeepCopy->edgeSchemas_ = curIter->second->edgeSchemas_;
+      infoDeepCopy->tagIndexes_ = curIter->second->tagIndexes_;
+      infoDeepCopy->edgeIndexes_ = curIter->second->edgeIndexes_;
+    } else {
+      infoDeepCopy->tagSchemas_ = buildTagSchemas(infoDeepCopy->tagItemVec_);
+      infoDeepCopy->edgeSchemas_ = buildEdgeSchemas(infoDeepCopy->edgeItemVec_);
+      infoDeepCopy->tagIndexes_ = buildIndexes(infoDeepCopy->tagIndexItemVec_);
+      infoDeepCopy->edgeIndexes_ = buildIndexes(infoDeepCopy->edgeIndexItemVec_);
+    }
     newMetaData->localCache_[spaceId] = infoDeepCopy;
   }
   newMetaData->spaceIndexByName_ = spaceIndexByName_;
@@ -1298,6 +1430,19 @@ folly::Future<StatusOr<std::vector<SpaceIdName>>> MetaClient::listSpaces() {
   return future;
 }
 
+folly::Future<StatusOr<cpp2::ListSpacesResp>> MetaClient::listSpacesWithUpdateTime() {
+  memory::MemoryCheckOffGuard g;
+  cpp2::ListSpacesReq req;
+  folly::Promise<StatusOr<cpp2::ListSpacesResp>> promise;
+  auto future = promise.getFuture();
+  getResponse(
+      std::move(req),
+      [](auto client, auto request) { return client->future_listSpaces(request); },
+      [](cpp2::ListSpacesResp&& resp) -> cpp2::ListSpacesResp { return std::move(resp); },
+      std::move(promise));
+  return future;
+}
+
 folly::Future<StatusOr<cpp2::SpaceItem>> MetaClient::getSpace(std::string name) {
   memory::MemoryCheckOffGuard g;
   cpp2::GetSpaceReq req;
@@ -2394,28 +2539,29 @@ StatusOr<HostAddr> MetaClient::getStorageLeaderFromCache(GraphSpaceID spaceId, P
     return Status::Error("Not ready!");
   }
 
-  {
-    folly::SharedMutex::ReadHolder holder(leadersLock_);
-    auto iter = leadersInfo_.leaderMap_.find({spaceId, partId});
-    if (iter != leadersInfo_.leaderMap_.end()) {
-      return iter->second;
-    }
+  auto key = std::make_pair(spaceId, partId);
+  auto iter = leaderMap_.find(key);
+  if (iter != leaderMap_.cend()) {
+    return iter->second;
   }
-  {
-    // no leader found, pick one in round-robin
-    auto partHostsRet = getPartHostsFromCache(spaceId, partId);
-    if (!partHostsRet.ok()) {
-      return partHostsRet.status();
-    }
-    auto partHosts = partHostsRet.value();
-    folly::SharedMutex::WriteHolder wh(leadersLock_);
-    VLOG(1) << "No leader exists. Choose one in round-robin.";
-    auto index = (leadersInfo_.pickedIndex_[{spaceId, partId}] + 1) % partHosts.hosts_.size();
-    auto picked = partHosts.hosts_[index];
-    leadersInfo_.leaderMap_[{spaceId, partId}] = picked;
-    leadersInfo_.pickedIndex_[{spaceId, partId}] = index;
-    return picked;
+
+  // no leader found, pick one in round-robin
+  auto partHostsRet = getPartHostsFromCache(spaceId, partId);
+  if (!partHostsRet.ok()) {
+    return partHostsRet.status();
   }
+  auto partHosts = partHostsRet.value();
+  VLOG(1) << "No leader exists. Choose one in round-robin.";
+  size_t lastIndex = 0;
+  auto pickedIter = pickedIndex_.find(key);
+  if (pickedIter != pickedIndex_.cend()) {
+    lastIndex = pickedIter->second;
+  }
+  auto index = (lastIndex + 1) % partHosts.hosts_.size();
+  auto picked = partHosts.hosts_[index];
+  leaderMap_.insert_or_assign(key, picked);
+  pickedIndex_.insert_or_assign(key, index);
+  return picked;
 }
 
 void MetaClient::updateStorageLeader(GraphSpaceID spaceId,
@@ -2423,15 +2569,13 @@ void MetaClient::updateStorageLeader(GraphSpaceID spaceId,
                                      const HostAddr& leader) {
   memory::MemoryCheckOffGuard g;
   VLOG(1) << "Update the leader for [" << spaceId << ", " << partId << "] to " << leader;
-  folly::SharedMutex::WriteHolder holder(leadersLock_);
-  leadersInfo_.leaderMap_[{spaceId, partId}] = leader;
+  leaderMap_.insert_or_assign(std::make_pair(spaceId, partId), leader);
 }
 
 void MetaClient::invalidStorageLeader(GraphSpaceID spaceId, PartitionID partId) {
   memory::MemoryCheckOffGuard g;
   VLOG(1) << "Invalidate the leader for [" << spaceId << ", " << partId << "]";
-  folly::SharedMutex::WriteHolder holder(leadersLock_);
-  leadersInfo_.leaderMap_.erase({spaceId, partId});
+  leaderMap_.erase(std::make_pair(spaceId, partId));
 }
 
 StatusOr<LeaderInfo> MetaClient::getLeaderInfo() {
@@ -2439,8 +2583,14 @@ StatusOr<LeaderInfo> MetaClient::getLeaderInfo() {
   if (!ready_) {
     return Status::Error("Not ready!");
   }
-  folly::SharedMutex::ReadHolder holder(leadersLock_);
-  return leadersInfo_;
+  LeaderInfo leaderInfo;
+  for (const auto& entry : leaderMap_) {
+    leaderInfo.leaderMap_.emplace(entry.first, entry.second);
+  }
+  for (const auto& entry : pickedIndex_) {
+    leaderInfo.pickedIndex_.emplace(entry.first, entry.second);
+  }
+  return leaderInfo;
 }
 
 const std::vector<HostAddr>& MetaClient::getAddresses() {
@@ -3267,8 +3417,22 @@ void MetaClient::loadLeader(const std::vector<cpp2::HostItem>& hostItems,
     // todo(doodle): in worst case, storage and meta isolated, so graph may get a outdate
     // leader info. The problem could be solved if leader term are cached as well.
     LOG(INFO) << "Load leader ok";
-    folly::SharedMutex::WriteHolder wh(leadersLock_);
-    leadersInfo_ = std::move(leaderInfo);
+    // Replace the leaders in place rather than clearing the maps, so the readers always find the
+    // leaders of the parts which are still there
+    auto replace = [](const auto& from, auto& to) {
+      for (const auto& entry : from) {
+        to.insert_or_assign(entry.first, entry.second);
+      }
+      for (auto iter = to.begin(); iter != to.end();) {
+        if (from.count(iter->first) == 0) {
+          iter = to.erase(iter);
+        } else {
+          ++iter;
+        }
+      }
+    };
+    replace(leaderInfo.leaderMap_, leaderMap_);
+    replace(leaderInfo.pickedIndex_, pickedIndex_);
   }
 }
 
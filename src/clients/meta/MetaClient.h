@@ -32,6 +32,7 @@
 
 DECLARE_int32(meta_client_retry_times);
 DECLARE_int32(heartbeat_interval_secs);
+DECLARE_int32(stats_cache_refresh_interval_secs);
 
 namespace nebula {
 namespace storage {
@@ -129,6 +130,7 @@ using SpaceEdgeTypeNameMap = std::unordered_map<std::pair<GraphSpaceID, EdgeType
 // get all edgeType edgeName via spaceId
 using SpaceAllEdgeMap = std::unordered_map<GraphSpaceID, std::vector<std::string>>;
 
+// A snapshot of the leaders cached, see MetaClient::getLeaderInfo
 struct LeaderInfo {
   // get leader host via spaceId and partId
   std::unordered_map<std::pair<GraphSpaceID, PartitionID>, HostAddr> leaderMap_;
@@ -248,6 +250,12 @@ class MetaClient : public BaseMetaClient {
 
   bool isMetadReady();
 
+  // The last update time of the meta data loaded into the local cache, it's changed once the
+  // spaces, schemas, indexes or users are changed.
+  int64_t localDataLastUpdateTime() const {
+    return localDataLastUpdateTime_.load();
+  }
+
   bool waitForMetadReady(int count = -1, int retryIntervalSecs = FLAGS_heartbeat_interval_secs);
 
   void notifyStop();
@@ -643,6 +651,10 @@ class MetaClient : public BaseMetaClient {
 
   folly::Future<StatusOr<cpp2::StatsItem>> getStats(GraphSpaceID spaceId);
 
+  // Get the statistics of the space which is refreshed periodically by the heartbeat thread of
+  // graphd, it is only available after the stats job has finished in the space.
+  StatusOr<std::shared_ptr<const cpp2::StatsItem>> getStatsFromCache(GraphSpaceID spaceId);
+
   folly::Future<StatusOr<nebula::cpp2::ErrorCode>> reportTaskFinish(
       GraphSpaceID spaceId,
       int32_t jobId,
@@ -676,6 +688,9 @@ class MetaClient : public BaseMetaClient {
   void updateGflagsValue(const cpp2::ConfigItem& item);
   void updateNestedGflags(const std::unordered_map<std::string, Value>& nameValues);
 
+  // List the spaces along with the last update time of their schemas, indexes and listeners
+  folly::Future<StatusOr<cpp2::ListSpacesResp>> listSpacesWithUpdateTime();
+
   bool loadSchemas(GraphSpaceID spaceId,
                    std::shared_ptr<SpaceInfoCache> spaceInfoCache,
                    SpaceTagNameIdMap& tagNameIdMap,
@@ -698,6 +713,8 @@ class MetaClient : public BaseMetaClient {
 
   bool loadSessions();
 
+  bool loadStats();
+
   void loadLeader(const std::vector<cpp2::HostItem>& hostItems,
                   const SpaceNameIdMap& spaceIndexByName);
 
@@ -777,9 +794,11 @@ class MetaClient : public BaseMetaClient {
   int64_t metaServerVersion_{-1};
   static constexpr int64_t EXPECT_META_VERSION = 4;
 
-  // leadersLock_ is used to protect leadersInfo
-  folly::SharedMutex leadersLock_;
-  LeaderInfo leadersInfo_;
+  // The leaders of the parts, which are read by the storage clients on every request, so they are
+  // kept in concurrent maps rather than behind a lock
+  folly::ConcurrentHashMap<std::pair<GraphSpaceID, PartitionID>, HostAddr> leaderMap_;
+  // index of picked host in all peers
+  folly::ConcurrentHashMap<std::pair<GraphSpaceID, PartitionID>, size_t> pickedIndex_;
 
   LocalCache localCache_;
   std::vector<HostAddr> addrs_;
@@ -829,6 +848,9 @@ class MetaClient : public BaseMetaClient {
   SpaceNewestTagVerMap spaceNewestTagVerMap_;
   SpaceNewestEdgeVerMap spaceNewestEdgeVerMap_;
   SpaceAllEdgeMap spaceAllEdgeMap_;
+  // The last update time of the schemas, indexes and listeners of the spaces loaded, the spaces
+  // whose time are not changed are not loaded again
+  std::unordered_map<GraphSpaceID, int64_t> spaceLastUpdateTime_;
 
   UserRolesMap userRolesMap_;
   UserPasswordMap userPasswordMap_;
@@ -862,6 +884,13 @@ class MetaClient : public BaseMetaClient {
   SessionMap sessionMap_;
   folly::F14FastSet<std::pair<SessionID, ExecutionPlanID>> killedPlans_;
   std::atomic<MetaData*> metadata_;
+
+  // statsLock_ is used to protect spaceStats_
+  folly::SharedMutex statsLock_;
+  std::unordered_map<GraphSpaceID, std::shared_ptr<const cpp2::StatsItem>> spaceStats_;
+  int64_t statsLastLoadTime_{0};
+  // The loading of the stats in flight, which is only touched by the heartbeat thread and stop()
+  std::optional<folly::Future<folly::Unit>> statsLoading_;
 };
 
 }  // namespace meta
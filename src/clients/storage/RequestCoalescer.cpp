@@ -0,0 +1,189 @@
+/* Copyright (c) 2023 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "clients/storage/RequestCoalescer.h"
+
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+
+namespace nebula {
+namespace storage {
+
+namespace {
+
+// The vertex ids are sent in strings, and returned in integers if the space is of integer vid
+std::string vidKey(const Value& vid) {
+  if (vid.isInt()) {
+    auto id = vid.getInt();
+    return std::string(reinterpret_cast<const char*>(&id), sizeof(id));
+  }
+  return vid.isStr() ? vid.getStr() : vid.toString();
+}
+
+}  // namespace
+
+using NeighborsTraits = CoalescingTraits<cpp2::GetNeighborsRequest, cpp2::GetNeighborsResponse>;
+
+// static
+std::string NeighborsTraits::key(const Request& req) {
+  // The common of the request is left out, the merged request carries those of all the requests
+  cpp2::GetNeighborsRequest spec;
+  spec.space_id_ref() = req.get_space_id();
+  spec.column_names_ref() = req.get_column_names();
+  spec.traverse_spec_ref() = req.get_traverse_spec();
+  return apache::thrift::CompactSerializer::serialize<std::string>(spec);
+}
+
+// static
+size_t NeighborsTraits::numRows(const Request& req) {
+  size_t numRows = 0;
+  for (const auto& part : req.get_parts()) {
+    numRows += part.second.size();
+  }
+  return numRows;
+}
+
+// static
+NeighborsTraits::Request NeighborsTraits::merge(const std::vector<Request>& requests) {
+  DCHECK(!requests.empty());
+  Request merged = requests.front();
+  auto& parts = *merged.parts_ref();
+  for (size_t i = 1; i < requests.size(); ++i) {
+    for (const auto& part : requests[i].get_parts()) {
+      auto& rows = parts[part.first];
+      rows.insert(rows.end(), part.second.begin(), part.second.end());
+    }
+  }
+
+  // The sessions and the plans of the requests, the detail is profiled if any of them asks for it
+  std::vector<cpp2::RequestCommon> commons;
+  bool profileDetail = false;
+  for (const auto& req : requests) {
+    auto common = req.common_ref().value_or(cpp2::RequestCommon());
+    profileDetail = profileDetail || common.profile_detail_ref().value_or(false);
+    auto session = common.session_id_ref().value_or(0);
+    auto plan = common.plan_id_ref().value_or(0);
+    auto found = std::find_if(commons.begin(), commons.end(), [&](const auto& c) {
+      return c.session_id_ref().value_or(0) == session && c.plan_id_ref().value_or(0) == plan;
+    });
+    if (found == commons.end()) {
+      cpp2::RequestCommon query;
+      query.session_id_ref() = session;
+      query.plan_id_ref() = plan;
+      commons.emplace_back(std::move(query));
+    }
+  }
+  if (profileDetail) {
+    auto common = merged.common_ref().value_or(cpp2::RequestCommon());
+    common.profile_detail_ref() = true;
+    merged.common_ref() = std::move(common);
+  }
+  if (commons.size() > 1) {
+    merged.merged_commons_ref() = std::move(commons);
+  }
+  return merged;
+}
+
+// static
+std::vector<NeighborsTraits::Request> NeighborsTraits::split(const Request& req, size_t maxRows) {
+  DCHECK_GT(maxRows, 0);
+  std::vector<Request> batches;
+  Request batch = req;
+  batch.parts_ref()->clear();
+  size_t numRows = 0;
+  for (const auto& part : req.get_parts()) {
+    auto begin = part.second.begin();
+    while (begin != part.second.end()) {
+      auto count = std::min(maxRows - numRows, static_cast<size_t>(part.second.end() - begin));
+      auto& rows = (*batch.parts_ref())[part.first];
+      rows.insert(rows.end(), begin, begin + count);
+      begin += count;
+      numRows += count;
+      if (numRows == maxRows) {
+        batches.emplace_back(batch);
+        batch.parts_ref()->clear();
+        numRows = 0;
+      }
+    }
+  }
+  if (numRows > 0) {
+    batches.emplace_back(std::move(batch));
+  }
+  return batches;
+}
+
+// static
+std::vector<NeighborsTraits::Response> NeighborsTraits::demux(
+    Response&& resp, const std::vector<Request>& requests) {
+  std::vector<Response> resps(requests.size());
+  // The vertex => the requests asking for it, one for each occurrence
+  std::unordered_map<std::string, std::deque<size_t>> owners;
+  for (size_t i = 0; i < requests.size(); ++i) {
+    auto& result = *resps[i].result_ref();
+    result.latency_in_us_ref() = resp.get_result().get_latency_in_us();
+    if (resp.get_result().latency_detail_us_ref().has_value()) {
+      result.latency_detail_us_ref() = *resp.get_result().latency_detail_us_ref();
+    }
+    const auto& parts = requests[i].get_parts();
+    for (const auto& failed : resp.get_result().get_failed_parts()) {
+      if (parts.find(failed.get_part_id()) != parts.end()) {
+        result.failed_parts_ref()->emplace_back(failed);
+      }
+    }
+    for (const auto& part : parts) {
+      for (const auto& vid : part.second) {
+        owners[vidKey(vid)].emplace_back(i);
+      }
+    }
+  }
+
+  if (!resp.vertices_ref().has_value()) {
+    return resps;
+  }
+  auto& ds = *resp.vertices_ref();
+  for (auto& r : resps) {
+    r.vertices_ref() = DataSet(ds.colNames);
+  }
+  for (auto& row : ds.rows) {
+    if (row.values.empty()) {
+      continue;
+    }
+    auto found = owners.find(vidKey(row.values.front()));
+    if (found == owners.end() || found->second.empty()) {
+      continue;
+    }
+    // The same vertex asked by several requests gets the same row, since they share the spec
+    auto owner = found->second.front();
+    found->second.pop_front();
+    resps[owner].vertices_ref()->rows.emplace_back(std::move(row));
+  }
+  return resps;
+}
+
+// static
+NeighborsTraits::Response NeighborsTraits::combine(std::vector<Response>&& resps) {
+  DCHECK(!resps.empty());
+  Response combined = std::move(resps.front());
+  auto& result = *combined.result_ref();
+  for (size_t i = 1; i < resps.size(); ++i) {
+    auto& resp = resps[i];
+    auto& failed = *resp.result_ref()->failed_parts_ref();
+    result.failed_parts_ref()->insert(
+        result.failed_parts_ref()->end(), failed.begin(), failed.end());
+    result.latency_in_us_ref() =
+        std::max(result.get_latency_in_us(), resp.get_result().get_latency_in_us());
+    if (!resp.vertices_ref().has_value()) {
+      continue;
+    }
+    if (!combined.vertices_ref().has_value()) {
+      combined.vertices_ref() = std::move(*resp.vertices_ref());
+    } else {
+      combined.vertices_ref()->append(std::move(*resp.vertices_ref()));
+    }
+  }
+  return combined;
+}
+
+}  // namespace storage
+}  // namespace nebula
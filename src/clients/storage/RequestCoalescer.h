@@ -0,0 +1,194 @@
+/* Copyright (c) 2023 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef CLIENTS_STORAGE_REQUESTCOALESCER_H_
+#define CLIENTS_STORAGE_REQUESTCOALESCER_H_
+
+#include <folly/futures/Future.h>
+#include <folly/io/async/EventBase.h>
+
+#include "clients/storage/stats/StorageClientStats.h"
+#include "common/base/Base.h"
+#include "common/datatypes/HostAddr.h"
+#include "common/stats/StatsManager.h"
+#include "interface/gen-cpp2/storage_types.h"
+
+DECLARE_uint32(storage_client_coalesce_window_us);
+DECLARE_uint32(storage_client_max_batch_rows);
+
+namespace nebula {
+namespace storage {
+
+// CoalescingTraits tells RequestCoalescer how to merge the requests of one kind and how to
+// demultiplex the response of the merged request, it's specialized for each kind of request.
+//
+//   static std::string key(const Request&);
+//     The requests with the same key are merged, i.e. they only differ in the parts and the
+//     queries they belong to
+//   static size_t numRows(const Request&);
+//   static Request merge(const std::vector<Request>& requests);
+//     The merged request carries the sessions and the plans of all the requests
+//   static std::vector<Request> split(const Request& request, size_t maxRows);
+//   static std::vector<Response> demux(Response&& resp, const std::vector<Request>& requests);
+//   static Response combine(std::vector<Response>&& resps);
+template <class Request, class Response>
+struct CoalescingTraits {
+  // The requests of the kinds not specialized are sent as they are
+  static constexpr bool kCoalescable = false;
+};
+
+template <>
+struct CoalescingTraits<cpp2::GetNeighborsRequest, cpp2::GetNeighborsResponse> {
+  using Request = cpp2::GetNeighborsRequest;
+  using Response = cpp2::GetNeighborsResponse;
+
+  static constexpr bool kCoalescable = true;
+
+  static std::string key(const Request& req);
+  static size_t numRows(const Request& req);
+  static Request merge(const std::vector<Request>& requests);
+  static std::vector<Request> split(const Request& req, size_t maxRows);
+  // The rows are dispatched to the requests by the vertex id in the first column
+  static std::vector<Response> demux(Response&& resp, const std::vector<Request>& requests);
+  static Response combine(std::vector<Response>&& resps);
+};
+
+// RequestCoalescer merges the small requests sent concurrently to the same host within
+// `--storage_client_coalesce_window_us` into one RPC, and splits a request of more than
+// `--storage_client_max_batch_rows` rows into several bounded RPCs. The response of the merged
+// or split requests is demultiplexed back to each caller, so the callers don't see the difference.
+//
+// The requests of different queries are merged, the merged request carries the sessions and the
+// plans of all of them so that the storage still kills it by the queries. A batch is sent from
+// the event base of its first request, and each caller is resumed on its own event base. A window
+// shorter than one millisecond, the precision of the timer of the event base, flushes the
+// requests at the next loop of the event base.
+template <class Request, class Response>
+class RequestCoalescer final {
+ public:
+  using Traits = CoalescingTraits<Request, Response>;
+  using SendFunc = std::function<folly::Future<Response>(const Request&)>;
+
+  // Must be called in the thread of `evb`, which `send` is bound to
+  folly::Future<Response> submit(folly::EventBase* evb,
+                                 const HostAddr& host,
+                                 const Request& req,
+                                 SendFunc send) {
+    auto maxRows = FLAGS_storage_client_max_batch_rows;
+    auto numRows = Traits::numRows(req);
+    if (maxRows > 0 && numRows > maxRows) {
+      return sendInBatches(evb, req, maxRows, std::move(send));
+    }
+    auto window = FLAGS_storage_client_coalesce_window_us;
+    if (window == 0) {
+      return send(req);
+    }
+
+    auto key = folly::stringPrintf("%s\n%s", host.toString().c_str(), Traits::key(req).c_str());
+    folly::Promise<Response> promise;
+    auto future = promise.getFuture().via(evb);
+    std::shared_ptr<Batch> batch, full;
+    {
+      std::lock_guard<std::mutex> guard(lock_);
+      auto& pending = batches_[key];
+      if (pending == nullptr) {
+        pending = std::make_shared<Batch>();
+        pending->evb = evb;
+        pending->send = std::move(send);
+        batch = pending;
+      }
+      pending->requests.emplace_back(req);
+      pending->promises.emplace_back(std::move(promise));
+      pending->numRows += numRows;
+      if (maxRows > 0 && pending->numRows >= maxRows) {
+        full = std::move(pending);
+        batches_.erase(key);
+      }
+    }
+
+    if (full != nullptr) {
+      // The batch is sent by the client of its first request
+      if (full->evb == evb) {
+        flush(std::move(full));
+      } else {
+        auto* batchEvb = full->evb;
+        batchEvb->runInEventBaseThread([full = std::move(full)]() mutable { flush(full); });
+      }
+    } else if (batch != nullptr) {
+      // The first request of the batch schedules the flush
+      auto flushFn = [this, key = std::move(key), batch = std::move(batch)]() mutable {
+        {
+          std::lock_guard<std::mutex> guard(lock_);
+          auto it = batches_.find(key);
+          if (it == batches_.end() || it->second != batch) {
+            // The batch has been flushed since it's full
+            return;
+          }
+          batches_.erase(it);
+        }
+        flush(std::move(batch));
+      };
+      if (window < 1000) {
+        evb->runInEventBaseThread(std::move(flushFn));
+      } else {
+        evb->runAfterDelay(std::move(flushFn), (window + 999) / 1000);
+      }
+    }
+    return future;
+  }
+
+ private:
+  struct Batch {
+    folly::EventBase* evb{nullptr};
+    std::vector<Request> requests;
+    std::vector<folly::Promise<Response>> promises;
+    size_t numRows{0};
+    SendFunc send;
+  };
+
+  static void flush(std::shared_ptr<Batch> batch) {
+    if (batch->requests.size() == 1) {
+      batch->send(batch->requests.front()).thenTry([batch](folly::Try<Response>&& t) {
+        batch->promises.front().setTry(std::move(t));
+      });
+      return;
+    }
+    stats::StatsManager::addValue(kNumRpcCoalescedToStoraged, batch->requests.size() - 1);
+    auto merged = Traits::merge(batch->requests);
+    batch->send(merged).thenTry([batch](folly::Try<Response>&& t) {
+      if (t.hasException()) {
+        for (auto& promise : batch->promises) {
+          promise.setException(t.exception());
+        }
+        return;
+      }
+      auto resps = Traits::demux(std::move(t).value(), batch->requests);
+      DCHECK_EQ(resps.size(), batch->promises.size());
+      for (size_t i = 0; i < resps.size(); ++i) {
+        batch->promises[i].setValue(std::move(resps[i]));
+      }
+    });
+  }
+
+  static folly::Future<Response> sendInBatches(folly::EventBase* evb,
+                                                const Request& req,
+                                                size_t maxRows,
+                                                SendFunc send) {
+    std::vector<folly::Future<Response>> futures;
+    for (const auto& batch : Traits::split(req, maxRows)) {
+      futures.emplace_back(send(batch));
+    }
+    return folly::collect(futures).via(evb).thenValue(
+        [](std::vector<Response>&& resps) { return Traits::combine(std::move(resps)); });
+  }
+
+  std::mutex lock_;
+  std::unordered_map<std::string, std::shared_ptr<Batch>> batches_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+
+#endif  // CLIENTS_STORAGE_REQUESTCOALESCER_H_
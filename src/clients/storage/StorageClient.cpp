@@ -104,11 +104,13 @@ StorageRpcRespFuture<cpp2::GetNeighborsResponse> StorageClient::getNeighbors(
     req.traverse_spec_ref() = std::move(spec);
   }
 
-  return collectResponse(param.evb,
-                         std::move(requests),
-                         [](ThriftClientType* client, const cpp2::GetNeighborsRequest& r) {
-                           return client->future_getNeighbors(r);
-                         });
+  return collectResponse(
+      param.evb,
+      std::move(requests),
+      [](ThriftClientType* client, const cpp2::GetNeighborsRequest& r) {
+        return client->future_getNeighbors(r);
+      },
+      &neighborsCoalescer_);
 }
 
 StorageRpcRespFuture<cpp2::GetDstBySrcResponse> StorageClient::getDstBySrc(
@@ -193,6 +193,8 @@ class StorageClient
 
   StatusOr<std::function<const VertexID&(const cpp2::DelTags&)>> getIdFromDelTags(
       GraphSpaceID space) const;
+
+  RequestCoalescer<cpp2::GetNeighborsRequest, cpp2::GetNeighborsResponse> neighborsCoalescer_;
 };
 
 }  // namespace storage
@@ -75,7 +75,8 @@ folly::SemiFuture<StorageRpcResponse<Response>>
 StorageClientBase<ClientType, ClientManagerType>::collectResponse(
     folly::EventBase* evb,
     std::unordered_map<HostAddr, Request> requests,
-    RemoteFunc&& remoteFunc) {
+    RemoteFunc&& remoteFunc,
+    RequestCoalescer<Request, Response>* coalescer) {
   memory::MemoryCheckOffGuard offGuard;
   std::vector<folly::Future<StatusOr<Response>>> respFutures;
   respFutures.reserve(requests.size());
@@ -91,7 +92,7 @@ StorageClientBase<ClientType, ClientManagerType>::collectResponse(
     // Future process code will be executed on the IO thread
     // Since all requests are sent using the same eventbase, all
     // then-callback will be executed on the same IO thread
-    auto fut = getResponse(evb, req.first, req.second, std::move(remoteFunc))
+    auto fut = getResponse(evb, req.first, req.second, std::move(remoteFunc), coalescer)
                    .ensure([totalLatencies, i, start]() {
                      (*totalLatencies)[i] = time::WallClock::fastNowInMicroSec() - start;
                    });
@@ -155,7 +156,11 @@ StorageClientBase<ClientType, ClientManagerType>::collectResponse(
 template <typename ClientType, typename ClientManagerType>
 template <class Request, class RemoteFunc, class Response>
 folly::Future<StatusOr<Response>> StorageClientBase<ClientType, ClientManagerType>::getResponse(
-    folly::EventBase* evb, const HostAddr& host, const Request& request, RemoteFunc&& remoteFunc) {
+    folly::EventBase* evb,
+    const HostAddr& host,
+    const Request& request,
+    RemoteFunc&& remoteFunc,
+    RequestCoalescer<Request, Response>* coalescer) {
   static_assert(
       folly::isFuture<std::invoke_result_t<RemoteFunc, ClientType*, const Request&>>::value);
 
@@ -166,15 +171,25 @@ folly::Future<StatusOr<Response>> StorageClientBase<ClientType, ClientManagerTyp
 
   auto spaceId = request.get_space_id();
   return folly::via(evb)
-      .thenValue([remoteFunc = std::move(remoteFunc), request, evb, host, this](auto&&) {
-        // MemoryTrackerVerified
-        memory::MemoryCheckGuard guard;
-        // NOTE: Create new channel on each thread to avoid TIMEOUT RPC error
-        auto client = clientsMan_->client(host, evb, false, FLAGS_storage_client_timeout_ms);
-        // Encoding invoke Cpp2Ops::write the request to protocol is in current thread,
-        // do not need to turn on in Cpp2Ops::write
-        return remoteFunc(client.get(), request);
-      })
+      .thenValue(
+          [remoteFunc = std::move(remoteFunc), request, evb, host, coalescer, this](auto&&) {
+            // MemoryTrackerVerified
+            memory::MemoryCheckGuard guard;
+            // NOTE: Create new channel on each thread to avoid TIMEOUT RPC error
+            auto client = clientsMan_->client(host, evb, false, FLAGS_storage_client_timeout_ms);
+            if constexpr (CoalescingTraits<Request, Response>::kCoalescable) {
+              if (coalescer != nullptr) {
+                // The request may be sent along with others, or split into several ones
+                return coalescer->submit(
+                    evb, host, request, [client, remoteFunc](const Request& r) mutable {
+                      return remoteFunc(client.get(), r);
+                    });
+              }
+            }
+            // Encoding invoke Cpp2Ops::write the request to protocol is in current thread,
+            // do not need to turn on in Cpp2Ops::write
+            return remoteFunc(client.get(), request);
+          })
       .thenValue([spaceId, this](Response&& resp) mutable -> StatusOr<Response> {
         // MemoryTrackerVerified
         memory::MemoryCheckGuard guard;
@@ -9,6 +9,14 @@ DEFINE_int32(storage_client_timeout_ms, 60 * 1000, "storage client timeout");
 DEFINE_uint32(storage_client_retry_interval_ms,
               1000,
               "storage client sleep interval milliseconds between retry");
+DEFINE_uint32(storage_client_coalesce_window_us,
+              100,
+              "The window in microseconds to merge the concurrent small requests to the same "
+              "storage host into one RPC, 0 to disable it");
+DEFINE_uint32(storage_client_max_batch_rows,
+              100000,
+              "The max number of rows sent to a storage host in one RPC, the larger request is "
+              "split into several RPCs, 0 for no limit");
 
 namespace nebula {
 namespace storage {}  // namespace storage
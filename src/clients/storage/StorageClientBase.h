@@ -10,6 +10,7 @@
 #include <folly/futures/Future.h>
 
 #include "clients/meta/MetaClient.h"
+#include "clients/storage/RequestCoalescer.h"
 #include "common/base/Base.h"
 #include "common/base/StatusOr.h"
 #include "common/datatypes/HostAddr.h"
@@ -128,16 +129,19 @@ class StorageClientBase {
   folly::SemiFuture<StorageRpcResponse<Response>> collectResponse(
       folly::EventBase* evb,
       std::unordered_map<HostAddr, Request> requests,
-      RemoteFunc&& remoteFunc);
+      RemoteFunc&& remoteFunc,
+      RequestCoalescer<Request, Response>* coalescer = nullptr);
 
   template <class Request,
             class RemoteFunc,
             class Response = typename std::result_of<RemoteFunc(ClientType* client,
                                                                 const Request&)>::type::value_type>
-  folly::Future<StatusOr<Response>> getResponse(folly::EventBase* evb,
-                                                const HostAddr& host,
-                                                const Request& request,
-                                                RemoteFunc&& remoteFunc);
+  folly::Future<StatusOr<Response>> getResponse(
+      folly::EventBase* evb,
+      const HostAddr& host,
+      const Request& request,
+      RemoteFunc&& remoteFunc,
+      RequestCoalescer<Request, Response>* coalescer = nullptr);
 
   // Cluster given ids into the host they belong to
   // The method returns a map
@@ -15,12 +15,15 @@
 
 #include "common/datatypes/List.h"
 #include "common/datatypes/Value.h"
+#include "common/datatypes/ValueArena.h"
 
 namespace nebula {
 
 using Row = List;
 
 struct DataSet {
+  NEBULA_VALUE_ARENA_OPERATORS
+
   std::vector<std::string> colNames;
   std::vector<Row> rows;
 
@@ -9,11 +9,14 @@
 #include <unordered_map>
 
 #include "common/datatypes/Value.h"
+#include "common/datatypes/ValueArena.h"
 #include "common/thrift/ThriftTypes.h"
 
 namespace nebula {
 
 struct Edge {
+  NEBULA_VALUE_ARENA_OPERATORS
+
   Value src;
   Value dst;
   EdgeType type;
@@ -10,10 +10,13 @@
 #include <vector>
 
 #include "common/datatypes/Value.h"
+#include "common/datatypes/ValueArena.h"
 
 namespace nebula {
 
 struct List {
+  NEBULA_VALUE_ARENA_OPERATORS
+
   std::vector<Value> values;
 
   List() = default;
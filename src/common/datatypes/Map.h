@@ -10,10 +10,13 @@
 
 #include "common/base/Logging.h"
 #include "common/datatypes/Value.h"
+#include "common/datatypes/ValueArena.h"
 
 namespace nebula {
 
 struct Map {
+  NEBULA_VALUE_ARENA_OPERATORS
+
   std::unordered_map<std::string, Value> kvs;
 
   Map() = default;
@@ -7,6 +7,7 @@
 #define COMMON_DATATYPES_PATH_H_
 
 #include "common/datatypes/Value.h"
+#include "common/datatypes/ValueArena.h"
 #include "common/datatypes/Vertex.h"
 #include "common/thrift/ThriftTypes.h"
 
@@ -101,6 +102,8 @@ struct Step {
 };
 
 struct Path {
+  NEBULA_VALUE_ARENA_OPERATORS
+
   Vertex src;
   std::vector<Step> steps;
 
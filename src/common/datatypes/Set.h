@@ -9,10 +9,13 @@
 #include <unordered_set>
 
 #include "common/datatypes/Value.h"
+#include "common/datatypes/ValueArena.h"
 
 namespace nebula {
 
 struct Set {
+  NEBULA_VALUE_ARENA_OPERATORS
+
   std::unordered_set<Value> values;
 
   Set() = default;
@@ -1224,23 +1224,39 @@ void Value::setF(double&& v) {
   type_ = Type::FLOAT;
 }
 
-void Value::setS(std::unique_ptr<std::string> v) {
-  new (std::addressof(value_.sVal)) std::unique_ptr<std::string>(std::move(v));
-  type_ = Type::STRING;
+void Value::StrDeleter::operator()(std::string* str) const noexcept {
+  str->~basic_string();
+  ValueArena::deallocate(str);
+}
+
+template <typename... Args>
+Value::StrPtr Value::makeStr(Args&&... args) {
+  void* ptr = ValueArena::allocate(sizeof(std::string));
+  try {
+    return StrPtr(new (ptr) std::string(std::forward<Args>(args)...));
+  } catch (...) {
+    ValueArena::deallocate(ptr);
+    throw;
+  }
 }
 
 void Value::setS(const std::string& v) {
-  new (std::addressof(value_.sVal)) std::unique_ptr<std::string>(new std::string(v));
+  new (std::addressof(value_.sVal)) StrPtr(makeStr(v));
   type_ = Type::STRING;
 }
 
 void Value::setS(std::string&& v) {
-  new (std::addressof(value_.sVal)) std::unique_ptr<std::string>(new std::string(std::move(v)));
+  new (std::addressof(value_.sVal)) StrPtr(makeStr(std::move(v)));
   type_ = Type::STRING;
 }
 
 void Value::setS(const char* v) {
-  new (std::addressof(value_.sVal)) std::unique_ptr<std::string>(new std::string(v));
+  new (std::addressof(value_.sVal)) StrPtr(makeStr(v));
+  type_ = Type::STRING;
+}
+
+void Value::setS(StrPtr v) {
+  new (std::addressof(value_.sVal)) StrPtr(std::move(v));
   type_ = Type::STRING;
 }
 
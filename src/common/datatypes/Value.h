@@ -12,6 +12,7 @@
 
 #include "common/datatypes/Date.h"
 #include "common/datatypes/Duration.h"
+#include "common/datatypes/ValueArena.h"
 #include "common/thrift/ThriftTypes.h"
 
 namespace apache {
@@ -384,6 +385,17 @@ struct Value {
   bool implicitBool() const;
 
  private:
+  // The string of a value is allocated by ValueArena like the other nodes, so a short one, which
+  // is kept in the small buffer of std::string, costs no heap allocation while an arena is bound.
+  // Otherwise it's a plain heap allocation just as std::unique_ptr<std::string>.
+  struct StrDeleter {
+    void operator()(std::string* str) const noexcept;
+  };
+  using StrPtr = std::unique_ptr<std::string, StrDeleter>;
+
+  template <typename... Args>
+  static StrPtr makeStr(Args&&... args);
+
   Type type_;
 
   union Storage {
@@ -391,7 +403,7 @@ struct Value {
     bool bVal;
     int64_t iVal;
     double fVal;
-    std::unique_ptr<std::string> sVal;
+    StrPtr sVal;
     Date dVal;
     Time tVal;
     DateTime dtVal;
@@ -430,7 +442,7 @@ struct Value {
   void setS(const std::string& v);
   void setS(std::string&& v);
   void setS(const char* v);
-  void setS(std::unique_ptr<std::string> v);
+  void setS(StrPtr v);
   // Date value
   void setD(const Date& v);
   void setD(Date&& v);
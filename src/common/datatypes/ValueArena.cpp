@@ -0,0 +1,108 @@
+/* Copyright (c) 2023 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "common/datatypes/ValueArena.h"
+
+#include <folly/concurrency/ConcurrentHashMap.h>
+
+#include <mutex>
+#include <new>
+
+namespace nebula {
+
+namespace {
+
+// The chunks alive of all arenas, to tell whether a node is allocated from a chunk
+folly::ConcurrentHashMap<std::uintptr_t, bool>& registeredChunks() {
+  static auto* chunks = new folly::ConcurrentHashMap<std::uintptr_t, bool>();
+  return *chunks;
+}
+
+}  // namespace
+
+thread_local ValueArena* ValueArena::current_ = nullptr;
+std::atomic<std::size_t> ValueArena::numArenas_{0};
+std::atomic<std::size_t> ValueArena::numChunks_{0};
+
+ValueArena::ValueArena() {
+  numArenas_.fetch_add(1, std::memory_order_relaxed);
+}
+
+ValueArena::~ValueArena() {
+  if (chunk_ != nullptr) {
+    release(chunk_);
+  }
+  numArenas_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+// static
+void* ValueArena::allocateSlow(std::size_t size) {
+  auto* arena = current_;
+  if (arena != nullptr && size <= kMaxNodeSize) {
+    return arena->allocateInChunk(size);
+  }
+  return ::operator new(size);
+}
+
+// static
+void ValueArena::deallocateSlow(void* ptr) noexcept {
+  // A chunk is registered before its first node and unregistered after its last one
+  auto base = reinterpret_cast<std::uintptr_t>(ptr) & ~(kChunkSize - 1);
+  auto& chunks = registeredChunks();
+  if (chunks.find(base) != chunks.cend()) {
+    release(reinterpret_cast<Chunk*>(base));
+  } else {
+    ::operator delete(ptr);
+  }
+}
+
+// static
+void ValueArena::release(Chunk* chunk) noexcept {
+  if (chunk->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    registeredChunks().erase(reinterpret_cast<std::uintptr_t>(chunk));
+    numChunks_.fetch_sub(1, std::memory_order_relaxed);
+    chunk->~Chunk();
+    ::operator delete(chunk, std::align_val_t(kChunkSize));
+  }
+}
+
+void* ValueArena::allocateInChunk(std::size_t size) {
+  // Keep the nodes aligned as the chunk
+  auto align = alignof(Chunk);
+  auto consumption = (size + align - 1) / align * align;
+  std::lock_guard<folly::SpinLock> guard(lock_);
+  if (consumption > available_) {
+    // The chunk is freed along with its last node
+    auto* chunk = new (::operator new(kChunkSize, std::align_val_t(kChunkSize))) Chunk();
+    numChunks_.fetch_add(1, std::memory_order_relaxed);
+    registeredChunks().insert(reinterpret_cast<std::uintptr_t>(chunk), true);
+    if (chunk_ != nullptr) {
+      release(chunk_);
+    }
+    chunk_ = chunk;
+    pos_ = reinterpret_cast<std::byte*>(chunk) + sizeof(Chunk);
+    available_ = kChunkSize - sizeof(Chunk);
+  }
+  auto* node = pos_;
+  chunk_->refs.fetch_add(1, std::memory_order_relaxed);
+  pos_ += consumption;
+  available_ -= consumption;
+  return node;
+}
+
+ValueArena::Scope::Scope(ValueArena* arena) : arena_(arena) {
+  if (arena_ != nullptr) {
+    prev_ = current_;
+    current_ = arena_;
+  }
+}
+
+ValueArena::Scope::~Scope() {
+  if (arena_ != nullptr) {
+    current_ = prev_;
+  }
+}
+
+}  // namespace nebula
@@ -0,0 +1,115 @@
+/* Copyright (c) 2023 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef COMMON_DATATYPES_VALUEARENA_H_
+#define COMMON_DATATYPES_VALUEARENA_H_
+
+#include <folly/SpinLock.h>
+
+#include <atomic>
+#include <boost/core/noncopyable.hpp>
+#include <cstddef>
+
+#include "common/cpp/helpers.h"
+
+namespace nebula {
+
+// Arena of the nodes owned by the Values, i.e. the strings, lists, maps, sets, datasets, vertices,
+// edges and paths, which are allocated from it while it's bound to the thread (see Scope), e.g.
+// the results built by the executors of a query.
+//
+// A node is bumped from the current chunk of the arena, and each chunk counts its nodes alive. The
+// chunk is freed once the arena moves on to another chunk or is destroyed, and all its nodes are
+// freed, so a node may outlive the arena safely, e.g. the values of the response.
+//
+// The chunks are aligned to their size and registered, so the chunk of a node is found from its
+// address and no node carries a header. While there is no arena at all, which is the default, the
+// nodes are allocated from the heap directly without looking up the arena of the thread.
+//
+// The types declare NEBULA_VALUE_ARENA_OPERATORS to be allocated by the arena.
+class ValueArena final : private boost::noncopyable, private cpp::NonMovable {
+ public:
+  ValueArena();
+
+  ~ValueArena();
+
+  // Allocate from the arena bound to the current thread, or from the heap if there is none
+  static void* allocate(std::size_t size) {
+    if (numArenas_.load(std::memory_order_relaxed) == 0) {
+      return ::operator new(size);
+    }
+    return allocateSlow(size);
+  }
+
+  // Free the memory returned by allocate
+  static void deallocate(void* ptr) noexcept {
+    if (numChunks_.load(std::memory_order_relaxed) == 0) {
+      ::operator delete(ptr);
+      return;
+    }
+    deallocateSlow(ptr);
+  }
+
+  // The arena bound to the current thread, nullptr if none
+  static ValueArena* current() {
+    return current_;
+  }
+
+  // Bind an arena to the current thread in the scope, a nullptr arena is ignored
+  class Scope final {
+   public:
+    explicit Scope(ValueArena* arena);
+    ~Scope();
+
+   private:
+    ValueArena* arena_;
+    ValueArena* prev_{nullptr};
+  };
+
+ private:
+  struct alignas(std::max_align_t) Chunk {
+    // Nodes alive, plus one if it's the current chunk of the arena
+    std::atomic<std::size_t> refs{1};
+  };
+
+  static constexpr std::size_t kChunkSize = 64 * 1024;
+  // A node bigger is allocated from the heap, not to waste the rest of a chunk
+  static constexpr std::size_t kMaxNodeSize = kChunkSize / 8;
+
+  static void* allocateSlow(std::size_t size);
+
+  static void deallocateSlow(void* ptr) noexcept;
+
+  static void release(Chunk* chunk) noexcept;
+
+  void* allocateInChunk(std::size_t size);
+
+  static thread_local ValueArena* current_;
+  // The arenas alive and the chunks registered
+  static std::atomic<std::size_t> numArenas_;
+  static std::atomic<std::size_t> numChunks_;
+
+  folly::SpinLock lock_;
+  Chunk* chunk_{nullptr};
+  std::byte* pos_{nullptr};
+  std::size_t available_{0};
+};
+
+}  // namespace nebula
+
+#define NEBULA_VALUE_ARENA_OPERATORS                   \
+  static void* operator new(std::size_t size) {        \
+    return ::nebula::ValueArena::allocate(size);       \
+  }                                                    \
+  static void operator delete(void* ptr) noexcept {    \
+    ::nebula::ValueArena::deallocate(ptr);             \
+  }                                                    \
+  static void* operator new(std::size_t, void* ptr) {  \
+    return ptr;                                        \
+  }                                                    \
+  static void operator delete(void*, void*) noexcept { \
+  }
+
+#endif  // COMMON_DATATYPES_VALUEARENA_H_
@@ -11,6 +11,7 @@
 #include <vector>
 
 #include "common/datatypes/Value.h"
+#include "common/datatypes/ValueArena.h"
 #include "common/thrift/ThriftTypes.h"
 
 namespace nebula {
@@ -60,6 +61,8 @@ struct Tag {
 };
 
 struct Vertex {
+  NEBULA_VALUE_ARENA_OPERATORS
+
   Value vid;
   std::vector<Tag> tags;
   std::atomic<size_t> refcnt{1};
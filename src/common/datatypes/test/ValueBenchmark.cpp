@@ -6,16 +6,21 @@
 #include <folly/Benchmark.h>
 
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include "common/base/Base.h"
 #include "common/datatypes/Edge.h"
+#include "common/datatypes/List.h"
 #include "common/datatypes/Value.h"
+#include "common/datatypes/ValueArena.h"
 #include "common/datatypes/Vertex.h"
 
 using nebula::Edge;
+using nebula::List;
 using nebula::Value;
+using nebula::ValueArena;
 using nebula::Vertex;
 
 static const int seed = folly::randomNumberSeed();
@@ -111,6 +116,127 @@ BENCHMARK(HashIntValue, n) {
   }
 }
 
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(CopyShortString, n) {
+  std::vector<Value> values;
+  BENCHMARK_SUSPEND {
+    values.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+      values.emplace_back(randomString(10));
+    }
+  }
+  std::vector<Value> copies(values);
+  folly::doNotOptimizeAway(copies);
+}
+
+BENCHMARK_RELATIVE(CopyShortStringInArena, n) {
+  std::vector<Value> values;
+  std::unique_ptr<ValueArena> arena;
+  BENCHMARK_SUSPEND {
+    values.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+      values.emplace_back(randomString(10));
+    }
+    arena = std::make_unique<ValueArena>();
+  }
+  ValueArena::Scope scope(arena.get());
+  std::vector<Value> copies(values);
+  folly::doNotOptimizeAway(copies);
+}
+
+BENCHMARK(CompareShortString, n) {
+  std::vector<Value> values;
+  BENCHMARK_SUSPEND {
+    values.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+      values.emplace_back(randomString(10));
+    }
+  }
+  size_t less = 0;
+  for (size_t i = 1; i < values.size(); i++) {
+    less += values[i - 1] < values[i];
+  }
+  folly::doNotOptimizeAway(less);
+}
+
+BENCHMARK_DRAW_LINE();
+
+// The rows of a short string vid and an int, half of which are duplicated
+std::vector<List> randomRows(size_t n) {
+  std::vector<List> rows;
+  rows.reserve(n);
+  for (size_t i = 0; i < n; i++) {
+    rows.emplace_back(List({randomString(10), random(0, 1)}));
+  }
+  for (size_t i = 0; i < n / 2; i++) {
+    rows[i * 2 + 1] = rows[i * 2];
+  }
+  return rows;
+}
+
+// Like DedupExecutor, which copies the rows into a set
+void dedup(size_t n, bool inArena) {
+  std::vector<List> rows;
+  std::unique_ptr<ValueArena> arena;
+  BENCHMARK_SUSPEND {
+    rows = randomRows(n);
+    if (inArena) {
+      arena = std::make_unique<ValueArena>();
+    }
+  }
+  ValueArena::Scope scope(arena.get());
+  std::unordered_set<List> set;
+  for (const auto &row : rows) {
+    set.emplace(row);
+  }
+  folly::doNotOptimizeAway(set);
+}
+
+BENCHMARK(Dedup, n) {
+  dedup(n, false);
+}
+
+BENCHMARK_RELATIVE(DedupInArena, n) {
+  dedup(n, true);
+}
+
+// Like the hash joins, which build the table of the keys and probe it by the keys of the other side
+void joinHash(size_t n, bool inArena) {
+  std::vector<List> rows;
+  std::unique_ptr<ValueArena> arena;
+  BENCHMARK_SUSPEND {
+    rows = randomRows(n);
+    if (inArena) {
+      arena = std::make_unique<ValueArena>();
+    }
+  }
+  ValueArena::Scope scope(arena.get());
+  std::unordered_map<Value, std::vector<const List *>> table;
+  for (const auto &row : rows) {
+    table[row.values[0]].emplace_back(&row);
+  }
+  std::vector<List> joined;
+  for (const auto &row : rows) {
+    auto find = table.find(row.values[0]);
+    if (find == table.end()) {
+      continue;
+    }
+    for (const auto *matched : find->second) {
+      joined.emplace_back(List({row.values[0], row.values[1], matched->values[1]}));
+    }
+  }
+  folly::doNotOptimizeAway(joined);
+}
+
+BENCHMARK(JoinHash, n) {
+  joinHash(n, false);
+}
+
+BENCHMARK_RELATIVE(JoinHashInArena, n) {
+  joinHash(n, true);
+}
+
 int main() {
   folly::runBenchmarks();
   return 0;
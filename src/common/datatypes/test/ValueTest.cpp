@@ -19,6 +19,7 @@
 #include "common/datatypes/Path.h"
 #include "common/datatypes/Set.h"
 #include "common/datatypes/Value.h"
+#include "common/datatypes/ValueArena.h"
 #include "common/datatypes/ValueOps-inl.h"
 #include "common/datatypes/Vertex.h"
 
@@ -1734,6 +1735,87 @@ TEST(Value, Ctor) {
   // Value v2(&tmp);
 }
 
+TEST(Value, MoveString) {
+  for (const auto& str : {std::string("short"), std::string(100, 'a')}) {
+    Value v(str);
+    Value moved(std::move(v));
+    EXPECT_TRUE(v.empty());  // NOLINT
+    EXPECT_EQ(str, moved.getStr());
+
+    std::vector<Value> values;
+    for (size_t i = 0; i < 100; i++) {
+      values.emplace_back(moved);
+    }
+    for (const auto& value : values) {
+      EXPECT_EQ(str, value.getStr());
+    }
+
+    Value assigned(1);
+    assigned = std::move(moved);
+    EXPECT_TRUE(moved.empty());  // NOLINT
+    EXPECT_EQ(str, assigned.getStr());
+    EXPECT_EQ(str, assigned.moveStr());
+    EXPECT_TRUE(assigned.empty());
+  }
+}
+
+TEST(Value, Arena) {
+  std::vector<Value> values;
+  {
+    auto arena = std::make_unique<ValueArena>();
+    ValueArena::Scope scope(arena.get());
+    for (int64_t i = 0; i < 10000; i++) {
+      values.emplace_back(List({i, std::to_string(i)}));
+      values.emplace_back(Edge("src", "dst", 1, "like", i, {{"prop", i}}));
+    }
+    // The nodes keep their chunks after the arena is gone
+    arena.reset();
+    values.emplace_back(List({-1}));
+  }
+  for (int64_t i = 0; i < 10000; i++) {
+    EXPECT_EQ(Value(List({i, std::to_string(i)})), values[i * 2]);
+    EXPECT_EQ(i, values[i * 2 + 1].getEdge().ranking);
+  }
+  EXPECT_EQ(Value(List({-1})), values.back());
+  // Free half of the nodes out of the order allocated
+  for (size_t i = 0; i < values.size(); i += 2) {
+    values[i].clear();
+  }
+  auto copies = values;
+  values.clear();
+  EXPECT_EQ(9999, copies[19999].getEdge().ranking);
+}
+
+TEST(Value, ArenaMixedWithHeap) {
+  // Allocated from the heap before any chunk exists
+  std::vector<Value> heap;
+  for (int64_t i = 0; i < 100; i++) {
+    heap.emplace_back(std::to_string(i));
+    heap.emplace_back(std::string(100, 'a' + i % 26));
+  }
+  std::vector<Value> values;
+  {
+    auto arena = std::make_unique<ValueArena>();
+    ValueArena::Scope scope(arena.get());
+    for (int64_t i = 0; i < 100; i++) {
+      values.emplace_back(std::to_string(i));
+      // The characters of a long string are still on the heap
+      values.emplace_back(std::string(100, 'a' + i % 26));
+      values.emplace_back(List({std::string(64 * 1024, 'x')}));
+    }
+    // Free the heap nodes while the chunks are alive
+    for (int64_t i = 0; i < 100; i++) {
+      EXPECT_EQ(values[i * 3], heap[i * 2]);
+      EXPECT_EQ(values[i * 3 + 1], heap[i * 2 + 1]);
+    }
+    heap.clear();
+  }
+  // And the heap nodes after the chunks are freed
+  heap.emplace_back("str");
+  values.clear();
+  EXPECT_EQ("str", heap.back().getStr());
+}
+
 TEST(Value, ToString) {
   {
     Duration d;
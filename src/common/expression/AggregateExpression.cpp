@@ -34,23 +34,53 @@ void AggregateExpression::resetFrom(Decoder& decoder) {
   if (aggFuncResult.ok()) {
     aggFunc_ = std::move(aggFuncResult).value();
   }
+  auto aggMergeResult = AggFunctionManager::getMerge(name_);
+  if (aggMergeResult.ok()) {
+    aggMerge_ = std::move(aggMergeResult).value();
+  }
 }
 
 const Value& AggregateExpression::eval(ExpressionContext& ctx) {
   DCHECK(!!aggData_);
   auto val = arg_->eval(ctx);
-  auto uniques = aggData_->uniques();
+  accumulate(aggData_, val);
+  return aggData_->result();
+}
+
+void AggregateExpression::accumulate(AggData* aggData, const Value& val) {
   if (distinct_) {
+    auto uniques = aggData->uniques();
     if (uniques->contains(val)) {
-      return aggData_->result();
+      return;
     }
     uniques->values.emplace(val);
   }
 
   DCHECK(aggFunc_);
-  aggFunc_(aggData_, val);
+  aggFunc_(aggData, val);
+}
 
-  return aggData_->result();
+bool AggregateExpression::mergeable() const {
+  if (!aggMerge_) {
+    return false;
+  }
+  // The distinct values are merged in no order, which matters to the list collected
+  return !distinct_ || !folly::StringPiece(name_).equals("COLLECT", folly::AsciiCaseInsensitive());
+}
+
+void AggregateExpression::merge(AggData* to, AggData* from) {
+  if (distinct_) {
+    // Accumulate the distinct values of `from` which are not in `to`
+    const auto* uniques = static_cast<const AggData*>(from)->uniques();
+    if (uniques != nullptr) {
+      for (const auto& val : uniques->values) {
+        accumulate(to, val);
+      }
+    }
+    return;
+  }
+  DCHECK(aggMerge_);
+  aggMerge_(to, from);
 }
 
 void AggregateExpression::apply(AggData* aggData, const Value& val) {
@@ -31,6 +31,17 @@ class AggregateExpression final : public Expression {
 
   void apply(AggData* aggData, const Value& val);
 
+  // Accumulate the value of the argument into the aggregate data, the same as `eval` except that
+  // the argument has been evaluated by the caller
+  void accumulate(AggData* aggData, const Value& val);
+
+  // Whether the aggregate data of the parts of the values could be merged by `merge`
+  bool mergeable() const;
+
+  // Merge the aggregate data of the values following the ones of `to`, the same as accumulating
+  // all the values into `to` in order
+  void merge(AggData* to, AggData* from);
+
   bool operator==(const Expression& rhs) const override;
 
   std::string toString() const override;
@@ -90,6 +101,10 @@ class AggregateExpression final : public Expression {
     if (aggFuncResult.ok()) {
       aggFunc_ = std::move(aggFuncResult).value();
     }
+    auto aggMergeResult = AggFunctionManager::getMerge(name_);
+    if (aggMergeResult.ok()) {
+      aggMerge_ = std::move(aggMergeResult).value();
+    }
   }
 
   void writeTo(Encoder& encoder) const override;
@@ -103,6 +118,7 @@ class AggregateExpression final : public Expression {
 
   // runtime cache for aggregate function lambda
   AggFunctionManager::AggFunction aggFunc_;
+  AggFunctionManager::AggMerge aggMerge_;
 };
 
 }  // namespace nebula
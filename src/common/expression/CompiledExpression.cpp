@@ -0,0 +1,411 @@
+/* Copyright (c) 2023 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "common/expression/CompiledExpression.h"
+
+#include "common/expression/BinaryExpression.h"
+#include "common/expression/ConstantExpression.h"
+#include "common/expression/LogicalExpression.h"
+#include "common/expression/PropertyExpression.h"
+#include "common/expression/UnaryExpression.h"
+
+namespace nebula {
+
+namespace {
+
+template <typename OpCode>
+bool binaryOpCode(Expression::Kind kind, OpCode* op) {
+  switch (kind) {
+    case Expression::Kind::kAdd:
+      *op = OpCode::kAdd;
+      return true;
+    case Expression::Kind::kMinus:
+      *op = OpCode::kMinus;
+      return true;
+    case Expression::Kind::kMultiply:
+      *op = OpCode::kMultiply;
+      return true;
+    case Expression::Kind::kDivision:
+      *op = OpCode::kDivision;
+      return true;
+    case Expression::Kind::kMod:
+      *op = OpCode::kMod;
+      return true;
+    case Expression::Kind::kRelEQ:
+      *op = OpCode::kRelEQ;
+      return true;
+    case Expression::Kind::kRelNE:
+      *op = OpCode::kRelNE;
+      return true;
+    case Expression::Kind::kRelLT:
+      *op = OpCode::kRelLT;
+      return true;
+    case Expression::Kind::kRelLE:
+      *op = OpCode::kRelLE;
+      return true;
+    case Expression::Kind::kRelGT:
+      *op = OpCode::kRelGT;
+      return true;
+    case Expression::Kind::kRelGE:
+      *op = OpCode::kRelGE;
+      return true;
+    default:
+      return false;
+  }
+}
+
+template <typename OpCode>
+bool unaryOpCode(Expression::Kind kind, OpCode* op) {
+  switch (kind) {
+    case Expression::Kind::kUnaryPlus:
+      *op = OpCode::kMove;
+      return true;
+    case Expression::Kind::kUnaryNegate:
+      *op = OpCode::kNegate;
+      return true;
+    case Expression::Kind::kUnaryNot:
+      *op = OpCode::kNot;
+      return true;
+    case Expression::Kind::kIsNull:
+      *op = OpCode::kIsNull;
+      return true;
+    case Expression::Kind::kIsNotNull:
+      *op = OpCode::kIsNotNull;
+      return true;
+    default:
+      return false;
+  }
+}
+
+// The state of XOR
+constexpr int64_t kXorHasEmpty = 1;
+constexpr int64_t kXorHasBool = 2;
+
+}  // namespace
+
+// static
+std::unique_ptr<CompiledExpression> CompiledExpression::compile(Expression* expr) {
+  DCHECK(expr != nullptr);
+  std::unique_ptr<CompiledExpression> compiled(new CompiledExpression());
+  compiled->result_ = compiled->emit(expr);
+  const auto& code = compiled->code_;
+  if (code.size() == 1 && code.front().op == OpCode::kEval) {
+    return nullptr;
+  }
+  return compiled;
+}
+
+const Value& CompiledExpression::eval(ExpressionContext& ctx) {
+  for (size_t pc = 0; pc < code_.size();) {
+    const auto& ins = code_[pc];
+    pc = execute(ins, &ctx) ? ins.target : pc + 1;
+  }
+  return regs_[result_];
+}
+
+uint32_t CompiledExpression::newRegister(Value value, bool constant) {
+  regs_.emplace_back(std::move(value));
+  constants_.emplace_back(constant);
+  return regs_.size() - 1;
+}
+
+uint32_t CompiledExpression::append(Instruction ins, std::initializer_list<uint32_t> operands) {
+  DCHECK_NE(operands.size(), 0);
+  ins.dst = newRegister();
+  bool foldable = std::all_of(
+      operands.begin(), operands.end(), [this](uint32_t reg) { return constants_[reg]; });
+  if (foldable) {
+    execute(ins, nullptr);
+    constants_[ins.dst] = true;
+  } else {
+    code_.emplace_back(ins);
+  }
+  return ins.dst;
+}
+
+uint32_t CompiledExpression::emit(Expression* expr) {
+  auto kind = expr->kind();
+  OpCode op;
+  if (binaryOpCode(kind, &op)) {
+    auto* binary = static_cast<BinaryExpression*>(expr);
+    auto lhs = emit(binary->left());
+    auto rhs = emit(binary->right());
+    return append({op, 0, lhs, rhs}, {lhs, rhs});
+  }
+  if (unaryOpCode(kind, &op)) {
+    auto operand = emit(static_cast<UnaryExpression*>(expr)->operand());
+    return append({op, 0, operand}, {operand});
+  }
+
+  switch (kind) {
+    case Expression::Kind::kConstant: {
+      return newRegister(static_cast<ConstantExpression*>(expr)->value(), true);
+    }
+    case Expression::Kind::kLogicalAnd:
+    case Expression::Kind::kLogicalOr:
+    case Expression::Kind::kLogicalXor: {
+      return emitLogical(expr);
+    }
+    case Expression::Kind::kEdgeProperty:
+    case Expression::Kind::kEdgeSrc:
+    case Expression::Kind::kEdgeType:
+    case Expression::Kind::kEdgeRank:
+    case Expression::Kind::kEdgeDst: {
+      op = OpCode::kEdgeProp;
+      break;
+    }
+    case Expression::Kind::kTagProperty: {
+      op = OpCode::kTagProp;
+      break;
+    }
+    case Expression::Kind::kSrcProperty: {
+      op = OpCode::kSrcProp;
+      break;
+    }
+    case Expression::Kind::kDstProperty: {
+      op = OpCode::kDstProp;
+      break;
+    }
+    default: {
+      op = OpCode::kEval;
+      break;
+    }
+  }
+  auto dst = newRegister();
+  code_.emplace_back(Instruction{op, dst, 0, 0, 0, expr});
+  return dst;
+}
+
+uint32_t CompiledExpression::emitLogical(Expression* expr) {
+  auto kind = expr->kind();
+  OpCode op = kind == Expression::Kind::kLogicalAnd  ? OpCode::kAnd
+              : kind == Expression::Kind::kLogicalOr ? OpCode::kOr
+                                                     : OpCode::kXor;
+  Value init;
+  if (op != OpCode::kXor) {
+    init = op == OpCode::kAnd;
+  }
+  auto begin = code_.size();
+  auto acc = newRegister();
+  code_.emplace_back(Instruction{OpCode::kMove, acc, newRegister(std::move(init), true)});
+  uint32_t state = 0;
+  if (op == OpCode::kXor) {
+    state = newRegister();
+    code_.emplace_back(Instruction{OpCode::kMove, state, newRegister(int64_t{0}, true)});
+  }
+
+  bool foldable = true;
+  std::vector<size_t> steps;
+  for (auto* operand : static_cast<LogicalExpression*>(expr)->operands()) {
+    auto reg = emit(operand);
+    foldable = foldable && constants_[reg];
+    steps.emplace_back(code_.size());
+    code_.emplace_back(Instruction{op, acc, reg, state});
+  }
+  // Jump to the end once the result is determined
+  for (auto step : steps) {
+    code_[step].target = code_.size();
+  }
+
+  if (foldable) {
+    // All operands are constants, so only the moves and the steps are emitted
+    for (auto pc = begin; pc < code_.size();) {
+      const auto& ins = code_[pc];
+      pc = execute(ins, nullptr) ? ins.target : pc + 1;
+    }
+    code_.resize(begin);
+    constants_[acc] = true;
+  }
+  return acc;
+}
+
+bool CompiledExpression::execute(const Instruction& ins, ExpressionContext* ctx) {
+  auto& dst = regs_[ins.dst];
+  switch (ins.op) {
+    case OpCode::kEval: {
+      dst = ins.expr->eval(*ctx);
+      return false;
+    }
+    case OpCode::kEdgeProp: {
+      auto* prop = static_cast<PropertyExpression*>(ins.expr);
+      dst = ctx->getEdgeProp(prop->sym(), prop->prop());
+      return false;
+    }
+    case OpCode::kTagProp: {
+      auto* prop = static_cast<PropertyExpression*>(ins.expr);
+      dst = ctx->getTagProp(prop->sym(), prop->prop());
+      return false;
+    }
+    case OpCode::kSrcProp: {
+      auto* prop = static_cast<PropertyExpression*>(ins.expr);
+      dst = ctx->getSrcProp(prop->sym(), prop->prop());
+      return false;
+    }
+    case OpCode::kDstProp: {
+      auto* prop = static_cast<PropertyExpression*>(ins.expr);
+      dst = ctx->getDstProp(prop->sym(), prop->prop());
+      return false;
+    }
+    case OpCode::kMove: {
+      dst = regs_[ins.a];
+      return false;
+    }
+    default: {
+      break;
+    }
+  }
+
+  // The operators specialize the integer operands, and fall back to the operators of Value,
+  // which are the same as the tree
+  const auto& lhs = regs_[ins.a];
+  const auto& rhs = regs_[ins.b];
+  bool ints = lhs.isInt() && rhs.isInt();
+  switch (ins.op) {
+    case OpCode::kAdd: {
+      int64_t res;
+      if (!ints) {
+        dst = lhs + rhs;
+      } else if (__builtin_add_overflow(lhs.getInt(), rhs.getInt(), &res)) {
+        dst = Value::kNullOverflow;
+      } else {
+        dst = res;
+      }
+      return false;
+    }
+    case OpCode::kMinus: {
+      int64_t res;
+      if (!ints) {
+        dst = lhs - rhs;
+      } else if (__builtin_sub_overflow(lhs.getInt(), rhs.getInt(), &res)) {
+        dst = Value::kNullOverflow;
+      } else {
+        dst = res;
+      }
+      return false;
+    }
+    case OpCode::kMultiply: {
+      int64_t res;
+      if (!ints) {
+        dst = lhs * rhs;
+      } else if (__builtin_mul_overflow(lhs.getInt(), rhs.getInt(), &res)) {
+        dst = Value::kNullOverflow;
+      } else {
+        dst = res;
+      }
+      return false;
+    }
+    case OpCode::kDivision: {
+      // Division by zero and INT64_MIN / -1 are handled by the operator of Value
+      if (ints && rhs.getInt() != 0 && rhs.getInt() != -1) {
+        dst = lhs.getInt() / rhs.getInt();
+      } else {
+        dst = lhs / rhs;
+      }
+      return false;
+    }
+    case OpCode::kMod: {
+      if (ints && rhs.getInt() != 0 && rhs.getInt() != -1) {
+        dst = lhs.getInt() % rhs.getInt();
+      } else {
+        dst = lhs % rhs;
+      }
+      return false;
+    }
+    case OpCode::kRelEQ: {
+      dst = ints ? Value(lhs.getInt() == rhs.getInt()) : lhs.equal(rhs);
+      return false;
+    }
+    case OpCode::kRelNE: {
+      dst = ints ? Value(lhs.getInt() != rhs.getInt()) : !lhs.equal(rhs);
+      return false;
+    }
+    case OpCode::kRelLT: {
+      dst = ints ? Value(lhs.getInt() < rhs.getInt()) : lhs.lessThan(rhs);
+      return false;
+    }
+    case OpCode::kRelLE: {
+      dst = ints ? Value(lhs.getInt() <= rhs.getInt()) : lhs.lessThan(rhs) || lhs.equal(rhs);
+      return false;
+    }
+    case OpCode::kRelGT: {
+      dst = ints ? Value(lhs.getInt() > rhs.getInt()) : rhs.lessThan(lhs);
+      return false;
+    }
+    case OpCode::kRelGE: {
+      dst = ints ? Value(lhs.getInt() >= rhs.getInt()) : rhs.lessThan(lhs) || lhs.equal(rhs);
+      return false;
+    }
+    case OpCode::kNot: {
+      dst = !lhs;
+      return false;
+    }
+    case OpCode::kNegate: {
+      dst = -lhs;
+      return false;
+    }
+    case OpCode::kIsNull: {
+      dst = lhs.isNull();
+      return false;
+    }
+    case OpCode::kIsNotNull: {
+      dst = !lhs.isNull();
+      return false;
+    }
+    case OpCode::kAnd:
+    case OpCode::kOr: {
+      // The same as LogicalExpression::evalAnd and LogicalExpression::evalOr
+      bool decisive = ins.op == OpCode::kOr;
+      if (lhs.isBadNull() || (lhs.isImplicitBool() && lhs.implicitBool() == decisive)) {
+        dst = lhs;
+        return true;
+      }
+      if (!lhs.isImplicitBool()) {
+        if (lhs.isNull()) {
+          dst = lhs;
+        } else if (lhs.empty() && !dst.isNull()) {
+          dst = lhs;
+        } else {
+          dst = Value::kNullBadType;
+          return true;
+        }
+      }
+      return false;
+    }
+    case OpCode::kXor: {
+      // The same as LogicalExpression::evalXor
+      auto& state = regs_[ins.b];
+      if (lhs.isNull()) {
+        dst = lhs;
+        return true;
+      }
+      if (!lhs.isImplicitBool()) {
+        if (lhs.empty()) {
+          dst = lhs;
+          state = state.getInt() | kXorHasEmpty;
+          return false;
+        }
+        dst = Value::kNullBadType;
+        return true;
+      }
+      if (state.getInt() & kXorHasEmpty) {
+        return false;
+      }
+      if (state.getInt() & kXorHasBool) {
+        dst = static_cast<bool>(dst.implicitBool() ^ lhs.implicitBool());
+      } else {
+        dst = static_cast<bool>(lhs.implicitBool());
+        state = state.getInt() | kXorHasBool;
+      }
+      return false;
+    }
+    default: {
+      break;
+    }
+  }
+  DLOG(FATAL) << "Unknown op code: " << static_cast<int>(ins.op);
+  return false;
+}
+
+}  // namespace nebula
@@ -0,0 +1,105 @@
+/* Copyright (c) 2023 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef COMMON_EXPRESSION_COMPILEDEXPRESSION_H_
+#define COMMON_EXPRESSION_COMPILEDEXPRESSION_H_
+
+#include "common/base/Base.h"
+#include "common/expression/Expression.h"
+
+namespace nebula {
+
+// CompiledExpression is an expression tree lowered into a flat register-based program, which is
+// executed by a single dispatch loop instead of the recursive virtual calls of `Expression::eval`.
+//
+// The arithmetic, relational, logical, and unary operators and the property accesses of
+// vertices and edges are compiled into instructions, the operands of which are registers.
+// Constants are preloaded into registers and the operators on constants are folded at compile
+// time. The logical operators jump over the rest operands once the result is determined, the same
+// short circuit as the tree. The other expressions are evaluated by the tree interpreter as a
+// whole, so any expression could be compiled and the result is always the same as the tree.
+//
+// Like `Expression`, it's not thread safe to evaluate a compiled expression concurrently.
+class CompiledExpression final {
+ public:
+  // Return nullptr if nothing in the expression could be compiled
+  static std::unique_ptr<CompiledExpression> compile(Expression* expr);
+
+  const Value& eval(ExpressionContext& ctx);
+
+  // The number of instructions
+  size_t size() const {
+    return code_.size();
+  }
+
+ private:
+  enum class OpCode : uint8_t {
+    // regs[dst] = expr->eval(ctx)
+    kEval,
+    // regs[dst] = ctx.getXXXProp(expr->sym(), expr->prop())
+    kEdgeProp,
+    kTagProp,
+    kSrcProp,
+    kDstProp,
+    // regs[dst] = regs[a]
+    kMove,
+    // regs[dst] = regs[a] op regs[b]
+    kAdd,
+    kMinus,
+    kMultiply,
+    kDivision,
+    kMod,
+    kRelEQ,
+    kRelNE,
+    kRelLT,
+    kRelLE,
+    kRelGT,
+    kRelGE,
+    // regs[dst] = op regs[a]
+    kNot,
+    kNegate,
+    kIsNull,
+    kIsNotNull,
+    // Fold regs[a] into the accumulator regs[dst], and jump to `target` if the result is
+    // determined. The XOR keeps its state in regs[b].
+    kAnd,
+    kOr,
+    kXor,
+  };
+
+  struct Instruction {
+    OpCode op;
+    uint32_t dst{0};
+    uint32_t a{0};
+    uint32_t b{0};
+    uint32_t target{0};
+    Expression* expr{nullptr};
+  };
+
+  CompiledExpression() = default;
+
+  // Emit the instructions of the expression, return the register of the result
+  uint32_t emit(Expression* expr);
+
+  uint32_t emitLogical(Expression* expr);
+
+  uint32_t newRegister(Value value = Value(), bool constant = false);
+
+  // Append the instruction, which is folded if all operands are constants
+  uint32_t append(Instruction ins, std::initializer_list<uint32_t> operands);
+
+  // Execute the instruction, return true to jump
+  bool execute(const Instruction& ins, ExpressionContext* ctx);
+
+  std::vector<Instruction> code_;
+  std::vector<Value> regs_;
+  // Whether the register holds a constant
+  std::vector<bool> constants_;
+  uint32_t result_{0};
+};
+
+}  // namespace nebula
+
+#endif  // COMMON_EXPRESSION_COMPILEDEXPRESSION_H_
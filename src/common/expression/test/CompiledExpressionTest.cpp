@@ -0,0 +1,157 @@
+/* Copyright (c) 2023 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+#include "common/expression/CompiledExpression.h"
+#include "common/expression/test/TestBase.h"
+
+namespace nebula {
+
+class CompiledExpressionTest : public ExpressionTest {
+ protected:
+  Expression *edgeProp(const std::string &prop) {
+    return EdgePropertyExpression::make(&pool, "e", prop);
+  }
+
+  Expression *srcProp(const std::string &prop) {
+    return SourcePropertyExpression::make(&pool, "t", prop);
+  }
+
+  Expression *constant(Value v) {
+    return ConstantExpression::make(&pool, std::move(v));
+  }
+
+  // The compiled expression must be evaluated to the same value as the tree
+  void check(Expression *expr) {
+    auto compiled = CompiledExpression::compile(expr);
+    ASSERT_NE(compiled, nullptr) << expr->toString();
+    Value expected = expr->eval(gExpCtxt);
+    // Evaluate twice to make sure the registers are reset
+    for (int i = 0; i < 2; ++i) {
+      const auto &result = compiled->eval(gExpCtxt);
+      EXPECT_EQ(expected.type(), result.type()) << expr->toString();
+      if (expected.isFloat() && std::isnan(expected.getFloat())) {
+        EXPECT_TRUE(result.isFloat() && std::isnan(result.getFloat())) << expr->toString();
+      } else {
+        EXPECT_EQ(expected, result) << expr->toString();
+      }
+    }
+  }
+};
+
+TEST_F(CompiledExpressionTest, Compile) {
+  // Nothing to compile
+  EXPECT_EQ(CompiledExpression::compile(FunctionCallExpression::make(&pool, "rand")), nullptr);
+  {
+    // Constant folding
+    auto *expr = ArithmeticExpression::makeAdd(
+        &pool, constant(1), ArithmeticExpression::makeMultiply(&pool, constant(2), constant(3)));
+    auto compiled = CompiledExpression::compile(expr);
+    ASSERT_NE(compiled, nullptr);
+    EXPECT_EQ(compiled->size(), 0);
+    EXPECT_EQ(compiled->eval(gExpCtxt), Value(7));
+  }
+  {
+    // e.int > 1 + 2 AND (true OR false)
+    auto *expr = LogicalExpression::makeAnd(
+        &pool,
+        RelationalExpression::makeGT(
+            &pool, edgeProp("int"), ArithmeticExpression::makeAdd(&pool, constant(1), constant(2))),
+        LogicalExpression::makeOr(&pool, constant(true), constant(false)));
+    auto compiled = CompiledExpression::compile(expr);
+    ASSERT_NE(compiled, nullptr);
+    // Load the accumulator, the edge property, the comparison and two steps of AND
+    EXPECT_EQ(compiled->size(), 5);
+    check(expr);
+  }
+}
+
+TEST_F(CompiledExpressionTest, Arithmetic) {
+  std::vector<Value> values = {Value::kEmpty,
+                               Value::kNullValue,
+                               true,
+                               0,
+                               -1,
+                               3,
+                               std::numeric_limits<int64_t>::max(),
+                               std::numeric_limits<int64_t>::min(),
+                               0.0,
+                               2.5,
+                               "abc"};
+  for (const auto &l : values) {
+    for (const auto &r : values) {
+      check(ArithmeticExpression::makeAdd(&pool, edgeProp("int"), constant(r)));
+      check(ArithmeticExpression::makeAdd(&pool, constant(l), srcProp("int")));
+      for (auto kind : {Expression::Kind::kAdd,
+                        Expression::Kind::kMinus,
+                        Expression::Kind::kMultiply,
+                        Expression::Kind::kDivision,
+                        Expression::Kind::kMod}) {
+        check(ArithmeticExpression::makeKind(&pool, kind, constant(l), constant(r)));
+        auto *lhs = ArithmeticExpression::makeAdd(&pool, edgeProp("int"), constant(l));
+        check(ArithmeticExpression::makeKind(&pool, kind, lhs, constant(r)));
+      }
+    }
+    check(UnaryExpression::makeNegate(&pool, constant(l)));
+    auto *minus = ArithmeticExpression::makeMinus(&pool, constant(l), edgeProp("int"));
+    check(UnaryExpression::makeNegate(&pool, minus));
+  }
+}
+
+TEST_F(CompiledExpressionTest, Relational) {
+  std::vector<Expression *> operands = {
+      edgeProp("int"),
+      edgeProp("float"),
+      edgeProp("null"),
+      edgeProp("empty"),
+      edgeProp("bool_true"),
+      edgeProp("string16"),
+      constant(1),
+      constant(1.0 + 1e-9),
+      constant(Value::kNullValue),
+  };
+  for (auto *l : operands) {
+    for (auto *r : operands) {
+      check(RelationalExpression::makeEQ(&pool, l, r));
+      check(RelationalExpression::makeNE(&pool, l, r));
+      check(RelationalExpression::makeLT(&pool, l, r));
+      check(RelationalExpression::makeLE(&pool, l, r));
+      check(RelationalExpression::makeGT(&pool, l, r));
+      check(RelationalExpression::makeGE(&pool, l, r));
+    }
+    check(UnaryExpression::makeIsNull(&pool, l));
+    check(UnaryExpression::makeIsNotNull(&pool, l));
+    check(UnaryExpression::makeNot(&pool, l));
+    check(UnaryExpression::makePlus(&pool, l));
+  }
+}
+
+TEST_F(CompiledExpressionTest, Logical) {
+  std::vector<Expression *> operands = {
+      edgeProp("bool_true"),
+      edgeProp("bool_false"),
+      edgeProp("null"),
+      edgeProp("empty"),
+      edgeProp("int"),
+      constant(true),
+      constant(false),
+      constant(Value::kNullValue),
+      constant(Value::kNullBadType),
+      constant(Value::kEmpty),
+  };
+  for (auto *a : operands) {
+    for (auto *b : operands) {
+      for (auto *c : operands) {
+        for (auto kind : {Expression::Kind::kLogicalAnd,
+                          Expression::Kind::kLogicalOr,
+                          Expression::Kind::kLogicalXor}) {
+          auto *expr = LogicalExpression::makeKind(&pool, kind, a, b);
+          expr->addOperand(c);
+          check(expr);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace nebula
@@ -10,6 +10,36 @@
 
 namespace nebula {
 
+namespace {
+
+void moveAggData(AggData* to, AggData* from) {
+  to->setCnt(std::move(from->cnt()));
+  to->setSum(std::move(from->sum()));
+  to->setAvg(std::move(from->avg()));
+  to->setDeviation(std::move(from->deviation()));
+  to->setResult(std::move(from->result()));
+}
+
+// Merge the results if either is null, return false if neither is null and they are left to merge
+bool mergeNulls(AggData* to, AggData* from) {
+  const auto& res = to->result();
+  const auto& other = from->result();
+  if (res.isBadNull()) {
+    return true;
+  }
+  if (other.isBadNull() || res.isNull()) {
+    moveAggData(to, from);
+    return true;
+  }
+  return other.isNull();
+}
+
+double toDouble(const Value& val) {
+  return val.isInt() ? static_cast<double>(val.getInt()) : val.getFloat();
+}
+
+}  // namespace
+
 // static
 AggFunctionManager& AggFunctionManager::instance() {
   static AggFunctionManager instance;
@@ -273,6 +303,139 @@ AggFunctionManager::AggFunctionManager() {
       set.values.emplace(val);
     };
   }
+  initMerges();
+}
+
+void AggFunctionManager::initMerges() {
+  {
+    auto& merge = merges_[""];
+    merge = [](AggData* to, AggData* from) { to->setResult(std::move(from->result())); };
+  }
+  {
+    // The count and sum are both added up
+    auto add = [](AggData* to, AggData* from) {
+      if (mergeNulls(to, from)) {
+        return;
+      }
+      to->setResult(to->result() + from->result());
+    };
+    merges_["COUNT"] = add;
+    merges_["SUM"] = add;
+  }
+  {
+    auto& merge = merges_["AVG"];
+    merge = [](AggData* to, AggData* from) {
+      if (mergeNulls(to, from)) {
+        return;
+      }
+      to->setSum(to->sum() + from->sum());
+      to->setCnt(to->cnt() + from->cnt());
+      to->setResult(to->sum() / to->cnt());
+    };
+  }
+  {
+    auto& merge = merges_["MAX"];
+    merge = [](AggData* to, AggData* from) {
+      if (mergeNulls(to, from)) {
+        return;
+      }
+      if (from->result() > to->result()) {
+        to->setResult(std::move(from->result()));
+      }
+    };
+  }
+  {
+    auto& merge = merges_["MIN"];
+    merge = [](AggData* to, AggData* from) {
+      if (mergeNulls(to, from)) {
+        return;
+      }
+      if (from->result() < to->result()) {
+        to->setResult(std::move(from->result()));
+      }
+    };
+  }
+  {
+    auto& merge = merges_["STD"];
+    merge = [](AggData* to, AggData* from) {
+      if (mergeNulls(to, from)) {
+        return;
+      }
+      // Combine the population variances of the two parts
+      auto cnt1 = toDouble(to->cnt()), cnt2 = toDouble(from->cnt());
+      auto avg1 = toDouble(to->avg()), avg2 = toDouble(from->avg());
+      auto cnt = cnt1 + cnt2;
+      auto delta = avg2 - avg1;
+      auto dev1 = toDouble(to->deviation()), dev2 = toDouble(from->deviation());
+      auto deviation =
+          (cnt1 * dev1 + cnt2 * dev2) / cnt + delta * delta * cnt1 * cnt2 / (cnt * cnt);
+      to->setCnt(cnt);
+      to->setAvg(avg1 + delta * cnt2 / cnt);
+      to->setDeviation(deviation);
+      to->setResult(std::sqrt(deviation));
+    };
+  }
+  {
+    auto& merge = merges_["BIT_AND"];
+    merge = [](AggData* to, AggData* from) {
+      if (mergeNulls(to, from)) {
+        return;
+      }
+      to->setResult(to->result() & from->result());
+    };
+  }
+  {
+    auto& merge = merges_["BIT_OR"];
+    merge = [](AggData* to, AggData* from) {
+      if (mergeNulls(to, from)) {
+        return;
+      }
+      to->setResult(to->result() | from->result());
+    };
+  }
+  {
+    auto& merge = merges_["BIT_XOR"];
+    merge = [](AggData* to, AggData* from) {
+      if (mergeNulls(to, from)) {
+        return;
+      }
+      to->setResult(to->result() ^ from->result());
+    };
+  }
+  {
+    auto& merge = merges_["COLLECT"];
+    merge = [](AggData* to, AggData* from) {
+      if (mergeNulls(to, from)) {
+        return;
+      }
+      auto& res = to->result();
+      auto& other = from->result();
+      if (!res.isList() || !other.isList()) {
+        res = Value::kNullBadData;
+        return;
+      }
+      auto& values = res.mutableList().values;
+      auto& others = other.mutableList().values;
+      values.insert(values.end(),
+                    std::make_move_iterator(others.begin()),
+                    std::make_move_iterator(others.end()));
+    };
+  }
+  {
+    auto& merge = merges_["COLLECT_SET"];
+    merge = [](AggData* to, AggData* from) {
+      if (mergeNulls(to, from)) {
+        return;
+      }
+      auto& res = to->result();
+      auto& other = from->result();
+      if (!res.isSet() || !other.isSet()) {
+        res = Value::kNullBadData;
+        return;
+      }
+      res.mutableSet().values.merge(other.mutableSet().values);
+    };
+  }
 }
 
 StatusOr<AggFunctionManager::AggFunction> AggFunctionManager::get(const std::string& func) {
@@ -281,6 +444,11 @@ StatusOr<AggFunctionManager::AggFunction> AggFunctionManager::get(const std::str
   return result.value();
 }
 
+// static
+StatusOr<AggFunctionManager::AggMerge> AggFunctionManager::getMerge(const std::string& func) {
+  return instance().getMergeInternal(func);
+}
+
 Status AggFunctionManager::find(const std::string& func) {
   auto result = instance().getInternal(func);
   NG_RETURN_IF_ERROR(result);
@@ -298,6 +466,16 @@ StatusOr<AggFunctionManager::AggFunction> AggFunctionManager::getInternal(std::s
   return iter->second;
 }
 
+StatusOr<AggFunctionManager::AggMerge> AggFunctionManager::getMergeInternal(
+    std::string func) const {
+  std::transform(func.begin(), func.end(), func.begin(), ::toupper);
+  auto iter = merges_.find(func);
+  if (iter == merges_.end()) {
+    return Status::Error("No merge of aggregate function `%s'", func.c_str());
+  }
+  return iter->second;
+}
+
 Status AggFunctionManager::load(const std::string& soname, const std::vector<std::string>& funcs) {
   return instance().loadInternal(soname, funcs);
 }
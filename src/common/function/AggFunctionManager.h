@@ -21,13 +21,10 @@ namespace nebula {
 
 class AggData final {
  public:
+  // The set of unique values is only used by the distinct aggregation, so it's allocated lazily
   explicit AggData(Set* uniques = nullptr)
       : cnt_(0), sum_(0.0), avg_(0.0), deviation_(0.0), result_(Value::kNullValue) {
-    if (uniques == nullptr) {
-      uniques_ = std::make_unique<Set>();
-    } else {
-      uniques_.reset(uniques);
-    }
+    uniques_.reset(uniques);
   }
 
   const Value& cnt() const {
@@ -99,6 +96,9 @@ class AggData final {
   }
 
   Set* uniques() {
+    if (uniques_ == nullptr) {
+      uniques_ = std::make_unique<Set>();
+    }
     return uniques_.get();
   }
 
@@ -118,12 +118,21 @@ class AggData final {
 class AggFunctionManager final {
  public:
   using AggFunction = std::function<void(AggData*, const Value&)>;
+  // Merge the aggregate data of the values following the ones of `to', the result is the same as
+  // applying the function on all the values in order. `from' is left in an unspecified state.
+  using AggMerge = std::function<void(AggData* to, AggData* from)>;
 
   /**
    * To obtain a aggregate function named `func'
    */
   static StatusOr<AggFunction> get(const std::string& func);
 
+  /**
+   * To obtain the merge of the aggregate function named `func', which is only available for the
+   * builtin functions
+   */
+  static StatusOr<AggMerge> getMerge(const std::string& func);
+
   /**
    * To Check the validity of the function named `func'
    * Only used for parser check.
@@ -151,11 +160,16 @@ class AggFunctionManager final {
 
   StatusOr<AggFunction> getInternal(std::string func) const;
 
+  StatusOr<AggMerge> getMergeInternal(std::string func) const;
+
+  void initMerges();
+
   Status loadInternal(const std::string& soname, const std::vector<std::string>& funcs);
 
   Status unloadInternal(const std::string& soname, const std::vector<std::string>& funcs);
 
   std::unordered_map<std::string, AggFunction> functions_;
+  std::unordered_map<std::string, AggMerge> merges_;
 };
 
 }  // namespace nebula
@@ -31,6 +31,27 @@ class AggFunctionManagerTest : public ::testing::Test {
     EXPECT_EQ(res, expect) << "agg function return value check failed: " << expr;
   }
 
+  // Aggregate the data split at each position and merge the two parts, which should be the same
+  // as aggregating the whole data
+  void testMerge(const char *expr, const std::vector<Value> &groupData) {
+    auto func = AggFunctionManager::get(expr);
+    ASSERT_TRUE(func.ok());
+    auto merge = AggFunctionManager::getMerge(expr);
+    ASSERT_TRUE(merge.ok());
+    AggData whole;
+    for (const auto &val : groupData) {
+      func.value()(&whole, val);
+    }
+    for (size_t i = 1; i < groupData.size(); ++i) {
+      AggData left, right;
+      for (size_t j = 0; j < groupData.size(); ++j) {
+        func.value()(j < i ? &left : &right, groupData[j]);
+      }
+      merge.value()(&left, &right);
+      EXPECT_EQ(left.result(), whole.result()) << "agg function merge check failed: " << expr;
+    }
+  }
+
   static std::unordered_map<std::string, std::vector<Value>> testData_;
 };
 
@@ -127,6 +148,23 @@ TEST_F(AggFunctionManagerTest, aggFunc) {
   }
 }
 
+TEST_F(AggFunctionManagerTest, aggMerge) {
+  std::vector<Value> numbers = {3, NullType::__NULL__, 1.5, 7, Value(), 2, 4.25, 9};
+  std::vector<Value> ints = {6, 3, NullType::__NULL__, 12, 5, 9};
+  std::vector<Value> badType = {1, "a", 2};
+  for (auto *func : {"count", "sum", "avg", "max", "min", "std", "collect", "collect_set"}) {
+    testMerge(func, numbers);
+    testMerge(func, testData_["mixed"]);
+  }
+  for (auto *func : {"bit_and", "bit_or", "bit_xor"}) {
+    testMerge(func, ints);
+  }
+  for (auto *func : {"sum", "avg", "std", "bit_and"}) {
+    testMerge(func, badType);
+  }
+  EXPECT_FALSE(AggFunctionManager::getMerge("unknown").ok());
+}
+
 }  // namespace nebula
 
 int main(int argc, char **argv) {
@@ -53,6 +53,9 @@ struct TccStructTraits<::nebula::ExecutionResponse> {
     } else if (_fname == "comment") {
       fid = 7;
       _ftype = apache::thrift::protocol::T_STRING;
+    } else if (_fname == "page_token") {
+      fid = 8;
+      _ftype = apache::thrift::protocol::T_I64;
     }
   }
 };
@@ -104,6 +107,12 @@ uint32_t Cpp2Ops<::nebula::ExecutionResponse>::write(Protocol* proto,
     xfer += proto->writeBinary(*obj->comment);
     xfer += proto->writeFieldEnd();
   }
+  if (obj->pageToken != nullptr) {
+    xfer += proto->writeFieldBegin("page_token", apache::thrift::protocol::T_I64, 8);
+    xfer += ::apache::thrift::detail::pm::protocol_methods<::apache::thrift::type_class::integral,
+                                                           int64_t>::write(*proto, *obj->pageToken);
+    xfer += proto->writeFieldEnd();
+  }
   xfer += proto->writeFieldStop();
   xfer += proto->writeStructEnd();
   return xfer;
@@ -183,7 +192,17 @@ _readField_comment : {
   //    this->__isset.comment = true;
 }
 
-  if (UNLIKELY(!_readState.advanceToNextField(proto, 7, 0, apache::thrift::protocol::T_STOP))) {
+  if (UNLIKELY(!_readState.advanceToNextField(proto, 7, 8, apache::thrift::protocol::T_I64))) {
+    goto _loop;
+  }
+_readField_page_token : {
+  obj->pageToken = std::make_unique<int64_t>(-1);
+  ::apache::thrift::detail::pm::protocol_methods<::apache::thrift::type_class::integral,
+                                                 int64_t>::read(*proto, *obj->pageToken);
+  //    this->__isset.page_token = true;
+}
+
+  if (UNLIKELY(!_readState.advanceToNextField(proto, 8, 0, apache::thrift::protocol::T_STOP))) {
     goto _loop;
   }
 
@@ -257,6 +276,13 @@ _loop:
         goto _skip;
       }
     }
+    case 8: {
+      if (LIKELY(_readState.fieldType == apache::thrift::protocol::T_I64)) {
+        goto _readField_page_token;
+      } else {
+        goto _skip;
+      }
+    }
     default: {
 _skip:
       proto->skip(_readState.fieldType);
@@ -301,6 +327,12 @@ uint32_t Cpp2Ops<::nebula::ExecutionResponse>::serializedSize(
     xfer += proto->serializedFieldSize("comment", apache::thrift::protocol::T_STRING, 7);
     xfer += proto->serializedSizeBinary(obj->comment);
   }
+  if (obj->pageToken != nullptr) {
+    xfer += proto->serializedFieldSize("page_token", apache::thrift::protocol::T_I64, 8);
+    xfer += ::apache::thrift::detail::pm::
+        protocol_methods<::apache::thrift::type_class::integral, int64_t>::serializedSize<false>(
+            *proto, *obj->pageToken);
+  }
   xfer += proto->serializedSizeStop();
   return xfer;
 }
@@ -339,6 +371,12 @@ uint32_t Cpp2Ops<::nebula::ExecutionResponse>::serializedSizeZC(
     xfer += proto->serializedFieldSize("comment", apache::thrift::protocol::T_STRING, 7);
     xfer += proto->serializedSizeZCBinary(*obj->comment);
   }
+  if (obj->pageToken != nullptr) {
+    xfer += proto->serializedFieldSize("page_token", apache::thrift::protocol::T_I64, 8);
+    xfer += ::apache::thrift::detail::pm::
+        protocol_methods<::apache::thrift::type_class::integral, int64_t>::serializedSize<false>(
+            *proto, *obj->pageToken);
+  }
   xfer += proto->serializedSizeStop();
   return xfer;
 }
@@ -483,6 +483,7 @@ struct ExecutionResponse {
     errorMsg.reset();
     planDesc.reset();
     comment.reset();
+    pageToken.reset();
   }
 
   void clear() {
@@ -511,6 +512,9 @@ struct ExecutionResponse {
     if (!checkPointer(comment.get(), rhs.comment.get())) {
       return false;
     }
+    if (!checkPointer(pageToken.get(), rhs.pageToken.get())) {
+      return false;
+    }
     return true;
   }
 
@@ -521,6 +525,8 @@ struct ExecutionResponse {
   std::unique_ptr<std::string> errorMsg{nullptr};
   std::unique_ptr<PlanDescription> planDesc{nullptr};
   std::unique_ptr<std::string> comment{nullptr};
+  // Set when the result has more pages, which are fetched with it
+  std::unique_ptr<int64_t> pageToken{nullptr};
 
   // Returns the response as a JSON string
   // only errorCode and latencyInUs are required fields, the rest are optional
@@ -610,6 +616,9 @@ struct ExecutionResponse {
     if (comment) {
       resultBody.insert("comment", *comment);
     }
+    if (pageToken) {
+      resultBody.insert("pageToken", *pageToken);
+    }
 
     auto resultArray = folly::dynamic::array();
     resultArray.push_back(resultBody);
@@ -6,6 +6,8 @@
 #ifndef COMMON_UTILS_LOGITERATOR_H_
 #define COMMON_UTILS_LOGITERATOR_H_
 
+#include <folly/io/IOBuf.h>
+
 #include "common/base/Base.h"
 #include "common/thrift/ThriftTypes.h"
 
@@ -26,6 +28,13 @@ class LogIterator {
   virtual TermID logTerm() const = 0;
   virtual ClusterID logSource() const = 0;
   virtual folly::StringPiece logMsg() const = 0;
+
+  // The log message as a buffer. The iterators keeping the messages in refcounted buffers share
+  // them without copying, the others copy the message.
+  virtual folly::IOBuf logBuf() const {
+    auto msg = logMsg();
+    return folly::IOBuf(folly::IOBuf::COPY_BUFFER, msg.data(), msg.size());
+  }
 };
 
 }  // namespace nebula
@@ -6,16 +6,33 @@
 #ifndef COMMON_UTILS_MEMORYLOCKCORE_H
 #define COMMON_UTILS_MEMORYLOCKCORE_H
 
-#include <folly/concurrency/ConcurrentHashMap.h>
+#include <folly/hash/Hash.h>
+#include <folly/lang/Aligned.h>
+
+#include <condition_variable>
 
 #include "common/base/Base.h"
+#include "common/stats/StatsManager.h"
 
 namespace nebula {
 
-template <typename Key>
+// The keys are spread over the shards of a lock table, each shard has its own mutex and lives in
+// its own cache lines, so the mutations of different keys rarely touch the same lock.
+//
+// A batch is acquired shard by shard in the order of the shards, all keys of a shard at once. So
+// when a conflict is waited for (see the waitTimeout), a batch only waits while holding keys of
+// the shards before the one it waits in, and the batches waiting for each other can't deadlock.
+template <typename Key, typename Hash = std::hash<Key>>
 class MemoryLockCore {
  public:
-  MemoryLockCore() = default;
+  /**
+   * @param waitTimeout How long to wait for the keys held by the others, a conflict fails at once
+   * if it's zero
+   * @param conflicts The counter of the lock attempts which meet a key held by the others
+   */
+  explicit MemoryLockCore(std::chrono::milliseconds waitTimeout = std::chrono::milliseconds(0),
+                          stats::CounterId conflicts = stats::CounterId())
+      : waitTimeout_(waitTimeout), conflicts_(std::move(conflicts)) {}
 
   ~MemoryLockCore() = default;
 
@@ -28,24 +45,50 @@ class MemoryLockCore {
   }
 
   bool try_lock(const Key& key) {
-    return hashMap_.insert(std::make_pair(key, 0)).second;
+    std::vector<const Key*> keys{&key};
+    return lockInShard(shardOf(key), keys, 0, 1, deadline()) == kNoConflict;
   }
 
   void unlock(const Key& key) {
-    hashMap_.erase(key);
+    auto& shard = *shards_[shardOf(key)];
+    std::lock_guard<std::mutex> guard(shard.lock);
+    shard.keys.erase(key);
+    if (shard.numWaiters > 0) {
+      shard.cv.notify_all();
+    }
   }
 
   template <class Iter>
   std::pair<Iter, bool> lockBatch(Iter begin, Iter end) {
-    Iter curr = begin;
-    bool inserted = false;
-    while (curr != end) {
-      std::tie(std::ignore, inserted) = hashMap_.insert(std::make_pair(*curr, 0));
-      if (!inserted) {
-        unlockBatch(begin, curr);
-        return std::make_pair(curr, false);
+    std::vector<std::pair<size_t, Iter>> sorted;
+    for (auto it = begin; it != end; ++it) {
+      sorted.emplace_back(shardOf(*it), it);
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+      return a.first < b.first;
+    });
+    std::vector<const Key*> keys;
+    keys.reserve(sorted.size());
+    for (const auto& s : sorted) {
+      keys.emplace_back(&*s.second);
+    }
+
+    auto until = deadline();
+    size_t i = 0;
+    while (i < keys.size()) {
+      auto shardIdx = sorted[i].first;
+      size_t j = i + 1;
+      while (j < keys.size() && sorted[j].first == shardIdx) {
+        ++j;
       }
-      ++curr;
+      auto conflict = lockInShard(shardIdx, keys, i, j, until);
+      if (conflict != kNoConflict) {
+        for (size_t k = 0; k < i; ++k) {
+          unlock(*keys[k]);
+        }
+        return std::make_pair(sorted[conflict].second, false);
+      }
+      i = j;
     }
     return std::make_pair(end, true);
   }
@@ -58,7 +101,7 @@ class MemoryLockCore {
   template <class Iter>
   void unlockBatch(Iter begin, Iter end) {
     for (; begin != end; ++begin) {
-      hashMap_.erase(*begin);
+      unlock(*begin);
     }
   }
 
@@ -68,19 +111,91 @@ class MemoryLockCore {
   }
 
   void clear() {
-    hashMap_.clear();
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> guard(shard->lock);
+      shard->keys.clear();
+      shard->cv.notify_all();
+    }
   }
 
   size_t size() {
-    return hashMap_.size();
+    size_t size = 0;
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> guard(shard->lock);
+      size += shard->keys.size();
+    }
+    return size;
   }
 
   bool contains(const Key& key) {
-    return hashMap_.find(key) == hashMap_.end();
+    auto& shard = *shards_[shardOf(key)];
+    std::lock_guard<std::mutex> guard(shard.lock);
+    return shard.keys.find(key) == shard.keys.end();
   }
 
  protected:
-  folly::ConcurrentHashMap<Key, int> hashMap_;
+  static constexpr size_t kShardBits = 6;
+  static constexpr size_t kNumShards = 1 << kShardBits;
+  static constexpr size_t kNoConflict = std::numeric_limits<size_t>::max();
+
+  struct Shard {
+    std::mutex lock;
+    std::condition_variable cv;
+    std::unordered_set<Key, Hash> keys;
+    size_t numWaiters{0};
+  };
+
+  static size_t shardOf(const Key& key) {
+    return folly::hash::twang_mix64(Hash()(key)) >> (64 - kShardBits);
+  }
+
+  std::chrono::steady_clock::time_point deadline() const {
+    return std::chrono::steady_clock::now() + waitTimeout_;
+  }
+
+  // Lock keys[begin, end) of the shard all together, return the index of a key held by the others
+  // if failed, or kNoConflict
+  size_t lockInShard(size_t shardIdx,
+                     const std::vector<const Key*>& keys,
+                     size_t begin,
+                     size_t end,
+                     std::chrono::steady_clock::time_point until) {
+    auto& shard = *shards_[shardIdx];
+    std::unique_lock<std::mutex> guard(shard.lock);
+    bool counted = false;
+    while (true) {
+      size_t curr = begin;
+      while (curr < end && shard.keys.insert(*keys[curr]).second) {
+        ++curr;
+      }
+      if (curr == end) {
+        return kNoConflict;
+      }
+      for (size_t k = begin; k < curr; ++k) {
+        shard.keys.erase(*keys[k]);
+      }
+      if (!counted) {
+        counted = true;
+        if (conflicts_.valid()) {
+          stats::StatsManager::addValue(conflicts_);
+        }
+      }
+      // A key duplicated in the batch conflicts with itself, never wait for it
+      bool duplicated = std::any_of(keys.begin() + begin,
+                                    keys.begin() + curr,
+                                    [&](const Key* key) { return *key == *keys[curr]; });
+      if (duplicated || waitTimeout_.count() <= 0 || std::chrono::steady_clock::now() >= until) {
+        return curr;
+      }
+      shard.numWaiters++;
+      shard.cv.wait_until(guard, until);
+      shard.numWaiters--;
+    }
+  }
+
+  const std::chrono::milliseconds waitTimeout_;
+  const stats::CounterId conflicts_;
+  std::array<folly::cacheline_aligned<Shard>, kNumShards> shards_;
 };
 
 }  // namespace nebula
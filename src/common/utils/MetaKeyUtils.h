@@ -72,6 +72,16 @@ class MetaKeyUtils final {
 
   static std::string lastUpdateTimeVal(const int64_t timeInMilliSec);
 
+  static int64_t parseLastUpdateTimeVal(folly::StringPiece rawVal);
+
+  // The last update time of the schemas, indexes and listeners of a space, which the clients use
+  // to reload the changed spaces only. The value is encoded as lastUpdateTimeVal.
+  static std::string spaceLastUpdateTimeKey(GraphSpaceID spaceId);
+
+  static const std::string& spaceLastUpdateTimePrefix();
+
+  static GraphSpaceID parseSpaceLastUpdateTimeSpace(folly::StringPiece rawKey);
+
   static std::string spaceKey(GraphSpaceID spaceId);
 
   static std::string spaceVal(const meta::cpp2::SpaceDesc& spaceDesc);
@@ -39,6 +39,16 @@ void ExecutionContext::dropResult(const std::string& name) {
   }
 }
 
+void ExecutionContext::reset() {
+  folly::RWSpinLock::WriteHolder holder(lock_);
+  for (auto& kv : valueMap_) {
+    if (FLAGS_enable_async_gc) {
+      GC::instance().clear(std::move(kv.second));
+    }
+    kv.second.clear();
+  }
+}
+
 size_t ExecutionContext::numVersions(const std::string& name) const {
   folly::RWSpinLock::ReadHolder holder(lock_);
   auto it = valueMap_.find(name);
@@ -66,6 +66,10 @@ class ExecutionContext {
 
   void dropResult(const std::string& name);
 
+  // Drop the values of all variables but keep them declared, which is used to execute a cached
+  // plan again
+  void reset();
+
   // Only keep the last several versions of the Value
   void truncHistory(const std::string& name, size_t numVersionsToKeep);
 
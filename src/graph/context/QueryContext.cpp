@@ -5,9 +5,38 @@
 
 #include "graph/context/QueryContext.h"
 
+#include "graph/service/GraphFlags.h"
+
 namespace nebula {
 namespace graph {
 
+namespace {
+
+// Run the tasks on the runner with the arena bound
+class ArenaRunner final : public folly::Executor {
+ public:
+  ArenaRunner(folly::Executor* runner, std::shared_ptr<ValueArena> arena)
+      : runner_(runner), arena_(std::move(arena)) {}
+
+  void add(folly::Func func) override {
+    // The task may run after the query context is released, e.g. an uncompleted async sub-task
+    runner_->add([arena = arena_, f = std::move(func)]() mutable {
+      ValueArena::Scope scope(arena.get());
+      f();
+    });
+  }
+
+  uint8_t getNumPriorities() const override {
+    return runner_->getNumPriorities();
+  }
+
+ private:
+  folly::Executor* runner_;
+  std::shared_ptr<ValueArena> arena_;
+};
+
+}  // namespace
+
 QueryContext::QueryContext(RequestContextPtr rctx,
                            meta::SchemaManager* sm,
                            meta::IndexManager* im,
@@ -29,17 +58,78 @@ QueryContext::QueryContext() {
 
 void QueryContext::init() {
   objPool_ = std::make_unique<ObjectPool>();
+  execPool_ = std::make_unique<ObjectPool>();
+  initValueArena();
   ep_ = std::make_unique<ExecutionPlan>();
   ectx_ = std::make_unique<ExecutionContext>();
+  initParameters();
+  idGen_ = std::make_unique<IdGenerator>(0);
+  symTable_ = std::make_unique<SymbolTable>(objPool_.get(), ectx_.get());
+  vctx_ = std::make_unique<ValidateContext>(std::make_unique<AnonVarGenerator>(symTable_.get()));
+}
+
+void QueryContext::initValueArena() {
+  if (FLAGS_enable_value_arena) {
+    valueArena_ = std::make_shared<ValueArena>();
+  } else {
+    valueArena_.reset();
+  }
+  initRunner();
+}
+
+void QueryContext::initRunner() {
+  if (valueArena_ != nullptr && rctx_ != nullptr && rctx_->runner() != nullptr) {
+    arenaRunner_ = std::make_unique<ArenaRunner>(rctx_->runner(), valueArena_);
+  } else {
+    arenaRunner_.reset();
+  }
+}
+
+void QueryContext::initParameters() {
   // copy parameterMap into ExecutionContext
   if (rctx_) {
     for (auto item : rctx_->parameterMap()) {
       ectx_->setValue(std::move(item.first), std::move(item.second));
     }
   }
-  idGen_ = std::make_unique<IdGenerator>(0);
-  symTable_ = std::make_unique<SymbolTable>(objPool_.get(), ectx_.get());
-  vctx_ = std::make_unique<ValidateContext>(std::make_unique<AnonVarGenerator>(symTable_.get()));
+}
+
+void QueryContext::reuse(RequestContextPtr rctx) {
+  rctx_ = std::move(rctx);
+  killed_.store(false);
+  execPool_ = std::make_unique<ObjectPool>();
+  initValueArena();
+  symTable_->resetUserCount();
+  ectx_->reset();
+  initParameters();
+}
+
+void QueryContext::releaseExecution() {
+  // The results may be allocated from the arena, so they're released ahead of it
+  ectx_->reset();
+  execPool_ = std::make_unique<ObjectPool>();
+  rctx_.reset();
+  arenaRunner_.reset();
+  valueArena_.reset();
+}
+
+Expression* QueryContext::acquireClone(const Expression* expr) {
+  {
+    std::lock_guard<std::mutex> guard(clonesLock_);
+    auto find = freeClones_.find(expr);
+    if (find != freeClones_.end() && !find->second.empty()) {
+      auto* clone = find->second.back();
+      find->second.pop_back();
+      return clone;
+    }
+  }
+  // There are at most as many clones of an expression as the jobs evaluating it concurrently
+  return expr->clone();
+}
+
+void QueryContext::releaseClone(const Expression* expr, Expression* clone) {
+  std::lock_guard<std::mutex> guard(clonesLock_);
+  freeClones_[expr].emplace_back(clone);
 }
 
 }  // namespace graph
@@ -6,12 +6,16 @@
 #ifndef GRAPH_CONTEXT_QUERYCONTEXT_H_
 #define GRAPH_CONTEXT_QUERYCONTEXT_H_
 
+#include <mutex>
+
 #include "clients/meta/MetaClient.h"
 #include "clients/storage/StorageClient.h"
 #include "common/base/ObjectPool.h"
 #include "common/charset/Charset.h"
 #include "common/cpp/helpers.h"
 #include "common/datatypes/Value.h"
+#include "common/datatypes/ValueArena.h"
+#include "common/expression/Expression.h"
 #include "common/meta/IndexManager.h"
 #include "common/meta/SchemaManager.h"
 #include "graph/context/ExecutionContext.h"
@@ -53,8 +57,17 @@ class QueryContext {
 
   void setRCtx(RequestContextPtr rctx) {
     rctx_ = std::move(rctx);
+    initRunner();
   }
 
+  // Prepare the context of a cached plan to be executed again for the request, the executors and
+  // the results of the last execution are released and the parameters are replaced.
+  void reuse(RequestContextPtr rctx);
+
+  // Release what the last execution holds before the context is cached, i.e. the request, the
+  // executors, the results including the values of the parameters, and the value arena.
+  void releaseExecution();
+
   void setSchemaManager(meta::SchemaManager* sm) {
     sm_ = sm;
   }
@@ -115,6 +128,25 @@ class QueryContext {
     return objPool_.get();
   }
 
+  ObjectPool* execPool() const {
+    return execPool_.get();
+  }
+
+  // The arena of the values built by the executors, nullptr if disabled
+  ValueArena* valueArena() const {
+    return valueArena_.get();
+  }
+
+  // The runner of the executors, which binds the value arena to the tasks it runs, so the async
+  // continuations of the executors allocate from the arena too, e.g. the gathering of the jobs
+  // and the handling of the storage responses. nullptr if the request has no runner.
+  folly::Executor* runner() const {
+    if (arenaRunner_ != nullptr) {
+      return arenaRunner_.get();
+    }
+    return rctx_ != nullptr ? rctx_->runner() : nullptr;
+  }
+
   int64_t genId() const {
     return idGen_->id();
   }
@@ -142,9 +174,34 @@ class QueryContext {
     return !ectx_->getValue(param).empty();  // Really fill value for parameter
   }
 
+  // Mark that the values of the parameters are folded into the plan in building stage, e.g. they
+  // are rewritten to constants, so the plan is only valid for the same values. The types of the
+  // parameters are not concerned, which are a part of the key of the cached plans.
+  void markParameterUsed() const {
+    parameterUsed_.store(true, std::memory_order_relaxed);
+  }
+
+  bool parameterUsed() const {
+    return parameterUsed_.load(std::memory_order_relaxed);
+  }
+
+  // Take a clone of the expression to evaluate exclusively, the expressions cache the props
+  // resolved in evaluating so the concurrent jobs don't share them. The clone is put back by
+  // releaseClone() and reused by the later jobs and executions, or the object pool kept along
+  // with a cached plan would grow with every execution. It's thread safe.
+  Expression* acquireClone(const Expression* expr);
+
+  void releaseClone(const Expression* expr, Expression* clone);
+
  private:
   void init();
 
+  void initParameters();
+
+  void initValueArena();
+
+  void initRunner();
+
   RequestContextPtr rctx_;
   std::unique_ptr<ValidateContext> vctx_;
   std::unique_ptr<ExecutionContext> ectx_;
@@ -156,12 +213,60 @@ class QueryContext {
   CharsetInfo* charsetInfo_{nullptr};
 
   // The Object Pool holds all internal generated objects.
-  // e.g. expressions, plan nodes, executors
+  // e.g. expressions, plan nodes
   std::unique_ptr<ObjectPool> objPool_;
+  // The objects of one execution of the plan, e.g. executors
+  std::unique_ptr<ObjectPool> execPool_;
+  // The values of one execution of the plan, which may outlive the arena. It's shared with the
+  // tasks of arenaRunner_, so it lives until the last async task of the query is done.
+  std::shared_ptr<ValueArena> valueArena_;
+  // The runner of the request binding valueArena_, nullptr if either is absent
+  std::unique_ptr<folly::Executor> arenaRunner_;
   std::unique_ptr<IdGenerator> idGen_;
   std::unique_ptr<SymbolTable> symTable_;
 
   std::atomic<bool> killed_{false};
+  mutable std::atomic<bool> parameterUsed_{false};
+
+  std::mutex clonesLock_;
+  // The clones not taken of each expression, which live in the object pool
+  std::unordered_map<const Expression*, std::vector<Expression*>> freeClones_;
+};
+
+// The clone of an expression taken from the query context, which is put back when it's out of
+// scope. It's empty if the expression is nullptr.
+class ExprClone final {
+ public:
+  ExprClone(QueryContext* qctx, const Expression* expr)
+      : qctx_(qctx), expr_(expr), clone_(expr == nullptr ? nullptr : qctx->acquireClone(expr)) {}
+
+  ExprClone(ExprClone&& other) noexcept
+      : qctx_(other.qctx_), expr_(other.expr_), clone_(other.clone_) {
+    other.clone_ = nullptr;
+  }
+
+  ExprClone(const ExprClone&) = delete;
+  ExprClone& operator=(const ExprClone&) = delete;
+  ExprClone& operator=(ExprClone&&) = delete;
+
+  ~ExprClone() {
+    if (clone_ != nullptr) {
+      qctx_->releaseClone(expr_, clone_);
+    }
+  }
+
+  Expression* get() const {
+    return clone_;
+  }
+
+  Expression* operator->() const {
+    return clone_;
+  }
+
+ private:
+  QueryContext* qctx_;
+  const Expression* expr_;
+  Expression* clone_;
 };
 
 }  // namespace graph
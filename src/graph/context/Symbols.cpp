@@ -125,5 +125,12 @@ Variable* SymbolTable::getVar(const std::string& varName) {
   }
 }
 
+void SymbolTable::resetUserCount() {
+  folly::RWSpinLock::ReadHolder holder(lock_);
+  for (auto& kv : vars_) {
+    kv.second->userCount.store(0, std::memory_order_relaxed);
+  }
+}
+
 }  // namespace graph
 }  // namespace nebula
@@ -75,6 +75,9 @@ class SymbolTable final {
 
   Variable* getVar(const std::string& varName);
 
+  // Clear the user count of all variables, which is analyzed again for each execution of the plan
+  void resetUserCount();
+
   std::string toString() const;
 
  private:
@@ -48,6 +48,22 @@ TEST(ExecutionContext, HistoryTest) {
   EXPECT_TRUE(it2 == hist2.end());
 }
 
+TEST(ExecutionContext, ResetTest) {
+  ExecutionContext ctx;
+  ctx.initVar("v1");
+  ctx.setValue("v2", 10);
+  ctx.setValue("v2", 20);
+  ctx.reset();
+  EXPECT_TRUE(ctx.exist("v1"));
+  EXPECT_TRUE(ctx.exist("v2"));
+  EXPECT_EQ(0, ctx.numVersions("v2"));
+  EXPECT_TRUE(ctx.getValue("v2").empty());
+
+  ctx.setValue("v2", 30);
+  ASSERT_EQ(1, ctx.numVersions("v2"));
+  EXPECT_EQ(Value(30), ctx.getValue("v2"));
+}
+
 TEST(ExecutionContextTest, TestResult) {
   DataSet ds;
   auto expected =
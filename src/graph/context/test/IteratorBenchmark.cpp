@@ -5,6 +5,7 @@
 
 #include <folly/Benchmark.h>
 
+#include "common/datatypes/ValueArena.h"
 #include "graph/context/Iterator.h"
 
 // 40 edges
@@ -151,6 +152,27 @@ size_t getEdge(size_t iters) {
   return iters * ops;
 }
 
+// Collect all the edges as the executors expanding the neighbors, with the values allocated from an
+// arena or not
+size_t getAllEdges(size_t iters, bool inArena) {
+  constexpr size_t ops = 100UL;
+  std::unique_ptr<ValueArena> arena;
+  if (inArena) {
+    arena = std::make_unique<ValueArena>();
+  }
+  ValueArena::Scope scope(arena.get());
+  for (size_t i = 0; i < iters * ops; ++i) {
+    GetNeighborsIter iter(gDataSets2);
+    std::vector<Value> edges;
+    edges.reserve(iter.size());
+    for (; iter.valid(); iter.next()) {
+      edges.emplace_back(iter.getEdge());
+    }
+    folly::doNotOptimizeAway(edges);
+  }
+  return iters * ops;
+}
+
 BENCHMARK_NAMED_PARAM_MULTI(getNeighborsIterCtor, get_neighbors_ctor_40_edges, gDataSets1)
 BENCHMARK_NAMED_PARAM_MULTI(getNeighborsIterCtor, get_neighbors_ctor_4000_edges, gDataSets2)
 BENCHMARK_NAMED_PARAM_MULTI(getColumnForGetNeighborsIter, get_column_1)
@@ -159,6 +181,9 @@ BENCHMARK_NAMED_PARAM_MULTI(getEdgeProp, get_edge_prop)
 BENCHMARK_NAMED_PARAM_MULTI(getVertex, get_vertex)
 BENCHMARK_NAMED_PARAM_MULTI(getEdge, get_edge)
 BENCHMARK_NAMED_PARAM_MULTI(getTagProps, get_tag_4000)
+BENCHMARK_DRAW_LINE();
+BENCHMARK_NAMED_PARAM_MULTI(getAllEdges, get_all_edges_4000, false)
+BENCHMARK_RELATIVE_NAMED_PARAM_MULTI(getAllEdges, get_all_edges_4000_in_arena, true)
 }  // namespace graph
 }  // namespace nebula
 
@@ -0,0 +1,86 @@
+/* Copyright (c) 2023 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <folly/executors/ManualExecutor.h>
+#include <gtest/gtest.h>
+
+#include "common/base/Base.h"
+#include "common/expression/ConstantExpression.h"
+#include "graph/context/QueryContext.h"
+#include "graph/context/QueryExpressionContext.h"
+#include "graph/service/GraphFlags.h"
+
+namespace nebula {
+namespace graph {
+
+TEST(QueryContext, ReuseClones) {
+  QueryContext qctx;
+  auto* expr = ConstantExpression::make(qctx.objPool(), 1);
+  Expression* first = nullptr;
+  Expression* second = nullptr;
+  {
+    ExprClone clone1(&qctx, expr);
+    ExprClone clone2(&qctx, expr);
+    first = clone1.get();
+    second = clone2.get();
+    EXPECT_NE(expr, first);
+    EXPECT_NE(first, second);
+    EXPECT_EQ(*expr, *first);
+  }
+  // The clones put back are taken again instead of cloning more
+  {
+    ExprClone clone1(&qctx, expr);
+    ExprClone clone2(&qctx, expr);
+    EXPECT_TRUE(clone1.get() == first || clone1.get() == second);
+    EXPECT_TRUE(clone2.get() == first || clone2.get() == second);
+    EXPECT_NE(clone1.get(), clone2.get());
+  }
+  ExprClone empty(&qctx, nullptr);
+  EXPECT_EQ(nullptr, empty.get());
+}
+
+TEST(QueryContext, ReleaseExecution) {
+  QueryContext qctx;
+  qctx.symTable()->newVariable("var");
+  qctx.ectx()->setResult("var", ResultBuilder().value(Value(1)).build());
+  auto* expr = ConstantExpression::make(qctx.objPool(), 1);
+  qctx.execPool()->makeAndAdd<int>(1);
+
+  // Such as the context is put into the plan cache
+  qctx.releaseExecution();
+  EXPECT_EQ(nullptr, qctx.rctx());
+  EXPECT_EQ(nullptr, qctx.valueArena());
+  EXPECT_EQ(nullptr, qctx.runner());
+  EXPECT_TRUE(qctx.ectx()->getValue("var").empty());
+  // The plan is kept
+  EXPECT_EQ(Value(1), expr->eval(QueryExpressionContext(qctx.ectx())()));
+}
+
+TEST(QueryContext, ArenaOutlivesContext) {
+  FLAGS_enable_value_arena = true;
+  folly::ManualExecutor runner;
+  auto qctx = std::make_unique<QueryContext>();
+  auto rctx = std::make_unique<RequestContext<ExecutionResponse>>();
+  rctx->setRunner(&runner);
+  qctx->setRCtx(std::move(rctx));
+  ASSERT_NE(nullptr, qctx->valueArena());
+
+  // An uncompleted async task of the query runs after the context is released
+  Value value;
+  ValueArena* arena = nullptr;
+  qctx->runner()->add([&]() {
+    arena = ValueArena::current();
+    value = List({1, "str"});
+  });
+  qctx.reset();
+  runner.drain();
+  EXPECT_NE(nullptr, arena);
+  EXPECT_EQ(nullptr, ValueArena::current());
+  EXPECT_EQ(Value(List({1, "str"})), value);
+  FLAGS_enable_value_arena = false;
+}
+
+}  // namespace graph
+}  // namespace nebula
@@ -156,7 +156,7 @@ Executor *Executor::makeExecutor(const PlanNode *node,
 
 // static
 Executor *Executor::makeExecutor(QueryContext *qctx, const PlanNode *node) {
-  auto pool = qctx->objPool();
+  auto pool = qctx->execPool();
   auto &spaceName = qctx->rctx() ? qctx->rctx()->session()->spaceName() : "";
   switch (node->kind()) {
     case PlanNode::Kind::kPassThrough: {
@@ -757,20 +757,27 @@ Status Executor::finish(Value &&value) {
 }
 
 folly::Executor *Executor::runner() const {
-  if (!qctx() || !qctx()->rctx() || !qctx()->rctx()->runner()) {
+  if (!qctx() || !qctx()->runner()) {
     // This is just for test
     return &folly::InlineExecutor::instance();
   }
-  return qctx()->rctx()->runner();
+  return qctx()->runner();
 }
 
 size_t Executor::getBatchSize(size_t totalSize) const {
-  // batch size should be the greater one of FLAGS_min_batch_size and (totalSize/FLAGS_max_job_size)
-  size_t jobSize = FLAGS_max_job_size;
-  size_t minBatchSize = FLAGS_min_batch_size;
-  size_t batchSizeTmp = std::ceil(static_cast<float>(totalSize) / jobSize);
-  size_t batchSize = batchSizeTmp > minBatchSize ? batchSizeTmp : minBatchSize;
-  return batchSize;
+  // Split the rows into several morsels for each job, so the jobs could balance the load by
+  // claiming the morsels dynamically. The morsel size should be no less than FLAGS_min_batch_size.
+  static constexpr size_t kMorselsPerJob = 4;
+  size_t jobSize = std::max(FLAGS_max_job_size, 1);
+  size_t minBatchSize = std::max(FLAGS_min_batch_size, 1);
+  size_t batchSize = (totalSize + jobSize * kMorselsPerJob - 1) / (jobSize * kMorselsPerJob);
+  return std::max(batchSize, minBatchSize);
+}
+
+size_t Executor::getNumJobs(size_t totalSize) const {
+  size_t batchSize = getBatchSize(totalSize);
+  size_t numMorsels = (totalSize + batchSize - 1) / batchSize;
+  return std::min<size_t>(numMorsels, std::max(FLAGS_max_job_size, 1));
 }
 
 }  // namespace graph
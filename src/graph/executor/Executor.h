@@ -113,11 +113,21 @@ class Executor : private boost::noncopyable, private cpp::NonMovable {
   // Store the default result which not used for later executor
   Status finish(Value &&value);
 
+  // The rows of a morsel, which is the unit of work dispatched to the jobs
   size_t getBatchSize(size_t totalSize) const;
 
+  // The number of the concurrent jobs to handle the rows
+  size_t getNumJobs(size_t totalSize) const;
+
   // ScatterFunc: A callback function that handle partial records of a dataset.
   // GatherFunc: A callback function that gather all results of ScatterFunc, and do post works.
   // Iterator: An iterator of a dataset.
+  //
+  // The dataset is split into morsels of `getBatchSize()` rows, which are claimed in order by
+  // `getNumJobs()` jobs, so the jobs finishing early take over the rest morsels of the slow ones.
+  // Each job is rescheduled on the runner after a morsel, so the jobs of the other queries queued
+  // in the meantime are not starved by a heavy query. ScatterFunc is called once for each morsel,
+  // and the results passed to GatherFunc are in the order of the morsels.
   template <
       class ScatterFunc,
       class ScatterResult = typename std::result_of<ScatterFunc(size_t, size_t, Iterator *)>::type,
@@ -163,6 +173,25 @@ class Executor : private boost::noncopyable, private cpp::NonMovable {
   time::Duration totalDuration_;
 
  private:
+  template <class ScatterResult>
+  struct Morsels {
+    Morsels(size_t total, size_t size)
+        : totalSize(total), morselSize(size), results((total + size - 1) / size) {}
+
+    const size_t totalSize;
+    const size_t morselSize;
+    // The next morsel to claim
+    std::atomic<size_t> next{0};
+    std::vector<folly::Try<ScatterResult>> results;
+  };
+
+  // Handle the morsels one by one until all of them are claimed, `iter` is at the row `pos`
+  template <class ScatterFunc, class ScatterResult>
+  folly::Future<folly::Unit> runMorsels(std::shared_ptr<Morsels<ScatterResult>> morsels,
+                                        std::unique_ptr<Iterator> iter,
+                                        size_t pos,
+                                        ScatterFunc scatter);
+
   std::mutex statsLock_;
   std::unordered_map<std::string, std::string> otherStats_;
 };
@@ -170,33 +199,59 @@ class Executor : private boost::noncopyable, private cpp::NonMovable {
 template <class ScatterFunc, class ScatterResult, class GatherFunc>
 auto Executor::runMultiJobs(ScatterFunc &&scatter, GatherFunc &&gather, Iterator *iter) {
   size_t totalSize = iter->size();
-  size_t batchSize = getBatchSize(totalSize);
-
-  // Start multiple jobs for handling the results
-  std::vector<folly::Future<ScatterResult>> futures;
-  size_t begin = 0, end = 0, dispathedCnt = 0;
-  while (dispathedCnt < totalSize) {
-    end = begin + batchSize > totalSize ? totalSize : begin + batchSize;
-    futures.emplace_back(folly::via(
-        runner(),
-        [begin, end, tmpIter = iter->copy(), f = std::move(scatter)]() mutable -> ScatterResult {
-          // MemoryTrackerVerified
-          memory::MemoryCheckGuard guard;
-          // Since not all iterators are linear, so iterates to the begin pos
-          size_t tmp = 0;
-          for (; tmpIter->valid() && tmp < begin; ++tmp) {
-            tmpIter->next();
-          }
-
-          return f(begin, end, tmpIter.get());
+  auto morsels = std::make_shared<Morsels<ScatterResult>>(totalSize, getBatchSize(totalSize));
+
+  // Start multiple jobs for handling the morsels
+  size_t numJobs = getNumJobs(totalSize);
+  std::vector<folly::Future<folly::Unit>> futures;
+  futures.reserve(numJobs);
+  for (size_t i = 0; i < numJobs; ++i) {
+    futures.emplace_back(
+        folly::via(runner(), [this, morsels, tmpIter = iter->copy(), f = scatter]() mutable {
+          return runMorsels<std::decay_t<ScatterFunc>, ScatterResult>(
+              std::move(morsels), std::move(tmpIter), 0, std::move(f));
         }));
-    begin = end;
-    dispathedCnt += batchSize;
   }
 
   // Gather all results and do post works
-  return folly::collectAll(futures).via(runner()).thenValue(std::move(gather));
+  return folly::collectAll(futures).via(runner()).thenValue(
+      [morsels, f = std::forward<GatherFunc>(gather)](auto &&) mutable {
+        return f(std::move(morsels->results));
+      });
+}
+
+template <class ScatterFunc, class ScatterResult>
+folly::Future<folly::Unit> Executor::runMorsels(std::shared_ptr<Morsels<ScatterResult>> morsels,
+                                                std::unique_ptr<Iterator> iter,
+                                                size_t pos,
+                                                ScatterFunc scatter) {
+  auto morsel = morsels->next.fetch_add(1, std::memory_order_relaxed);
+  if (morsel >= morsels->results.size()) {
+    return folly::makeFuture();
+  }
+  size_t begin = morsel * morsels->morselSize;
+  size_t end = std::min(begin + morsels->morselSize, morsels->totalSize);
+  morsels->results[morsel] = folly::makeTryWith([&] {
+    // MemoryTrackerVerified
+    memory::MemoryCheckGuard guard;
+    // Bound for each morsel, the job is rescheduled to any thread of the runner after a morsel
+    ValueArena::Scope arenaScope(qctx_->valueArena());
+    // Since not all iterators are linear, so iterates to the begin pos. The morsels are claimed
+    // in order, so the iterator of a job only moves forward.
+    for (; iter->valid() && pos < begin; ++pos) {
+      iter->next();
+    }
+    auto tmpIter = iter->copy();
+    return scatter(begin, end, tmpIter.get());
+  });
+
+  // Reschedule the job for the next morsel
+  auto job = [this, morsels, it = std::move(iter), pos, f = std::move(scatter)]() mutable {
+    return runMorsels<ScatterFunc, ScatterResult>(morsels, std::move(it), pos, std::move(f));
+  };
+  return folly::via(runner(), std::move(job));
 }
+
 }  // namespace graph
 }  // namespace nebula
 
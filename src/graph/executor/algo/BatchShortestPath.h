@@ -10,6 +10,9 @@
 namespace nebula {
 namespace graph {
 
+// Find the shortest paths of many pairs of start and end vids, which are split into a few batches
+// each expanding both sides in one step. Unlike SingleShortestPath, the side to expand can't be
+// chosen by the frontier of a pair, since the pairs in a batch share the requests of both sides.
 class BatchShortestPath final : public ShortestPathBase {
  public:
   BatchShortestPath(const ShortestPath* node,
@@ -37,7 +37,7 @@ folly::Future<std::vector<Value>> ShortestPathBase::getMeetVidsProps(
                  {},
                  -1,
                  nullptr)
-      .via(qctx_->rctx()->runner())
+      .via(runner())
       .thenValue([this, getPropsTime](PropRpcResponse&& resp) {
         memory::MemoryCheckGuard guard;
         addStats(resp, getPropsTime.elapsedInUSec());
@@ -219,10 +219,10 @@ void ShortestPathBase::addStats(PropRpcResponse& resp, int64_t timeInUSec) const
 }
 
 folly::Executor* ShortestPathBase::runner() const {
-  if (!qctx_ || !qctx_->rctx() || !qctx_->rctx()->runner()) {
+  if (!qctx_ || !qctx_->runner()) {
     return &folly::InlineExecutor::instance();
   }
-  return qctx_->rctx()->runner();
+  return qctx_->runner();
 }
 
 }  // namespace graph
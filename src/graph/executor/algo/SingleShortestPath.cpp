@@ -48,54 +48,76 @@ folly::Future<Status> SingleShortestPath::execute(const HashSet& startVids,
       });
 }
 
-void SingleShortestPath::init(const HashSet& startVids, const HashSet& endVids, size_t rowSize) {
-  leftVids_.reserve(rowSize);
-  rightVids_.reserve(rowSize);
-
-  leftVisitedVids_.resize(rowSize);
-  rightVisitedVids_.resize(rowSize);
+uint32_t SingleShortestPath::PathState::encode(const Value& vid) {
+  auto find = ids.find(vid);
+  if (find != ids.end()) {
+    return find->second;
+  }
+  auto id = static_cast<uint32_t>(vids.size());
+  ids.emplace(vid, id);
+  vids.emplace_back(vid);
+  vertices.emplace_back();
+  left.visited.emplace_back(false);
+  left.parents.emplace_back();
+  right.visited.emplace_back(false);
+  right.parents.emplace_back();
+  found.emplace_back(false);
+  return id;
+}
 
-  allLeftPaths_.resize(rowSize);
-  allRightPaths_.reserve(rowSize);
+void SingleShortestPath::init(const HashSet& startVids, const HashSet& endVids, size_t rowSize) {
+  states_.resize(rowSize);
   resultDs_.resize(rowSize);
+  size_t rowNum = 0;
   for (const auto& startVid : startVids) {
-    HashSet srcVid({startVid});
     for (const auto& endVid : endVids) {
-      robin_hood::unordered_flat_map<Value, std::vector<Row>, std::hash<Value>> steps;
-      std::vector<Row> dummy;
-      steps.emplace(endVid, std::move(dummy));
-      HalfPath originRightPath({std::move(steps)});
-      allRightPaths_.emplace_back(std::move(originRightPath));
-
-      HashSet dstVid({endVid});
-      leftVids_.emplace_back(srcVid);
-      rightVids_.emplace_back(std::move(dstVid));
+      auto& state = states_[rowNum++];
+      auto startId = state.encode(startVid);
+      auto endId = state.encode(endVid);
+      state.left.frontier.emplace_back(startId);
+      state.right.visited[endId] = true;
+      if (startId == endId) {
+        // The left side meets the right one when it comes back to the start vid
+        state.cycle = true;
+      } else {
+        state.left.visited[startId] = true;
+        state.right.frontier.emplace_back(endId);
+      }
     }
   }
 }
 
+bool SingleShortestPath::expandRight(size_t rowNum) const {
+  const auto& state = states_[rowNum];
+  return !state.cycle && state.right.frontier.size() < state.left.frontier.size();
+}
+
+std::vector<Value> SingleShortestPath::takeFrontier(size_t rowNum, bool reverse) {
+  auto& state = states_[rowNum];
+  auto& side = reverse ? state.right : state.left;
+  std::vector<Value> vids;
+  vids.reserve(side.frontier.size());
+  for (auto id : side.frontier) {
+    vids.emplace_back(state.vids[id]);
+  }
+  side.frontier.clear();
+  ++side.step;
+  return vids;
+}
+
+bool SingleShortestPath::hasNextStep(size_t rowNum, size_t stepNum) const {
+  const auto& state = states_[rowNum];
+  return stepNum < maxStep_ && !state.left.frontier.empty() &&
+         (state.cycle || !state.right.frontier.empty());
+}
+
 folly::Future<Status> SingleShortestPath::shortestPath(size_t rowNum, size_t stepNum) {
-  std::vector<folly::Future<Status>> futures;
-  futures.reserve(2);
-  futures.emplace_back(getNeighbors(rowNum, stepNum, false));
-  futures.emplace_back(getNeighbors(rowNum, stepNum, true));
-  return folly::collectAll(futures)
+  return getNeighbors(rowNum, expandRight(rowNum))
       .via(runner())
-      .thenValue([this, rowNum, stepNum](std::vector<folly::Try<Status>>&& resps) {
+      .thenValue([this, rowNum, stepNum](Status&& resp) {
         memory::MemoryCheckGuard guard;
-        for (auto& respVal : resps) {
-          if (respVal.hasException()) {
-            auto ex = respVal.exception().get_exception<std::bad_alloc>();
-            if (ex) {
-              throw std::bad_alloc();
-            } else {
-              throw std::runtime_error(respVal.exception().what().c_str());
-            }
-          }
-          auto resp = std::move(respVal).value();
-          if (!resp.ok()) {
-            return folly::makeFuture<Status>(std::move(resp));
-          }
+        if (!resp.ok()) {
+          return folly::makeFuture<Status>(std::move(resp));
         }
         return handleResponse(rowNum, stepNum);
       })
@@ -108,18 +130,15 @@ folly::Future<Status> SingleShortestPath::shortestPath(size_t rowNum, size_t ste
       });
 }
 
-folly::Future<Status> SingleShortestPath::getNeighbors(size_t rowNum,
-                                                       size_t stepNum,
-                                                       bool reverse) {
+folly::Future<Status> SingleShortestPath::getNeighbors(size_t rowNum, bool reverse) {
   StorageClient* storageClient = qctx_->getStorageClient();
   time::Duration getNbrTime;
   storage::StorageClient::CommonRequestParam param(pathNode_->space(),
                                                    qctx_->rctx()->session()->id(),
                                                    qctx_->plan()->id(),
                                                    qctx_->plan()->isProfileEnabled());
-  auto& inputVids = reverse ? rightVids_[rowNum] : leftVids_[rowNum];
-  std::vector<Value> vids(inputVids.begin(), inputVids.end());
-  inputVids.clear();
+  auto vids = takeFrontier(rowNum, reverse);
+  auto stepNum = reverse ? states_[rowNum].right.step : states_[rowNum].left.step;
   return storageClient
       ->getNeighbors(param,
                      {nebula::kVid},
@@ -140,11 +159,11 @@ folly::Future<Status> SingleShortestPath::getNeighbors(size_t rowNum,
       .thenValue([this, rowNum, stepNum, getNbrTime, reverse](auto&& resp) {
         memory::MemoryCheckGuard guard;
         addStats(resp, stepNum, getNbrTime.elapsedInUSec(), reverse);
-        return buildPath(rowNum, std::move(resp), reverse);
+        return expand(rowNum, std::move(resp), reverse);
       });
 }
 
-Status SingleShortestPath::buildPath(size_t rowNum, RpcResponse&& resps, bool reverse) {
+Status SingleShortestPath::expand(size_t rowNum, RpcResponse&& resps, bool reverse) {
   auto result = handleCompleteness(resps, FLAGS_accept_partial_success);
   NG_RETURN_IF_ERROR(result);
   auto& responses = std::move(resps).responses();
@@ -159,242 +178,161 @@ Status SingleShortestPath::buildPath(size_t rowNum, RpcResponse&& resps, bool re
   }
   auto listVal = std::make_shared<Value>(std::move(list));
   auto iter = std::make_unique<GetNeighborsIter>(listVal);
-  return doBuildPath(rowNum, iter.get(), reverse);
+  return doExpand(rowNum, iter.get(), reverse);
 }
 
-Status SingleShortestPath::doBuildPath(size_t rowNum, GetNeighborsIter* iter, bool reverse) {
-  auto iterSize = iter->size();
-  auto& visitedVids = reverse ? rightVisitedVids_[rowNum] : leftVisitedVids_[rowNum];
-  visitedVids.reserve(visitedVids.size() + iterSize);
-  auto& allSteps = reverse ? allRightPaths_[rowNum] : allLeftPaths_[rowNum];
-  allSteps.emplace_back();
-  auto& currentStep = allSteps.back();
-
-  auto& nextStepVids = reverse ? rightVids_[rowNum] : leftVids_[rowNum];
-  nextStepVids.reserve(iterSize);
+Status SingleShortestPath::doExpand(size_t rowNum, GetNeighborsIter* iter, bool reverse) {
+  auto& state = states_[rowNum];
+  auto& side = reverse ? state.right : state.left;
+  const auto& otherSide = reverse ? state.left : state.right;
+  auto& nextStepIds = side.frontier;
+  nextStepIds.reserve(iter->size());
 
-  QueryExpressionContext ctx(qctx_->ectx());
   for (iter->reset(); iter->valid(); iter->next()) {
     auto edgeVal = iter->getEdge();
     if (UNLIKELY(!edgeVal.isEdge())) {
       continue;
     }
-    auto& edge = edgeVal.getEdge();
-    auto& dst = edge.dst;
-    if (visitedVids.find(dst) != visitedVids.end()) {
+    auto& edge = edgeVal.mutableEdge();
+    auto srcId = state.encode(edge.src);
+    if (state.vertices[srcId].empty()) {
+      state.vertices[srcId] = iter->getVertex();
+    }
+    auto dstId = state.encode(edge.dst);
+    if (side.visited[dstId]) {
+      // Another shortest way to the vid found in this step. Only one path is needed for the single
+      // shortest path, but the ones through the vids met at are kept too, in case the first way
+      // is rejected for going through the same edge twice
+      if (state.found[dstId] && (!singleShortest_ || otherSide.visited[dstId])) {
+        side.parents[dstId].emplace_back(Parent{srcId, std::move(edge)});
+      }
       continue;
     }
-    visitedVids.emplace(edge.src);
-    nextStepVids.emplace(dst);
-    auto vertex = iter->getVertex();
-    Row step;
-    step.emplace_back(std::move(vertex));
-    step.emplace_back(std::move(edge));
-    auto findDst = currentStep.find(dst);
-    if (findDst == currentStep.end()) {
-      std::vector<Row> steps({std::move(step)});
-      currentStep.emplace(std::move(dst), std::move(steps));
-    } else {
-      auto& steps = findDst->second;
-      steps.emplace_back(std::move(step));
+    side.visited[dstId] = true;
+    state.found[dstId] = true;
+    side.parents[dstId].emplace_back(Parent{srcId, std::move(edge)});
+    nextStepIds.emplace_back(dstId);
+    if (otherSide.visited[dstId]) {
+      state.meets.emplace_back(dstId);
     }
   }
-  visitedVids.insert(nextStepVids.begin(), nextStepVids.end());
+  for (auto id : nextStepIds) {
+    state.found[id] = false;
+  }
   return Status::OK();
 }
 
 folly::Future<Status> SingleShortestPath::handleResponse(size_t rowNum, size_t stepNum) {
-  return folly::makeFuture<Status>(Status::OK())
-      .via(runner())
-      .thenValue([this, rowNum, stepNum](auto&& status) {
-        // MemoryTrackerVerified
-        memory::MemoryCheckGuard guard;
-
-        UNUSED(status);
-        return conjunctPath(rowNum, stepNum);
-      })
-      .thenValue([this, rowNum, stepNum](auto&& result) {
-        memory::MemoryCheckGuard guard;
-        if (result || stepNum * 2 >= maxStep_) {
-          return folly::makeFuture<Status>(Status::OK());
-        }
-        auto& leftVids = leftVids_[rowNum];
-        auto& rightVids = rightVids_[rowNum];
-        if (leftVids.empty() || rightVids.empty()) {
-          return folly::makeFuture<Status>(Status::OK());
-        }
-        return shortestPath(rowNum, stepNum + 1);
-      });
-}
-
-folly::Future<bool> SingleShortestPath::conjunctPath(size_t rowNum, size_t stepNum) {
-  const auto& leftStep = allLeftPaths_[rowNum].back();
-  const auto& prevRightStep = allRightPaths_[rowNum][stepNum - 1];
-  std::vector<Value> meetVids;
-  for (const auto& step : leftStep) {
-    if (prevRightStep.find(step.first) != prevRightStep.end()) {
-      meetVids.push_back(step.first);
-      if (singleShortest_) {
-        break;
-      }
-    }
-  }
-  if (!meetVids.empty()) {
-    buildOddPath(rowNum, meetVids);
-    return folly::makeFuture<bool>(true);
+  const auto& state = states_[rowNum];
+  // All the vids met at are first found in this step, so the paths through them are the shortest
+  if (!state.meets.empty()) {
+    return conjunctPath(rowNum);
   }
-  if (stepNum * 2 > maxStep_) {
-    return folly::makeFuture<bool>(false);
+  if (!hasNextStep(rowNum, stepNum)) {
+    return folly::makeFuture<Status>(Status::OK());
   }
+  return shortestPath(rowNum, stepNum + 1);
+}
 
-  const auto& rightStep = allRightPaths_[rowNum].back();
-  for (const auto& step : leftStep) {
-    if (rightStep.find(step.first) != rightStep.end()) {
-      meetVids.push_back(step.first);
-      if (singleShortest_) {
-        break;
-      }
+folly::Future<Status> SingleShortestPath::conjunctPath(size_t rowNum) {
+  const auto& state = states_[rowNum];
+  // The vids met at are just found by one side and not expanded by the other, so get their props
+  std::vector<Value> meetVids;
+  for (auto id : state.meets) {
+    if (state.vertices[id].empty()) {
+      meetVids.emplace_back(state.vids[id]);
     }
   }
   if (meetVids.empty()) {
-    return folly::makeFuture<bool>(false);
+    buildPath(rowNum);
+    return folly::makeFuture<Status>(Status::OK());
   }
-  return buildEvenPath(rowNum, meetVids);
-}
-
-void SingleShortestPath::buildOddPath(size_t rowNum, const std::vector<Value>& meetVids) {
-  for (auto& meetVid : meetVids) {
-    auto leftPaths = createLeftPath(rowNum, meetVid);
-    auto rightPaths = createRightPath(rowNum, meetVid, true);
-    for (auto& leftPath : leftPaths) {
-      for (auto& rightPath : rightPaths) {
-        Row path = leftPath;
-        auto& steps = path.values.back().mutableList().values;
-        steps.insert(steps.end(), rightPath.values.begin(), rightPath.values.end() - 1);
-        if (hasSameEdge(steps)) {
-          continue;
-        }
-        path.emplace_back(rightPath.values.back());
-        resultDs_[rowNum].rows.emplace_back(std::move(path));
-        if (singleShortest_) {
-          return;
-        }
-      }
-    }
-  }
-}
-
-folly::Future<bool> SingleShortestPath::buildEvenPath(size_t rowNum,
-                                                      const std::vector<Value>& meetVids) {
-  auto future = getMeetVidsProps(meetVids);
-  return future.via(runner()).thenValue([this, rowNum](auto&& vertices) {
+  return getMeetVidsProps(meetVids).via(runner()).thenValue([this, rowNum](auto&& vertices) {
     // MemoryTrackerVerified
     memory::MemoryCheckGuard guard;
 
-    if (vertices.empty()) {
-      return false;
-    }
-    for (auto& meetVertex : vertices) {
-      if (!meetVertex.isVertex()) {
+    auto& pathState = states_[rowNum];
+    for (auto& vertex : vertices) {
+      if (!vertex.isVertex()) {
         continue;
       }
-      auto meetVid = meetVertex.getVertex().vid;
-      auto leftPaths = createLeftPath(rowNum, meetVid);
-      auto rightPaths = createRightPath(rowNum, meetVid, false);
-      for (auto& leftPath : leftPaths) {
-        for (auto& rightPath : rightPaths) {
-          Row path = leftPath;
-          auto& steps = path.values.back().mutableList().values;
-          steps.emplace_back(meetVertex);
-          steps.insert(steps.end(), rightPath.values.begin(), rightPath.values.end() - 1);
-          if (hasSameEdge(steps)) {
-            continue;
-          }
-          path.emplace_back(rightPath.values.back());
-          resultDs_[rowNum].rows.emplace_back(std::move(path));
-          if (singleShortest_) {
-            return true;
-          }
-        }
+      auto find = pathState.ids.find(vertex.getVertex().vid);
+      if (find != pathState.ids.end()) {
+        pathState.vertices[find->second] = std::move(vertex);
       }
     }
-    return true;
+    buildPath(rowNum);
+    return Status::OK();
   });
 }
 
-std::vector<Row> SingleShortestPath::createLeftPath(size_t rowNum, const Value& meetVid) {
-  auto& allSteps = allLeftPaths_[rowNum];
-  auto& lastSteps = allSteps.back();
-  auto findMeetVid = lastSteps.find(meetVid);
-  std::vector<Row> leftPaths(findMeetVid->second);
-  for (auto stepIter = allSteps.rbegin() + 1; stepIter != allSteps.rend(); ++stepIter) {
-    std::vector<Row> temp;
-    for (auto& leftPath : leftPaths) {
-      Value id = leftPath.values.front().getVertex().vid;
-      auto findId = stepIter->find(id);
-      for (auto& step : findId->second) {
-        auto newPath = leftPath;
-        newPath.values.insert(newPath.values.begin(), step.values.begin(), step.values.end());
-        temp.emplace_back(std::move(newPath));
-      }
+void SingleShortestPath::buildPath(size_t rowNum) {
+  const auto& state = states_[rowNum];
+  for (auto meetId : state.meets) {
+    if (state.vertices[meetId].empty()) {
+      // The vertex doesn't exist
+      continue;
     }
-    leftPaths.swap(temp);
-  }
-  std::vector<Row> result;
-  result.reserve(leftPaths.size());
-  for (auto& path : leftPaths) {
-    Row row;
-    auto src = path.values.front();
-    path.values.erase(path.values.begin());
-    row.emplace_back(std::move(src));
-    row.emplace_back(std::move(path));
-    result.emplace_back(std::move(row));
-  }
-  return result;
-}
+    auto leftPaths = createHalfPath(state.left, meetId);
+    auto rightPaths = createHalfPath(state.right, meetId);
+    for (const auto& leftPath : leftPaths) {
+      for (const auto& rightPath : rightPaths) {
+        // The vids and the edges between them, from the start vid to the end vid
+        std::vector<uint32_t> ids;
+        std::vector<const Edge*> edges;
+        ids.reserve(leftPath.size() + rightPath.size() + 1);
+        edges.reserve(leftPath.size() + rightPath.size());
+        for (auto iter = leftPath.rbegin(); iter != leftPath.rend(); ++iter) {
+          ids.emplace_back((*iter)->id);
+          edges.emplace_back(&(*iter)->edge);
+        }
+        ids.emplace_back(meetId);
+        for (const auto* parent : rightPath) {
+          edges.emplace_back(&parent->edge);
+          ids.emplace_back(parent->id);
+        }
 
-std::vector<Row> SingleShortestPath::createRightPath(size_t rowNum,
-                                                     const Value& meetVid,
-                                                     bool oddStep) {
-  auto& allSteps = allRightPaths_[rowNum];
-  std::vector<Row> rightPaths;
-  auto& lastSteps = allSteps.back();
-  if (oddStep) {
-    for (auto& steps : lastSteps) {
-      bool flag = false;
-      for (auto& step : steps.second) {
-        auto& vertex = step.values.front();
-        if (vertex.getVertex().vid == meetVid) {
-          rightPaths.emplace_back(Row({vertex}));
-          flag = true;
-          break;
+        List steps;
+        steps.values.reserve(edges.size() * 2);
+        for (size_t i = 0; i < edges.size(); ++i) {
+          steps.values.emplace_back(*edges[i]);
+          if (i + 1 < edges.size()) {
+            steps.values.emplace_back(state.vertices[ids[i + 1]]);
+          }
+        }
+        if (hasSameEdge(steps.values)) {
+          continue;
+        }
+        Row path;
+        path.emplace_back(state.vertices[ids.front()]);
+        path.emplace_back(std::move(steps));
+        path.emplace_back(state.vertices[ids.back()]);
+        resultDs_[rowNum].rows.emplace_back(std::move(path));
+        if (singleShortest_) {
+          return;
         }
-      }
-      if (flag) {
-        break;
       }
     }
-  } else {
-    auto findMeetVid = lastSteps.find(meetVid);
-    rightPaths = findMeetVid->second;
   }
-  for (auto stepIter = allSteps.rbegin() + 1; stepIter != allSteps.rend() - 1; ++stepIter) {
-    std::vector<Row> temp;
-    for (auto& rightPath : rightPaths) {
-      Value id = rightPath.values.front().getVertex().vid;
-      auto findId = stepIter->find(id);
-      for (auto& step : findId->second) {
-        auto newPath = rightPath;
-        newPath.values.insert(newPath.values.begin(), step.values.begin(), step.values.end());
+}
+
+std::vector<std::vector<const SingleShortestPath::Parent*>> SingleShortestPath::createHalfPath(
+    const Side& side, uint32_t id) {
+  std::vector<std::vector<const Parent*>> paths(1);
+  // The parents are always in the previous step, so each path takes as many steps as expanded
+  for (size_t step = 0; step < side.step; ++step) {
+    std::vector<std::vector<const Parent*>> temp;
+    for (auto& path : paths) {
+      auto lastId = path.empty() ? id : path.back()->id;
+      for (const auto& parent : side.parents[lastId]) {
+        auto newPath = path;
+        newPath.emplace_back(&parent);
         temp.emplace_back(std::move(newPath));
       }
     }
-    rightPaths.swap(temp);
-  }
-  for (auto& path : rightPaths) {
-    std::reverse(path.values.begin(), path.values.end());
+    paths.swap(temp);
   }
-  return rightPaths;
+  return paths;
 }
 
 }  // namespace graph
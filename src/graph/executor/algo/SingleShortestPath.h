@@ -10,6 +10,8 @@
 namespace nebula {
 namespace graph {
 
+// Find the shortest paths of each pair of start and end vids by a bidirectional BFS, which expands
+// the side with the smaller frontier in each step.
 class SingleShortestPath final : public ShortestPathBase {
  public:
   using HashSet = robin_hood::unordered_flat_set<Value, std::hash<Value>>;
@@ -22,37 +24,77 @@ class SingleShortestPath final : public ShortestPathBase {
                                 const HashSet& endVids,
                                 DataSet* result) override;
 
-  using HalfPath = std::vector<
-      robin_hood::unordered_flat_map<DstVid, std::vector<CustomStep>, std::hash<Value>>>;
-
  private:
+  // The edge to a vertex from the one it's found by
+  struct Parent {
+    uint32_t id;
+    Edge edge;
+  };
+
+  // The BFS from the start vid (left) or from the end vid (right)
+  struct Side {
+    // The ids to expand in the next step
+    std::vector<uint32_t> frontier;
+    std::vector<bool> visited;
+    // The parents in the previous step of the ids visited, all of them if finding all the
+    // shortest paths, or the first one otherwise except for the ids met at
+    std::vector<std::vector<Parent>> parents;
+    // The steps expanded
+    size_t step{0};
+  };
+
+  // The search of a pair of start and end vids. The vids are encoded to dense ids in the order
+  // they are found, so the sides keep bitmaps and parent pointers instead of the paths, which
+  // are built only for the ids the sides meet at.
+  struct PathState {
+    robin_hood::unordered_flat_map<Value, uint32_t, std::hash<Value>> ids;
+    std::vector<Value> vids;
+    // The vertices with props, got when they are expanded or met at
+    std::vector<Value> vertices;
+    Side left;
+    Side right;
+    // The ids found in the step being expanded
+    std::vector<bool> found;
+    // The ids where the sides meet, they are all at the same distance from the start vid
+    std::vector<uint32_t> meets;
+    // The start vid is the end vid, so only the left side is expanded to find the cycles
+    bool cycle{false};
+
+    uint32_t encode(const Value& vid);
+  };
+
   void init(const HashSet& startVids, const HashSet& endVids, size_t rowSize);
 
-  folly::Future<Status> shortestPath(size_t rowNum, size_t stepNum);
+  // Whether to expand the right side in the next step, which is the side with the smaller frontier
+  bool expandRight(size_t rowNum) const;
+
+  // Take the vids of the frontier of the side to expand
+  std::vector<Value> takeFrontier(size_t rowNum, bool reverse);
 
-  folly::Future<Status> getNeighbors(size_t rowNum, size_t stepNum, bool reverse);
+  // Whether to expand another step if the sides don't meet in `stepNum` steps
+  bool hasNextStep(size_t rowNum, size_t stepNum) const;
 
-  Status buildPath(size_t rowNum, RpcResponse&& resps, bool reverse);
+  folly::Future<Status> shortestPath(size_t rowNum, size_t stepNum);
 
-  Status doBuildPath(size_t rowNum, GetNeighborsIter* iter, bool reverse);
+  folly::Future<Status> getNeighbors(size_t rowNum, bool reverse);
 
-  folly::Future<Status> handleResponse(size_t rowNum, size_t stepNum);
+  Status expand(size_t rowNum, RpcResponse&& resps, bool reverse);
 
-  folly::Future<bool> conjunctPath(size_t rowNum, size_t stepNum);
+  Status doExpand(size_t rowNum, GetNeighborsIter* iter, bool reverse);
 
-  folly::Future<bool> buildEvenPath(size_t rowNum, const std::vector<Value>& meetVids);
+  folly::Future<Status> handleResponse(size_t rowNum, size_t stepNum);
 
-  void buildOddPath(size_t rowNum, const std::vector<Value>& meetVids);
+  folly::Future<Status> conjunctPath(size_t rowNum);
 
-  std::vector<Row> createRightPath(size_t rowNum, const Value& meetVid, bool evenStep);
+  void buildPath(size_t rowNum);
 
-  std::vector<Row> createLeftPath(size_t rowNum, const Value& meetVid);
+  // The paths from the id to the start of the side, each of which is the parents on the way
+  std::vector<std::vector<const Parent*>> createHalfPath(const Side& side, uint32_t id);
 
  private:
-  std::vector<HashSet> leftVisitedVids_;
-  std::vector<HashSet> rightVisitedVids_;
-  std::vector<HalfPath> allLeftPaths_;
-  std::vector<HalfPath> allRightPaths_;
+  friend class SingleShortestPathTest;
+
+  std::vector<PathState> states_;
 };
 
 }  // namespace graph
@@ -4,17 +4,194 @@
 
 #include "graph/executor/query/AggregateExecutor.h"
 
+#include <folly/hash/Hash.h>
+
+#include "common/base/Arena.h"
 #include "graph/planner/plan/Query.h"
+#include "graph/service/GraphFlags.h"
+#include "graph/util/BatchExprEvaluator.h"
+#include "graph/util/SpillFile.h"
 
 namespace nebula {
 namespace graph {
 
+// Open addressing hash table from the group keys to the aggregate states. The states are
+// allocated from an arena, which are destroyed along with the table.
+class GroupTable final {
+ public:
+  explicit GroupTable(size_t numItems) : numItems_(numItems) {}
+
+  ~GroupTable() {
+    for (auto* state : states_) {
+      state->~AggData();
+    }
+  }
+
+  // Return the index of the group, a group with the empty states is inserted if not exists
+  size_t findOrInsert(List&& key, size_t hash) {
+    if ((keys_.size() + 1) * 2 > slots_.size()) {
+      rehash(std::max<size_t>(kMinCapacity, slots_.size() * 2));
+    }
+    auto mask = slots_.size() - 1;
+    for (auto pos = hash & mask;; pos = (pos + 1) & mask) {
+      auto& slot = slots_[pos];
+      if (slot.group == kEmpty) {
+        slot.hash = hash;
+        slot.group = keys_.size();
+        keys_.emplace_back(std::move(key));
+        hashes_.emplace_back(hash);
+        for (size_t i = 0; i < numItems_; ++i) {
+          states_.emplace_back(new (arena_.allocateAligned(sizeof(AggData))) AggData());
+        }
+        return slot.group;
+      }
+      if (slot.hash == hash && keys_[slot.group] == key) {
+        return slot.group;
+      }
+    }
+  }
+
+  AggData* state(size_t group, size_t item) {
+    DCHECK_LT(item, numItems_);
+    return states_[group * numItems_ + item];
+  }
+
+  size_t numGroups() const {
+    return keys_.size();
+  }
+
+  size_t hash(size_t group) const {
+    return hashes_[group];
+  }
+
+  // Move out the key of the group, which is only called when the table is merged into another one
+  List takeKey(size_t group) {
+    return std::move(keys_[group]);
+  }
+
+  // One row for each group, the columns are the results of the group items
+  void appendTo(DataSet* ds) const {
+    for (size_t group = 0; group < keys_.size(); ++group) {
+      Row row;
+      row.values.reserve(numItems_);
+      for (size_t i = 0; i < numItems_; ++i) {
+        row.values.emplace_back(states_[group * numItems_ + i]->result());
+      }
+      ds->rows.emplace_back(std::move(row));
+    }
+  }
+
+ private:
+  static constexpr size_t kEmpty = std::numeric_limits<size_t>::max();
+  static constexpr size_t kMinCapacity = 16;
+
+  struct Slot {
+    size_t hash{0};
+    size_t group{kEmpty};
+  };
+
+  void rehash(size_t capacity) {
+    DCHECK_EQ(capacity & (capacity - 1), 0);
+    std::vector<Slot> slots(capacity);
+    auto mask = capacity - 1;
+    for (const auto& slot : slots_) {
+      if (slot.group == kEmpty) {
+        continue;
+      }
+      auto pos = slot.hash & mask;
+      while (slots[pos].group != kEmpty) {
+        pos = (pos + 1) & mask;
+      }
+      slots[pos] = slot;
+    }
+    slots_.swap(slots);
+  }
+
+  size_t numItems_;
+  std::vector<Slot> slots_;
+  std::vector<List> keys_;
+  std::vector<size_t> hashes_;
+  // The states of the group g are in [g * numItems_, (g + 1) * numItems_)
+  std::vector<AggData*> states_;
+  Arena arena_;
+};
+
+namespace {
+
+size_t groupHash(const List& key) {
+  // Mix the bits since the hash of integer is the identity
+  return folly::hash::twang_mix64(std::hash<List>()(key));
+}
+
+// Whether the partial results of the group items could be merged
+bool mergeable(const std::vector<Expression*>& groupItems) {
+  for (auto* item : groupItems) {
+    if (item->kind() == Expression::Kind::kAggregate &&
+        !static_cast<AggregateExpression*>(item)->mergeable()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Evaluate the group keys and the inputs of the group items for at most `numRows` rows, and
+// call `consume(key, input)` for each row, where `input(i)` is the input of the i-th group item.
+// The input of an aggregate function is its argument, otherwise it's the item itself.
+template <typename Consume>
+void evalGroupRows(QueryExpressionContext& ctx,
+                   const std::vector<Expression*>& groupKeys,
+                   const std::vector<Expression*>& groupItems,
+                   Iterator* iter,
+                   size_t numRows,
+                   Consume&& consume) {
+  std::vector<Expression*> exprs(groupKeys.begin(), groupKeys.end());
+  for (auto* item : groupItems) {
+    if (item->kind() == Expression::Kind::kAggregate) {
+      exprs.emplace_back(static_cast<AggregateExpression*>(item)->arg());
+    } else {
+      exprs.emplace_back(item);
+    }
+  }
+  BatchExprEvaluator evaluator(exprs);
+  size_t batchSize = FLAGS_enable_vectorized_execution ? BatchExprEvaluator::kBatchSize : 1;
+  while (iter->valid() && numRows > 0) {
+    auto evaluated = evaluator.evalBatch(ctx, iter, std::min(numRows, batchSize));
+    numRows -= evaluated;
+    for (size_t row = 0; row < evaluated; ++row) {
+      List key;
+      key.values.reserve(groupKeys.size());
+      for (size_t i = 0; i < groupKeys.size(); ++i) {
+        key.values.emplace_back(evaluator.result(i).value(row));
+      }
+      consume(std::move(key),
+              [&](size_t item) { return evaluator.result(groupKeys.size() + item).value(row); });
+    }
+  }
+}
+
+template <typename Input>
+void updateGroup(const std::vector<Expression*>& groupItems,
+                 GroupTable* table,
+                 size_t group,
+                 Input&& input) {
+  for (size_t i = 0; i < groupItems.size(); ++i) {
+    auto* item = groupItems[i];
+    if (item->kind() == Expression::Kind::kAggregate) {
+      static_cast<AggregateExpression*>(item)->accumulate(table->state(group, i), input(i));
+    } else {
+      table->state(group, i)->setResult(input(i));
+    }
+  }
+}
+
+}  // namespace
+
 folly::Future<Status> AggregateExecutor::execute() {
   SCOPED_TIMER(&execTime_);
   // MemoryTrackerVerified
   auto* agg = asNode<Aggregate>(node());
-  auto groupKeys = agg->groupKeys();
-  auto groupItems = agg->groupItems();
+  const auto& groupKeys = agg->groupKeys();
+  const auto& groupItems = agg->groupItems();
   auto iter = ectx_->getResult(agg->inputVar()).iter();
   DCHECK(!!iter);
   QueryExpressionContext ctx(ectx_);
@@ -30,7 +207,22 @@ folly::Future<Status> AggregateExecutor::execute() {
     }
   }
 
-  std::unordered_map<List, std::vector<std::unique_ptr<AggData>>, std::hash<nebula::List>> result;
+  if (FLAGS_enable_spill_to_disk && !iter->isGetNeighborsIter()) {
+    auto bytes = SpillDir::estimateSize(iter.get());
+    if (SpillDir::exceedsBudget(bytes)) {
+      return aggregateWithSpill(iter.get(), SpillDir::numPartitions(bytes));
+    }
+  }
+
+  // TODO: GetNeighborsIterator is not an thread safe implementation.
+  if (FLAGS_max_job_size > 1 && !iter->isGetNeighborsIter() && mergeable(groupItems)) {
+    auto numJobs = getNumJobs(iter->size());
+    if (numJobs > 1) {
+      return handleMultiJobs(iter.get(), numJobs);
+    }
+  }
+
+  GroupTable table(groupItems.size());
 
   // generate default result when input dataset is empty
   if (UNLIKELY(!iter->valid())) {
@@ -48,52 +240,206 @@ folly::Future<Status> AggregateExecutor::execute() {
     }
     if (allAggItems) {
       List dummyKey;
-      std::vector<std::unique_ptr<AggData>> cols;
+      auto hash = groupHash(dummyKey);
+      auto group = table.findOrInsert(std::move(dummyKey), hash);
       for (size_t i = 0; i < groupItems.size(); ++i) {
-        cols.emplace_back(new AggData());
-        cols[i]->setResult(defaultValues[i]);
+        table.state(group, i)->setResult(defaultValues[i]);
       }
-      result.emplace(std::make_pair(dummyKey, std::move(cols)));
     }
   }
 
-  for (; iter->valid(); iter->next()) {
-    List list;
-    for (auto* key : groupKeys) {
-      list.values.emplace_back(key->eval(ctx(iter.get())));
-    }
+  evalGroupRows(ctx,
+                groupKeys,
+                groupItems,
+                iter.get(),
+                std::numeric_limits<size_t>::max(),
+                [&](List&& key, auto&& input) {
+                  auto hash = groupHash(key);
+                  auto group = table.findOrInsert(std::move(key), hash);
+                  updateGroup(groupItems, &table, group, input);
+                });
 
-    auto it = result.find(list);
-    if (it == result.end()) {
-      std::vector<std::unique_ptr<AggData>> cols;
-      for (size_t i = 0; i < groupItems.size(); ++i) {
-        cols.emplace_back(new AggData());
+  DataSet ds;
+  ds.colNames = agg->colNames();
+  table.appendTo(&ds);
+  return finish(ResultBuilder().value(Value(std::move(ds))).build());
+}
+
+folly::Future<Status> AggregateExecutor::handleMultiJobs(Iterator* iter, size_t numPartitions) {
+  auto scatter = [this, numPartitions](size_t begin, size_t end, Iterator* tmpIter) -> Partitions {
+    return handleJob(begin, end, tmpIter, numPartitions);
+  };
+
+  auto gather = [this, numPartitions](std::vector<folly::Try<Partitions>>&& results) {
+    memory::MemoryCheckGuard guard1;
+    auto jobs = std::make_shared<std::vector<Partitions>>();
+    jobs->reserve(results.size());
+    for (auto& respVal : results) {
+      if (respVal.hasException()) {
+        auto ex = respVal.exception().get_exception<std::bad_alloc>();
+        if (ex) {
+          throw std::bad_alloc();
+        } else {
+          throw std::runtime_error(respVal.exception().what().c_str());
+        }
       }
-      result.emplace(std::make_pair(list, std::move(cols)));
-    } else {
-      DCHECK_EQ(it->second.size(), groupItems.size());
+      jobs->emplace_back(std::move(respVal).value());
     }
 
-    for (size_t i = 0; i < groupItems.size(); ++i) {
-      auto* item = groupItems[i];
-      if (item->kind() == Expression::Kind::kAggregate) {
-        static_cast<AggregateExpression*>(item)->setAggData(result[list][i].get());
-        item->eval(ctx(iter.get()));
-      } else {
-        result[list][i]->setResult(item->eval(ctx(iter.get())));
+    std::vector<folly::Future<DataSet>> futures;
+    futures.reserve(numPartitions);
+    for (size_t i = 0; i < numPartitions; ++i) {
+      futures.emplace_back(folly::via(runner(), [this, jobs, i]() {
+        memory::MemoryCheckGuard guard;
+        return mergePartition(*jobs, i);
+      }));
+    }
+
+    return folly::collectAll(futures).via(runner()).thenValue(
+        [this](std::vector<folly::Try<DataSet>>&& partitions) {
+          memory::MemoryCheckGuard guard2;
+          DataSet ds;
+          ds.colNames = asNode<Aggregate>(node())->colNames();
+          for (auto& respVal : partitions) {
+            if (respVal.hasException()) {
+              auto ex = respVal.exception().get_exception<std::bad_alloc>();
+              if (ex) {
+                throw std::bad_alloc();
+              } else {
+                throw std::runtime_error(respVal.exception().what().c_str());
+              }
+            }
+            auto rows = std::move(respVal).value().rows;
+            ds.rows.insert(ds.rows.end(),
+                           std::make_move_iterator(rows.begin()),
+                           std::make_move_iterator(rows.end()));
+          }
+          return finish(ResultBuilder().value(Value(std::move(ds))).build());
+        });
+  };
+
+  return runMultiJobs(std::move(scatter), std::move(gather), iter);
+}
+
+AggregateExecutor::Partitions AggregateExecutor::handleJob(size_t begin,
+                                                           size_t end,
+                                                           Iterator* iter,
+                                                           size_t numPartitions) {
+  auto* agg = asNode<Aggregate>(node());
+  // The expressions are not thread safe to evaluate
+  std::vector<ExprClone> clones;
+  clones.reserve(agg->groupKeys().size() + agg->groupItems().size());
+  std::vector<Expression*> groupKeys;
+  for (auto* key : agg->groupKeys()) {
+    clones.emplace_back(qctx(), key);
+    groupKeys.emplace_back(clones.back().get());
+  }
+  std::vector<Expression*> groupItems;
+  for (auto* item : agg->groupItems()) {
+    clones.emplace_back(qctx(), item);
+    groupItems.emplace_back(clones.back().get());
+  }
+
+  Partitions partitions;
+  partitions.reserve(numPartitions);
+  for (size_t i = 0; i < numPartitions; ++i) {
+    partitions.emplace_back(std::make_unique<GroupTable>(groupItems.size()));
+  }
+  QueryExpressionContext ctx(ectx_);
+  evalGroupRows(
+      ctx, groupKeys, groupItems, iter, end - begin, [&](List&& key, auto&& input) {
+        auto hash = groupHash(key);
+        // The low bits are used by the hash table of the partition
+        auto* table = partitions[(hash >> 32) % numPartitions].get();
+        auto group = table->findOrInsert(std::move(key), hash);
+        updateGroup(groupItems, table, group, input);
+      });
+  return partitions;
+}
+
+DataSet AggregateExecutor::mergePartition(std::vector<Partitions>& jobs, size_t partition) {
+  // The aggregate functions are stateless, so they are shared by all partitions
+  const auto& groupItems = asNode<Aggregate>(node())->groupItems();
+  auto table = std::move(jobs.front()[partition]);
+  for (size_t job = 1; job < jobs.size(); ++job) {
+    auto other = std::move(jobs[job][partition]);
+    for (size_t i = 0; i < other->numGroups(); ++i) {
+      auto group = table->findOrInsert(other->takeKey(i), other->hash(i));
+      for (size_t j = 0; j < groupItems.size(); ++j) {
+        auto* item = groupItems[j];
+        if (item->kind() == Expression::Kind::kAggregate) {
+          static_cast<AggregateExpression*>(item)->merge(table->state(group, j),
+                                                         other->state(i, j));
+        } else {
+          // The value of the last row of the group
+          table->state(group, j)->setResult(std::move(other->state(i, j)->result()));
+        }
       }
     }
   }
+  DataSet ds;
+  table->appendTo(&ds);
+  return ds;
+}
+
+folly::Future<Status> AggregateExecutor::aggregateWithSpill(Iterator* iter, size_t numPartitions) {
+  auto* agg = asNode<Aggregate>(node());
+  const auto& groupKeys = agg->groupKeys();
+  const auto& groupItems = agg->groupItems();
+  auto dir = SpillDir::create();
+  NG_RETURN_IF_ERROR(dir);
+  std::vector<std::unique_ptr<SpillFile>> files;
+  for (size_t i = 0; i < numPartitions; ++i) {
+    auto file = dir.value()->newFile();
+    NG_RETURN_IF_ERROR(file);
+    files.emplace_back(std::move(file).value());
+  }
+
+  // The spilled row is the group key followed by the inputs of the group items
+  Status status;
+  QueryExpressionContext ctx(ectx_);
+  evalGroupRows(ctx,
+                groupKeys,
+                groupItems,
+                iter,
+                std::numeric_limits<size_t>::max(),
+                [&](List&& key, auto&& input) {
+                  if (!status.ok()) {
+                    return;
+                  }
+                  auto partition = (groupHash(key) >> 32) % numPartitions;
+                  Row row;
+                  row.values.reserve(groupItems.size() + 1);
+                  row.values.emplace_back(std::move(key));
+                  for (size_t i = 0; i < groupItems.size(); ++i) {
+                    row.values.emplace_back(input(i));
+                  }
+                  status = files[partition]->append(std::move(row));
+                });
+  NG_RETURN_IF_ERROR(status);
 
   DataSet ds;
   ds.colNames = agg->colNames();
-  ds.rows.reserve(result.size());
-  for (auto& kv : result) {
+  for (auto& file : files) {
+    NG_RETURN_IF_ERROR(file->finish());
+    GroupTable table(groupItems.size());
     Row row;
-    for (auto& v : kv.second) {
-      row.values.emplace_back(v->result());
+    while (true) {
+      auto ret = file->next(&row);
+      NG_RETURN_IF_ERROR(ret);
+      if (!ret.value()) {
+        break;
+      }
+      auto key = row.values.front().moveList();
+      auto hash = groupHash(key);
+      auto group = table.findOrInsert(std::move(key), hash);
+      updateGroup(groupItems, &table, group, [&row](size_t i) -> const Value& {
+        return row.values[i + 1];
+      });
     }
-    ds.rows.emplace_back(std::move(row));
+    table.appendTo(&ds);
+    // Remove the file once the partition is aggregated
+    file.reset();
   }
   return finish(ResultBuilder().value(Value(std::move(ds))).build());
 }
@@ -11,12 +11,33 @@
 namespace nebula {
 namespace graph {
 
+class GroupTable;
+
 class AggregateExecutor final : public Executor {
  public:
   AggregateExecutor(const PlanNode *node, QueryContext *qctx)
       : Executor("AggregateExecutor", node, qctx) {}
 
   folly::Future<Status> execute() override;
+
+ private:
+  // The groups aggregated by a job, which are partitioned by the hash of the group keys
+  using Partitions = std::vector<std::unique_ptr<GroupTable>>;
+
+  // Aggregate in two phases when there are multiple jobs, each job aggregates its rows into the
+  // partitions by the group keys at first, and then the partial results of each partition from
+  // all jobs are merged by one job independently.
+  folly::Future<Status> handleMultiJobs(Iterator *iter, size_t numPartitions);
+
+  // Aggregate the rows in [begin, end) into the partitions
+  Partitions handleJob(size_t begin, size_t end, Iterator *iter, size_t numPartitions);
+
+  // Merge the partial results of the partition from all jobs, which are merged in the input order
+  DataSet mergePartition(std::vector<Partitions> &jobs, size_t partition);
+
+  // Aggregate when the input exceeds the memory budget, the rows are partitioned by the group keys
+  // into spill files, and then the partitions are aggregated one by one
+  folly::Future<Status> aggregateWithSpill(Iterator *iter, size_t numPartitions);
 };
 
 }  // namespace graph
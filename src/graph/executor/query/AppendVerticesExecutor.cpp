@@ -259,13 +259,13 @@ folly::Future<Status> AppendVerticesExecutor::handleRespMultiJobs(
 
 DataSet AppendVerticesExecutor::buildVerticesResult(size_t begin, size_t end, Iterator *iter) {
   auto *av = asNode<AppendVertices>(node());
-  auto vFilter = av->vFilter() ? av->vFilter()->clone() : nullptr;
+  ExprClone vFilter(qctx(), av->vFilter());
   DataSet ds;
   ds.colNames = av->colNames();
   ds.rows.reserve(end - begin);
   QueryExpressionContext ctx(qctx()->ectx());
   for (; iter->valid() && begin++ < end; iter->next()) {
-    if (vFilter != nullptr) {
+    if (vFilter.get() != nullptr) {
       auto &vFilterVal = vFilter->eval(ctx(iter));
       if (!vFilterVal.isBool() || !vFilterVal.getBool()) {
         continue;
@@ -281,10 +281,10 @@ DataSet AppendVerticesExecutor::buildVerticesResult(size_t begin, size_t end, It
 
 void AppendVerticesExecutor::buildMap(size_t begin, size_t end, Iterator *iter) {
   auto *av = asNode<AppendVertices>(node());
-  auto vFilter = av->vFilter() ? av->vFilter()->clone() : nullptr;
+  ExprClone vFilter(qctx(), av->vFilter());
   QueryExpressionContext ctx(qctx()->ectx());
   for (; iter->valid() && begin++ < end; iter->next()) {
-    if (vFilter != nullptr) {
+    if (vFilter.get() != nullptr) {
       auto &vFilterVal = vFilter->eval(ctx(iter));
       if (!vFilterVal.isBool() || !vFilterVal.getBool()) {
         continue;
@@ -299,7 +299,7 @@ DataSet AppendVerticesExecutor::handleJob(size_t begin, size_t end, Iterator *it
   DataSet ds;
   ds.colNames = av->colNames();
   ds.rows.reserve(end - begin);
-  auto src = av->src()->clone();
+  ExprClone src(qctx(), av->src());
   QueryExpressionContext ctx(qctx()->ectx());
   for (; iter->valid() && begin++ < end; iter->next()) {
     auto dstFound = dsts_.find(src->eval(ctx(iter)));
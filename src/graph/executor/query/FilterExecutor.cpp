@@ -4,8 +4,10 @@
 
 #include "graph/executor/query/FilterExecutor.h"
 
+#include "common/expression/CompiledExpression.h"
 #include "graph/planner/plan/Query.h"
 #include "graph/service/GraphFlags.h"
+#include "graph/util/BatchExprEvaluator.h"
 
 namespace nebula {
 namespace graph {
@@ -71,8 +73,18 @@ folly::Future<Status> FilterExecutor::execute() {
 StatusOr<DataSet> FilterExecutor::handleJob(size_t begin, size_t end, Iterator *iter) {
   auto *filter = asNode<Filter>(node());
   QueryExpressionContext ctx(ectx_);
-  auto condition = filter->condition()->clone();
+  ExprClone clone(qctx(), filter->condition());
+  auto *condition = clone.get();
   DataSet ds;
+  if (FLAGS_enable_vectorized_execution && BatchExprEvaluator::canVectorize(condition)) {
+    BatchExprEvaluator evaluator({condition});
+    while (iter->valid() && begin < end) {
+      auto batchSize = std::min(end - begin, BatchExprEvaluator::kBatchSize);
+      begin += evaluator.evalBatch(ctx, iter, batchSize);
+      NG_RETURN_IF_ERROR(collectBatch(evaluator, condition, &ds));
+    }
+    return ds;
+  }
   for (; iter->valid() && begin++ < end; iter->next()) {
     auto val = condition->eval(ctx(iter));
     if (val.isBadNull() || (!val.empty() && !val.isImplicitBool() && !val.isNull())) {
@@ -90,6 +102,35 @@ StatusOr<DataSet> FilterExecutor::handleJob(size_t begin, size_t end, Iterator *
   return ds;
 }
 
+Status FilterExecutor::collectBatch(const BatchExprEvaluator &evaluator,
+                                    const Expression *condition,
+                                    DataSet *ds) {
+  const auto &result = evaluator.result(0);
+  const auto &rows = evaluator.rows();
+  if (result.type() == ColumnVector::Type::kBool) {
+    // The NULL rows are filtered out
+    for (size_t i = 0; i < rows.size(); ++i) {
+      if (result.bools()[i] && !result.isNull(i)) {
+        ds->rows.emplace_back(*rows[i]);
+      }
+    }
+    return Status::OK();
+  }
+  for (size_t i = 0; i < rows.size(); ++i) {
+    auto val = result.value(i);
+    if (val.isBadNull() || (!val.empty() && !val.isImplicitBool() && !val.isNull())) {
+      return Status::Error("Failed to evaluate condition: %s. %s%s",
+                           condition->toString().c_str(),
+                           "For boolean conditions, please write in their full forms like",
+                           " <condition> == <true/false> or <condition> IS [NOT] NULL.");
+    }
+    if (val.isImplicitBool() && val.implicitBool()) {
+      ds->rows.emplace_back(*rows[i]);
+    }
+  }
+  return Status::OK();
+}
+
 Status FilterExecutor::handleSingleJobFilter() {
   auto *filter = asNode<Filter>(node());
   auto inputVar = filter->inputVar();
@@ -105,10 +146,11 @@ Status FilterExecutor::handleSingleJobFilter() {
   ResultBuilder builder;
   QueryExpressionContext ctx(ectx_);
   auto condition = filter->condition();
+  auto compiled = CompiledExpression::compile(condition);
   if (LIKELY(canMoveData)) {
     builder.value(result.valuePtr());
     while (iter->valid()) {
-      auto val = condition->eval(ctx(iter));
+      auto val = compiled != nullptr ? compiled->eval(ctx(iter)) : condition->eval(ctx(iter));
       if (val.isBadNull() || (!val.empty() && !val.isImplicitBool() && !val.isNull())) {
         return Status::Error("Failed to evaluate condition: %s. %s%s",
                              condition->toString().c_str(),
@@ -129,12 +171,18 @@ Status FilterExecutor::handleSingleJobFilter() {
     iter->reset();
     builder.iter(std::move(result).iter());
     return finish(builder.build());
+  } else if (FLAGS_enable_vectorized_execution &&
+             BatchExprEvaluator::canVectorize(filter->condition())) {
+    auto ds = handleJob(0, iter->size(), iter);
+    NG_RETURN_IF_ERROR(ds);
+    ds.value().colNames = result.getColNames();
+    return finish(builder.value(Value(std::move(ds).value())).iter(Iterator::Kind::kProp).build());
   } else {
     DataSet ds;
     ds.colNames = result.getColNames();
     ds.rows.reserve(iter->size());
     for (; iter->valid(); iter->next()) {
-      auto val = condition->eval(ctx(iter));
+      auto val = compiled != nullptr ? compiled->eval(ctx(iter)) : condition->eval(ctx(iter));
       if (val.isBadNull() || (!val.empty() && !val.isImplicitBool() && !val.isNull())) {
         return Status::Error("Failed to evaluate condition: %s. %s%s",
                              condition->toString().c_str(),
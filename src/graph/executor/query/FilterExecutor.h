@@ -6,6 +6,7 @@
 #define GRAPH_EXECUTOR_QUERY_FILTEREXECUTOR_H_
 
 #include "graph/executor/Executor.h"
+#include "graph/util/BatchExprEvaluator.h"
 
 // delete the corresponding iterator when the row in the dataset does not meet the conditions
 // and save the filtered iterator to the result
@@ -22,6 +23,12 @@ class FilterExecutor final : public Executor {
   StatusOr<DataSet> handleJob(size_t begin, size_t end, Iterator *iter);
 
   Status handleSingleJobFilter();
+
+ private:
+  // Append the rows of the last batch which satisfy the condition to the dataset
+  Status collectBatch(const BatchExprEvaluator &evaluator,
+                      const Expression *condition,
+                      DataSet *ds);
 };
 
 }  // namespace graph
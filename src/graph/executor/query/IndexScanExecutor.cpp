@@ -23,12 +23,12 @@ folly::Future<Status> IndexScanExecutor::execute() {
 folly::Future<Status> IndexScanExecutor::indexScan() {
   StorageClient *storageClient = qctx_->getStorageClient();
   auto *lookup = asNode<IndexScan>(node());
-  auto objPool = qctx()->objPool();
+  auto objPool = qctx()->execPool();
 
   IndexQueryContextList ictxs;
   if (lookup->lazyIndexHint()) {
     auto filterStr = lookup->queryContext().front().get_filter();
-    Expression *filter = Expression::decode(qctx()->objPool(), filterStr);
+    Expression *filter = Expression::decode(objPool, filterStr);
     if (filter->kind() != Expression::Kind::kRelEQ && filter->kind() != Expression::Kind::kRelIn) {
       return Status::Error("The kind of filter expression is invalid: %s",
                            filter->toString().c_str());
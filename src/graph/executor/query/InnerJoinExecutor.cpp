@@ -4,8 +4,11 @@
 
 #include "graph/executor/query/InnerJoinExecutor.h"
 
+#include <folly/hash/Hash.h>
+
 #include "graph/planner/plan/Query.h"
 #include "graph/service/GraphFlags.h"
+#include "graph/util/SpillFile.h"
 
 namespace nebula {
 namespace graph {
@@ -38,6 +41,14 @@ folly::Future<Status> InnerJoinExecutor::join(const std::vector<Expression*>& ha
     return finish(ResultBuilder().value(Value(std::move(result))).build());
   }
 
+  if (FLAGS_enable_spill_to_disk) {
+    auto* buildIter = lhsIter_->size() < rhsIter_->size() ? lhsIter_.get() : rhsIter_.get();
+    auto bytes = SpillDir::estimateSize(buildIter);
+    if (SpillDir::exceedsBudget(bytes)) {
+      return joinWithSpill(hashKeys, probeKeys, colNames, SpillDir::numPartitions(bytes));
+    }
+  }
+
   if (hashKeys.size() == 1 && probeKeys.size() == 1) {
     std::unordered_map<Value, std::vector<const Row*>> hashTable;
     hashTable.reserve(bucketSize);
@@ -126,6 +137,14 @@ folly::Future<Status> InnerJoinExecutor::joinMultiJobs(const std::vector<Express
     return finish(ResultBuilder().value(Value(std::move(result))).build());
   }
 
+  if (FLAGS_enable_spill_to_disk) {
+    auto* buildIter = lhsIter_->size() < rhsIter_->size() ? lhsIter_.get() : rhsIter_.get();
+    auto bytes = SpillDir::estimateSize(buildIter);
+    if (SpillDir::exceedsBudget(bytes)) {
+      return joinWithSpill(hashKeys, probeKeys, colNames, SpillDir::numPartitions(bytes));
+    }
+  }
+
   if (hashKeys.size() == 1 && probeKeys.size() == 1) {
     hashTable_.reserve(bucketSize);
     if (lhsIter_->size() < rhsIter_->size()) {
@@ -151,12 +170,13 @@ folly::Future<Status> InnerJoinExecutor::joinMultiJobs(const std::vector<Express
 
 folly::Future<Status> InnerJoinExecutor::probe(const std::vector<Expression*>& probeKeys,
                                                Iterator* probeIter) {
-  std::vector<Expression*> tmpProbeKeys;
-  std::for_each(probeKeys.begin(), probeKeys.end(), [&tmpProbeKeys](auto& e) {
-    tmpProbeKeys.emplace_back(e->clone());
-  });
-  auto scatter = [this, tmpProbeKeys = std::move(tmpProbeKeys)](
+  auto scatter = [this, probeKeys = probeKeys](
                      size_t begin, size_t end, Iterator* tmpIter) -> StatusOr<DataSet> {
+    std::vector<ExprClone> tmpProbeKeys;
+    tmpProbeKeys.reserve(probeKeys.size());
+    for (auto* key : probeKeys) {
+      tmpProbeKeys.emplace_back(qctx(), key);
+    }
     DataSet ds;
     QueryExpressionContext ctx(ectx_);
     ds.rows.reserve(end - begin);
@@ -203,7 +223,7 @@ folly::Future<Status> InnerJoinExecutor::probe(const std::vector<Expression*>& p
 folly::Future<Status> InnerJoinExecutor::singleKeyProbe(Expression* probeKey, Iterator* probeIter) {
   auto scatter = [this, probeKey](
                      size_t begin, size_t end, Iterator* tmpIter) -> StatusOr<DataSet> {
-    auto tmpProbeKey = probeKey->clone();
+    ExprClone tmpProbeKey(qctx(), probeKey);
     DataSet ds;
     QueryExpressionContext ctx(ectx_);
     ds.rows.reserve(end - begin);
@@ -242,6 +262,103 @@ folly::Future<Status> InnerJoinExecutor::singleKeyProbe(Expression* probeKey, It
   return runMultiJobs(std::move(scatter), std::move(gather), probeIter);
 }
 
+folly::Future<Status> InnerJoinExecutor::joinWithSpill(const std::vector<Expression*>& hashKeys,
+                                                       const std::vector<Expression*>& probeKeys,
+                                                       const std::vector<std::string>& colNames,
+                                                       size_t numPartitions) {
+  auto dir = SpillDir::create();
+  NG_RETURN_IF_ERROR(dir);
+  std::vector<std::unique_ptr<SpillFile>> buildFiles, probeFiles;
+  for (size_t i = 0; i < numPartitions; ++i) {
+    auto buildFile = dir.value()->newFile();
+    NG_RETURN_IF_ERROR(buildFile);
+    buildFiles.emplace_back(std::move(buildFile).value());
+    auto probeFile = dir.value()->newFile();
+    NG_RETURN_IF_ERROR(probeFile);
+    probeFiles.emplace_back(std::move(probeFile).value());
+  }
+
+  // Build on the smaller side the same as the in-memory join
+  if (lhsIter_->size() < rhsIter_->size()) {
+    NG_RETURN_IF_ERROR(partition(hashKeys, lhsIter_.get(), movable(leftVar()), buildFiles));
+    NG_RETURN_IF_ERROR(partition(probeKeys, rhsIter_.get(), movable(rightVar()), probeFiles));
+  } else {
+    exchange_ = true;
+    NG_RETURN_IF_ERROR(partition(probeKeys, rhsIter_.get(), movable(rightVar()), buildFiles));
+    NG_RETURN_IF_ERROR(partition(hashKeys, lhsIter_.get(), movable(leftVar()), probeFiles));
+  }
+
+  DataSet result;
+  result.colNames = colNames;
+  for (size_t i = 0; i < numPartitions; ++i) {
+    auto& buildFile = buildFiles[i];
+    NG_RETURN_IF_ERROR(buildFile->finish());
+    std::vector<Row> buildRows;
+    // The hash table refers to the rows, so they must not be reallocated
+    buildRows.reserve(buildFile->numRows());
+    std::unordered_map<List, std::vector<const Row*>> hashTable;
+    Row row;
+    while (true) {
+      auto ret = buildFile->next(&row);
+      NG_RETURN_IF_ERROR(ret);
+      if (!ret.value()) {
+        break;
+      }
+      auto key = row.values.front().moveList();
+      row.values.erase(row.values.begin());
+      buildRows.emplace_back(std::move(row));
+      hashTable[std::move(key)].emplace_back(&buildRows.back());
+    }
+    buildFile.reset();
+
+    auto& probeFile = probeFiles[i];
+    NG_RETURN_IF_ERROR(probeFile->finish());
+    while (true) {
+      auto ret = probeFile->next(&row);
+      NG_RETURN_IF_ERROR(ret);
+      if (!ret.value()) {
+        break;
+      }
+      auto key = row.values.front().moveList();
+      row.values.erase(row.values.begin());
+      buildNewRow<List>(hashTable, key, std::move(row), result);
+    }
+    probeFile.reset();
+  }
+  return finish(ResultBuilder().value(Value(std::move(result))).build());
+}
+
+Status InnerJoinExecutor::partition(const std::vector<Expression*>& keys,
+                                    Iterator* iter,
+                                    bool moveRows,
+                                    std::vector<std::unique_ptr<SpillFile>>& files) const {
+  QueryExpressionContext ctx(ectx_);
+  for (; iter->valid(); iter->next()) {
+    List key;
+    key.values.reserve(keys.size());
+    for (auto* col : keys) {
+      key.values.emplace_back(col->eval(ctx(iter)));
+    }
+    auto hash = folly::hash::twang_mix64(std::hash<List>()(key));
+    auto& file = files[hash % files.size()];
+    // The spilled row is the key followed by the values of the row
+    Row row;
+    row.values.reserve(iter->row()->size() + 1);
+    row.values.emplace_back(std::move(key));
+    if (moveRows) {
+      auto values = std::move(iter->moveRow().values);
+      row.values.insert(row.values.end(),
+                        std::make_move_iterator(values.begin()),
+                        std::make_move_iterator(values.end()));
+    } else {
+      const auto& values = iter->row()->values;
+      row.values.insert(row.values.end(), values.begin(), values.end());
+    }
+    NG_RETURN_IF_ERROR(file->append(std::move(row)));
+  }
+  return Status::OK();
+}
+
 template <class T>
 void InnerJoinExecutor::buildNewRow(const std::unordered_map<T, std::vector<const Row*>>& hashTable,
                                     const T& val,
@@ -9,6 +9,8 @@
 namespace nebula {
 namespace graph {
 
+class SpillFile;
+
 class InnerJoinExecutor : public JoinExecutor {
  public:
   InnerJoinExecutor(const PlanNode* node, QueryContext* qctx)
@@ -42,6 +44,20 @@ class InnerJoinExecutor : public JoinExecutor {
 
   folly::Future<Status> singleKeyProbe(Expression* probeKey, Iterator* probeIter);
 
+  // Grace hash join when the build side exceeds the memory budget. Both sides are partitioned by
+  // the hash of the join keys into spill files, and then each pair of partitions is joined in
+  // memory.
+  folly::Future<Status> joinWithSpill(const std::vector<Expression*>& hashKeys,
+                                      const std::vector<Expression*>& probeKeys,
+                                      const std::vector<std::string>& colNames,
+                                      size_t numPartitions);
+
+  // Spill the rows of the iterator along with their keys into the partition files
+  Status partition(const std::vector<Expression*>& keys,
+                   Iterator* iter,
+                   bool moveRows,
+                   std::vector<std::unique_ptr<SpillFile>>& files) const;
+
   template <class T>
   void buildNewRow(const std::unordered_map<T, std::vector<const Row*>>& hashTable,
                    const T& val,
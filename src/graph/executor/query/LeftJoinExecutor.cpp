@@ -129,10 +129,11 @@ folly::Future<Status> LeftJoinExecutor::probe(const std::vector<Expression*>& pr
                                               Iterator* probeIter) {
   auto scatter = [this, probeKeys = probeKeys](
                      size_t begin, size_t end, Iterator* tmpIter) -> StatusOr<DataSet> {
-    std::vector<Expression*> tmpProbeKeys;
-    std::for_each(probeKeys.begin(), probeKeys.end(), [&tmpProbeKeys](auto& e) {
-      tmpProbeKeys.emplace_back(e->clone());
-    });
+    std::vector<ExprClone> tmpProbeKeys;
+    tmpProbeKeys.reserve(probeKeys.size());
+    for (auto* key : probeKeys) {
+      tmpProbeKeys.emplace_back(qctx(), key);
+    }
     DataSet ds;
     QueryExpressionContext ctx(ectx_);
     ds.rows.reserve(end - begin);
@@ -179,7 +180,7 @@ folly::Future<Status> LeftJoinExecutor::probe(const std::vector<Expression*>& pr
 folly::Future<Status> LeftJoinExecutor::singleKeyProbe(Expression* probeKey, Iterator* probeIter) {
   auto scatter = [this, probeKey](
                      size_t begin, size_t end, Iterator* tmpIter) -> StatusOr<DataSet> {
-    auto tmpProbeKey = probeKey->clone();
+    ExprClone tmpProbeKey(qctx(), probeKey);
     DataSet ds;
     QueryExpressionContext ctx(ectx_);
     ds.rows.reserve(end - begin);
@@ -6,6 +6,7 @@
 
 #include "graph/planner/plan/Query.h"
 #include "graph/service/GraphFlags.h"
+#include "graph/util/BatchExprEvaluator.h"
 
 namespace nebula {
 namespace graph {
@@ -58,15 +59,60 @@ folly::Future<Status> ProjectExecutor::execute() {
 
 DataSet ProjectExecutor::handleJob(size_t begin, size_t end, Iterator *iter) {
   auto *project = asNode<Project>(node());
-  auto columns = project->columns()->clone();
+  std::vector<ExprClone> clones;
+  std::vector<Expression *> exprs;
+  clones.reserve(project->columns()->size());
+  exprs.reserve(project->columns()->size());
+  for (auto &col : project->columns()->columns()) {
+    clones.emplace_back(qctx(), col->expr());
+    exprs.emplace_back(clones.back().get());
+  }
   DataSet ds;
   ds.colNames = project->colNames();
   QueryExpressionContext ctx(qctx()->ectx());
   ds.rows.reserve(end - begin);
+  if (FLAGS_enable_vectorized_execution) {
+    // Only the vectorizable columns are evaluated in batch, the others are evaluated row by row
+    // while the evaluator iterates the rows
+    std::vector<Expression *> batchExprs;
+    std::vector<size_t> batchCols, rowCols;
+    for (size_t i = 0; i < exprs.size(); ++i) {
+      if (BatchExprEvaluator::canVectorize(exprs[i])) {
+        batchExprs.emplace_back(exprs[i]);
+        batchCols.emplace_back(i);
+      } else {
+        rowCols.emplace_back(i);
+      }
+    }
+    if (!batchExprs.empty()) {
+      BatchExprEvaluator evaluator(batchExprs);
+      auto evalRow = [&ds, &exprs, &rowCols](QueryExpressionContext &rowCtx) {
+        Row row;
+        row.values.resize(exprs.size());
+        for (auto col : rowCols) {
+          row.values[col] = exprs[col]->eval(rowCtx);
+        }
+        ds.rows.emplace_back(std::move(row));
+      };
+      while (iter->valid() && begin < end) {
+        auto first = ds.rows.size();
+        auto numRows = evaluator.evalBatch(
+            ctx, iter, std::min(end - begin, BatchExprEvaluator::kBatchSize), evalRow);
+        begin += numRows;
+        for (size_t i = 0; i < numRows; ++i) {
+          auto &row = ds.rows[first + i];
+          for (size_t j = 0; j < batchCols.size(); ++j) {
+            row.values[batchCols[j]] = evaluator.result(j).value(i);
+          }
+        }
+      }
+      return ds;
+    }
+  }
   for (; iter->valid() && begin++ < end; iter->next()) {
     Row row;
-    for (auto &col : columns->columns()) {
-      Value val = col->expr()->eval(ctx(iter));
+    for (auto *expr : exprs) {
+      Value val = expr->eval(ctx(iter));
       row.values.emplace_back(std::move(val));
     }
     ds.rows.emplace_back(std::move(row));
@@ -8,6 +8,7 @@
 #include "graph/context/QueryContext.h"
 #include "graph/executor/query/AggregateExecutor.h"
 #include "graph/planner/plan/Query.h"
+#include "graph/service/GraphFlags.h"
 
 namespace nebula {
 namespace graph {
@@ -2177,5 +2178,90 @@ TEST_F(AggregateTest, BitXor) {
     TEST_AGG_4("BIT_XOR", "bit_xor", true)
   }
 }
+
+TEST_F(AggregateTest, MultiJobs) {
+  auto run = [](int32_t maxJobSize, int32_t minBatchSize) {
+    FLAGS_max_job_size = maxJobSize;
+    FLAGS_min_batch_size = minBatchSize;
+    // key = col3
+    // items = col3, collect(col1), sum(col2), count(distinct col2), avg(col1), std(col1),
+    //         max(col2)
+    std::vector<Expression*> groupKeys;
+    std::vector<Expression*> groupItems;
+    auto col3 = InputPropertyExpression::make(pool_, "col3");
+    groupKeys.emplace_back(col3);
+    groupItems.emplace_back(AggregateExpression::make(pool_, "", col3->clone(), false));
+    groupItems.emplace_back(AggregateExpression::make(
+        pool_, "COLLECT", InputPropertyExpression::make(pool_, "col1"), false));
+    groupItems.emplace_back(AggregateExpression::make(
+        pool_, "SUM", InputPropertyExpression::make(pool_, "col2"), false));
+    groupItems.emplace_back(AggregateExpression::make(
+        pool_, "COUNT", InputPropertyExpression::make(pool_, "col2"), true));
+    groupItems.emplace_back(AggregateExpression::make(
+        pool_, "AVG", InputPropertyExpression::make(pool_, "col1"), false));
+    groupItems.emplace_back(AggregateExpression::make(
+        pool_, "STD", InputPropertyExpression::make(pool_, "col1"), false));
+    groupItems.emplace_back(AggregateExpression::make(
+        pool_, "MAX", InputPropertyExpression::make(pool_, "col2"), false));
+    auto* agg = Aggregate::make(qctx_.get(), nullptr, std::move(groupKeys), std::move(groupItems));
+    agg->setInputVar(*input_);
+    agg->setColNames({"col3", "collect", "sum", "count", "avg", "std", "max"});
+
+    auto aggExe = std::make_unique<AggregateExecutor>(agg, qctx_.get());
+    auto status = aggExe->execute().get();
+    EXPECT_TRUE(status.ok());
+    auto& result = qctx_->ectx()->getResult(agg->outputVar());
+    EXPECT_EQ(result.state(), Result::State::kSuccess);
+    DataSet ds = result.value().getDataSet();
+    std::sort(ds.rows.begin(), ds.rows.end(), RowCmp());
+    return ds;
+  };
+
+  auto expected = run(1, 8192);
+  EXPECT_EQ(expected.rowSize(), 4);
+  // The partial results of the jobs are merged in the input order of each group
+  for (auto minBatchSize : {1, 2, 3, 5}) {
+    EXPECT_EQ(run(4, minBatchSize), expected) << "min_batch_size: " << minBatchSize;
+  }
+  FLAGS_max_job_size = 1;
+  FLAGS_min_batch_size = 8192;
+}
+
+TEST_F(AggregateTest, Spill) {
+  auto run = [](bool spill) {
+    FLAGS_enable_spill_to_disk = spill;
+    FLAGS_spill_memory_budget_bytes = 1;
+    // key = col3
+    // items = col3, collect(col1), count(distinct col2)
+    std::vector<Expression*> groupKeys;
+    std::vector<Expression*> groupItems;
+    auto col3 = InputPropertyExpression::make(pool_, "col3");
+    groupKeys.emplace_back(col3);
+    groupItems.emplace_back(AggregateExpression::make(pool_, "", col3->clone(), false));
+    groupItems.emplace_back(AggregateExpression::make(
+        pool_, "COLLECT", InputPropertyExpression::make(pool_, "col1"), false));
+    groupItems.emplace_back(AggregateExpression::make(
+        pool_, "COUNT", InputPropertyExpression::make(pool_, "col2"), true));
+    auto* agg = Aggregate::make(qctx_.get(), nullptr, std::move(groupKeys), std::move(groupItems));
+    agg->setInputVar(*input_);
+    agg->setColNames({"col3", "collect", "count"});
+
+    auto aggExe = std::make_unique<AggregateExecutor>(agg, qctx_.get());
+    auto status = aggExe->execute().get();
+    EXPECT_TRUE(status.ok()) << status;
+    auto& result = qctx_->ectx()->getResult(agg->outputVar());
+    EXPECT_EQ(result.state(), Result::State::kSuccess);
+    DataSet ds = result.value().getDataSet();
+    std::sort(ds.rows.begin(), ds.rows.end(), RowCmp());
+    return ds;
+  };
+
+  auto expected = run(false);
+  EXPECT_EQ(expected.rowSize(), 4);
+  EXPECT_EQ(run(true), expected);
+  FLAGS_enable_spill_to_disk = false;
+  FLAGS_spill_memory_budget_bytes = 1024 * 1024 * 1024;
+}
+
 }  // namespace graph
 }  // namespace nebula
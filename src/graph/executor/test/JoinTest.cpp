@@ -11,6 +11,7 @@
 #include "graph/executor/test/QueryTestBase.h"
 #include "graph/planner/plan/Logic.h"
 #include "graph/planner/plan/Query.h"
+#include "graph/service/GraphFlags.h"
 
 namespace nebula {
 namespace graph {
@@ -330,6 +331,42 @@ TEST_F(JoinTest, InnerJoinEmpty) {
   }
 }
 
+TEST_F(JoinTest, InnerJoinWithSpill) {
+  auto makeJoin = [this]() {
+    // $var1 inner join $var2 on $var2.dst = $var1._vid
+    auto key = VariablePropertyExpression::make(pool_, "var2", "dst");
+    std::vector<Expression*> hashKeys = {key};
+    auto probe = VariablePropertyExpression::make(pool_, "var1", "_vid");
+    std::vector<Expression*> probeKeys = {probe};
+    auto* join = InnerJoin::make(
+        qctx_.get(), nullptr, {"var2", 0}, {"var1", 0}, std::move(hashKeys), std::move(probeKeys));
+    join->setColNames(std::vector<std::string>{"src", "dst", kVid, "tag_prop", "edge_prop", kDst});
+    return join;
+  };
+  auto run = [this](InnerJoin* join, bool spill) {
+    FLAGS_enable_spill_to_disk = spill;
+    FLAGS_spill_memory_budget_bytes = 1;
+    auto joinExe = std::make_unique<InnerJoinExecutor>(join, qctx_.get());
+    auto status = joinExe->execute().get();
+    EXPECT_TRUE(status.ok()) << status;
+    auto& result = qctx_->ectx()->getResult(join->outputVar());
+    EXPECT_EQ(result.state(), Result::State::kSuccess);
+    DataSet ds = result.value().getDataSet();
+    std::sort(ds.rows.begin(), ds.rows.end());
+    return ds;
+  };
+
+  // Both joins read the inputs, so that the rows are not moved by the first one
+  auto* join = makeJoin();
+  auto* spillJoin = makeJoin();
+  auto expected = run(join, false);
+  EXPECT_EQ(expected.rowSize(), 10);
+  // The rows are joined partition by partition
+  EXPECT_EQ(run(spillJoin, true), expected);
+  FLAGS_enable_spill_to_disk = false;
+  FLAGS_spill_memory_budget_bytes = 1024 * 1024 * 1024;
+}
+
 TEST_F(JoinTest, HashLeftJoin) {
   DataSet expected;
   expected.colNames = {"v2", "e2", "v3", "v1", "e1"};
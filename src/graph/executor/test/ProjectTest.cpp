@@ -3,14 +3,17 @@
  * This source code is licensed under Apache 2.0 License.
  */
 
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 
+#include "common/expression/ArithmeticExpression.h"
 #include "common/expression/PropertyExpression.h"
 #include "graph/context/QueryContext.h"
 #include "graph/executor/query/ProjectExecutor.h"
 #include "graph/executor/test/QueryTestBase.h"
 #include "graph/planner/plan/Logic.h"
 #include "graph/planner/plan/Query.h"
+#include "graph/service/GraphFlags.h"
 #include "parser/Clauses.h"
 
 namespace nebula {
@@ -107,6 +110,136 @@ TEST_F(ProjectTest, Project2Col) {
   EXPECT_EQ(result.state(), Result::State::kSuccess);
 }
 
+TEST_F(ProjectTest, VectorizedCols) {
+  // The column of the arithmetic is evaluated in batch, the others are evaluated row by row
+  std::string input = "input_project";
+  auto* pool = qctx_->objPool();
+  auto yieldColumns = pool->makeAndAdd<YieldColumns>();
+  yieldColumns->addColumn(
+      new YieldColumn(VariablePropertyExpression::make(pool, "input_project", "vid"), "vid"));
+  auto* sum = ArithmeticExpression::makeAdd(
+      pool,
+      VariablePropertyExpression::make(pool, "input_project", "vid"),
+      VariablePropertyExpression::make(pool, "input_project", "col2"));
+  yieldColumns->addColumn(new YieldColumn(sum, "sum"));
+  yieldColumns->addColumn(
+      new YieldColumn(VariablePropertyExpression::make(pool, "input_project", "col2"), "num"));
+  auto* project = Project::make(qctx_.get(), start_, yieldColumns);
+  project->setInputVar(input);
+  project->setColNames(std::vector<std::string>{"vid", "sum", "num"});
+
+  DataSet expected;
+  expected.colNames = {"vid", "sum", "num"};
+  for (auto i = 0; i < 10; ++i) {
+    Row row;
+    row.values.emplace_back(i);
+    row.values.emplace_back(2 * i + 1);
+    row.values.emplace_back(i + 1);
+    expected.rows.emplace_back(std::move(row));
+  }
+  for (auto vectorized : {true, false}) {
+    FLAGS_enable_vectorized_execution = vectorized;
+    auto proExe = Executor::create(project, qctx_.get());
+    auto status = proExe->execute().get();
+    EXPECT_TRUE(status.ok());
+    auto& result = qctx_->ectx()->getResult(project->outputVar());
+    EXPECT_EQ(result.value().getDataSet(), expected) << "vectorized: " << vectorized;
+    EXPECT_EQ(result.state(), Result::State::kSuccess);
+  }
+  FLAGS_enable_vectorized_execution = true;
+}
+
+TEST_F(ProjectTest, MultiJobs) {
+  std::string input = "input_project";
+  auto yieldColumns = qctx_->objPool()->makeAndAdd<YieldColumns>();
+  yieldColumns->addColumn(new YieldColumn(
+      VariablePropertyExpression::make(qctx_->objPool(), "input_project", "vid"), "vid"));
+  auto* project = Project::make(qctx_.get(), start_, yieldColumns);
+  project->setInputVar(input);
+  project->setColNames(std::vector<std::string>{"vid"});
+
+  DataSet expected;
+  expected.colNames = {"vid"};
+  for (auto i = 0; i < 10; ++i) {
+    Row row;
+    row.values.emplace_back(i);
+    expected.rows.emplace_back(std::move(row));
+  }
+  // The morsels are gathered in order whatever the jobs claiming them
+  for (auto maxJobSize : {2, 3, 16}) {
+    for (auto minBatchSize : {1, 2, 3}) {
+      FLAGS_max_job_size = maxJobSize;
+      FLAGS_min_batch_size = minBatchSize;
+      auto proExe = Executor::create(project, qctx_.get());
+      auto status = proExe->execute().get();
+      EXPECT_TRUE(status.ok());
+      auto& result = qctx_->ectx()->getResult(project->outputVar());
+      EXPECT_EQ(result.value().getDataSet(), expected)
+          << "max_job_size: " << maxJobSize << ", min_batch_size: " << minBatchSize;
+    }
+  }
+  FLAGS_max_job_size = 1;
+  FLAGS_min_batch_size = 8192;
+}
+
+// Records the arena bound for each morsel of the input run by the jobs, and for the gathering
+class MorselArenaExecutor final : public Executor {
+ public:
+  MorselArenaExecutor(const PlanNode* node, QueryContext* qctx)
+      : Executor("MorselArenaExecutor", node, qctx) {}
+
+  folly::Future<Status> execute() override {
+    auto iter = ectx_->getResult("input_project").iter();
+    auto scatter = [](size_t, size_t, Iterator*) -> ValueArena* { return ValueArena::current(); };
+    auto gather = [this](std::vector<folly::Try<ValueArena*>>&& results) -> Status {
+      gatherArena = ValueArena::current();
+      for (auto& result : results) {
+        arenas.emplace_back(result.value());
+      }
+      return Status::OK();
+    };
+    return runMultiJobs(std::move(scatter), std::move(gather), iter.get());
+  }
+
+  std::vector<ValueArena*> arenas;
+  ValueArena* gatherArena{nullptr};
+};
+
+TEST_F(ProjectTest, MultiJobsInArena) {
+  FLAGS_enable_value_arena = true;
+  FLAGS_max_job_size = 2;
+  FLAGS_min_batch_size = 1;
+  // The jobs are rescheduled to any thread of the pool after each morsel
+  auto pool = std::make_unique<folly::CPUThreadPoolExecutor>(2);
+  auto qctx = std::make_unique<QueryContext>();
+  auto rctx = std::make_unique<RequestContext<ExecutionResponse>>();
+  rctx->setRunner(pool.get());
+  qctx->setRCtx(std::move(rctx));
+  ASSERT_NE(nullptr, qctx->valueArena());
+  DataSet ds;
+  ds.colNames = {"vid"};
+  for (auto i = 0; i < 10; ++i) {
+    Row row;
+    row.values.emplace_back(i);
+    ds.rows.emplace_back(std::move(row));
+  }
+  qctx->symTable()->newVariable("input_project");
+  qctx->ectx()->setResult("input_project", ResultBuilder().value(Value(std::move(ds))).build());
+
+  MorselArenaExecutor exe(StartNode::make(qctx.get()), qctx.get());
+  EXPECT_TRUE(exe.execute().get().ok());
+  // Each of the 2 jobs handles several of the 5 morsels, all of which are run with the arena bound
+  ASSERT_EQ(5, exe.arenas.size());
+  for (auto* arena : exe.arenas) {
+    EXPECT_EQ(qctx->valueArena(), arena);
+  }
+  EXPECT_EQ(qctx->valueArena(), exe.gatherArena);
+  EXPECT_EQ(nullptr, ValueArena::current());
+  FLAGS_enable_value_arena = false;
+  FLAGS_max_job_size = 1;
+  FLAGS_min_batch_size = 8192;
+}
+
 TEST_F(ProjectTest, EmptyInput) {
   std::string input = "empty";
   auto yieldColumns = qctx_->objPool()->makeAndAdd<YieldColumns>();
@@ -0,0 +1,193 @@
+// Copyright (c) 2023 vesoft inc. All rights reserved.
+//
+// This source code is licensed under Apache 2.0 License.
+
+#include <gtest/gtest.h>
+
+#include "graph/context/QueryContext.h"
+#include "graph/executor/algo/SingleShortestPath.h"
+#include "graph/planner/plan/Algo.h"
+#include "graph/planner/plan/Logic.h"
+
+namespace nebula {
+namespace graph {
+
+class SingleShortestPathTest : public testing::Test {
+ protected:
+  static constexpr EdgeType kEdgeType = 1;
+
+  void SetUp() override {
+    qctx_ = std::make_unique<QueryContext>();
+  }
+
+  // Add the edge of the rank, edges of different ranks between two vertices could be added
+  void addEdge(const std::string& src, const std::string& dst, int64_t rank = 0) {
+    outEdges_[src].emplace_back(dst, rank);
+    inEdges_[dst].emplace_back(src, rank);
+  }
+
+  // Search the paths like SingleShortestPath::execute, with the neighbors got from the edges
+  // added instead of the storage. Return the vids of each path.
+  std::vector<std::vector<std::string>> findPath(const std::string& start,
+                                                 const std::string& end,
+                                                 size_t maxStep,
+                                                 bool singleShortest,
+                                                 bool bidirect = false) {
+    auto* node = ShortestPath::make(qctx_.get(), StartNode::make(qctx_.get()), 1, singleShortest);
+    node->setStepRange(MatchStepRange(1, maxStep));
+    SingleShortestPath path(node, qctx_.get(), &stats_);
+
+    path.init({Value(start)}, {Value(end)}, 1);
+    auto& state = path.states_[0];
+    for (size_t stepNum = 1;; ++stepNum) {
+      auto reverse = path.expandRight(0);
+      auto vids = path.takeFrontier(0, reverse);
+      auto iter = neighbors(vids, reverse, bidirect);
+      EXPECT_TRUE(path.doExpand(0, iter.get(), reverse).ok());
+      if (!state.meets.empty()) {
+        // The props of the vertices met at are got from the storage
+        for (auto id : state.meets) {
+          if (state.vertices[id].empty()) {
+            state.vertices[id] = Vertex(state.vids[id], {});
+          }
+        }
+        path.buildPath(0);
+        break;
+      }
+      if (!path.hasNextStep(0, stepNum)) {
+        break;
+      }
+    }
+
+    std::vector<std::vector<std::string>> paths;
+    for (const auto& row : path.resultDs_[0].rows) {
+      std::vector<std::string> vids;
+      vids.emplace_back(row.values[0].getVertex().vid.getStr());
+      for (const auto& step : row.values[1].getList().values) {
+        if (step.isVertex()) {
+          vids.emplace_back(step.getVertex().vid.getStr());
+        }
+      }
+      vids.emplace_back(row.values[2].getVertex().vid.getStr());
+      paths.emplace_back(std::move(vids));
+    }
+    std::sort(paths.begin(), paths.end());
+    return paths;
+  }
+
+  // The response of GetNeighbors, the left side gets the out edges and the right side gets the in
+  // edges, or both of them if bidirect
+  std::unique_ptr<GetNeighborsIter> neighbors(const std::vector<Value>& vids,
+                                              bool reverse,
+                                              bool bidirect) {
+    DataSet ds;
+    ds.colNames = {
+        kVid, "_stats", "_edge:+like:_type:_dst:_rank", "_edge:-like:_type:_dst:_rank", "_expr"};
+    auto edgeList = [](const std::vector<std::pair<std::string, int64_t>>& edges, EdgeType type) {
+      List list;
+      for (const auto& edge : edges) {
+        list.values.emplace_back(List({type, edge.first, edge.second}));
+      }
+      return list;
+    };
+    for (const auto& vid : vids) {
+      Row row;
+      row.values.emplace_back(vid);
+      row.values.emplace_back(Value());
+      const auto& out = outEdges_[vid.getStr()];
+      const auto& in = inEdges_[vid.getStr()];
+      row.values.emplace_back(bidirect || !reverse ? edgeList(out, kEdgeType) : List());
+      row.values.emplace_back(bidirect || reverse ? edgeList(in, -kEdgeType) : List());
+      row.values.emplace_back(Value());
+      ds.rows.emplace_back(std::move(row));
+    }
+    List datasets;
+    datasets.values.emplace_back(std::move(ds));
+    return std::make_unique<GetNeighborsIter>(std::make_shared<Value>(std::move(datasets)));
+  }
+
+  std::unique_ptr<QueryContext> qctx_;
+  std::unordered_map<std::string, std::string> stats_;
+  std::unordered_map<std::string, std::vector<std::pair<std::string, int64_t>>> outEdges_;
+  std::unordered_map<std::string, std::vector<std::pair<std::string, int64_t>>> inEdges_;
+};
+
+using Paths = std::vector<std::vector<std::string>>;
+
+TEST_F(SingleShortestPathTest, EvenSteps) {
+  // a->b->x, a->c->x, a->d->e->x
+  addEdge("a", "b");
+  addEdge("a", "c");
+  addEdge("a", "d");
+  addEdge("b", "x");
+  addEdge("c", "x");
+  addEdge("d", "e");
+  addEdge("e", "x");
+  EXPECT_EQ(findPath("a", "x", 5, false), Paths({{"a", "b", "x"}, {"a", "c", "x"}}));
+  auto paths = findPath("a", "x", 5, true);
+  ASSERT_EQ(paths.size(), 1);
+  EXPECT_EQ(paths[0].size(), 3);
+}
+
+TEST_F(SingleShortestPathTest, OddSteps) {
+  // a->b->d->y, a->c->d->y, a->y is reversed
+  addEdge("a", "b");
+  addEdge("a", "c");
+  addEdge("b", "d");
+  addEdge("c", "d");
+  addEdge("d", "y");
+  addEdge("y", "a");
+  EXPECT_EQ(findPath("a", "y", 5, false), Paths({{"a", "b", "d", "y"}, {"a", "c", "d", "y"}}));
+  auto paths = findPath("a", "y", 5, true);
+  ASSERT_EQ(paths.size(), 1);
+  EXPECT_EQ(paths[0].size(), 4);
+  // The edge reversed is one step away when bidirect
+  EXPECT_EQ(findPath("a", "y", 5, false, true), Paths({{"a", "y"}}));
+}
+
+TEST_F(SingleShortestPathTest, MultiShortestPaths) {
+  // Two edges of different ranks on each step, so 4 shortest paths of the same vids
+  addEdge("a", "b", 0);
+  addEdge("a", "b", 1);
+  addEdge("b", "c", 0);
+  addEdge("b", "c", 1);
+  EXPECT_EQ(findPath("a", "c", 5, false), Paths(4, {"a", "b", "c"}));
+  EXPECT_EQ(findPath("a", "c", 5, true), Paths({{"a", "b", "c"}}));
+}
+
+TEST_F(SingleShortestPathTest, MaxStep) {
+  // a->b->c->d
+  addEdge("a", "b");
+  addEdge("b", "c");
+  addEdge("c", "d");
+  EXPECT_EQ(findPath("a", "d", 2, false), Paths());
+  EXPECT_EQ(findPath("a", "d", 2, true), Paths());
+  EXPECT_EQ(findPath("a", "d", 3, false), Paths({{"a", "b", "c", "d"}}));
+  EXPECT_EQ(findPath("a", "d", 3, true), Paths({{"a", "b", "c", "d"}}));
+  EXPECT_EQ(findPath("a", "e", 5, false), Paths());
+}
+
+TEST_F(SingleShortestPathTest, Cycle) {
+  // a->b->c->a, a->d->a
+  addEdge("a", "b");
+  addEdge("b", "c");
+  addEdge("c", "a");
+  addEdge("a", "d");
+  addEdge("d", "a");
+  EXPECT_EQ(findPath("a", "a", 5, false), Paths({{"a", "d", "a"}}));
+  EXPECT_EQ(findPath("b", "b", 5, true), Paths({{"b", "c", "a", "b"}}));
+  EXPECT_EQ(findPath("b", "b", 2, true), Paths());
+}
+
+TEST_F(SingleShortestPathTest, CycleWithoutSameEdge) {
+  // Two edges between a and b, so going back through the other edge is a cycle when bidirect
+  addEdge("a", "b", 0);
+  addEdge("a", "b", 1);
+  // The paths going back through the same edge are rejected
+  EXPECT_EQ(findPath("a", "a", 5, false, true), Paths(2, {"a", "b", "a"}));
+  // The first way back found goes through the same edge, the other one is taken instead
+  EXPECT_EQ(findPath("a", "a", 5, true, true), Paths({{"a", "b", "a"}}));
+}
+
+}  // namespace graph
+}  // namespace nebula
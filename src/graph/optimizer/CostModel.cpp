@@ -0,0 +1,338 @@
+/* Copyright (c) 2023 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/optimizer/CostModel.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "clients/meta/MetaClient.h"
+#include "graph/context/QueryContext.h"
+#include "graph/planner/plan/PlanNode.h"
+#include "graph/planner/plan/Query.h"
+#include "graph/util/ExpressionUtils.h"
+
+using nebula::graph::PlanNode;
+using nebula::graph::QueryContext;
+
+namespace nebula {
+namespace opt {
+
+namespace {
+
+// Get the constant limit of explore node, return -1 if there is no constant limit
+int64_t constantLimit(const graph::Explore *explore, QueryContext *qctx) {
+  auto *limitExpr = explore->limitExpr();
+  if (limitExpr == nullptr || !graph::ExpressionUtils::isEvaluableExpr(limitExpr, qctx)) {
+    return -1;
+  }
+  return explore->limit(qctx);
+}
+
+double applyLimit(double rows, int64_t limit) {
+  return limit < 0 ? rows : std::min(rows, static_cast<double>(limit));
+}
+
+template <typename Props>
+std::vector<EdgeType> toEdgeTypes(const Props *props) {
+  std::vector<EdgeType> edgeTypes;
+  if (props != nullptr) {
+    for (const auto &prop : *props) {
+      edgeTypes.emplace_back(std::abs(prop.get_type()));
+    }
+  }
+  std::sort(edgeTypes.begin(), edgeTypes.end());
+  edgeTypes.erase(std::unique(edgeTypes.begin(), edgeTypes.end()), edgeTypes.end());
+  return edgeTypes;
+}
+
+template <typename Props>
+std::vector<TagID> toTags(const Props *props) {
+  std::vector<TagID> tags;
+  if (props != nullptr) {
+    for (const auto &prop : *props) {
+      tags.emplace_back(prop.get_tag());
+    }
+  }
+  return tags;
+}
+
+}  // namespace
+
+CostModel::CostModel(QueryContext *qctx) : qctx_(qctx) {}
+
+const meta::cpp2::StatsItem *CostModel::stats(GraphSpaceID space) const {
+  auto iter = stats_.find(space);
+  if (iter != stats_.end()) {
+    return iter->second.get();
+  }
+  std::shared_ptr<const meta::cpp2::StatsItem> item;
+  auto *metaClient = qctx_ != nullptr ? qctx_->getMetaClient() : nullptr;
+  if (metaClient != nullptr) {
+    auto ret = metaClient->getStatsFromCache(space);
+    if (ret.ok()) {
+      item = std::move(ret).value();
+    }
+  }
+  // Cache the missing statistics too to avoid looking up the meta client again
+  return stats_.emplace(space, std::move(item)).first->second.get();
+}
+
+double CostModel::vertexCount(GraphSpaceID space, const std::vector<TagID> &tags) const {
+  auto *item = stats(space);
+  if (item == nullptr) {
+    return kDefaultVertexCount;
+  }
+  double total = std::max<int64_t>(item->get_space_vertices(), 1);
+  if (tags.empty() || qctx_ == nullptr || qctx_->schemaMng() == nullptr) {
+    return total;
+  }
+  double count = 0.0;
+  const auto &tagVertices = item->get_tag_vertices();
+  for (auto tagId : tags) {
+    auto tagName = qctx_->schemaMng()->toTagName(space, tagId);
+    if (!tagName.ok()) {
+      return total;
+    }
+    auto found = tagVertices.find(tagName.value());
+    if (found == tagVertices.end()) {
+      return total;
+    }
+    count += found->second;
+  }
+  // One vertex could have multiple tags
+  return std::max(1.0, std::min(count, total));
+}
+
+double CostModel::edgeCount(GraphSpaceID space, const std::vector<EdgeType> &edgeTypes) const {
+  auto *item = stats(space);
+  if (item == nullptr) {
+    return kDefaultVertexCount * kDefaultDegree;
+  }
+  double total = std::max<int64_t>(item->get_space_edges(), 1);
+  if (edgeTypes.empty() || qctx_ == nullptr || qctx_->schemaMng() == nullptr) {
+    return total;
+  }
+  double count = 0.0;
+  const auto &edges = item->get_edges();
+  for (auto edgeType : edgeTypes) {
+    auto edgeName = qctx_->schemaMng()->toEdgeName(space, edgeType);
+    if (!edgeName.ok()) {
+      return total;
+    }
+    auto found = edges.find(edgeName.value());
+    if (found == edges.end()) {
+      return total;
+    }
+    count += found->second;
+  }
+  return std::max(1.0, count);
+}
+
+double CostModel::avgDegree(GraphSpaceID space, const std::vector<EdgeType> &edgeTypes) const {
+  if (stats(space) == nullptr) {
+    return kDefaultDegree * std::max<size_t>(edgeTypes.size(), 1);
+  }
+  return edgeCount(space, edgeTypes) / vertexCount(space, {});
+}
+
+CostModel::Estimate CostModel::estimateIndexScan(const graph::IndexScan *node) const {
+  double total = node->isEdge() ? edgeCount(node->space(), {node->schemaId()})
+                                : vertexCount(node->space(), {node->schemaId()});
+  double rows = 0.0;
+  const auto &contexts = node->queryContext();
+  for (const auto &ictx : contexts) {
+    double selectivity = 1.0;
+    for (const auto &hint : ictx.get_column_hints()) {
+      selectivity *= hint.get_scan_type() == storage::cpp2::ScanType::PREFIX
+                         ? kPrefixHintSelectivity
+                         : kRangeHintSelectivity;
+    }
+    rows += total * selectivity;
+  }
+  rows = std::min(rows, total);
+  Estimate est;
+  // The rows are read sequentially from the index after one seek per index query context
+  est.cost = rows * kSeqReadRowCost + contexts.size() * kRandomReadCost;
+  for (const auto &ictx : contexts) {
+    if (!ictx.get_filter().empty()) {
+      rows *= kDefaultFilterSelectivity;
+      break;
+    }
+  }
+  est.rows = applyLimit(rows, constantLimit(node, qctx_));
+  return est;
+}
+
+CostModel::Estimate CostModel::estimate(const PlanNode *node,
+                                        const std::vector<Estimate> &deps) const {
+  Estimate est;
+  double inputRows = 1.0;
+  for (const auto &dep : deps) {
+    est.cost += dep.cost;
+  }
+  if (!deps.empty()) {
+    inputRows = deps.front().rows;
+  }
+
+  switch (node->kind()) {
+    case PlanNode::Kind::kStart:
+    case PlanNode::Kind::kArgument: {
+      est.rows = 1.0;
+      break;
+    }
+    case PlanNode::Kind::kScanVertices: {
+      auto *scan = node->asNode<graph::ScanVertices>();
+      double rows = vertexCount(scan->space(), toTags(scan->props()));
+      est.cost += rows * kSeqReadRowCost;
+      est.rows = applyLimit(rows, constantLimit(scan, qctx_));
+      if (scan->filter() != nullptr) {
+        est.rows *= kDefaultFilterSelectivity;
+      }
+      break;
+    }
+    case PlanNode::Kind::kScanEdges: {
+      auto *scan = node->asNode<graph::ScanEdges>();
+      double rows = edgeCount(scan->space(), toEdgeTypes(scan->props()));
+      est.cost += rows * kSeqReadRowCost;
+      est.rows = applyLimit(rows, constantLimit(scan, qctx_));
+      if (scan->filter() != nullptr) {
+        est.rows *= kDefaultFilterSelectivity;
+      }
+      break;
+    }
+    case PlanNode::Kind::kIndexScan:
+    case PlanNode::Kind::kTagIndexFullScan:
+    case PlanNode::Kind::kTagIndexPrefixScan:
+    case PlanNode::Kind::kTagIndexRangeScan:
+    case PlanNode::Kind::kEdgeIndexFullScan:
+    case PlanNode::Kind::kEdgeIndexPrefixScan:
+    case PlanNode::Kind::kEdgeIndexRangeScan: {
+      auto idx = estimateIndexScan(node->asNode<graph::IndexScan>());
+      est.cost += idx.cost;
+      est.rows = idx.rows;
+      break;
+    }
+    case PlanNode::Kind::kGetNeighbors: {
+      auto *gn = node->asNode<graph::GetNeighbors>();
+      // One seek per (vertex, edge type) and then scan the edges of the vertex sequentially
+      auto edgeTypes = toEdgeTypes(gn->edgeProps());
+      double edges = inputRows * avgDegree(gn->space(), edgeTypes);
+      est.cost += inputRows * std::max<size_t>(edgeTypes.size(), 1) * kRandomReadCost +
+                  edges * kSeqReadRowCost;
+      est.rows = applyLimit(edges, constantLimit(gn, qctx_));
+      break;
+    }
+    case PlanNode::Kind::kTraverse: {
+      auto *traverse = node->asNode<graph::Traverse>();
+      double degree = avgDegree(traverse->space(), toEdgeTypes(traverse->edgeProps()));
+      auto range = traverse->stepRange();
+      // Avoid the overflow of the unbounded step range
+      size_t maxSteps = std::min<size_t>(range.max(), 16);
+      double frontier = inputRows;
+      double rows = range.min() == 0 ? inputRows : 0.0;
+      for (size_t step = 1; step <= maxSteps; ++step) {
+        est.cost += frontier * kRandomReadCost;
+        frontier *= degree;
+        est.cost += frontier * kSeqReadRowCost;
+        if (step >= range.min()) {
+          rows += frontier;
+        }
+      }
+      est.rows = std::max(rows, 1.0);
+      break;
+    }
+    case PlanNode::Kind::kExpand:
+    case PlanNode::Kind::kExpandAll: {
+      auto *expand = node->asNode<graph::Expand>();
+      double degree = avgDegree(expand->space(), toEdgeTypes(expand->edgeProps()));
+      double frontier = inputRows;
+      for (size_t step = 0; step < std::max<size_t>(expand->maxSteps(), 1); ++step) {
+        est.cost += frontier * kRandomReadCost;
+        frontier *= degree;
+        est.cost += frontier * kSeqReadRowCost;
+      }
+      est.rows = applyLimit(frontier, constantLimit(expand, qctx_));
+      break;
+    }
+    case PlanNode::Kind::kGetVertices:
+    case PlanNode::Kind::kAppendVertices:
+    case PlanNode::Kind::kGetEdges: {
+      // Point lookup per input row
+      est.cost += inputRows * kRandomReadCost;
+      est.rows = applyLimit(inputRows, constantLimit(node->asNode<graph::Explore>(), qctx_));
+      break;
+    }
+    case PlanNode::Kind::kFilter: {
+      est.cost += inputRows * kCpuRowCost;
+      est.rows = inputRows * kDefaultFilterSelectivity;
+      break;
+    }
+    case PlanNode::Kind::kLimit: {
+      auto *limit = node->asNode<graph::Limit>();
+      est.rows = inputRows;
+      auto *countExpr = limit->countExpr();
+      if (countExpr != nullptr && graph::ExpressionUtils::isEvaluableExpr(countExpr, qctx_)) {
+        est.rows = applyLimit(inputRows, limit->count(qctx_));
+      }
+      est.cost += est.rows * kCpuRowCost;
+      break;
+    }
+    case PlanNode::Kind::kTopN: {
+      auto *topN = node->asNode<graph::TopN>();
+      est.rows = applyLimit(inputRows, topN->offset() + topN->count());
+      est.cost += inputRows * std::log2(std::max(est.rows, 2.0)) * kCpuRowCost;
+      break;
+    }
+    case PlanNode::Kind::kSort: {
+      est.rows = inputRows;
+      est.cost += inputRows * std::log2(std::max(inputRows, 2.0)) * kCpuRowCost;
+      break;
+    }
+    case PlanNode::Kind::kAggregate: {
+      auto *agg = node->asNode<graph::Aggregate>();
+      est.rows = agg->groupKeys().empty() ? 1.0
+                                          : std::max(1.0, inputRows * kDefaultGroupSelectivity);
+      est.cost += inputRows * kCpuRowCost;
+      break;
+    }
+    case PlanNode::Kind::kHashInnerJoin:
+    case PlanNode::Kind::kHashLeftJoin: {
+      DCHECK_EQ(deps.size(), 2U);
+      double left = deps[0].rows;
+      double right = deps[1].rows;
+      // Build the hash table on one side and probe it with the other
+      est.cost += (left + right) * kCpuRowCost;
+      est.rows = node->kind() == PlanNode::Kind::kHashLeftJoin ? left : std::max(left, right);
+      break;
+    }
+    case PlanNode::Kind::kCrossJoin: {
+      est.rows = 1.0;
+      for (const auto &dep : deps) {
+        est.rows *= dep.rows;
+      }
+      est.cost += est.rows * kCpuRowCost;
+      break;
+    }
+    case PlanNode::Kind::kUnion: {
+      est.rows = 0.0;
+      for (const auto &dep : deps) {
+        est.rows += dep.rows;
+      }
+      est.cost += est.rows * kCpuRowCost;
+      break;
+    }
+    default: {
+      // Assume that the other plan nodes process and output every input row once
+      est.rows = inputRows;
+      est.cost += inputRows * kCpuRowCost;
+      break;
+    }
+  }
+  return est;
+}
+
+}  // namespace opt
+}  // namespace nebula
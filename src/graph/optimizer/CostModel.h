@@ -0,0 +1,88 @@
+/* Copyright (c) 2023 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_OPTIMIZER_COSTMODEL_H_
+#define GRAPH_OPTIMIZER_COSTMODEL_H_
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "common/thrift/ThriftTypes.h"
+#include "interface/gen-cpp2/meta_types.h"
+#include "interface/gen-cpp2/storage_types.h"
+
+namespace nebula {
+namespace graph {
+class PlanNode;
+class QueryContext;
+class IndexScan;
+}  // namespace graph
+
+namespace opt {
+
+// CostModel estimates the output cardinality and the cumulative cost of a plan node in the memo of
+// optimizer. The cardinality is derived from the statistics collected by the stats job (cached in
+// meta client by the heartbeat thread of graphd) and falls back to the default estimations when no
+// statistics are available in the current space.
+//
+// The cost is a dimensionless number which is only meaningful when comparing the alternatives in
+// the same OptGroup, so the per row weights below only need to be correct relative to each other.
+class CostModel final {
+ public:
+  struct Estimate {
+    // The estimated number of rows produced by the plan node
+    double rows{1.0};
+    // The cumulative cost of the plan node and all its dependencies
+    double cost{0.0};
+  };
+
+  explicit CostModel(graph::QueryContext *qctx);
+
+  // Estimate the plan node given the estimations of its dependencies, which are in the same order
+  // as the dependencies of the plan node.
+  Estimate estimate(const graph::PlanNode *node, const std::vector<Estimate> &deps) const;
+
+  // Replace the statistics of the space, only for test
+  void setStats(GraphSpaceID space, std::shared_ptr<const meta::cpp2::StatsItem> stats) {
+    stats_[space] = std::move(stats);
+  }
+
+  // Cost weights per row
+  static constexpr double kCpuRowCost = 0.01;
+  static constexpr double kSeqReadRowCost = 1.0;
+  static constexpr double kRandomReadCost = 4.0;
+
+  // Default estimations when the statistics are missing
+  static constexpr double kDefaultVertexCount = 1000000.0;
+  static constexpr double kDefaultDegree = 10.0;
+  static constexpr double kDefaultFilterSelectivity = 0.5;
+  static constexpr double kDefaultGroupSelectivity = 0.1;
+  static constexpr double kPrefixHintSelectivity = 0.1;
+  static constexpr double kRangeHintSelectivity = 0.3;
+
+ private:
+  const meta::cpp2::StatsItem *stats(GraphSpaceID space) const;
+
+  // Number of vertices having any of the tags, count all vertices if tags are empty
+  double vertexCount(GraphSpaceID space, const std::vector<TagID> &tags) const;
+
+  // Number of edges of the edge types, count all edges if edge types are empty
+  double edgeCount(GraphSpaceID space, const std::vector<EdgeType> &edgeTypes) const;
+
+  // Average number of edges of the edge types per vertex
+  double avgDegree(GraphSpaceID space, const std::vector<EdgeType> &edgeTypes) const;
+
+  Estimate estimateIndexScan(const graph::IndexScan *node) const;
+
+  graph::QueryContext *qctx_{nullptr};
+  // Statistics snapshot of spaces, taken once per query to keep the estimation stable
+  mutable std::unordered_map<GraphSpaceID, std::shared_ptr<const meta::cpp2::StatsItem>> stats_;
+};
+
+}  // namespace opt
+}  // namespace nebula
+
+#endif  // GRAPH_OPTIMIZER_COSTMODEL_H_
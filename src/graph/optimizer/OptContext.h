@@ -12,6 +12,7 @@
 #include <unordered_set>
 
 #include "common/cpp/helpers.h"
+#include "graph/optimizer/CostModel.h"
 
 namespace nebula {
 
@@ -48,11 +49,16 @@ class OptContext final : private boost::noncopyable, private cpp::NonMovable {
     changed_ = changed;
   }
 
+  const CostModel *costModel() const {
+    return costModel_.get();
+  }
+
   void addPlanNodeAndOptGroupNode(int64_t planNodeId, const OptGroupNode *optGroupNode);
   const OptGroupNode *findOptGroupNodeByPlanNodeId(int64_t planNodeId) const;
 
  private:
   friend OptGroup;
+  friend OptGroupNode;
   friend Optimizer;
   // A global flag to record whether this iteration caused a change to the plan
   bool changed_{true};
@@ -62,6 +68,9 @@ class OptContext final : private boost::noncopyable, private cpp::NonMovable {
   std::unordered_map<int64_t, const OptGroupNode *> planNodeToOptGroupNodeMap_;
   std::unordered_set<const OptGroup *> visited_;
   std::unordered_map<const OptGroup *, const graph::PlanNode *> group2PlanNodeMap_;
+  std::unique_ptr<CostModel> costModel_;
+  // Estimations of the opt group nodes, only filled after the exploration is done
+  std::unordered_map<const OptGroupNode *, CostModel::Estimate> estimates_;
 };
 
 }  // namespace opt
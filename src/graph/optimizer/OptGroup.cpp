@@ -249,6 +249,10 @@ double OptGroup::getCost() const {
   return findMinCostGroupNode().first;
 }
 
+const CostModel::Estimate &OptGroup::estimate() const {
+  return DCHECK_NOTNULL(findMinCostGroupNode().second)->estimate();
+}
+
 const PlanNode *OptGroup::getPlan() const {
   auto &group2PlanNodeMap = ctx_->group2PlanNodeMap_;
   auto iter = group2PlanNodeMap.find(this);
@@ -317,7 +321,26 @@ Status OptGroupNode::explore(const OptRule *rule) {
 }
 
 double OptGroupNode::getCost() const {
-  return node_->cost();
+  return estimate().cost;
+}
+
+const CostModel::Estimate &OptGroupNode::estimate() const {
+  auto *ctx = group_->ctx();
+  auto iter = ctx->estimates_.find(this);
+  if (iter != ctx->estimates_.end()) {
+    return iter->second;
+  }
+  std::vector<CostModel::Estimate> deps;
+  deps.reserve(dependencies_.size());
+  for (auto *dep : dependencies_) {
+    deps.emplace_back(dep->estimate());
+  }
+  auto est = ctx->costModel()->estimate(node_, deps);
+  for (auto *body : bodies_) {
+    est.cost += body->getCost();
+  }
+  node_->setCost(est.cost);
+  return ctx->estimates_.emplace(this, est).first->second;
 }
 
 const PlanNode *OptGroupNode::getPlan() const {
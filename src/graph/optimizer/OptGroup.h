@@ -8,6 +8,7 @@
 
 #include "common/base/ObjectPool.h"
 #include "common/base/Status.h"
+#include "graph/optimizer/CostModel.h"
 
 namespace nebula {
 namespace graph {
@@ -43,6 +44,8 @@ class OptGroup final {
   Status explore(const OptRule *rule);
   Status exploreUntilMaxRound(const OptRule *rule);
   double getCost() const;
+  // The estimation of the cheapest opt group node in this group
+  const CostModel::Estimate &estimate() const;
   const graph::PlanNode *getPlan() const;
   const std::string &outputVar() const {
     return outputVar_;
@@ -60,6 +63,10 @@ class OptGroup final {
 
   Status validate(const OptRule *rule) const;
 
+  OptContext *ctx() const {
+    return ctx_;
+  }
+
  private:
   friend ObjectPool;
   explicit OptGroup(OptContext *ctx) noexcept;
@@ -130,6 +137,8 @@ class OptGroupNode final {
 
   Status explore(const OptRule *rule);
   double getCost() const;
+  // Estimate the output rows and the cumulative cost of this opt group node by the cost model
+  const CostModel::Estimate &estimate() const;
   const graph::PlanNode *getPlan() const;
 
   // Release the opt group node from its opt group
@@ -0,0 +1,80 @@
+/* Copyright (c) 2023 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "graph/context/QueryContext.h"
+#include "graph/optimizer/CostModel.h"
+#include "graph/planner/plan/Logic.h"
+#include "graph/planner/plan/Query.h"
+
+using nebula::graph::Aggregate;
+using nebula::graph::Filter;
+using nebula::graph::GetNeighbors;
+using nebula::graph::QueryContext;
+using nebula::graph::ScanVertices;
+using nebula::graph::StartNode;
+
+namespace nebula {
+namespace opt {
+
+class CostModelTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    qctx_ = std::make_unique<QueryContext>();
+  }
+
+  std::unique_ptr<QueryContext> qctx_;
+};
+
+TEST_F(CostModelTest, DefaultEstimation) {
+  CostModel costModel(qctx_.get());
+  auto *start = StartNode::make(qctx_.get());
+  auto startEst = costModel.estimate(start, {});
+  EXPECT_EQ(1.0, startEst.rows);
+
+  auto *scan = ScanVertices::make(qctx_.get(), start, 1);
+  auto scanEst = costModel.estimate(scan, {startEst});
+  EXPECT_EQ(CostModel::kDefaultVertexCount, scanEst.rows);
+  EXPECT_GT(scanEst.cost, startEst.cost);
+}
+
+TEST_F(CostModelTest, EstimationWithStats) {
+  CostModel costModel(qctx_.get());
+  auto stats = std::make_shared<meta::cpp2::StatsItem>();
+  stats->space_vertices_ref() = 100;
+  stats->space_edges_ref() = 1000;
+  costModel.setStats(1, stats);
+
+  auto *start = StartNode::make(qctx_.get());
+  auto startEst = costModel.estimate(start, {});
+
+  auto *scan = ScanVertices::make(qctx_.get(), start, 1);
+  auto scanEst = costModel.estimate(scan, {startEst});
+  EXPECT_EQ(100.0, scanEst.rows);
+
+  // Limit of the scan caps the output rows
+  auto *limitedScan = ScanVertices::make(qctx_.get(), start, 1, nullptr, nullptr, false, {}, 10);
+  auto limitedEst = costModel.estimate(limitedScan, {startEst});
+  EXPECT_EQ(10.0, limitedEst.rows);
+
+  // Expand from 10 vertices with the average degree 10
+  auto *gn = GetNeighbors::make(qctx_.get(), limitedScan, 1);
+  auto gnEst = costModel.estimate(gn, {limitedEst});
+  EXPECT_EQ(100.0, gnEst.rows);
+  EXPECT_GT(gnEst.cost, limitedEst.cost);
+
+  auto *filter = Filter::make(qctx_.get(), gn, ConstantExpression::make(qctx_->objPool(), true));
+  auto filterEst = costModel.estimate(filter, {gnEst});
+  EXPECT_EQ(100.0 * CostModel::kDefaultFilterSelectivity, filterEst.rows);
+
+  auto *agg = Aggregate::make(qctx_.get(), filter);
+  auto aggEst = costModel.estimate(agg, {filterEst});
+  EXPECT_EQ(1.0, aggEst.rows);
+  EXPECT_GT(aggEst.cost, filterEst.cost);
+}
+
+}  // namespace opt
+}  // namespace nebula
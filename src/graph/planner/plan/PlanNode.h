@@ -294,6 +294,10 @@ class PlanNode {
     return cost_;
   }
 
+  void setCost(double cost) {
+    cost_ = cost;
+  }
+
   void setLoopLayers(std::size_t c) {
     loopLayers_ = c;
   }
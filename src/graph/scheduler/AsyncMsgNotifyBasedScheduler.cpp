@@ -48,7 +48,7 @@ folly::Future<Status> AsyncMsgNotifyBasedScheduler::doSchedule(Executor* root) c
   std::queue<Executor*> queue2;
   std::unordered_set<Executor*> visited;
 
-  auto* runner = qctx_->rctx()->runner();
+  auto* runner = qctx_->runner();
   folly::Promise<Status> promiseForRoot;
   auto resultFuture = promiseForRoot.getFuture();
   promiseMap[root->id()].emplace_back(std::move(promiseForRoot));
@@ -267,6 +267,7 @@ folly::Future<Status> AsyncMsgNotifyBasedScheduler::runExecute(Executor* executo
     folly::Future<Status> status = Status::OK();
     {
       memory::MemoryCheckGuard guard;
+      ValueArena::Scope arenaScope(qctx_->valueArena());
       status = executor->execute();
     }
     return std::move(status).thenError(folly::tag_t<std::bad_alloc>{}, [](const std::bad_alloc&) {
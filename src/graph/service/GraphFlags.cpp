@@ -83,6 +83,22 @@ DEFINE_bool(enable_experimental_feature, false, "Whether to enable experimental
 DEFINE_bool(enable_data_balance, true, "Whether to enable data balance feature");
 
 DEFINE_int32(num_rows_to_check_memory, 1024, "number rows to check memory");
+DEFINE_int32(max_paged_results_per_session,
+             16,
+             "The max number of the paged results kept by a session, the pages of a result which "
+             "are not fetched yet are kept until they are fetched, released or expired.");
+DEFINE_int32(paged_result_expire_secs,
+             600,
+             "The pages of a result which are not fetched this long after the first page are "
+             "released.");
+DEFINE_int64(max_paged_bytes_per_session,
+             512 * 1024 * 1024,
+             "The max estimated bytes of the pages kept by a session, paging a result fails "
+             "beyond it.");
+DEFINE_int32(plan_cache_capacity,
+             0,
+             "The max number of the optimized plans of the read-only queries to cache, 0 to "
+             "disable the plan cache.");
 DEFINE_int32(max_sessions_per_ip_per_user,
              300,
              "Maximum number of sessions that can be created per IP and per user");
@@ -110,8 +126,24 @@ DEFINE_int32(min_batch_size,
              "The min batch size for handling dataset in multi job mode, only enabled when "
              "max_job_size is greater than 1.");
 DEFINE_int32(max_job_size, 1, "The max job size in multi job mode.");
+DEFINE_bool(enable_vectorized_execution,
+            true,
+            "Whether to evaluate the expressions of Filter, Project and Aggregate in batch.");
+DEFINE_bool(enable_spill_to_disk,
+            false,
+            "Whether to spill the intermediate results of Aggregate and inner HashJoin to disk "
+            "when they exceed the memory budget.");
+DEFINE_int64(spill_memory_budget_bytes,
+             1024 * 1024 * 1024,
+             "The memory budget of the intermediate result of one Aggregate or inner HashJoin of a "
+             "query, which is lowered to the memory left when the memory tracker is near limit.");
+DEFINE_string(spill_tmp_dir, "/tmp", "The directory of the spill files.");
 
 DEFINE_bool(enable_async_gc, false, "If enable async gc.");
+DEFINE_bool(enable_value_arena,
+            false,
+            "Whether to allocate the strings, lists, maps, sets, vertices, edges and paths built "
+            "by the executors of a query from an arena of the query.");
 DEFINE_uint32(
     gc_worker_size,
     0,
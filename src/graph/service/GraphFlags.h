@@ -40,6 +40,10 @@ DECLARE_bool(enable_authorize);
 DECLARE_string(auth_type);
 DECLARE_string(cloud_http_url);
 DECLARE_uint32(max_allowed_statements);
+DECLARE_int32(max_paged_results_per_session);
+DECLARE_int32(paged_result_expire_secs);
+DECLARE_int64(max_paged_bytes_per_session);
+DECLARE_int32(plan_cache_capacity);
 DECLARE_int32(max_sessions_per_ip_per_user);
 
 DECLARE_uint32(max_statements);
@@ -68,8 +72,13 @@ DECLARE_int32(num_rows_to_check_memory);
 
 DECLARE_int32(min_batch_size);
 DECLARE_int32(max_job_size);
+DECLARE_bool(enable_vectorized_execution);
+DECLARE_bool(enable_spill_to_disk);
+DECLARE_int64(spill_memory_budget_bytes);
+DECLARE_string(spill_tmp_dir);
 
 DECLARE_bool(enable_async_gc);
+DECLARE_bool(enable_value_arena);
 DECLARE_uint32(gc_worker_size);
 
 DECLARE_bool(graph_use_vertex_key);
@@ -218,6 +218,88 @@ folly::Future<std::string> GraphService::future_executeJsonWithParameter(
   });
 }
 
+folly::Future<ExecutionResponse> GraphService::future_executeWithPagination(
+    int64_t sessionId,
+    const std::string& query,
+    const std::unordered_map<std::string, Value>& parameterMap,
+    int32_t pageSize) {
+  if (pageSize <= 0) {
+    ExecutionResponse resp;
+    resp.errorCode = ErrorCode::E_EXECUTION_ERROR;
+    resp.errorMsg = std::make_unique<std::string>(
+        folly::stringPrintf("Invalid page size: %d, it should be positive", pageSize));
+    return folly::makeFuture<ExecutionResponse>(std::move(resp));
+  }
+  auto future = future_executeWithParameter(sessionId, query, parameterMap);
+  return std::move(future).thenValue([this, sessionId, pageSize](ExecutionResponse&& resp) {
+    auto count = static_cast<size_t>(pageSize);
+    if (resp.errorCode != ErrorCode::SUCCEEDED || resp.data == nullptr ||
+        resp.data->rowSize() <= count) {
+      return std::move(resp);
+    }
+    auto session = sessionManager_->findSessionFromCache(sessionId);
+    if (session == nullptr) {
+      resp.errorCode = ErrorCode::E_SESSION_INVALID;
+      resp.errorMsg = std::make_unique<std::string>(
+          folly::stringPrintf("SessionId[%ld] does not exist", sessionId));
+      resp.data.reset();
+      return std::move(resp);
+    }
+    // Keep the pages after the first one in the session
+    auto pageToken = session->savePages(resp.data.get(), count);
+    if (!pageToken.ok()) {
+      resp.errorCode = ErrorCode::E_EXECUTION_ERROR;
+      resp.errorMsg = std::make_unique<std::string>(pageToken.status().toString());
+      resp.data.reset();
+      return std::move(resp);
+    }
+    resp.pageToken = std::make_unique<int64_t>(pageToken.value());
+    return std::move(resp);
+  });
+}
+
+folly::Future<ExecutionResponse> GraphService::future_fetchPage(int64_t sessionId,
+                                                                int64_t pageToken,
+                                                                int32_t pageSize) {
+  time::Duration duration;
+  ExecutionResponse resp;
+  auto session = sessionManager_->findSessionFromCache(sessionId);
+  if (session == nullptr) {
+    resp.errorCode = ErrorCode::E_SESSION_INVALID;
+    resp.errorMsg = std::make_unique<std::string>(
+        folly::stringPrintf("SessionId[%ld] does not exist", sessionId));
+    return folly::makeFuture<ExecutionResponse>(std::move(resp));
+  }
+  if (pageSize <= 0) {
+    resp.errorCode = ErrorCode::E_EXECUTION_ERROR;
+    resp.errorMsg = std::make_unique<std::string>(
+        folly::stringPrintf("Invalid page size: %d, it should be positive", pageSize));
+    return folly::makeFuture<ExecutionResponse>(std::move(resp));
+  }
+  session->charge();
+  bool hasMore = false;
+  auto data = session->fetchPage(pageToken, pageSize, &hasMore);
+  if (!data.ok()) {
+    resp.errorCode = ErrorCode::E_EXECUTION_ERROR;
+    resp.errorMsg = std::make_unique<std::string>(data.status().toString());
+  } else {
+    resp.data = std::make_unique<DataSet>(std::move(data).value());
+    if (hasMore) {
+      resp.pageToken = std::make_unique<int64_t>(pageToken);
+    }
+    resp.spaceName = std::make_unique<std::string>(session->space().name);
+  }
+  resp.latencyInUs = duration.elapsedInUSec();
+  return folly::makeFuture<ExecutionResponse>(std::move(resp));
+}
+
+void GraphService::releasePages(int64_t sessionId, int64_t pageToken) {
+  auto session = sessionManager_->findSessionFromCache(sessionId);
+  if (session != nullptr) {
+    session->releasePages(pageToken);
+  }
+}
+
 Status GraphService::auth(const std::string& username, const std::string& password) {
   auto metaClient = queryEngine_->metaClient();
 
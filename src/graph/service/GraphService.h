@@ -48,6 +48,18 @@ class GraphService final : public cpp2::GraphServiceSvIf {
   folly::Future<std::string> future_executeJson(int64_t sessionId,
                                                 const std::string& stmt) override;
 
+  folly::Future<ExecutionResponse> future_executeWithPagination(
+      int64_t sessionId,
+      const std::string& stmt,
+      const std::unordered_map<std::string, Value>& parameterMap,
+      int32_t pageSize) override;
+
+  folly::Future<ExecutionResponse> future_fetchPage(int64_t sessionId,
+                                                    int64_t pageToken,
+                                                    int32_t pageSize) override;
+
+  void releasePages(int64_t sessionId, int64_t pageToken) override;
+
   folly::Future<cpp2::VerifyClientVersionResp> future_verifyClientVersion(
       const cpp2::VerifyClientVersionReq& req) override;
 
@@ -0,0 +1,161 @@
+/* Copyright (c) 2023 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/service/PlanCache.h"
+
+#include "parser/SequentialSentences.h"
+#include "parser/TraverseSentences.h"
+
+namespace nebula {
+namespace graph {
+
+// static
+std::string PlanCache::makeKey(const RequestContext<ExecutionResponse>& rctx) {
+  auto* session = rctx.session();
+  auto spaceId = session->space().id;
+  if (spaceId == kInvalidSpaceID) {
+    return "";
+  }
+  // Different types of the parameters may lead to different plans
+  std::vector<std::string> params;
+  params.reserve(rctx.parameterMap().size());
+  for (const auto& kv : rctx.parameterMap()) {
+    params.emplace_back(folly::stringPrintf(
+        "%s:%d", kv.first.c_str(), static_cast<int32_t>(kv.second.type())));
+  }
+  std::sort(params.begin(), params.end());
+  return folly::stringPrintf("%d\n%s\n%s\n%s",
+                             spaceId,
+                             session->user().c_str(),
+                             folly::join(",", params).c_str(),
+                             normalize(rctx.query()).c_str());
+}
+
+// static
+std::string PlanCache::normalize(folly::StringPiece query) {
+  std::string result;
+  result.reserve(query.size());
+  char quote = '\0';
+  bool space = false;
+  for (size_t i = 0; i < query.size(); ++i) {
+    char c = query[i];
+    if (quote != '\0') {
+      result.push_back(c);
+      if (c == '\\' && quote != '`' && i + 1 < query.size()) {
+        result.push_back(query[++i]);
+      } else if (c == quote) {
+        quote = '\0';
+      }
+      continue;
+    }
+    if (std::isspace(static_cast<unsigned char>(c))) {
+      space = true;
+      continue;
+    }
+    if (space && !result.empty()) {
+      result.push_back(' ');
+    }
+    space = false;
+    if (c == '\'' || c == '"' || c == '`') {
+      quote = c;
+    }
+    result.push_back(c);
+  }
+  return result;
+}
+
+// static
+bool PlanCache::cacheable(const Sentence* sentence) {
+  switch (sentence->kind()) {
+    case Sentence::Kind::kSequential: {
+      auto* seq = static_cast<const SequentialSentences*>(sentence);
+      return seq->numSentences() == 1 && cacheable(seq->sentences().front());
+    }
+    case Sentence::Kind::kPipe: {
+      auto* pipe = static_cast<const PipedSentence*>(sentence);
+      return cacheable(pipe->left()) && cacheable(pipe->right());
+    }
+    case Sentence::Kind::kGo:
+    case Sentence::Kind::kMatch:
+    case Sentence::Kind::kLookup:
+    case Sentence::Kind::kFetchVertices:
+    case Sentence::Kind::kFetchEdges:
+    case Sentence::Kind::kFindPath:
+    case Sentence::Kind::kGetSubgraph:
+    case Sentence::Kind::kYield:
+    case Sentence::Kind::kOrderBy:
+    case Sentence::Kind::kLimit:
+    case Sentence::Kind::kGroupBy:
+    case Sentence::Kind::kUnwind:
+      return true;
+    default:
+      return false;
+  }
+}
+
+std::optional<PlanCache::Prepared> PlanCache::take(
+    const std::string& key, int64_t version, const std::unordered_map<std::string, Value>& params) {
+  std::lock_guard<std::mutex> guard(lock_);
+  auto range = index_.equal_range(key);
+  for (auto it = range.first; it != range.second;) {
+    auto entry = it->second;
+    if (entry->version != version) {
+      // The meta data has been changed since the plan was built
+      it = index_.erase(it);
+      entries_.erase(entry);
+      continue;
+    }
+    if (entry->paramsUsed && entry->params != params) {
+      ++it;
+      continue;
+    }
+    auto prepared = std::move(entry->prepared);
+    index_.erase(it);
+    entries_.erase(entry);
+    return prepared;
+  }
+  return std::nullopt;
+}
+
+void PlanCache::put(std::string key, int64_t version, Prepared prepared) {
+  if (capacity_ == 0) {
+    return;
+  }
+  Entry entry;
+  entry.version = version;
+  entry.paramsUsed = prepared.qctx->parameterUsed();
+  if (entry.paramsUsed) {
+    entry.params = prepared.qctx->rctx()->parameterMap();
+  }
+  prepared.qctx->releaseExecution();
+  entry.prepared = std::move(prepared);
+  entry.key = std::move(key);
+
+  std::lock_guard<std::mutex> guard(lock_);
+  entries_.emplace_front(std::move(entry));
+  index_.emplace(entries_.front().key, entries_.begin());
+  while (entries_.size() > capacity_) {
+    erase(std::prev(entries_.end()));
+  }
+}
+
+size_t PlanCache::size() const {
+  std::lock_guard<std::mutex> guard(lock_);
+  return entries_.size();
+}
+
+void PlanCache::erase(EntryList::iterator it) {
+  auto range = index_.equal_range(it->key);
+  for (auto iter = range.first; iter != range.second; ++iter) {
+    if (iter->second == it) {
+      index_.erase(iter);
+      break;
+    }
+  }
+  entries_.erase(it);
+}
+
+}  // namespace graph
+}  // namespace nebula
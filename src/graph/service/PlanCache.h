@@ -0,0 +1,84 @@
+/* Copyright (c) 2023 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_SERVICE_PLANCACHE_H_
+#define GRAPH_SERVICE_PLANCACHE_H_
+
+#include <boost/core/noncopyable.hpp>
+
+#include "common/base/Base.h"
+#include "common/cpp/helpers.h"
+#include "graph/context/QueryContext.h"
+#include "parser/Sentence.h"
+
+namespace nebula {
+namespace graph {
+
+// PlanCache keeps the optimized plans of the read-only queries, so that the same query executed
+// again skips the parsing, validation and optimization.
+//
+// A plan is bound to the QueryContext which owns its plan nodes, expressions and variables, so the
+// whole context is cached along with the parsing tree. A cached context is taken out by the query
+// executing it exclusively and put back when the execution is done, so the same query executed
+// concurrently builds more contexts, all of which are cached until the capacity is reached.
+//
+// The plans are keyed by the space, the user, the normalized query text and the names and types
+// of the parameters. They're tagged with the version of the meta data they're built with, and
+// the ones built with the stale meta data, e.g. before a schema change, are never reused. If the
+// values of the parameters are used to build the plan, e.g. they're folded into constants, the
+// plan is only reused with the same values.
+class PlanCache final : public boost::noncopyable, public cpp::NonMovable {
+ public:
+  struct Prepared {
+    std::unique_ptr<QueryContext> qctx;
+    std::unique_ptr<Sentence> sentence;
+  };
+
+  explicit PlanCache(size_t capacity) : capacity_(capacity) {}
+
+  // Return an empty key if the query is not cacheable
+  static std::string makeKey(const RequestContext<ExecutionResponse>& rctx);
+
+  // Collapse the whitespaces out of the quoted strings and trim the query
+  static std::string normalize(folly::StringPiece query);
+
+  // Only the single read-only sentence, or the pipe of them, is cacheable
+  static bool cacheable(const Sentence* sentence);
+
+  // Take out a plan built with the meta data of `version`, the stale plans are dropped
+  std::optional<Prepared> take(const std::string& key,
+                               int64_t version,
+                               const std::unordered_map<std::string, Value>& params);
+
+  // Put back the plan after the execution, what the execution holds is released
+  void put(std::string key, int64_t version, Prepared prepared);
+
+  size_t size() const;
+
+ private:
+  struct Entry {
+    std::string key;
+    int64_t version;
+    // Whether the plan is built with the values of the parameters
+    bool paramsUsed{false};
+    std::unordered_map<std::string, Value> params;
+    Prepared prepared;
+  };
+
+  using EntryList = std::list<Entry>;
+
+  void erase(EntryList::iterator it);
+
+  const size_t capacity_;
+  mutable std::mutex lock_;
+  // The most recently used ones are at the front
+  EntryList entries_;
+  std::unordered_multimap<std::string, EntryList::iterator> index_;
+};
+
+}  // namespace graph
+}  // namespace nebula
+
+#endif  // GRAPH_SERVICE_PLANCACHE_H_
@@ -41,19 +41,48 @@ Status QueryEngine::init(std::shared_ptr<folly::IOThreadPoolExecutor> ioExecutor
     rulesets.emplace_back(&opt::RuleSet::QueryRules());
   }
   optimizer_ = std::make_unique<opt::Optimizer>(rulesets);
+  if (FLAGS_plan_cache_capacity > 0) {
+    planCache_ = std::make_unique<PlanCache>(FLAGS_plan_cache_capacity);
+  }
 
   return setupMemoryMonitorThread();
 }
 
-// Create query context and query instance and execute it
+// Create query context and query instance and execute it, the query context is taken from the
+// plan cache if the plan of the query has been cached
 void QueryEngine::execute(RequestContextPtr rctx) {
-  auto qctx = std::make_unique<QueryContext>(std::move(rctx),
-                                             schemaManager_.get(),
-                                             indexManager_.get(),
-                                             storage_.get(),
-                                             metaClient_,
-                                             charsetInfo_);
+  std::string key;
+  int64_t version = 0;
+  std::optional<PlanCache::Prepared> prepared;
+  if (planCache_ != nullptr) {
+    key = PlanCache::makeKey(*rctx);
+    // Take the version before building the plan, so the plan built during a change of the meta
+    // data is treated as a stale one
+    version = metaClient_->localDataLastUpdateTime();
+    if (!key.empty()) {
+      prepared = planCache_->take(key, version, rctx->parameterMap());
+    }
+  }
+
+  std::unique_ptr<QueryContext> qctx;
+  if (prepared) {
+    qctx = std::move(prepared->qctx);
+    qctx->reuse(std::move(rctx));
+  } else {
+    qctx = std::make_unique<QueryContext>(std::move(rctx),
+                                          schemaManager_.get(),
+                                          indexManager_.get(),
+                                          storage_.get(),
+                                          metaClient_,
+                                          charsetInfo_);
+  }
   auto* instance = new QueryInstance(std::move(qctx), optimizer_.get());
+  if (prepared) {
+    instance->setPrepared(std::move(prepared->sentence));
+  }
+  if (!key.empty()) {
+    instance->setPlanCache(planCache_.get(), std::move(key), version);
+  }
   instance->execute();
 }
 
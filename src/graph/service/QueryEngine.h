@@ -18,6 +18,7 @@
 #include "common/meta/SchemaManager.h"
 #include "common/network/NetworkUtils.h"
 #include "graph/optimizer/Optimizer.h"
+#include "graph/service/PlanCache.h"
 #include "graph/service/RequestContext.h"
 #include "interface/gen-cpp2/GraphService.h"
 
@@ -26,8 +27,9 @@ namespace graph {
 
 /**
  * QueryEngine is responsible to create and manage ExecutionPlan.
- * For the time being, we don't have the execution plan cache support,
- * instead we create a plan for each query, and destroy it upon finish.
+ * We create a plan for each query, and destroy it upon finish, except
+ * that the plans of the read-only queries are kept in the plan cache
+ * if `--plan_cache_capacity' is not zero.
  */
 class QueryEngine final : public boost::noncopyable, public cpp::NonMovable {
  public:
@@ -51,6 +53,7 @@ class QueryEngine final : public boost::noncopyable, public cpp::NonMovable {
   std::unique_ptr<meta::IndexManager> indexManager_;
   std::unique_ptr<storage::StorageClient> storage_;
   std::unique_ptr<opt::Optimizer> optimizer_;
+  std::unique_ptr<PlanCache> planCache_;
   std::unique_ptr<thread::GenericWorker> memoryMonitorThread_;
   meta::MetaClient* metaClient_{nullptr};
   CharsetInfo* charsetInfo_{nullptr};
@@ -38,16 +38,20 @@ QueryInstance::QueryInstance(std::unique_ptr<QueryContext> qctx, Optimizer *opti
 
 void QueryInstance::execute() {
   try {
-    Status status = validateAndOptimize();
-    if (!status.ok()) {
-      onError(std::move(status));
-      return;
-    }
+    if (prepared_) {
+      addPlanCacheHitStats();
+    } else {
+      Status status = validateAndOptimize();
+      if (!status.ok()) {
+        onError(std::move(status));
+        return;
+      }
 
-    // Sentence is explain query, finish
-    if (!explainOrContinue()) {
-      onFinish();
-      return;
+      // Sentence is explain query, finish
+      if (!explainOrContinue()) {
+        onFinish();
+        return;
+      }
     }
 
     // The execution engine converts the physical execution plan generated by the Planner into a
@@ -138,6 +142,11 @@ void QueryInstance::onFinish() {
 
   rctx->session()->deleteQuery(qctx_.get());
   scheduler_->waitFinish();
+  if (planCache_ != nullptr && PlanCache::cacheable(sentence_.get())) {
+    planCache_->put(std::move(cacheKey_),
+                    cacheVersion_,
+                    PlanCache::Prepared{std::move(qctx_), std::move(sentence_)});
+  }
   // The `QueryInstance' is the root node holding all resources during the
   // execution. When the whole query process is done, it's safe to release this
   // object, as long as no other contexts have chances to access these resources
@@ -230,6 +239,18 @@ void QueryInstance::addSlowQueryStats(uint64_t latency, const std::string &space
   }
 }
 
+void QueryInstance::addPlanCacheHitStats() const {
+  auto &spaceName = qctx_->rctx()->session()->space().name;
+  stats::StatsManager::addValue(kNumSentences);
+  stats::StatsManager::addValue(kNumPlanCacheHits);
+  if (FLAGS_enable_space_level_metrics && spaceName != "") {
+    stats::StatsManager::addValue(
+        stats::StatsManager::counterWithLabels(kNumSentences, {{"space", spaceName}}));
+    stats::StatsManager::addValue(
+        stats::StatsManager::counterWithLabels(kNumPlanCacheHits, {{"space", spaceName}}));
+  }
+}
+
 // Get result from query context and fill the response
 void QueryInstance::fillRespData(ExecutionResponse *resp) {
   auto ectx = DCHECK_NOTNULL(qctx_->ectx());
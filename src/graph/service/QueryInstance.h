@@ -13,6 +13,7 @@
 #include "graph/context/QueryContext.h"
 #include "graph/optimizer/Optimizer.h"
 #include "graph/scheduler/Scheduler.h"
+#include "graph/service/PlanCache.h"
 #include "parser/GQLParser.h"
 
 /**
@@ -36,6 +37,19 @@ class QueryInstance final : public boost::noncopyable, public cpp::NonMovable {
     return qctx_.get();
   }
 
+  // The context has been prepared by the plan cache, so the validation and optimization are skipped
+  void setPrepared(std::unique_ptr<Sentence> sentence) {
+    sentence_ = std::move(sentence);
+    prepared_ = true;
+  }
+
+  // Put the plan into the cache once the query is finished successfully if it's cacheable
+  void setPlanCache(PlanCache* planCache, std::string key, int64_t version) {
+    planCache_ = planCache;
+    cacheKey_ = std::move(key);
+    cacheVersion_ = version;
+  }
+
  private:
   /**
    * If the whole execution was done, `onFinish' would be invoked.
@@ -55,6 +69,7 @@ class QueryInstance final : public boost::noncopyable, public cpp::NonMovable {
   // Return true if continue to execute
   bool explainOrContinue();
   void addSlowQueryStats(uint64_t latency, const std::string& spaceName) const;
+  void addPlanCacheHitStats() const;
   void fillRespData(ExecutionResponse* resp);
   Status findBestPlan();
 
@@ -62,6 +77,10 @@ class QueryInstance final : public boost::noncopyable, public cpp::NonMovable {
   std::unique_ptr<QueryContext> qctx_;
   std::unique_ptr<Scheduler> scheduler_;
   opt::Optimizer* optimizer_{nullptr};
+  bool prepared_{false};
+  PlanCache* planCache_{nullptr};
+  std::string cacheKey_;
+  int64_t cacheVersion_{0};
 };
 
 }  // namespace graph
@@ -7,11 +7,28 @@
 #include "common/stats/StatsManager.h"
 #include "common/time/WallClock.h"
 #include "graph/context/QueryContext.h"
+#include "graph/service/GraphFlags.h"
 #include "graph/stats/GraphStats.h"
+#include "graph/util/SpillFile.h"
 
 namespace nebula {
 namespace graph {
 
+namespace {
+
+int64_t estimateRows(std::vector<Row>::const_iterator begin, std::vector<Row>::const_iterator end) {
+  size_t bytes = 0;
+  for (auto iter = begin; iter != end; ++iter) {
+    bytes += sizeof(Row);
+    for (const auto& value : iter->values) {
+      bytes += SpillDir::estimateSize(value);
+    }
+  }
+  return static_cast<int64_t>(bytes);
+}
+
+}  // namespace
+
 ClientSession::ClientSession(meta::cpp2::Session&& session, meta::MetaClient* metaClient) {
   session_ = std::move(session);
   metaClient_ = metaClient;
@@ -104,5 +121,107 @@ void ClientSession::markAllQueryKilled() {
         contexts_.size());
   }
 }
+
+ClientSession::~ClientSession() {
+  if (pagedBytes_ > 0) {
+    stats::StatsManager::decValue(kPagedResultBytes, pagedBytes_);
+  }
+}
+
+StatusOr<int64_t> ClientSession::savePages(DataSet* data, size_t pageSize) {
+  auto& rows = data->rows;
+  if (rows.size() <= pageSize) {
+    return kInvalidPageToken;
+  }
+  auto bytes = estimateRows(rows.begin() + pageSize, rows.end());
+
+  folly::RWSpinLock::WriteHolder wHolder(rwSpinLock_);
+  releaseExpiredPagesLocked();
+  if (pagedResults_.size() >= static_cast<size_t>(FLAGS_max_paged_results_per_session)) {
+    return Status::Error("Too many paged results in session %ld, the max is %d",
+                         session_.get_session_id(),
+                         FLAGS_max_paged_results_per_session);
+  }
+  if (pagedBytes_ + bytes > FLAGS_max_paged_bytes_per_session) {
+    return Status::Error(
+        "The pages left of %ld bytes exceed the memory for the pages of session %ld, which "
+        "keeps %ld bytes and the max is %ld bytes, try a larger page size",
+        bytes,
+        session_.get_session_id(),
+        pagedBytes_,
+        FLAGS_max_paged_bytes_per_session);
+  }
+  PagedResult result;
+  result.data.colNames = data->colNames;
+  result.data.rows.insert(result.data.rows.end(),
+                          std::make_move_iterator(rows.begin() + pageSize),
+                          std::make_move_iterator(rows.end()));
+  result.bytes = bytes;
+  rows.resize(pageSize);
+  auto pageToken = nextPageToken_++;
+  pagedResults_.emplace(pageToken, std::move(result));
+  pagedBytes_ += bytes;
+  stats::StatsManager::addValue(kPagedResultBytes, bytes);
+  return pageToken;
+}
+
+StatusOr<DataSet> ClientSession::fetchPage(int64_t pageToken, size_t pageSize, bool* hasMore) {
+  folly::RWSpinLock::WriteHolder wHolder(rwSpinLock_);
+  auto iter = pagedResults_.find(pageToken);
+  if (iter == pagedResults_.end()) {
+    return Status::Error("Page token %ld does not exist, or its pages are released or expired",
+                         pageToken);
+  }
+  auto& result = iter->second;
+  auto& rows = result.data.rows;
+  auto end = std::min(rows.size(), result.offset + pageSize);
+  DataSet ds;
+  ds.colNames = result.data.colNames;
+  ds.rows.reserve(end - result.offset);
+  ds.rows.insert(ds.rows.end(),
+                 std::make_move_iterator(rows.begin() + result.offset),
+                 std::make_move_iterator(rows.begin() + end));
+  result.offset = end;
+  *hasMore = end < rows.size();
+  if (!*hasMore) {
+    erasePagedResult(iter);
+  } else {
+    auto bytes = std::min(estimateRows(ds.rows.begin(), ds.rows.end()), result.bytes);
+    result.bytes -= bytes;
+    pagedBytes_ -= bytes;
+    stats::StatsManager::decValue(kPagedResultBytes, bytes);
+  }
+  return ds;
+}
+
+void ClientSession::releasePages(int64_t pageToken) {
+  folly::RWSpinLock::WriteHolder wHolder(rwSpinLock_);
+  auto iter = pagedResults_.find(pageToken);
+  if (iter != pagedResults_.end()) {
+    erasePagedResult(iter);
+  }
+}
+
+void ClientSession::releaseExpiredPages() {
+  folly::RWSpinLock::WriteHolder wHolder(rwSpinLock_);
+  releaseExpiredPagesLocked();
+}
+
+void ClientSession::erasePagedResult(std::unordered_map<int64_t, PagedResult>::iterator iter) {
+  pagedBytes_ -= iter->second.bytes;
+  stats::StatsManager::decValue(kPagedResultBytes, iter->second.bytes);
+  pagedResults_.erase(iter);
+}
+
+void ClientSession::releaseExpiredPagesLocked() {
+  for (auto iter = pagedResults_.begin(); iter != pagedResults_.end();) {
+    auto cur = iter++;
+    if (cur->second.age.elapsedInSec() >= static_cast<uint64_t>(FLAGS_paged_result_expire_secs)) {
+      VLOG(1) << "Release the expired pages of token " << cur->first << " in session "
+              << session_.get_session_id();
+      erasePagedResult(cur);
+    }
+  }
+}
 }  // namespace graph
 }  // namespace nebula
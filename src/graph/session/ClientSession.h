@@ -6,6 +6,7 @@
 #define GRAPH_SESSION_CLIENTSESSION_H_
 
 #include "clients/meta/MetaClient.h"
+#include "common/datatypes/DataSet.h"
 #include "common/time/Duration.h"
 #include "interface/gen-cpp2/meta_types.h"
 
@@ -16,6 +17,7 @@ class QueryContext;
 
 constexpr int64_t kInvalidSpaceID = -1;
 constexpr int64_t kInvalidSessionID = 0;
+constexpr int64_t kInvalidPageToken = 0;
 
 struct SpaceInfo {
   std::string name;
@@ -160,11 +162,53 @@ class ClientSession final {
   // Marks all queries as killed.
   void markAllQueryKilled();
 
+  // Pages a result which is already built, only the first page is returned and the rest pages
+  // are kept in the session until they are fetched, released or expired.
+  // data: the result, which is truncated to the first page.
+  // pageSize: the max number of rows of a page.
+  // return: the page token, or kInvalidPageToken if the result fits in one page.
+  StatusOr<int64_t> savePages(DataSet* data, size_t pageSize);
+
+  // Moves the next page out of the session. The pages are released once all are fetched.
+  // pageToken: the token returned by savePages().
+  // pageSize: the max number of rows of the page.
+  // hasMore: whether there are pages left.
+  StatusOr<DataSet> fetchPage(int64_t pageToken, size_t pageSize, bool* hasMore);
+
+  // Releases the pages left.
+  void releasePages(int64_t pageToken);
+
+  // Releases the pages saved FLAGS_paged_result_expire_secs ago.
+  void releaseExpiredPages();
+
+  // The estimated bytes of the pages kept by the session.
+  int64_t pagedBytes() const {
+    folly::RWSpinLock::ReadHolder rHolder(rwSpinLock_);
+    return pagedBytes_;
+  }
+
+  ~ClientSession();
+
  private:
   ClientSession() = default;
 
   ClientSession(meta::cpp2::Session&& session, meta::MetaClient* metaClient);
 
+  struct PagedResult {
+    DataSet data;
+    // The rows before it are fetched
+    size_t offset{0};
+    // The estimated bytes of the rows not fetched
+    int64_t bytes{0};
+    // The pages are released FLAGS_paged_result_expire_secs after they are saved, however they
+    // are fetched
+    time::Duration age;
+  };
+
+  void erasePagedResult(std::unordered_map<int64_t, PagedResult>::iterator iter);
+
+  void releaseExpiredPagesLocked();
+
  private:
   SpaceInfo space_;  // The space that the session is using.
   // When the idle time exceeds FLAGS_session_idle_timeout_secs,
@@ -181,6 +225,14 @@ class ClientSession final {
   // An ExecutionPlanID represents a query.
   // A QueryContext also represents a query.
   std::unordered_map<ExecutionPlanID, QueryContext*> contexts_;
+
+  // The pages of the results being fetched by the client, which are released along with the
+  // session.
+  std::unordered_map<int64_t, PagedResult> pagedResults_;
+  int64_t nextPageToken_{1};
+  // The estimated bytes of the pages kept, which are limited by
+  // FLAGS_max_paged_bytes_per_session
+  int64_t pagedBytes_{0};
 };
 
 }  // namespace graph
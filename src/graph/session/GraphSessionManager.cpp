@@ -204,6 +204,7 @@ void GraphSessionManager::reclaimExpiredSessions() {
     int32_t idleSecs = iter.second->idleSeconds();
     VLOG(2) << "SessionId: " << iter.first << ", idleSecs: " << idleSecs;
     if (idleSecs < FLAGS_session_idle_timeout_secs) {
+      iter.second->releaseExpiredPages();
       continue;
     }
     FLOG_INFO("ClientSession %ld has expired", iter.first);
@@ -0,0 +1,150 @@
+/* Copyright (c) 2023 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "graph/service/GraphFlags.h"
+#include "graph/session/ClientSession.h"
+
+namespace nebula {
+namespace graph {
+
+class ClientSessionTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    meta::cpp2::Session session;
+    session.session_id_ref() = 1;
+    session_ = ClientSession::create(std::move(session), nullptr);
+  }
+
+  static DataSet result(int64_t numRows) {
+    DataSet ds({"id", "name"});
+    for (int64_t i = 0; i < numRows; ++i) {
+      ds.emplace_back(Row({i, folly::to<std::string>(i)}));
+    }
+    return ds;
+  }
+
+  std::shared_ptr<ClientSession> session_;
+};
+
+// The way GraphService::future_executeWithPagination returns the first page
+TEST_F(ClientSessionTest, SavePages) {
+  {
+    auto ds = result(3);
+    auto pageToken = session_->savePages(&ds, 3);
+    ASSERT_TRUE(pageToken.ok());
+    EXPECT_EQ(kInvalidPageToken, pageToken.value());
+    EXPECT_EQ(result(3), ds);
+    EXPECT_EQ(0, session_->pagedBytes());
+  }
+  {
+    auto ds = result(10);
+    auto pageToken = session_->savePages(&ds, 4);
+    ASSERT_TRUE(pageToken.ok());
+    EXPECT_NE(kInvalidPageToken, pageToken.value());
+    EXPECT_EQ(result(4), ds);
+    EXPECT_GT(session_->pagedBytes(), 0);
+  }
+}
+
+// The way GraphService::future_fetchPage returns the rest pages
+TEST_F(ClientSessionTest, FetchPage) {
+  auto ds = result(10);
+  auto pageToken = session_->savePages(&ds, 4);
+  ASSERT_TRUE(pageToken.ok());
+  auto bytes = session_->pagedBytes();
+
+  bool hasMore = false;
+  auto fetched = session_->fetchPage(pageToken.value(), 4, &hasMore);
+  ASSERT_TRUE(fetched.ok());
+  EXPECT_TRUE(hasMore);
+  ASSERT_EQ(4, fetched.value().rowSize());
+  EXPECT_EQ(fetched.value().colNames, ds.colNames);
+  EXPECT_EQ(Value(4), fetched.value().rows.front().values[0]);
+  EXPECT_EQ(Value(7), fetched.value().rows.back().values[0]);
+  EXPECT_LT(session_->pagedBytes(), bytes);
+  EXPECT_GT(session_->pagedBytes(), 0);
+
+  fetched = session_->fetchPage(pageToken.value(), 4, &hasMore);
+  ASSERT_TRUE(fetched.ok());
+  EXPECT_FALSE(hasMore);
+  ASSERT_EQ(2, fetched.value().rowSize());
+  EXPECT_EQ(Value(8), fetched.value().rows.front().values[0]);
+  EXPECT_EQ(Value(9), fetched.value().rows.back().values[0]);
+  EXPECT_EQ(0, session_->pagedBytes());
+
+  // The pages are released after the last page is fetched
+  fetched = session_->fetchPage(pageToken.value(), 4, &hasMore);
+  EXPECT_FALSE(fetched.ok());
+}
+
+// The way GraphService::releasePages releases the pages
+TEST_F(ClientSessionTest, ReleasePages) {
+  auto ds = result(10);
+  auto pageToken = session_->savePages(&ds, 4);
+  ASSERT_TRUE(pageToken.ok());
+  session_->releasePages(pageToken.value());
+  EXPECT_EQ(0, session_->pagedBytes());
+  bool hasMore = false;
+  EXPECT_FALSE(session_->fetchPage(pageToken.value(), 4, &hasMore).ok());
+  // Releasing the pages again or the ones which don't exist does nothing
+  session_->releasePages(pageToken.value());
+  session_->releasePages(100);
+}
+
+TEST_F(ClientSessionTest, PagedResultLimits) {
+  {
+    auto maxResults = FLAGS_max_paged_results_per_session;
+    FLAGS_max_paged_results_per_session = 1;
+    auto ds1 = result(10);
+    auto pageToken = session_->savePages(&ds1, 4);
+    ASSERT_TRUE(pageToken.ok());
+    auto ds2 = result(10);
+    EXPECT_FALSE(session_->savePages(&ds2, 4).ok());
+    // A result could be paged after the previous one is released
+    session_->releasePages(pageToken.value());
+    EXPECT_TRUE(session_->savePages(&ds2, 4).ok());
+    FLAGS_max_paged_results_per_session = maxResults;
+  }
+  {
+    auto maxBytes = FLAGS_max_paged_bytes_per_session;
+    FLAGS_max_paged_bytes_per_session = session_->pagedBytes() + 1;
+    auto ds = result(10);
+    EXPECT_FALSE(session_->savePages(&ds, 4).ok());
+    FLAGS_max_paged_bytes_per_session = maxBytes;
+  }
+}
+
+TEST_F(ClientSessionTest, ExpiredPages) {
+  auto expireSecs = FLAGS_paged_result_expire_secs;
+  FLAGS_paged_result_expire_secs = 2;
+  auto ds = result(10);
+  auto pageToken = session_->savePages(&ds, 4);
+  ASSERT_TRUE(pageToken.ok());
+  session_->releaseExpiredPages();
+  bool hasMore = false;
+  ASSERT_TRUE(session_->fetchPage(pageToken.value(), 1, &hasMore).ok());
+
+  // Fetching the pages doesn't put off their expiry
+  sleep(1);
+  ASSERT_TRUE(session_->fetchPage(pageToken.value(), 1, &hasMore).ok());
+  sleep(1);
+  session_->releaseExpiredPages();
+  EXPECT_EQ(0, session_->pagedBytes());
+  EXPECT_FALSE(session_->fetchPage(pageToken.value(), 1, &hasMore).ok());
+  FLAGS_paged_result_expire_secs = expireSecs;
+}
+
+}  // namespace graph
+}  // namespace nebula
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  folly::init(&argc, &argv, true);
+  google::SetStderrLogging(google::INFO);
+
+  return RUN_ALL_TESTS();
+}
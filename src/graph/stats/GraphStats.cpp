@@ -29,6 +29,7 @@ stats::CounterId kNumKilledQueries;
 stats::CounterId kNumQueriesHitMemoryWatermark;
 
 stats::CounterId kOptimizerLatencyUs;
+stats::CounterId kNumPlanCacheHits;
 
 stats::CounterId kNumAggregateExecutors;
 stats::CounterId kNumSortExecutors;
@@ -42,6 +43,7 @@ stats::CounterId kNumAuthFailedSessionsBadUserNamePassword;
 stats::CounterId kNumAuthFailedSessionsOutOfMaxAllowed;
 stats::CounterId kNumActiveSessions;
 stats::CounterId kNumReclaimedExpiredSessions;
+stats::CounterId kPagedResultBytes;
 
 void initGraphStats() {
   kNumQueries = stats::StatsManager::registerStats("num_queries", "rate, sum");
@@ -61,6 +63,7 @@ void initGraphStats() {
 
   kOptimizerLatencyUs = stats::StatsManager::registerHisto(
       "optimizer_latency_us", 1000, 0, 2000, "avg, p75, p95, p99, p999");
+  kNumPlanCacheHits = stats::StatsManager::registerStats("num_plan_cache_hits", "rate, sum");
 
   kNumAggregateExecutors =
       stats::StatsManager::registerStats("num_aggregate_executors", "rate, sum");
@@ -82,6 +85,7 @@ void initGraphStats() {
   kNumActiveSessions = stats::StatsManager::registerStats("num_active_sessions", "sum");
   kNumReclaimedExpiredSessions =
       stats::StatsManager::registerStats("num_reclaimed_expired_sessions", "rate, sum");
+  kPagedResultBytes = stats::StatsManager::registerStats("paged_result_bytes", "sum");
 
   initMetaClientStats();
   initStorageClientStats();
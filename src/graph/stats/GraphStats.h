@@ -29,6 +29,7 @@ extern stats::CounterId kNumKilledQueries;
 extern stats::CounterId kNumQueriesHitMemoryWatermark;
 
 extern stats::CounterId kOptimizerLatencyUs;
+extern stats::CounterId kNumPlanCacheHits;
 
 // Executor
 extern stats::CounterId kNumAggregateExecutors;
@@ -48,6 +49,7 @@ extern stats::CounterId kNumAuthFailedSessionsBadUserNamePassword;
 extern stats::CounterId kNumAuthFailedSessionsOutOfMaxAllowed;
 extern stats::CounterId kNumActiveSessions;
 extern stats::CounterId kNumReclaimedExpiredSessions;
+extern stats::CounterId kPagedResultBytes;
 
 void initGraphStats();
 
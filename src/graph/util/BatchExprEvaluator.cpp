@@ -0,0 +1,606 @@
+/* Copyright (c) 2023 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/util/BatchExprEvaluator.h"
+
+#include "common/expression/ConstantExpression.h"
+#include "common/expression/LogicalExpression.h"
+#include "common/expression/UnaryExpression.h"
+#include "graph/util/ExpressionUtils.h"
+
+namespace nebula {
+namespace graph {
+
+namespace {
+
+using Kind = Expression::Kind;
+
+bool isArithmetic(Kind kind) {
+  switch (kind) {
+    case Kind::kAdd:
+    case Kind::kMinus:
+    case Kind::kMultiply:
+    case Kind::kDivision:
+    case Kind::kMod:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool isRelational(Kind kind) {
+  switch (kind) {
+    case Kind::kRelEQ:
+    case Kind::kRelNE:
+    case Kind::kRelLT:
+    case Kind::kRelLE:
+    case Kind::kRelGT:
+    case Kind::kRelGE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool isLogical(Kind kind) {
+  return kind == Kind::kLogicalAnd || kind == Kind::kLogicalOr || kind == Kind::kLogicalXor;
+}
+
+bool isUnary(Kind kind) {
+  switch (kind) {
+    case Kind::kUnaryPlus:
+    case Kind::kUnaryNegate:
+    case Kind::kUnaryNot:
+    case Kind::kIsNull:
+    case Kind::kIsNotNull:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// The same as ArithmeticExpression::eval
+Value arithmetic(Kind kind, const Value& lhs, const Value& rhs) {
+  switch (kind) {
+    case Kind::kAdd:
+      return lhs + rhs;
+    case Kind::kMinus:
+      return lhs - rhs;
+    case Kind::kMultiply:
+      return lhs * rhs;
+    case Kind::kDivision:
+      return lhs / rhs;
+    case Kind::kMod:
+      return lhs % rhs;
+    default:
+      DLOG(FATAL) << "Unknown type: " << kind;
+      return Value::kNullBadType;
+  }
+}
+
+// The same as RelationalExpression::eval
+Value relational(Kind kind, const Value& lhs, const Value& rhs) {
+  switch (kind) {
+    case Kind::kRelEQ:
+      return lhs.equal(rhs);
+    case Kind::kRelNE:
+      return !lhs.equal(rhs);
+    case Kind::kRelLT:
+      return lhs.lessThan(rhs);
+    case Kind::kRelLE:
+      return lhs.lessThan(rhs) || lhs.equal(rhs);
+    case Kind::kRelGT:
+      return rhs.lessThan(lhs);
+    case Kind::kRelGE:
+      return rhs.lessThan(lhs) || lhs.equal(rhs);
+    default:
+      DLOG(FATAL) << "Unknown type: " << kind;
+      return Value::kNullBadType;
+  }
+}
+
+// The same as UnaryExpression::eval
+Value unary(Kind kind, const Value& operand) {
+  switch (kind) {
+    case Kind::kUnaryPlus:
+      return operand;
+    case Kind::kUnaryNegate:
+      return -operand;
+    case Kind::kUnaryNot:
+      return !operand;
+    case Kind::kIsNull:
+      return operand.isNull();
+    case Kind::kIsNotNull:
+      return !operand.isNull();
+    default:
+      DLOG(FATAL) << "Unknown type: " << kind;
+      return Value::kNullBadType;
+  }
+}
+
+// The same as LogicalExpression::evalAnd and LogicalExpression::evalOr, `shortCircuit` is false
+// for AND and true for OR
+Value andOr(bool shortCircuit, const std::vector<const ColumnVector*>& operands, size_t row) {
+  Value result = !shortCircuit;
+  for (auto* operand : operands) {
+    auto value = operand->value(row);
+    if (value.isBadNull() || (value.isImplicitBool() && value.implicitBool() == shortCircuit)) {
+      return value;
+    }
+    if (!value.isImplicitBool()) {
+      if (value.isNull()) {
+        result = value;
+      } else if (value.empty() && !result.isNull()) {
+        result = value;
+      } else {
+        return Value::kNullBadType;
+      }
+    }
+  }
+  return result;
+}
+
+// The same as LogicalExpression::evalXor
+Value exclusiveOr(const std::vector<const ColumnVector*>& operands, size_t row) {
+  Value result;
+  bool hasEmpty = false;
+  bool firstBool = true;
+  for (auto* operand : operands) {
+    auto value = operand->value(row);
+    if (value.isNull()) {
+      return value;
+    }
+    if (!value.isImplicitBool()) {
+      if (value.empty()) {
+        result = value;
+        hasEmpty = true;
+        continue;
+      }
+      return Value::kNullBadType;
+    }
+    if (hasEmpty) continue;
+    if (firstBool) {
+      result = static_cast<bool>(value.implicitBool());
+      firstBool = false;
+    } else {
+      result = static_cast<bool>(result.implicitBool() ^ value.implicitBool());
+    }
+  }
+  return result;
+}
+
+// Integer kernel, return false if any row overflows or is divided by zero, in which case the
+// result is a special NULL and the caller should fall back to the tagged values.
+bool intArithmetic(Kind kind, const ColumnVector& lhs, const ColumnVector& rhs, ColumnVector* out) {
+  const auto& a = lhs.ints();
+  const auto& b = rhs.ints();
+  auto& c = out->ints();
+  auto size = out->size();
+  bool overflow = false;
+  switch (kind) {
+    case Kind::kAdd: {
+      for (size_t i = 0; i < size; ++i) {
+        overflow |= __builtin_add_overflow(a[i], b[i], &c[i]);
+      }
+      break;
+    }
+    case Kind::kMinus: {
+      for (size_t i = 0; i < size; ++i) {
+        overflow |= __builtin_sub_overflow(a[i], b[i], &c[i]);
+      }
+      break;
+    }
+    case Kind::kMultiply: {
+      for (size_t i = 0; i < size; ++i) {
+        overflow |= __builtin_mul_overflow(a[i], b[i], &c[i]);
+      }
+      break;
+    }
+    case Kind::kDivision:
+    case Kind::kMod: {
+      // The slots of NULL rows are zero, skip them
+      for (size_t i = 0; i < size; ++i) {
+        if (out->isNull(i)) {
+          continue;
+        }
+        if (b[i] == 0 || (b[i] == -1 && a[i] == INT64_MIN)) {
+          return false;
+        }
+        c[i] = kind == Kind::kDivision ? a[i] / b[i] : a[i] % b[i];
+      }
+      break;
+    }
+    default: {
+      return false;
+    }
+  }
+  return !overflow;
+}
+
+void floatArithmetic(Kind kind,
+                     const ColumnVector& lhs,
+                     const ColumnVector& rhs,
+                     ColumnVector* out) {
+  auto& c = out->floats();
+  auto size = out->size();
+  switch (kind) {
+    case Kind::kAdd: {
+      for (size_t i = 0; i < size; ++i) {
+        c[i] = lhs.numeric(i) + rhs.numeric(i);
+      }
+      break;
+    }
+    case Kind::kMinus: {
+      for (size_t i = 0; i < size; ++i) {
+        c[i] = lhs.numeric(i) - rhs.numeric(i);
+      }
+      break;
+    }
+    case Kind::kMultiply: {
+      for (size_t i = 0; i < size; ++i) {
+        c[i] = lhs.numeric(i) * rhs.numeric(i);
+      }
+      break;
+    }
+    case Kind::kDivision: {
+      for (size_t i = 0; i < size; ++i) {
+        c[i] = lhs.numeric(i) / rhs.numeric(i);
+      }
+      break;
+    }
+    case Kind::kMod: {
+      for (size_t i = 0; i < size; ++i) {
+        c[i] = std::fmod(lhs.numeric(i), rhs.numeric(i));
+      }
+      break;
+    }
+    default: {
+      DLOG(FATAL) << "Unknown type: " << kind;
+    }
+  }
+}
+
+ColumnVector arithmeticColumn(Kind kind, const ColumnVector& lhs, const ColumnVector& rhs) {
+  auto size = lhs.size();
+  if (lhs.isNumeric() && rhs.isNumeric()) {
+    if (lhs.type() == ColumnVector::Type::kInt && rhs.type() == ColumnVector::Type::kInt) {
+      auto out = ColumnVector::makeInts(size);
+      out.unionNulls(lhs, rhs);
+      if (intArithmetic(kind, lhs, rhs, &out)) {
+        return out;
+      }
+    } else {
+      auto out = ColumnVector::makeFloats(size);
+      out.unionNulls(lhs, rhs);
+      floatArithmetic(kind, lhs, rhs, &out);
+      return out;
+    }
+  }
+  auto out = ColumnVector::makeValues(size);
+  auto& values = out.values();
+  for (size_t i = 0; i < size; ++i) {
+    values[i] = arithmetic(kind, lhs.value(i), rhs.value(i));
+  }
+  return out;
+}
+
+template <typename T, typename Cmp>
+void compareLoop(const T& a, const T& b, Cmp cmp, std::vector<uint8_t>* out) {
+  for (size_t i = 0; i < out->size(); ++i) {
+    (*out)[i] = cmp(a[i], b[i]);
+  }
+}
+
+template <typename T>
+bool typedCompare(Kind kind, const T& a, const T& b, std::vector<uint8_t>* out) {
+  switch (kind) {
+    case Kind::kRelEQ:
+      compareLoop(a, b, [](auto x, auto y) { return x == y; }, out);
+      return true;
+    case Kind::kRelNE:
+      compareLoop(a, b, [](auto x, auto y) { return x != y; }, out);
+      return true;
+    case Kind::kRelLT:
+      compareLoop(a, b, [](auto x, auto y) { return x < y; }, out);
+      return true;
+    case Kind::kRelLE:
+      compareLoop(a, b, [](auto x, auto y) { return x <= y; }, out);
+      return true;
+    case Kind::kRelGT:
+      compareLoop(a, b, [](auto x, auto y) { return x > y; }, out);
+      return true;
+    case Kind::kRelGE:
+      compareLoop(a, b, [](auto x, auto y) { return x >= y; }, out);
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Compare the numbers with the tolerance as Value::equal and Value::lessThan do for floats
+bool floatCompare(Kind kind, const ColumnVector& lhs, const ColumnVector& rhs, ColumnVector* out) {
+  auto& c = out->bools();
+  for (size_t i = 0; i < out->size(); ++i) {
+    double a = lhs.numeric(i);
+    double b = rhs.numeric(i);
+    bool eq = std::abs(a - b) < kEpsilon;
+    switch (kind) {
+      case Kind::kRelEQ:
+        c[i] = eq;
+        break;
+      case Kind::kRelNE:
+        c[i] = !eq;
+        break;
+      case Kind::kRelLT:
+        c[i] = !eq && a < b;
+        break;
+      case Kind::kRelLE:
+        c[i] = eq || a < b;
+        break;
+      case Kind::kRelGT:
+        c[i] = !eq && a > b;
+        break;
+      case Kind::kRelGE:
+        c[i] = eq || a > b;
+        break;
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+ColumnVector relationalColumn(Kind kind, const ColumnVector& lhs, const ColumnVector& rhs) {
+  auto size = lhs.size();
+  bool sameTyped = lhs.isTyped() && lhs.type() == rhs.type();
+  if (sameTyped || (lhs.isNumeric() && rhs.isNumeric())) {
+    auto out = ColumnVector::makeBools(size);
+    out.unionNulls(lhs, rhs);
+    bool done = false;
+    if (lhs.type() == ColumnVector::Type::kInt && rhs.type() == ColumnVector::Type::kInt) {
+      done = typedCompare(kind, lhs.ints(), rhs.ints(), &out.bools());
+    } else if (lhs.type() == ColumnVector::Type::kBool) {
+      done = typedCompare(kind, lhs.bools(), rhs.bools(), &out.bools());
+    } else {
+      done = floatCompare(kind, lhs, rhs, &out);
+    }
+    if (done) {
+      return out;
+    }
+  }
+  auto out = ColumnVector::makeValues(size);
+  auto& values = out.values();
+  for (size_t i = 0; i < size; ++i) {
+    values[i] = relational(kind, lhs.value(i), rhs.value(i));
+  }
+  return out;
+}
+
+ColumnVector logicalColumn(Kind kind, const std::vector<const ColumnVector*>& operands) {
+  DCHECK(!operands.empty());
+  auto size = operands.front()->size();
+  bool allBools = std::all_of(operands.begin(), operands.end(), [](auto* col) {
+    return col->type() == ColumnVector::Type::kBool;
+  });
+  if (allBools) {
+    auto out = ColumnVector::makeBools(size);
+    auto& c = out.bools();
+    for (size_t i = 0; i < size; ++i) {
+      bool hasNull = false;
+      bool result = kind == Kind::kLogicalAnd;
+      bool decided = false;
+      for (auto* operand : operands) {
+        if (operand->isNull(i)) {
+          hasNull = true;
+          if (kind == Kind::kLogicalXor) {
+            break;
+          }
+          continue;
+        }
+        bool b = operand->bools()[i];
+        if (kind == Kind::kLogicalXor) {
+          result ^= b;
+        } else if (b != result) {
+          // false for AND, true for OR
+          result = b;
+          decided = true;
+          break;
+        }
+      }
+      if (hasNull && !decided) {
+        out.setNull(i);
+      } else {
+        c[i] = result;
+      }
+    }
+    return out;
+  }
+  auto out = ColumnVector::makeValues(size);
+  auto& values = out.values();
+  for (size_t i = 0; i < size; ++i) {
+    values[i] = kind == Kind::kLogicalXor ? exclusiveOr(operands, i)
+                                          : andOr(kind == Kind::kLogicalOr, operands, i);
+  }
+  return out;
+}
+
+ColumnVector unaryColumn(Kind kind, const ColumnVector& operand) {
+  auto size = operand.size();
+  switch (kind) {
+    case Kind::kIsNull:
+    case Kind::kIsNotNull: {
+      if (!operand.isTyped()) {
+        break;
+      }
+      auto out = ColumnVector::makeBools(size);
+      for (size_t i = 0; i < size; ++i) {
+        out.bools()[i] = operand.isNull(i) == (kind == Kind::kIsNull);
+      }
+      return out;
+    }
+    case Kind::kUnaryNot: {
+      if (operand.type() != ColumnVector::Type::kBool) {
+        break;
+      }
+      auto out = ColumnVector::makeBools(size);
+      out.unionNulls(operand, operand);
+      for (size_t i = 0; i < size; ++i) {
+        out.bools()[i] = !operand.bools()[i];
+      }
+      return out;
+    }
+    case Kind::kUnaryNegate: {
+      if (operand.type() == ColumnVector::Type::kFloat) {
+        auto out = ColumnVector::makeFloats(size);
+        out.unionNulls(operand, operand);
+        for (size_t i = 0; i < size; ++i) {
+          out.floats()[i] = -operand.floats()[i];
+        }
+        return out;
+      }
+      if (operand.type() == ColumnVector::Type::kInt) {
+        const auto& a = operand.ints();
+        if (std::find(a.begin(), a.end(), INT64_MIN) != a.end()) {
+          // Overflow
+          break;
+        }
+        auto out = ColumnVector::makeInts(size);
+        out.unionNulls(operand, operand);
+        for (size_t i = 0; i < size; ++i) {
+          out.ints()[i] = -a[i];
+        }
+        return out;
+      }
+      break;
+    }
+    default: {
+      break;
+    }
+  }
+  auto out = ColumnVector::makeValues(size);
+  auto& values = out.values();
+  for (size_t i = 0; i < size; ++i) {
+    values[i] = unary(kind, operand.value(i));
+  }
+  return out;
+}
+
+}  // namespace
+
+BatchExprEvaluator::BatchExprEvaluator(const std::vector<Expression*>& exprs) {
+  roots_.reserve(exprs.size());
+  for (auto* expr : exprs) {
+    roots_.emplace_back(compile(DCHECK_NOTNULL(expr)));
+  }
+  slots_.resize(ops_.size());
+}
+
+// static
+bool BatchExprEvaluator::canVectorize(const Expression* expr) {
+  if (expr == nullptr) {
+    return false;
+  }
+  auto kind = expr->kind();
+  if (!isArithmetic(kind) && !isRelational(kind) && !isLogical(kind) && !isUnary(kind)) {
+    return false;
+  }
+  // The operands of logical operators are evaluated eagerly in batch
+  return !ExpressionUtils::hasAny(expr, {Kind::kUnaryIncr, Kind::kUnaryDecr, Kind::kAggregate});
+}
+
+size_t BatchExprEvaluator::compile(Expression* expr) {
+  Op op;
+  op.expr = expr;
+  auto kind = expr->kind();
+  if (kind == Kind::kConstant) {
+    op.type = OpType::kConstant;
+  } else if (isArithmetic(kind) || isRelational(kind)) {
+    auto* binary = static_cast<BinaryExpression*>(expr);
+    op.type = isArithmetic(kind) ? OpType::kArithmetic : OpType::kRelational;
+    op.inputs.emplace_back(compile(binary->left()));
+    op.inputs.emplace_back(compile(binary->right()));
+  } else if (isLogical(kind) && !static_cast<LogicalExpression*>(expr)->operands().empty()) {
+    op.type = OpType::kLogical;
+    for (auto* operand : static_cast<LogicalExpression*>(expr)->operands()) {
+      op.inputs.emplace_back(compile(operand));
+    }
+  } else if (isUnary(kind)) {
+    op.type = OpType::kUnary;
+    op.inputs.emplace_back(compile(static_cast<UnaryExpression*>(expr)->operand()));
+  } else {
+    op.type = OpType::kLeaf;
+    leaves_.emplace_back(ops_.size());
+  }
+  ops_.emplace_back(std::move(op));
+  return ops_.size() - 1;
+}
+
+size_t BatchExprEvaluator::evalBatch(QueryExpressionContext& ctx,
+                                     Iterator* iter,
+                                     size_t maxRows,
+                                     const std::function<void(QueryExpressionContext&)>& onRow) {
+  rows_.clear();
+  std::vector<std::vector<Value>> leafValues(leaves_.size());
+  for (auto& values : leafValues) {
+    values.reserve(std::min(maxRows, iter->size()));
+  }
+  size_t numRows = 0;
+  for (; numRows < maxRows && iter->valid(); ++numRows, iter->next()) {
+    // The default iterator holds a single value rather than rows
+    rows_.emplace_back(iter->isDefaultIter() ? nullptr : iter->row());
+    auto& ectx = ctx(iter);
+    for (size_t i = 0; i < leaves_.size(); ++i) {
+      leafValues[i].emplace_back(ops_[leaves_[i]].expr->eval(ectx));
+    }
+    if (onRow) {
+      onRow(ectx);
+    }
+  }
+
+  for (size_t i = 0; i < leaves_.size(); ++i) {
+    slots_[leaves_[i]] = ColumnVector::fromValues(std::move(leafValues[i]));
+  }
+  // The ops are in post order, so the inputs are always ready
+  for (size_t i = 0; i < ops_.size(); ++i) {
+    if (ops_[i].type != OpType::kLeaf) {
+      slots_[i] = execute(ops_[i], numRows);
+    }
+  }
+  return numRows;
+}
+
+ColumnVector BatchExprEvaluator::execute(const Op& op, size_t numRows) const {
+  auto kind = op.expr->kind();
+  switch (op.type) {
+    case OpType::kConstant: {
+      return ColumnVector::broadcast(static_cast<ConstantExpression*>(op.expr)->value(), numRows);
+    }
+    case OpType::kArithmetic: {
+      return arithmeticColumn(kind, slots_[op.inputs[0]], slots_[op.inputs[1]]);
+    }
+    case OpType::kRelational: {
+      return relationalColumn(kind, slots_[op.inputs[0]], slots_[op.inputs[1]]);
+    }
+    case OpType::kLogical: {
+      std::vector<const ColumnVector*> operands;
+      operands.reserve(op.inputs.size());
+      for (auto input : op.inputs) {
+        operands.emplace_back(&slots_[input]);
+      }
+      return logicalColumn(kind, operands);
+    }
+    case OpType::kUnary: {
+      return unaryColumn(kind, slots_[op.inputs[0]]);
+    }
+    case OpType::kLeaf: {
+      break;
+    }
+  }
+  DLOG(FATAL) << "Unexpected op of expression: " << op.expr->toString();
+  return ColumnVector::makeValues(numRows);
+}
+
+}  // namespace graph
+}  // namespace nebula
@@ -0,0 +1,90 @@
+/* Copyright (c) 2023 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_UTIL_BATCHEXPREVALUATOR_H_
+#define GRAPH_UTIL_BATCHEXPREVALUATOR_H_
+
+#include "common/expression/Expression.h"
+#include "graph/context/Iterator.h"
+#include "graph/context/QueryExpressionContext.h"
+#include "graph/util/ColumnVector.h"
+
+namespace nebula {
+namespace graph {
+
+// BatchExprEvaluator evaluates expressions over a batch of rows at a time.
+//
+// The arithmetic, relational, logical and some unary operators on top of the expression tree are
+// lowered into a program of column kernels, which loop over the typed ColumnVectors of a batch.
+// The other sub-expressions, e.g. property accesses and function calls, become the leaves of the
+// program and are still evaluated row by row with the tree interpreter. So any expression could be
+// evaluated by this class, and an expression without vectorizable operators degrades to the tree
+// interpreter.
+//
+// The result of each row is always the same as `Expression::eval`, except that the operands of the
+// logical operators are evaluated without short circuit, so the expressions with side effects are
+// never vectorized, see `canVectorize`.
+class BatchExprEvaluator final {
+ public:
+  static constexpr size_t kBatchSize = 1024;
+
+  explicit BatchExprEvaluator(const std::vector<Expression*>& exprs);
+
+  // Whether it's worthwhile to evaluate the expression in batch
+  static bool canVectorize(const Expression* expr);
+
+  // Evaluate all expressions on at most `maxRows` rows starting from the current position of the
+  // iterator, and move the iterator forward. Return the number of evaluated rows.
+  //
+  // `onRow` is called at each row before the iterator moves, so that the caller could evaluate
+  // the expressions not worth vectorizing in the same pass.
+  size_t evalBatch(QueryExpressionContext& ctx,
+                   Iterator* iter,
+                   size_t maxRows = kBatchSize,
+                   const std::function<void(QueryExpressionContext&)>& onRow = nullptr);
+
+  // The result of the idx-th expression in the last batch
+  const ColumnVector& result(size_t idx) const {
+    DCHECK_LT(idx, roots_.size());
+    return slots_[roots_[idx]];
+  }
+
+  // The rows of the last batch
+  const std::vector<const Row*>& rows() const {
+    return rows_;
+  }
+
+ private:
+  enum class OpType : uint8_t {
+    kLeaf,
+    kConstant,
+    kArithmetic,
+    kRelational,
+    kLogical,
+    kUnary,
+  };
+
+  struct Op {
+    OpType type;
+    Expression* expr;
+    std::vector<size_t> inputs;
+  };
+
+  // Append the ops of the expression in post order, return the index of the op of the root
+  size_t compile(Expression* expr);
+
+  ColumnVector execute(const Op& op, size_t numRows) const;
+
+  std::vector<Op> ops_;
+  std::vector<size_t> roots_;
+  std::vector<size_t> leaves_;
+  std::vector<ColumnVector> slots_;
+  std::vector<const Row*> rows_;
+};
+
+}  // namespace graph
+}  // namespace nebula
+
+#endif  // GRAPH_UTIL_BATCHEXPREVALUATOR_H_
@@ -0,0 +1,186 @@
+/* Copyright (c) 2023 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/util/ColumnVector.h"
+
+namespace nebula {
+namespace graph {
+
+namespace {
+
+bool isPlainNull(const Value& v) {
+  return v.isNull() && v.getNull() == NullType::__NULL__;
+}
+
+}  // namespace
+
+// static
+ColumnVector ColumnVector::fromValues(std::vector<Value>&& values) {
+  // Find the common type of the non-null values
+  Value::Type type = Value::Type::__EMPTY__;
+  bool typed = true;
+  for (const auto& v : values) {
+    if (isPlainNull(v)) {
+      continue;
+    }
+    auto t = v.type();
+    if ((t != Value::Type::INT && t != Value::Type::FLOAT && t != Value::Type::BOOL) ||
+        (type != Value::Type::__EMPTY__ && type != t)) {
+      typed = false;
+      break;
+    }
+    type = t;
+  }
+
+  // The column with all NULLs keeps the tagged layout
+  if (!typed || type == Value::Type::__EMPTY__) {
+    ColumnVector col;
+    col.type_ = Type::kValue;
+    col.size_ = values.size();
+    col.values_ = std::move(values);
+    return col;
+  }
+
+  auto size = values.size();
+  ColumnVector col;
+  switch (type) {
+    case Value::Type::INT: {
+      col = makeInts(size);
+      for (size_t i = 0; i < size; ++i) {
+        if (values[i].isInt()) {
+          col.ints_[i] = values[i].getInt();
+        } else {
+          col.setNull(i);
+        }
+      }
+      break;
+    }
+    case Value::Type::FLOAT: {
+      col = makeFloats(size);
+      for (size_t i = 0; i < size; ++i) {
+        if (values[i].isFloat()) {
+          col.floats_[i] = values[i].getFloat();
+        } else {
+          col.setNull(i);
+        }
+      }
+      break;
+    }
+    default: {
+      DCHECK(type == Value::Type::BOOL);
+      col = makeBools(size);
+      for (size_t i = 0; i < size; ++i) {
+        if (values[i].isBool()) {
+          col.bools_[i] = values[i].getBool();
+        } else {
+          col.setNull(i);
+        }
+      }
+      break;
+    }
+  }
+  return col;
+}
+
+// static
+ColumnVector ColumnVector::broadcast(const Value& value, size_t size) {
+  return fromValues(std::vector<Value>(size, value));
+}
+
+// static
+ColumnVector ColumnVector::makeInts(size_t size) {
+  ColumnVector col;
+  col.type_ = Type::kInt;
+  col.size_ = size;
+  col.ints_.resize(size);
+  return col;
+}
+
+// static
+ColumnVector ColumnVector::makeFloats(size_t size) {
+  ColumnVector col;
+  col.type_ = Type::kFloat;
+  col.size_ = size;
+  col.floats_.resize(size);
+  return col;
+}
+
+// static
+ColumnVector ColumnVector::makeBools(size_t size) {
+  ColumnVector col;
+  col.type_ = Type::kBool;
+  col.size_ = size;
+  col.bools_.resize(size);
+  return col;
+}
+
+// static
+ColumnVector ColumnVector::makeValues(size_t size) {
+  ColumnVector col;
+  col.type_ = Type::kValue;
+  col.size_ = size;
+  col.values_.resize(size);
+  return col;
+}
+
+void ColumnVector::setNull(size_t i) {
+  DCHECK(isTyped());
+  DCHECK_LT(i, size_);
+  if (nulls_.empty()) {
+    nulls_.resize((size_ + 63) / 64, 0);
+  }
+  nulls_[i >> 6] |= (1UL << (i & 63));
+}
+
+void ColumnVector::unionNulls(const ColumnVector& lhs, const ColumnVector& rhs) {
+  DCHECK_EQ(lhs.size(), size_);
+  DCHECK_EQ(rhs.size(), size_);
+  if (!lhs.hasNull()) {
+    nulls_ = rhs.nulls_;
+  } else if (!rhs.hasNull()) {
+    nulls_ = lhs.nulls_;
+  } else {
+    nulls_.resize(lhs.nulls_.size());
+    for (size_t i = 0; i < nulls_.size(); ++i) {
+      nulls_[i] = lhs.nulls_[i] | rhs.nulls_[i];
+    }
+  }
+}
+
+Value ColumnVector::value(size_t i) const {
+  DCHECK_LT(i, size_);
+  if (isNull(i)) {
+    return Value::kNullValue;
+  }
+  switch (type_) {
+    case Type::kInt:
+      return ints_[i];
+    case Type::kFloat:
+      return floats_[i];
+    case Type::kBool:
+      return static_cast<bool>(bools_[i]);
+    case Type::kValue:
+      return values_[i];
+  }
+  DLOG(FATAL) << "Unknown column type: " << static_cast<int>(type_);
+  return Value::kNullBadType;
+}
+
+ColumnVector ColumnVector::toValues() const {
+  if (type_ == Type::kValue) {
+    auto col = makeValues(0);
+    col.size_ = size_;
+    col.values_ = values_;
+    return col;
+  }
+  auto col = makeValues(size_);
+  for (size_t i = 0; i < size_; ++i) {
+    col.values_[i] = value(i);
+  }
+  return col;
+}
+
+}  // namespace graph
+}  // namespace nebula
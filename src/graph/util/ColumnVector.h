@@ -0,0 +1,129 @@
+/* Copyright (c) 2023 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_UTIL_COLUMNVECTOR_H_
+#define GRAPH_UTIL_COLUMNVECTOR_H_
+
+#include "common/base/Base.h"
+#include "common/datatypes/Value.h"
+
+namespace nebula {
+namespace graph {
+
+// ColumnVector is a column of values in a batch of rows. The column is stored as a contiguous
+// typed array when all values in it are of the same numeric or boolean type, where the NULL
+// values are tracked by a null bitmap. Otherwise it falls back to an array of the tagged values.
+//
+// Only the plain NULL (NullType::__NULL__) could be represented by the null bitmap, so the
+// evaluation on the typed column always produces the same result as on the tagged values.
+class ColumnVector final {
+ public:
+  enum class Type : uint8_t {
+    kInt,
+    kFloat,
+    kBool,
+    kValue,
+  };
+
+  ColumnVector() = default;
+  ColumnVector(ColumnVector&&) = default;
+  ColumnVector& operator=(ColumnVector&&) = default;
+
+  // Build the column from tagged values, the typed layout is chosen if possible
+  static ColumnVector fromValues(std::vector<Value>&& values);
+
+  // Repeat the value `size` times
+  static ColumnVector broadcast(const Value& value, size_t size);
+
+  static ColumnVector makeInts(size_t size);
+  static ColumnVector makeFloats(size_t size);
+  static ColumnVector makeBools(size_t size);
+  static ColumnVector makeValues(size_t size);
+
+  Type type() const {
+    return type_;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  bool isTyped() const {
+    return type_ != Type::kValue;
+  }
+
+  bool isNumeric() const {
+    return type_ == Type::kInt || type_ == Type::kFloat;
+  }
+
+  bool hasNull() const {
+    return !nulls_.empty();
+  }
+
+  bool isNull(size_t i) const {
+    DCHECK_LT(i, size_);
+    return !nulls_.empty() && (nulls_[i >> 6] & (1UL << (i & 63))) != 0;
+  }
+
+  void setNull(size_t i);
+
+  // Set the null bitmap to the union of the null bitmaps of two columns
+  void unionNulls(const ColumnVector& lhs, const ColumnVector& rhs);
+
+  // Materialize the i-th value
+  Value value(size_t i) const;
+
+  // Get the i-th value as double, the column must be numeric
+  double numeric(size_t i) const {
+    DCHECK(isNumeric());
+    return type_ == Type::kInt ? static_cast<double>(ints_[i]) : floats_[i];
+  }
+
+  // Convert the typed column to the column of tagged values
+  ColumnVector toValues() const;
+
+  std::vector<int64_t>& ints() {
+    return ints_;
+  }
+  const std::vector<int64_t>& ints() const {
+    return ints_;
+  }
+
+  std::vector<double>& floats() {
+    return floats_;
+  }
+  const std::vector<double>& floats() const {
+    return floats_;
+  }
+
+  std::vector<uint8_t>& bools() {
+    return bools_;
+  }
+  const std::vector<uint8_t>& bools() const {
+    return bools_;
+  }
+
+  std::vector<Value>& values() {
+    return values_;
+  }
+  const std::vector<Value>& values() const {
+    return values_;
+  }
+
+ private:
+  Type type_{Type::kValue};
+  size_t size_{0};
+  std::vector<int64_t> ints_;
+  std::vector<double> floats_;
+  std::vector<uint8_t> bools_;
+  std::vector<Value> values_;
+  // One bit per row, empty if there is no NULL in the typed column
+  std::vector<uint64_t> nulls_;
+};
+
+}  // namespace graph
+}  // namespace nebula
+
+#endif  // GRAPH_UTIL_COLUMNVECTOR_H_
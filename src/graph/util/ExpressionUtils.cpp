@@ -113,6 +113,10 @@ bool ExpressionUtils::checkVarExprIfExist(const Expression *expr, const QueryCon
 bool ExpressionUtils::isEvaluableExpr(const Expression *expr, const QueryContext *qctx) {
   EvaluableExprVisitor visitor(qctx);
   const_cast<Expression *>(expr)->accept(&visitor);
+  if (visitor.ok() && visitor.parameterUsed()) {
+    // The expressions evaluable in building stage are evaluated and folded into the plan
+    qctx->markParameterUsed();
+  }
   return visitor.ok();
 }
 
@@ -251,6 +255,7 @@ Expression *ExpressionUtils::rewriteParameter(const Expression *expr, QueryConte
     DCHECK_EQ(e->kind(), Expression::Kind::kVar);
     auto exp = static_cast<VariableExpression *>(const_cast<Expression *>(e));
     exp->setInner(false);
+    qctx->markParameterUsed();
     auto &v = exp->eval(graph::QueryExpressionContext(qctx->ectx())());
     return ConstantExpression::make(qctx->objPool(), v);
   };
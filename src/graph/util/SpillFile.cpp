@@ -0,0 +1,310 @@
+/* Copyright (c) 2023 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "graph/util/SpillFile.h"
+
+#include <fcntl.h>
+#include <folly/compression/Compression.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+#include <unistd.h>
+
+#include "common/datatypes/DataSetOps-inl.h"
+#include "common/datatypes/Edge.h"
+#include "common/datatypes/Map.h"
+#include "common/datatypes/Path.h"
+#include "common/datatypes/Set.h"
+#include "common/datatypes/Vertex.h"
+#include "common/memory/MemoryTracker.h"
+#include "graph/context/iterator/SequentialIter.h"
+#include "graph/service/GraphFlags.h"
+
+namespace nebula {
+namespace graph {
+
+namespace {
+
+// The rows sampled to estimate the size of an iterator
+constexpr size_t kSamples = 64;
+
+struct BlockHeader {
+  uint32_t rawSize;
+  uint32_t size;
+};
+
+folly::io::CodecType codecType() {
+  static const auto type = folly::io::hasCodec(folly::io::CodecType::LZ4)
+                               ? folly::io::CodecType::LZ4
+                               : folly::io::CodecType::NO_COMPRESSION;
+  return type;
+}
+
+Status writeFully(int fd, const char* data, size_t len) {
+  while (len > 0) {
+    auto written = ::write(fd, data, len);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return Status::Error("Failed to write the spill file: %s", strerror(errno));
+    }
+    data += written;
+    len -= written;
+  }
+  return Status::OK();
+}
+
+// Return false if reaching the end of the file before reading anything
+StatusOr<bool> readFully(int fd, char* data, size_t len) {
+  size_t total = 0;
+  while (total < len) {
+    auto read = ::read(fd, data + total, len - total);
+    if (read < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return Status::Error("Failed to read the spill file: %s", strerror(errno));
+    }
+    if (read == 0) {
+      if (total == 0) {
+        return false;
+      }
+      return Status::Error("The spill file is truncated");
+    }
+    total += read;
+  }
+  return true;
+}
+
+size_t estimatePropsSize(const std::unordered_map<std::string, Value>& props) {
+  size_t size = 0;
+  for (const auto& kv : props) {
+    size += kv.first.size() + SpillDir::estimateSize(kv.second);
+  }
+  return size;
+}
+
+size_t estimateVertexSize(const Vertex& vertex) {
+  size_t size = sizeof(Vertex) + SpillDir::estimateSize(vertex.vid);
+  for (const auto& tag : vertex.tags) {
+    size += sizeof(Tag) + tag.name.size() + estimatePropsSize(tag.props);
+  }
+  return size;
+}
+
+size_t estimateRowSize(const Row& row) {
+  size_t size = sizeof(Row);
+  for (const auto& value : row.values) {
+    size += SpillDir::estimateSize(value);
+  }
+  return size;
+}
+
+}  // namespace
+
+SpillFile::~SpillFile() {
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+  ::unlink(path_.c_str());
+}
+
+Status SpillFile::append(Row row) {
+  block_.emplace_back(std::move(row));
+  ++numRows_;
+  if (block_.size() >= kBlockSize) {
+    return writeBlock();
+  }
+  return Status::OK();
+}
+
+Status SpillFile::finish() {
+  if (!block_.empty()) {
+    NG_RETURN_IF_ERROR(writeBlock());
+  }
+  if (::lseek(fd_, 0, SEEK_SET) < 0) {
+    return Status::Error("Failed to rewind the spill file: %s", strerror(errno));
+  }
+  pos_ = 0;
+  return Status::OK();
+}
+
+StatusOr<bool> SpillFile::next(Row* row) {
+  if (pos_ >= block_.size()) {
+    block_.clear();
+    pos_ = 0;
+    NG_RETURN_IF_ERROR(readBlock());
+    if (block_.empty()) {
+      return false;
+    }
+  }
+  *row = std::move(block_[pos_++]);
+  return true;
+}
+
+Status SpillFile::writeBlock() {
+  DataSet ds;
+  ds.rows = std::move(block_);
+  block_.clear();
+  std::string raw;
+  apache::thrift::CompactSerializer::serialize(ds, &raw);
+  auto data = folly::io::getCodec(codecType())->compress(raw);
+  BlockHeader header{static_cast<uint32_t>(raw.size()), static_cast<uint32_t>(data.size())};
+  NG_RETURN_IF_ERROR(writeFully(fd_, reinterpret_cast<const char*>(&header), sizeof(header)));
+  return writeFully(fd_, data.data(), data.size());
+}
+
+Status SpillFile::readBlock() {
+  BlockHeader header;
+  auto ret = readFully(fd_, reinterpret_cast<char*>(&header), sizeof(header));
+  NG_RETURN_IF_ERROR(ret);
+  if (!ret.value()) {
+    return Status::OK();
+  }
+  std::string data(header.size, '\0');
+  ret = readFully(fd_, data.data(), data.size());
+  NG_RETURN_IF_ERROR(ret);
+  if (!ret.value()) {
+    return Status::Error("The spill file is truncated");
+  }
+  auto raw = folly::io::getCodec(codecType())->uncompress(data, header.rawSize);
+  DataSet ds;
+  apache::thrift::CompactSerializer::deserialize(raw, ds);
+  block_ = std::move(ds.rows);
+  return Status::OK();
+}
+
+// static
+StatusOr<std::unique_ptr<SpillDir>> SpillDir::create() {
+  auto dir = std::make_unique<fs::TempDir>(FLAGS_spill_tmp_dir.c_str(), "nebula_spill.XXXXXX");
+  if (dir->path() == nullptr) {
+    return Status::Error("Failed to create the spill directory in `%s'",
+                         FLAGS_spill_tmp_dir.c_str());
+  }
+  return std::unique_ptr<SpillDir>(new SpillDir(std::move(dir)));
+}
+
+StatusOr<std::unique_ptr<SpillFile>> SpillDir::newFile() {
+  auto path = fs::FileUtils::joinPath(dir_->path(), folly::stringPrintf("%zu", nextFileId_++));
+  int fd = ::open(path.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    return Status::Error(
+        "Failed to create the spill file `%s': %s", path.c_str(), strerror(errno));
+  }
+  return std::unique_ptr<SpillFile>(new SpillFile(std::move(path), fd));
+}
+
+// static
+int64_t SpillDir::budget() {
+  auto& stats = memory::MemoryStats::instance();
+  auto available = std::max<int64_t>(stats.getLimit() - stats.used(), 0);
+  return std::min<int64_t>(FLAGS_spill_memory_budget_bytes, available);
+}
+
+// static
+bool SpillDir::exceedsBudget(size_t bytes) {
+  return static_cast<int64_t>(bytes) > budget();
+}
+
+// static
+size_t SpillDir::numPartitions(size_t bytes) {
+  static constexpr size_t kMaxPartitions = 256;
+  // Each partition is loaded back alone, so it has to fit into the memory left now
+  auto partBytes = static_cast<size_t>(std::max<int64_t>(budget(), 1));
+  return std::clamp<size_t>((bytes + partBytes - 1) / partBytes, 2, kMaxPartitions);
+}
+
+// static
+size_t SpillDir::estimateSize(Iterator* iter) {
+  auto numRows = iter->size();
+  if (numRows == 0) {
+    return 0;
+  }
+  if (iter->isDefaultIter()) {
+    // A single value rather than rows
+    auto value = iter->valuePtr();
+    return value == nullptr ? 0 : estimateSize(*value);
+  }
+  size_t sampled = 0, size = 0;
+  if (iter->isSequentialIter() || iter->isPropIter()) {
+    // The rows are picked evenly without walking the iterator
+    auto* seqIter = static_cast<SequentialIter*>(iter);
+    auto begin = seqIter->begin();
+    auto step = std::max<size_t>(numRows / kSamples, 1);
+    for (size_t i = 0; i < numRows; i += step) {
+      size += estimateRowSize(*(begin + i));
+      ++sampled;
+    }
+  } else {
+    // The iterator can't be accessed randomly, so only the first rows are sampled
+    iter->reset();
+    for (; iter->valid() && sampled < kSamples; iter->next()) {
+      auto* row = iter->row();
+      if (row != nullptr) {
+        size += estimateRowSize(*row);
+        ++sampled;
+      }
+    }
+    iter->reset();
+  }
+  return sampled == 0 ? 0 : size / sampled * numRows;
+}
+
+// static
+size_t SpillDir::estimateSize(const Value& value) {
+  size_t size = sizeof(Value);
+  switch (value.type()) {
+    case Value::Type::STRING: {
+      size += value.getStr().size();
+      break;
+    }
+    case Value::Type::LIST: {
+      for (const auto& v : value.getList().values) {
+        size += estimateSize(v);
+      }
+      break;
+    }
+    case Value::Type::SET: {
+      for (const auto& v : value.getSet().values) {
+        size += estimateSize(v);
+      }
+      break;
+    }
+    case Value::Type::MAP: {
+      size += estimatePropsSize(value.getMap().kvs);
+      break;
+    }
+    case Value::Type::VERTEX: {
+      size += estimateVertexSize(value.getVertex());
+      break;
+    }
+    case Value::Type::EDGE: {
+      const auto& edge = value.getEdge();
+      size += sizeof(Edge) + estimateSize(edge.src) + estimateSize(edge.dst) + edge.name.size() +
+              estimatePropsSize(edge.props);
+      break;
+    }
+    case Value::Type::PATH: {
+      const auto& path = value.getPath();
+      size += estimateVertexSize(path.src);
+      for (const auto& step : path.steps) {
+        size += sizeof(Step) + estimateVertexSize(step.dst) + estimatePropsSize(step.props);
+      }
+      break;
+    }
+    case Value::Type::DATASET: {
+      for (const auto& row : value.getDataSet().rows) {
+        size += estimateRowSize(row);
+      }
+      break;
+    }
+    default: {
+      break;
+    }
+  }
+  return size;
+}
+
+}  // namespace graph
+}  // namespace nebula
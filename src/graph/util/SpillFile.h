@@ -0,0 +1,94 @@
+/* Copyright (c) 2023 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef GRAPH_UTIL_SPILLFILE_H_
+#define GRAPH_UTIL_SPILLFILE_H_
+
+#include "common/base/Base.h"
+#include "common/base/StatusOr.h"
+#include "common/datatypes/DataSet.h"
+#include "common/fs/TempDir.h"
+#include "graph/context/iterator/Iterator.h"
+
+namespace nebula {
+namespace graph {
+
+// SpillFile is a temporary file of rows, which is used by the executors to move their
+// intermediate results out of memory when they exceed the memory budget of the query.
+//
+// The rows are appended at first, and then read back sequentially after `finish()`. They are
+// written in blocks, each block is a serialized DataSet which is compressed if the codec is
+// available. The file is removed when it is destroyed.
+class SpillFile final {
+ public:
+  // The rows of a block
+  static constexpr size_t kBlockSize = 1024;
+
+  ~SpillFile();
+
+  Status append(Row row);
+
+  // Flush the buffered rows and rewind to read from the beginning
+  Status finish();
+
+  // Read the next row, return false when reaching the end of the file
+  StatusOr<bool> next(Row* row);
+
+  size_t numRows() const {
+    return numRows_;
+  }
+
+ private:
+  friend class SpillDir;
+
+  SpillFile(std::string path, int fd) : path_(std::move(path)), fd_(fd) {}
+
+  Status writeBlock();
+
+  Status readBlock();
+
+  std::string path_;
+  int fd_{-1};
+  size_t numRows_{0};
+  // The rows to write or the rows read from the current block
+  std::vector<Row> block_;
+  size_t pos_{0};
+};
+
+// SpillDir is the temporary directory of the spill files of one executor, which is removed along
+// with all its files when destroyed.
+class SpillDir final {
+ public:
+  static StatusOr<std::unique_ptr<SpillDir>> create();
+
+  StatusOr<std::unique_ptr<SpillFile>> newFile();
+
+  // The memory budget of an intermediate result, which is the smaller one of
+  // `--spill_memory_budget_bytes` and the memory left to the process
+  static int64_t budget();
+
+  // Whether an intermediate result of `bytes` exceeds the memory budget
+  static bool exceedsBudget(size_t bytes);
+
+  // How many parts the intermediate result of `bytes` is split into so that each part fits into
+  // the memory budget
+  static size_t numPartitions(size_t bytes);
+
+  // Estimate the memory used by the rows of the iterator by sampling, the iterator is reset
+  static size_t estimateSize(Iterator* iter);
+
+  static size_t estimateSize(const Value& value);
+
+ private:
+  explicit SpillDir(std::unique_ptr<fs::TempDir> dir) : dir_(std::move(dir)) {}
+
+  std::unique_ptr<fs::TempDir> dir_;
+  size_t nextFileId_{0};
+};
+
+}  // namespace graph
+}  // namespace nebula
+
+#endif  // GRAPH_UTIL_SPILLFILE_H_
@@ -0,0 +1,145 @@
+// Copyright (c) 2023 vesoft inc. All rights reserved.
+//
+// This source code is licensed under Apache 2.0 License.
+
+#include <gtest/gtest.h>
+
+#include "common/base/ObjectPool.h"
+#include "common/expression/ArithmeticExpression.h"
+#include "common/expression/ConstantExpression.h"
+#include "common/expression/LogicalExpression.h"
+#include "common/expression/PropertyExpression.h"
+#include "common/expression/RelationalExpression.h"
+#include "common/expression/UnaryExpression.h"
+#include "graph/context/ExecutionContext.h"
+#include "graph/util/BatchExprEvaluator.h"
+
+namespace nebula {
+namespace graph {
+
+class BatchExprEvaluatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    DataSet ds({"a", "b", "s", "t"});
+    ds.rows.emplace_back(Row({1, 1.5, "x", true}));
+    ds.rows.emplace_back(Row({Value::kNullValue, 2.0, "y", false}));
+    ds.rows.emplace_back(Row({3, Value::kNullValue, "x", Value::kNullValue}));
+    ds.rows.emplace_back(Row({0, -4.0, Value::kNullValue, true}));
+    ds.rows.emplace_back(Row({INT64_MAX, 5.0, "z", false}));
+    ds.rows.emplace_back(Row({INT64_MIN, 1e-9, "x", true}));
+    ds.rows.emplace_back(Row({-1, 0.0, 7, false}));
+    input_ = std::make_shared<Value>(std::move(ds));
+  }
+
+  Expression *prop(const std::string &name) {
+    return InputPropertyExpression::make(&pool_, name);
+  }
+
+  Expression *constant(Value v) {
+    return ConstantExpression::make(&pool_, std::move(v));
+  }
+
+  // Check the batch result is the same as the result of the tree interpreter row by row
+  void check(const std::vector<Expression *> &exprs, size_t batchSize) {
+    QueryExpressionContext ctx(&ectx_);
+    std::vector<std::vector<Value>> expected(exprs.size());
+    SequentialIter rowIter(input_);
+    for (; rowIter.valid(); rowIter.next()) {
+      for (size_t i = 0; i < exprs.size(); ++i) {
+        expected[i].emplace_back(exprs[i]->eval(ctx(&rowIter)));
+      }
+    }
+
+    BatchExprEvaluator evaluator(exprs);
+    SequentialIter batchIter(input_);
+    size_t offset = 0;
+    while (batchIter.valid()) {
+      auto numRows = evaluator.evalBatch(ctx, &batchIter, batchSize);
+      ASSERT_GT(numRows, 0);
+      ASSERT_EQ(numRows, evaluator.rows().size());
+      for (size_t i = 0; i < exprs.size(); ++i) {
+        const auto &col = evaluator.result(i);
+        ASSERT_EQ(numRows, col.size());
+        for (size_t row = 0; row < numRows; ++row) {
+          const auto &exp = expected[i][offset + row];
+          auto val = col.value(row);
+          EXPECT_EQ(exp.type(), val.type()) << exprs[i]->toString() << " at row " << offset + row;
+          EXPECT_TRUE(exp == val || (exp.isFloat() && val.isFloat() &&
+                                     std::isnan(exp.getFloat()) && std::isnan(val.getFloat())))
+              << exprs[i]->toString() << " at row " << offset + row << ": " << exp << " vs. "
+              << val;
+        }
+      }
+      offset += numRows;
+    }
+    EXPECT_EQ(offset, input_->getDataSet().rowSize());
+  }
+
+  ObjectPool pool_;
+  ExecutionContext ectx_;
+  std::shared_ptr<Value> input_;
+};
+
+TEST_F(BatchExprEvaluatorTest, CanVectorize) {
+  EXPECT_TRUE(BatchExprEvaluator::canVectorize(
+      ArithmeticExpression::makeAdd(&pool_, prop("a"), constant(1))));
+  auto *isNull = UnaryExpression::makeIsNull(&pool_, prop("a"));
+  EXPECT_TRUE(
+      BatchExprEvaluator::canVectorize(LogicalExpression::makeAnd(&pool_, prop("t"), isNull)));
+  EXPECT_FALSE(BatchExprEvaluator::canVectorize(prop("a")));
+  EXPECT_FALSE(BatchExprEvaluator::canVectorize(constant(1)));
+}
+
+TEST_F(BatchExprEvaluatorTest, Arithmetic) {
+  std::vector<Expression *> exprs = {
+      ArithmeticExpression::makeAdd(&pool_, prop("a"), constant(1)),
+      ArithmeticExpression::makeMinus(&pool_, prop("a"), prop("b")),
+      ArithmeticExpression::makeMultiply(&pool_, prop("a"), constant(2)),
+      ArithmeticExpression::makeDivision(&pool_, constant(10), prop("a")),
+      ArithmeticExpression::makeMod(&pool_, prop("a"), constant(3)),
+      ArithmeticExpression::makeDivision(&pool_, prop("b"), prop("b")),
+      ArithmeticExpression::makeAdd(&pool_, prop("s"), prop("a")),
+      UnaryExpression::makeNegate(&pool_, prop("a")),
+      UnaryExpression::makeNegate(&pool_, prop("b")),
+  };
+  for (size_t batchSize : {1, 3, 1024}) {
+    check(exprs, batchSize);
+  }
+}
+
+TEST_F(BatchExprEvaluatorTest, Relational) {
+  std::vector<Expression *> exprs = {
+      RelationalExpression::makeEQ(&pool_, prop("a"), constant(3)),
+      RelationalExpression::makeNE(&pool_, prop("a"), prop("b")),
+      RelationalExpression::makeLT(&pool_, prop("b"), constant(1e-8)),
+      RelationalExpression::makeLE(&pool_, prop("a"), constant(0.0)),
+      RelationalExpression::makeGT(&pool_, prop("t"), constant(false)),
+      RelationalExpression::makeGE(&pool_, prop("s"), constant("x")),
+      RelationalExpression::makeEQ(&pool_, prop("t"), prop("a")),
+      RelationalExpression::makeLT(&pool_, prop("t"), prop("a")),
+  };
+  for (size_t batchSize : {1, 3, 1024}) {
+    check(exprs, batchSize);
+  }
+}
+
+TEST_F(BatchExprEvaluatorTest, Logical) {
+  auto *gt = RelationalExpression::makeGT(&pool_, prop("a"), constant(0));
+  std::vector<Expression *> exprs = {
+      LogicalExpression::makeAnd(&pool_, gt, prop("t")),
+      LogicalExpression::makeOr(&pool_, prop("t"), gt),
+      LogicalExpression::makeXor(&pool_, prop("t"), gt),
+      LogicalExpression::makeAnd(&pool_, prop("t"), prop("s")),
+      LogicalExpression::makeOr(&pool_, UnaryExpression::makeIsNull(&pool_, prop("a")), prop("b")),
+      UnaryExpression::makeNot(&pool_, prop("t")),
+      UnaryExpression::makeNot(&pool_, prop("s")),
+      UnaryExpression::makeIsNull(&pool_, prop("b")),
+      UnaryExpression::makeIsNotNull(&pool_, prop("s")),
+  };
+  for (size_t batchSize : {1, 3, 1024}) {
+    check(exprs, batchSize);
+  }
+}
+
+}  // namespace graph
+}  // namespace nebula
@@ -7,6 +7,7 @@
 #include "common/expression/ArithmeticExpression.h"
 #include "common/expression/ConstantExpression.h"
 #include "common/expression/TypeCastingExpression.h"
+#include "common/expression/VariableExpression.h"
 #include "graph/util/ExpressionUtils.h"
 #include "parser/GQLParser.h"
 
@@ -827,5 +828,20 @@ TEST_F(ExpressionUtilsTest, simplifyLogicalExpr) {
   }
 }
 
+TEST_F(ExpressionUtilsTest, ParameterUsed) {
+  qctx_->ectx()->setValue("p", 1);
+  // Only referring to the parameter doesn't fold its value into the plan
+  EXPECT_TRUE(qctx_->existParameter("p"));
+  auto *filter = RelationalExpression::makeGT(
+      pool, LabelExpression::make(pool, "a"), VariableExpression::make(pool, "p"));
+  EXPECT_FALSE(ExpressionUtils::isEvaluableExpr(filter, qctx_.get()));
+  EXPECT_FALSE(qctx_->parameterUsed());
+
+  auto *limit = ArithmeticExpression::makeAdd(
+      pool, VariableExpression::make(pool, "p"), ConstantExpression::make(pool, 1));
+  EXPECT_TRUE(ExpressionUtils::isEvaluableExpr(limit, qctx_.get()));
+  EXPECT_TRUE(qctx_->parameterUsed());
+}
+
 }  // namespace graph
 }  // namespace nebula
@@ -0,0 +1,84 @@
+// Copyright (c) 2023 vesoft inc. All rights reserved.
+//
+// This source code is licensed under Apache 2.0 License.
+
+#include <gtest/gtest.h>
+
+#include "common/memory/MemoryTracker.h"
+#include "graph/context/iterator/DefaultIter.h"
+#include "graph/context/iterator/SequentialIter.h"
+#include "graph/service/GraphFlags.h"
+#include "graph/util/SpillFile.h"
+
+namespace nebula {
+namespace graph {
+
+TEST(SpillFileTest, WriteAndRead) {
+  auto dir = SpillDir::create();
+  ASSERT_TRUE(dir.ok()) << dir.status();
+  auto file = dir.value()->newFile();
+  ASSERT_TRUE(file.ok()) << file.status();
+  auto spill = std::move(file).value();
+
+  // Multiple blocks and a partial one
+  size_t numRows = SpillFile::kBlockSize * 2 + 10;
+  std::vector<Row> rows;
+  for (size_t i = 0; i < numRows; ++i) {
+    Row row;
+    row.values.emplace_back(static_cast<int64_t>(i));
+    row.values.emplace_back(folly::to<std::string>(i));
+    row.values.emplace_back(i % 2 == 0 ? Value::kNullValue : Value(List({1, "a", 2.5})));
+    rows.emplace_back(row);
+    ASSERT_TRUE(spill->append(std::move(row)).ok());
+  }
+  EXPECT_EQ(spill->numRows(), numRows);
+  ASSERT_TRUE(spill->finish().ok());
+
+  Row row;
+  for (size_t i = 0; i < numRows; ++i) {
+    auto ret = spill->next(&row);
+    ASSERT_TRUE(ret.ok()) << ret.status();
+    ASSERT_TRUE(ret.value());
+    EXPECT_EQ(row, rows[i]);
+  }
+  auto ret = spill->next(&row);
+  ASSERT_TRUE(ret.ok()) << ret.status();
+  EXPECT_FALSE(ret.value());
+}
+
+TEST(SpillFileTest, Budget) {
+  EXPECT_EQ(SpillDir::estimateSize(Value(1)), sizeof(Value));
+  EXPECT_EQ(SpillDir::estimateSize(Value(std::string(100, 'a'))), sizeof(Value) + 100);
+  EXPECT_EQ(SpillDir::estimateSize(Value(List({1, 2}))), sizeof(Value) * 3);
+
+  DataSet ds({"a"});
+  for (int64_t i = 0; i < 1000; ++i) {
+    ds.rows.emplace_back(Row({i}));
+  }
+  SequentialIter iter(std::make_shared<Value>(std::move(ds)));
+  auto bytes = SpillDir::estimateSize(&iter);
+  EXPECT_EQ(bytes, (sizeof(Row) + sizeof(Value)) * 1000);
+  EXPECT_TRUE(iter.valid());
+
+  // Such as the input of `YIELD sum(1)`, which has no rows
+  DefaultIter defaultIter(std::make_shared<Value>(1));
+  EXPECT_EQ(SpillDir::estimateSize(&defaultIter), sizeof(Value));
+
+  auto budget = FLAGS_spill_memory_budget_bytes;
+  FLAGS_spill_memory_budget_bytes = bytes / 4;
+  EXPECT_TRUE(SpillDir::exceedsBudget(bytes));
+  EXPECT_FALSE(SpillDir::exceedsBudget(bytes / 4));
+  EXPECT_EQ(SpillDir::numPartitions(bytes), 4);
+  FLAGS_spill_memory_budget_bytes = budget;
+
+  // The partitions fit into the memory left when it's less than the budget
+  auto& stats = memory::MemoryStats::instance();
+  auto limit = stats.getLimit();
+  stats.updateLimit(bytes / 8);
+  EXPECT_TRUE(SpillDir::exceedsBudget(bytes));
+  EXPECT_GE(SpillDir::numPartitions(bytes), 8);
+  stats.setLimit(limit);
+}
+
+}  // namespace graph
+}  // namespace nebula
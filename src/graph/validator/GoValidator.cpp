@@ -102,8 +102,11 @@ Status GoValidator::validateTruncate(TruncateClause* truncate) {
   }
   auto* tExpr = truncate->truncate();
   goCtx_->random = truncate->isSample();
-  auto qeCtx = QueryExpressionContext();
-  auto limits = tExpr->eval(qeCtx);
+  // The parameters evaluated here are folded into the plan
+  if (!ExpressionUtils::isEvaluableExpr(tExpr, qctx_)) {
+    return Status::SemanticError("`%s' should be instantly evaluable", tExpr->toString().c_str());
+  }
+  auto limits = tExpr->eval(QueryExpressionContext(qctx_->ectx())());
   if (!limits.isList()) {
     return Status::SemanticError("`%s' type must be LIST.", tExpr->toString().c_str());
   }
@@ -26,6 +26,7 @@ void EvaluableExprVisitor::visit(UUIDExpression *) {
 
 void EvaluableExprVisitor::visit(VariableExpression *expr) {
   isEvaluable_ = (qctx_ && qctx_->existParameter(expr->var())) ? true : false;
+  parameterUsed_ = parameterUsed_ || isEvaluable_;
 }
 
 void EvaluableExprVisitor::visit(VersionedVariableExpression *) {
@@ -52,6 +53,7 @@ void EvaluableExprVisitor::visit(VariablePropertyExpression *expr) {
   isEvaluable_ = (qctx_ && qctx_->existParameter(static_cast<PropertyExpression *>(expr)->sym()))
                      ? true
                      : false;
+  parameterUsed_ = parameterUsed_ || isEvaluable_;
 }
 
 void EvaluableExprVisitor::visit(DestPropertyExpression *) {
@@ -19,6 +19,11 @@ class EvaluableExprVisitor : public ExprVisitorImpl {
     return isEvaluable_;
   }
 
+  // Whether any parameter is referred, the expression is evaluated with its value then
+  bool parameterUsed() const {
+    return parameterUsed_;
+  }
+
  private:
   using ExprVisitorImpl::visit;
 
@@ -65,6 +70,7 @@ class EvaluableExprVisitor : public ExprVisitorImpl {
   void visitBinaryExpr(BinaryExpression *) override;
 
   bool isEvaluable_{true};
+  bool parameterUsed_{false};
   const QueryContext *qctx_{nullptr};
 };
 
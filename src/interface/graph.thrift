@@ -86,6 +86,8 @@ struct ExecutionResponse {
     5: optional binary                  error_msg;
     6: optional PlanDescription         plan_desc;
     7: optional binary                  comment;        // Supplementary instruction
+    // Set when the result has more pages, which are fetched by fetchPage() with it
+    8: optional i64                     page_token;
 } (cpp.type = "nebula::ExecutionResponse", cpp.noncopyable)
 
 
@@ -119,6 +121,16 @@ service GraphService {
     // Same as execute(), but response will be a json string
     binary executeJson(1: i64 sessionId, 2: binary stmt)
     binary executeJsonWithParameter(1: i64 sessionId, 2: binary stmt, 3: map<binary, common.Value>(cpp.template = "std::unordered_map") parameterMap)
+
+    // Same as executeWithParameter(), but only the first page of at most pageSize rows is
+    // returned. The whole result is still built before the first page is returned, the rest pages
+    // are kept in the session until they are fetched, released or expired.
+    ExecutionResponse executeWithPagination(1: i64 sessionId, 2: binary stmt, 3: map<binary, common.Value>(cpp.template = "std::unordered_map") parameterMap, 4: i32 pageSize)
+    // Fetch the next page of at most pageSize rows, the pages are released after the last page is
+    // fetched, which is indicated by the absent page_token in the response
+    ExecutionResponse fetchPage(1: i64 sessionId, 2: i64 pageToken, 3: i32 pageSize)
+    // Release the pages left before all of them are fetched
+    oneway void releasePages(1: i64 sessionId, 2: i64 pageToken)
     
     VerifyClientVersionResp verifyClientVersion(1: VerifyClientVersionReq req)
 }
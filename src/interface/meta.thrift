@@ -360,6 +360,10 @@ struct ListSpacesResp {
     // Valid if ret equals E_LEADER_CHANGED.
     2: common.HostAddr  leader,
     3: list<IdName>     spaces,
+    // The last update time of the schemas, indexes and listeners of each space,
+    // absent if the space has never been updated since created
+    4: map<common.GraphSpaceID, i64>
+        (cpp.template = "std::unordered_map") space_update_times,
 }
 
 struct GetSpaceReq {
@@ -7,6 +7,8 @@ namespace cpp nebula.raftex
 
 include "common.thrift"
 
+cpp_include "folly/io/IOBuf.h"
+
 enum Role {
     LEADER      = 1, // the leader
     FOLLOWER    = 2; // following a leader
@@ -51,11 +53,12 @@ struct AskForVoteResponse {
 }
 
 // Log entries being sent to follower, logId is not included, it could be calculated by
-// last_log_id_sent and offset in log_str_list in AppendLogRequest
+// last_log_id_sent and offset in log_str_list in AppendLogRequest. The log_str shares the buffer
+// of the log in the wal of leader, and the buffer of the request received on follower
 struct RaftLogEntry {
-    1: ClusterID cluster;
-    2: binary    log_str;
-    3: TermID    log_term;
+    1: ClusterID                            cluster;
+    2: binary (cpp.type = "folly::IOBuf")   log_str;
+    3: TermID                               log_term;
 }
 
 struct AppendLogRequest {
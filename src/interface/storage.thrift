@@ -178,6 +178,9 @@ struct GetNeighborsRequest {
         (cpp.template = "std::unordered_map")   parts,
     4: TraverseSpec                             traverse_spec,
     5: optional RequestCommon                   common,
+    // The sessions and the plans of all the requests merged into this one by the client,
+    //   the request is only killed when all of them are killed
+    6: optional list<RequestCommon>             merged_commons,
 }
 
 
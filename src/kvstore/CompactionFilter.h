@@ -7,6 +7,7 @@
 #define KVSTORE_COMPACTIONFILTER_H_
 
 #include <rocksdb/compaction_filter.h>
+#include <rocksdb/table_properties.h>
 
 #include "common/base/Base.h"
 #include "common/time/WallClock.h"
@@ -93,6 +94,27 @@ class KVCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
 
   virtual std::unique_ptr<KVFilter> createKVFilter() = 0;
 
+  /**
+   * @brief Create the factory of the collectors of the table properties used by expired()
+   *
+   * @return std::shared_ptr<rocksdb::TablePropertiesCollectorFactory> nullptr if none
+   */
+  virtual std::shared_ptr<rocksdb::TablePropertiesCollectorFactory>
+  createTablePropertiesCollectorFactory() {
+    return nullptr;
+  }
+
+  /**
+   * @brief Whether all entries of a sst file are expired, so the file can be dropped without
+   * going through the filter
+   *
+   * @param props Table properties of the sst file
+   */
+  virtual bool expired(const rocksdb::TableProperties& props) const {
+    UNUSED(props);
+    return false;
+  }
+
  private:
   GraphSpaceID spaceId_;
 };
@@ -43,6 +43,19 @@ class KVIterator {
    * @return folly::StringPiece Value
    */
   virtual folly::StringPiece val() const = 0;
+
+  /**
+   * @brief Seek to the first key with another prefix, so that one iterator is reused to scan
+   * several prefixes. It's cheaper than creating a new iterator, especially when the prefixes
+   * are scanned in the key order.
+   *
+   * @param prefix The new prefix, which should outlive the iterator or the next seek
+   * @return Whether the iterator supports it, create a new iterator if not
+   */
+  virtual bool seekPrefix(const std::string& prefix) {
+    UNUSED(prefix);
+    return false;
+  }
 };
 
 }  // namespace kvstore
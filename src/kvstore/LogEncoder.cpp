@@ -177,8 +177,8 @@ std::string encodeBatchValue(
   // Values
   for (auto& op : batch) {
     auto opType = std::get<0>(op);
-    auto key = std::get<1>(op);
-    auto val = std::get<2>(op);
+    const auto& key = std::get<1>(op);
+    const auto& val = std::get<2>(op);
     auto keySize = key.size();
     auto valSize = val.size();
     encoded.append(reinterpret_cast<char*>(&opType), 1)
@@ -18,6 +18,7 @@
 #include "kvstore/NebulaSnapshotManager.h"
 #include "kvstore/RocksEngine.h"
 #include "kvstore/listener/elasticsearch/ESListener.h"
+#include "kvstore/wal/WalJournal.h"
 
 DEFINE_string(engine_type, "rocksdb", "rocksdb, memory...");
 DEFINE_int32(num_workers, 4, "Number of worker threads");
@@ -179,6 +180,8 @@ void NebulaStore::loadPartFromDataPath() {
           LOG(INFO) << "Part " << partId
                     << " is not in balancing and does not exist in meta any more, will remove it!";
           engine->removePart(partId);
+          wal::WalJournal::dropPart(
+              folly::stringPrintf("%s/wal/%d", engine->getWalRoot(), partId), spaceId, partId);
           continue;
         }
 
@@ -596,6 +599,8 @@ void NebulaStore::removePart(GraphSpaceID spaceId, PartitionID partId, bool need
       partIt->second->resetPart();
       spaceIt->second->parts_.erase(partId);
       e->removePart(partId);
+      wal::WalJournal::dropPart(
+          folly::stringPrintf("%s/wal/%d", e->getWalRoot(), partId), spaceId, partId);
     }
   }
   LOG(INFO) << "Space " << spaceId << ", part " << partId << " has been removed!";
@@ -989,6 +994,11 @@ nebula::cpp2::ErrorCode NebulaStore::ingest(GraphSpaceID spaceId) {
   for (auto& engine : space->engines_) {
     threads.emplace_back(std::thread([&engine, &code, this, spaceId] {
       auto parts = engine->allParts();
+      std::vector<PartitionID> ingested;
+      SCOPE_EXIT {
+        // The edges cached of the parts are stale
+        onDataChanged(spaceId, ingested);
+      };
       for (auto part : parts) {
         auto ret = this->engine(spaceId, part);
         if (!ok(ret)) {
@@ -1004,6 +1014,8 @@ nebula::cpp2::ErrorCode NebulaStore::ingest(GraphSpaceID spaceId) {
           auto result = engine->ingest(std::vector<std::string>(files));
           if (result != nebula::cpp2::ErrorCode::SUCCEEDED) {
             code = result;
+          } else {
+            ingested.emplace_back(part);
           }
         }
       }
@@ -1381,6 +1393,10 @@ nebula::cpp2::ErrorCode NebulaStore::restoreFromFiles(GraphSpaceID spaceId,
   }
   auto space = nebula::value(spaceRet);
 
+  SCOPE_EXIT {
+    // Some engines may be restored even if the others fail
+    onDataChanged(spaceId);
+  };
   for (auto& engine : space->engines_) {
     auto ret = engine->ingest(files, true);
     if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
@@ -1391,6 +1407,33 @@ nebula::cpp2::ErrorCode NebulaStore::restoreFromFiles(GraphSpaceID spaceId,
   return nebula::cpp2::ErrorCode::SUCCEEDED;
 }
 
+void NebulaStore::onDataChanged(GraphSpaceID spaceId, const std::vector<PartitionID>& partIds) {
+  std::vector<std::shared_ptr<Part>> parts;
+  {
+    folly::RWSpinLock::ReadHolder rh(&lock_);
+    auto it = spaces_.find(spaceId);
+    if (it == spaces_.end()) {
+      return;
+    }
+    if (partIds.empty()) {
+      for (const auto& part : it->second->parts_) {
+        parts.emplace_back(part.second);
+      }
+    } else {
+      for (auto partId : partIds) {
+        auto partIt = it->second->parts_.find(partId);
+        if (partIt != it->second->parts_.end()) {
+          parts.emplace_back(partIt->second);
+        }
+      }
+    }
+  }
+  // The callbacks are invoked out of the lock, which may look up the store again
+  for (auto& part : parts) {
+    part->onDataChanged();
+  }
+}
+
 std::unique_ptr<WriteBatch> NebulaStore::startBatchWrite() {
   return std::make_unique<RocksWriteBatch>();
 }
@@ -1404,6 +1447,9 @@ nebula::cpp2::ErrorCode NebulaStore::batchWriteWithoutReplicator(
   }
   auto space = nebula::value(spaceRet);
 
+  SCOPE_EXIT {
+    onDataChanged(spaceId);
+  };
   for (auto& engine : space->engines_) {
     auto ret = engine->commitBatchWrite(
         std::move(batch), FLAGS_rocksdb_disable_wal, FLAGS_rocksdb_wal_sync, true);
@@ -846,6 +846,15 @@ class NebulaStore : public KVStore, public Handler {
    */
   bool checkLeader(std::shared_ptr<Part> part, bool canReadFromFollower = false) const;
 
+  /**
+   * @brief Notify the parts of a space that their data is changed out of the raft apply, see
+   * Part::onDataChanged
+   *
+   * @param spaceId
+   * @param partIds The parts changed, all parts of the space if empty
+   */
+  void onDataChanged(GraphSpaceID spaceId, const std::vector<PartitionID>& partIds = {});
+
   /**
    * @brief clean useless wal
    */
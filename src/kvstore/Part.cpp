@@ -5,6 +5,7 @@
 
 #include "kvstore/Part.h"
 
+#include "common/stats/StatsManager.h"
 #include "common/time/ScopedTimer.h"
 #include "common/utils/IndexKeyUtils.h"
 #include "common/utils/MetaKeyUtils.h"
@@ -16,6 +17,14 @@
 #include "kvstore/stats/KVStats.h"
 
 DEFINE_int32(cluster_id, 0, "A unique id for each cluster");
+DEFINE_bool(merge_concurrent_writes,
+            true,
+            "Whether to merge the multi put/remove requests to a part, which arrive while another "
+            "one is being replicated, into one raft log");
+DEFINE_uint32(max_merged_write_bytes,
+              4 * 1024 * 1024,
+              "The max size of the keys and values merged into one raft log, the merged requests "
+              "are replicated without waiting for the one in flight when exceeded");
 
 namespace nebula {
 namespace kvstore {
@@ -80,7 +89,15 @@ void Part::asyncAppendBatch(std::string&& batch, KVCallback cb) {
           [callback = std::move(cb)](nebula::cpp2::ErrorCode code) mutable { callback(code); });
 }
 
-void Part::asyncMultiPut(const std::vector<KV>& keyValues, KVCallback cb) {
+void Part::asyncMultiPut(std::vector<KV> keyValues, KVCallback cb) {
+  if (FLAGS_merge_concurrent_writes) {
+    MergedWrite write;
+    write.type = OP_MULTI_PUT;
+    write.kvs = std::move(keyValues);
+    write.cb = std::move(cb);
+    asyncMergedWrite(std::move(write));
+    return;
+  }
   std::string log = encodeMultiValues(OP_MULTI_PUT, keyValues);
 
   appendAsync(FLAGS_cluster_id, std::move(log))
@@ -96,7 +113,15 @@ void Part::asyncRemove(folly::StringPiece key, KVCallback cb) {
           [callback = std::move(cb)](nebula::cpp2::ErrorCode code) mutable { callback(code); });
 }
 
-void Part::asyncMultiRemove(const std::vector<std::string>& keys, KVCallback cb) {
+void Part::asyncMultiRemove(std::vector<std::string> keys, KVCallback cb) {
+  if (FLAGS_merge_concurrent_writes) {
+    MergedWrite write;
+    write.type = OP_MULTI_REMOVE;
+    write.keys = std::move(keys);
+    write.cb = std::move(cb);
+    asyncMergedWrite(std::move(write));
+    return;
+  }
   std::string log = encodeMultiValues(OP_MULTI_REMOVE, keys);
 
   appendAsync(FLAGS_cluster_id, std::move(log))
@@ -104,6 +129,75 @@ void Part::asyncMultiRemove(const std::vector<std::string>& keys, KVCallback cb)
           [callback = std::move(cb)](nebula::cpp2::ErrorCode code) mutable { callback(code); });
 }
 
+void Part::asyncMergedWrite(MergedWrite write) {
+  size_t bytes = 0;
+  for (const auto& kv : write.kvs) {
+    bytes += kv.first.size() + kv.second.size();
+  }
+  for (const auto& key : write.keys) {
+    bytes += key.size();
+  }
+  std::vector<MergedWrite> writes;
+  {
+    std::lock_guard<std::mutex> g(mergeLock_);
+    pendingWrites_.emplace_back(std::move(write));
+    pendingWriteBytes_ += bytes;
+    if (numMergedInFlight_ > 0 && pendingWriteBytes_ < FLAGS_max_merged_write_bytes) {
+      // Replicated with the others arriving meanwhile when the one in flight is done
+      return;
+    }
+    numMergedInFlight_++;
+    writes.swap(pendingWrites_);
+    pendingWriteBytes_ = 0;
+  }
+  appendMergedWrites(std::move(writes));
+}
+
+void Part::appendMergedWrites(std::vector<MergedWrite> writes) {
+  std::string log;
+  if (writes.size() == 1) {
+    auto& write = writes.front();
+    log = write.type == OP_MULTI_PUT ? encodeMultiValues(OP_MULTI_PUT, write.kvs)
+                                     : encodeMultiValues(OP_MULTI_REMOVE, write.keys);
+  } else {
+    // The operations are applied in the order the requests arrived
+    BatchHolder batch;
+    for (auto& write : writes) {
+      for (auto& kv : write.kvs) {
+        batch.put(std::move(kv.first), std::move(kv.second));
+      }
+      for (auto& key : write.keys) {
+        batch.remove(std::move(key));
+      }
+    }
+    log = encodeBatchValue(batch.getBatch());
+    stats::StatsManager::addValue(kNumWritesMerged, writes.size() - 1);
+  }
+
+  std::vector<KVCallback> callbacks;
+  callbacks.reserve(writes.size());
+  for (auto& write : writes) {
+    callbacks.emplace_back(std::move(write.cb));
+  }
+  appendAsync(FLAGS_cluster_id, std::move(log))
+      .thenValue([this, callbacks = std::move(callbacks)](nebula::cpp2::ErrorCode code) mutable {
+        for (auto& cb : callbacks) {
+          cb(code);
+        }
+        std::vector<MergedWrite> next;
+        {
+          std::lock_guard<std::mutex> g(mergeLock_);
+          if (pendingWrites_.empty()) {
+            numMergedInFlight_--;
+            return;
+          }
+          next.swap(pendingWrites_);
+          pendingWriteBytes_ = 0;
+        }
+        appendMergedWrites(std::move(next));
+      });
+}
+
 void Part::asyncRemoveRange(folly::StringPiece start, folly::StringPiece end, KVCallback cb) {
   std::string log = encodeMultiValues(OP_REMOVE_RANGE, start, end);
 
@@ -205,6 +299,21 @@ void Part::registerOnLeaderLost(LeaderChangeCB cb) {
   leaderLostCB_.emplace_back(std::move(cb));
 }
 
+void Part::registerOnCommitted(CommittedCB cb) {
+  committedCB_.emplace_back(std::move(cb));
+}
+
+void Part::onCommitted(const std::vector<std::string>& keys, bool all) {
+  CallbackOptions opt;
+  opt.spaceId = spaceId_;
+  opt.partId = partId_;
+  opt.term = term_;
+
+  for (auto& cb : committedCB_) {
+    cb(opt, keys, all);
+  }
+}
+
 void Part::onDiscoverNewLeader(HostAddr nLeader) {
   VLOG(2) << idStr_ << "Find the new leader " << nLeader;
   if (newLeaderCb_) {
@@ -222,6 +331,10 @@ std::tuple<nebula::cpp2::ErrorCode, LogID, TermID> Part::commitLogs(
   auto batch = engine_->startBatchWrite();
   LogID lastId = kNoCommitLogId;
   TermID lastTerm = kNoCommitLogTerm;
+  // The keys changed, only collected if anyone cares about them
+  bool collectKeys = !committedCB_.empty();
+  std::vector<std::string> changedKeys;
+  bool allChanged = false;
   while (iter->valid()) {
     lastId = iter->logId();
     lastTerm = iter->logTerm();
@@ -238,6 +351,9 @@ std::tuple<nebula::cpp2::ErrorCode, LogID, TermID> Part::commitLogs(
         auto pieces = decodeMultiValues(log);
         DCHECK_EQ(2, pieces.size());
         auto code = batch->put(pieces[0], pieces[1]);
+        if (collectKeys) {
+          changedKeys.emplace_back(pieces[0].str());
+        }
         if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
           VLOG(3) << idStr_ << "Failed to call WriteBatch::put()";
           return {code, kNoCommitLogId, kNoCommitLogTerm};
@@ -252,6 +368,9 @@ std::tuple<nebula::cpp2::ErrorCode, LogID, TermID> Part::commitLogs(
           VLOG(4) << "OP_MULTI_PUT " << folly::hexlify(kvs[i])
                   << ", val = " << folly::hexlify(kvs[i + 1]);
           auto code = batch->put(kvs[i], kvs[i + 1]);
+          if (collectKeys) {
+            changedKeys.emplace_back(kvs[i].str());
+          }
           if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
             VLOG(3) << idStr_ << "Failed to call WriteBatch::put()";
             return {code, kNoCommitLogId, kNoCommitLogTerm};
@@ -262,6 +381,9 @@ std::tuple<nebula::cpp2::ErrorCode, LogID, TermID> Part::commitLogs(
       case OP_REMOVE: {
         auto key = decodeSingleValue(log);
         auto code = batch->remove(key);
+        if (collectKeys) {
+          changedKeys.emplace_back(key.str());
+        }
         if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
           VLOG(3) << idStr_ << "Failed to call WriteBatch::remove()";
           return {code, kNoCommitLogId, kNoCommitLogTerm};
@@ -272,6 +394,9 @@ std::tuple<nebula::cpp2::ErrorCode, LogID, TermID> Part::commitLogs(
         auto keys = decodeMultiValues(log);
         for (auto k : keys) {
           auto code = batch->remove(k);
+          if (collectKeys) {
+            changedKeys.emplace_back(k.str());
+          }
           if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
             VLOG(3) << idStr_ << "Failed to call WriteBatch::remove()";
             return {code, kNoCommitLogId, kNoCommitLogTerm};
@@ -283,6 +408,7 @@ std::tuple<nebula::cpp2::ErrorCode, LogID, TermID> Part::commitLogs(
         auto range = decodeMultiValues(log);
         DCHECK_EQ(2, range.size());
         auto code = batch->removeRange(range[0], range[1]);
+        allChanged = true;
         if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
           VLOG(3) << idStr_ << "Failed to call WriteBatch::removeRange()";
           return {code, kNoCommitLogId, kNoCommitLogTerm};
@@ -301,6 +427,10 @@ std::tuple<nebula::cpp2::ErrorCode, LogID, TermID> Part::commitLogs(
             code = batch->remove(op.second.first);
           } else if (op.first == BatchLogType::OP_BATCH_REMOVE_RANGE) {
             code = batch->removeRange(op.second.first, op.second.second);
+            allChanged = true;
+          }
+          if (collectKeys && op.first != BatchLogType::OP_BATCH_REMOVE_RANGE) {
+            changedKeys.emplace_back(op.second.first.str());
           }
           if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
             VLOG(3) << idStr_ << "Failed to call WriteBatch";
@@ -357,6 +487,9 @@ std::tuple<nebula::cpp2::ErrorCode, LogID, TermID> Part::commitLogs(
   auto code = engine_->commitBatchWrite(
       std::move(batch), FLAGS_rocksdb_disable_wal, FLAGS_rocksdb_wal_sync, wait);
   if (code == nebula::cpp2::ErrorCode::SUCCEEDED) {
+    if (collectKeys && (allChanged || !changedKeys.empty())) {
+      onCommitted(changedKeys, allChanged);
+    }
     return {code, lastId, lastTerm};
   } else {
     return {code, kNoCommitLogId, kNoCommitLogTerm};
@@ -397,6 +530,9 @@ std::tuple<nebula::cpp2::ErrorCode, int64_t, int64_t> Part::commitSnapshot(
   if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
     return {code, kNoSnapshotCount, kNoSnapshotSize};
   }
+  if (!committedCB_.empty()) {
+    onCommitted({}, true);
+  }
   return {code, count, size};
 }
 
@@ -557,8 +693,12 @@ nebula::cpp2::ErrorCode Part::cleanup() {
             << apache::thrift::util::enumNameSafe(ret);
     return ret;
   }
-  return engine_->commitBatchWrite(
+  ret = engine_->commitBatchWrite(
       std::move(batch), FLAGS_rocksdb_disable_wal, FLAGS_rocksdb_wal_sync, true);
+  if (ret == nebula::cpp2::ErrorCode::SUCCEEDED && !committedCB_.empty()) {
+    onCommitted({}, true);
+  }
+  return ret;
 }
 
 nebula::cpp2::ErrorCode Part::metaCleanup() {
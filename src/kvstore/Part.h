@@ -10,6 +10,7 @@
 #include "common/utils/NebulaKeyUtils.h"
 #include "kvstore/Common.h"
 #include "kvstore/KVEngine.h"
+#include "kvstore/LogEncoder.h"
 #include "kvstore/raftex/SnapshotManager.h"
 #include "kvstore/wal/FileBasedWal.h"
 #include "raftex/RaftPart.h"
@@ -81,7 +82,7 @@ class Part : public raftex::RaftPart {
    * @param keyValues Key/values to put
    * @param cb Callback when has a result
    */
-  void asyncMultiPut(const std::vector<KV>& keyValues, KVCallback cb);
+  void asyncMultiPut(std::vector<KV> keyValues, KVCallback cb);
 
   /**
    * @brief Remove a key from kvstore asynchronously
@@ -97,7 +98,7 @@ class Part : public raftex::RaftPart {
    * @param key Keys to remove
    * @param cb Callback when has a result
    */
-  void asyncMultiRemove(const std::vector<std::string>& keys, KVCallback cb);
+  void asyncMultiRemove(std::vector<std::string> keys, KVCallback cb);
 
   /**
    * @brief Remove keys in range [start, end) asynchronously
@@ -339,6 +340,27 @@ class Part : public raftex::RaftPart {
    */
   void registerOnLeaderLost(LeaderChangeCB cb);
 
+  /**
+   * @brief Callback after the logs are committed to the engine, with the keys put or removed by
+   * them. If `all` is true, a range of keys is removed or the data of the part is replaced, and all
+   * keys of the part should be regarded as changed.
+   */
+  using CommittedCB = std::function<void(
+      const CallbackOptions& opt, const std::vector<std::string>& keys, bool all)>;
+
+  /**
+   * @brief Register callback after the data of the part is changed, on both leader and followers
+   */
+  void registerOnCommitted(CommittedCB cb);
+
+  /**
+   * @brief Invoke the callbacks registered by registerOnCommitted with all keys changed, when the
+   * data of the part is changed out of the raft apply, e.g. the sst files are ingested
+   */
+  void onDataChanged() {
+    onCommitted({}, true);
+  }
+
  protected:
   GraphSpaceID spaceId_;
   PartitionID partId_;
@@ -346,10 +368,47 @@ class Part : public raftex::RaftPart {
   NewLeaderCallback newLeaderCb_ = nullptr;
   std::vector<LeaderChangeCB> leaderReadyCB_;
   std::vector<LeaderChangeCB> leaderLostCB_;
+  std::vector<CommittedCB> committedCB_;
 
  private:
+  // A multi put or multi remove request waiting to be merged with the others
+  struct MergedWrite {
+    LogType type;
+    std::vector<KV> kvs;
+    std::vector<std::string> keys;
+    KVCallback cb;
+  };
+
+  /**
+   * @brief Invoke the callbacks registered by registerOnCommitted
+   */
+  void onCommitted(const std::vector<std::string>& keys, bool all);
+
+  /**
+   * @brief Replicate the write with the others arriving while a merged log is in flight. The
+   * requests pending are merged into one log when the log in flight is done, so the concurrent
+   * small writes to a part take one raft log instead of one each. The memory locks of the keys are
+   * held by the processors until the callbacks, so the merged requests never conflict.
+   *
+   * @param write The request
+   */
+  void asyncMergedWrite(MergedWrite write);
+
+  /**
+   * @brief Encode the writes into one log, and replicate it
+   *
+   * @param writes The requests to merge
+   */
+  void appendMergedWrites(std::vector<MergedWrite> writes);
+
   KVEngine* engine_ = nullptr;
   int32_t vIdLen_;
+
+  std::mutex mergeLock_;
+  std::vector<MergedWrite> pendingWrites_;
+  size_t pendingWriteBytes_{0};
+  // Number of the merged logs being replicated
+  size_t numMergedInFlight_{0};
 };
 
 }  // namespace kvstore
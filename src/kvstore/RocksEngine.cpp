@@ -8,6 +8,8 @@
 #include <folly/String.h>
 #include <rocksdb/convenience.h>
 
+#include <numeric>
+
 #include "common/base/Base.h"
 #include "common/fs/FileUtils.h"
 #include "common/utils/MetaKeyUtils.h"
@@ -15,6 +17,9 @@
 #include "kvstore/KVStore.h"
 
 DEFINE_bool(move_files, false, "Move the SST files instead of copy when ingest into dataset");
+DEFINE_bool(rocksdb_drop_expired_files,
+            true,
+            "Whether to drop the sst files whose rows are all expired by ttl before compaction");
 DEFINE_int64(balance_expired_sesc,
              86400,
              "The expired time of balancing part info persisted in the storaged");
@@ -35,11 +40,12 @@ RocksEngine::RocksEngine(GraphSpaceID spaceId,
                          const std::string& dataPath,
                          const std::string& walPath,
                          std::shared_ptr<rocksdb::MergeOperator> mergeOp,
-                         std::shared_ptr<rocksdb::CompactionFilterFactory> cfFactory,
+                         std::shared_ptr<KVCompactionFilterFactory> cfFactory,
                          bool readonly)
     : KVEngine(spaceId),
       spaceId_(spaceId),
-      dataPath_(folly::stringPrintf("%s/nebula/%d", dataPath.c_str(), spaceId)) {
+      dataPath_(folly::stringPrintf("%s/nebula/%d", dataPath.c_str(), spaceId)),
+      cfFactory_(cfFactory) {
   // set wal path as dataPath by default
   if (walPath.empty()) {
     walPath_ = folly::stringPrintf("%s/nebula/%d", dataPath.c_str(), spaceId);
@@ -72,6 +78,10 @@ RocksEngine::RocksEngine(GraphSpaceID spaceId,
   }
   if (cfFactory != nullptr) {
     options.compaction_filter_factory = cfFactory;
+    auto collectorFactory = cfFactory->createTablePropertiesCollectorFactory();
+    if (collectorFactory != nullptr) {
+      options.table_properties_collector_factories.emplace_back(std::move(collectorFactory));
+    }
   }
 
   if (readonly) {
@@ -164,22 +174,42 @@ std::vector<Status> RocksEngine::multiGet(const std::vector<std::string>& keys,
                                           std::vector<std::string>* values) {
   memory::MemoryCheckOffGuard guard;
   rocksdb::ReadOptions options;
+  // The batched MultiGet looks up the keys in the key order, which shares the index and data
+  // blocks read among the keys in the same block
+  std::vector<size_t> order(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&keys](size_t lhs, size_t rhs) {
+    return keys[lhs] < keys[rhs];
+  });
   std::vector<rocksdb::Slice> slices;
-  for (size_t index = 0; index < keys.size(); index++) {
+  slices.reserve(keys.size());
+  for (auto index : order) {
     slices.emplace_back(keys[index]);
   }
-
-  auto status = db_->MultiGet(options, slices, values);
-  std::vector<Status> ret;
-  std::transform(status.begin(), status.end(), std::back_inserter(ret), [](const auto& s) {
-    if (s.ok()) {
-      return Status::OK();
-    } else if (s.IsNotFound()) {
-      return Status::KeyNotFound();
+  std::vector<rocksdb::PinnableSlice> pinned(keys.size());
+  std::vector<rocksdb::Status> status(keys.size());
+  db_->MultiGet(options,
+                db_->DefaultColumnFamily(),
+                slices.size(),
+                slices.data(),
+                pinned.data(),
+                status.data(),
+                true);
+
+  std::vector<Status> ret(keys.size());
+  values->clear();
+  values->resize(keys.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    auto index = order[i];
+    if (status[i].ok()) {
+      (*values)[index] = pinned[i].ToString();
+      ret[index] = Status::OK();
+    } else if (status[i].IsNotFound()) {
+      ret[index] = Status::KeyNotFound();
     } else {
-      return Status::Error();
+      ret[index] = Status::Error();
     }
-  });
+  }
   return ret;
 }
 
@@ -525,6 +555,9 @@ ErrorOr<nebula::cpp2::ErrorCode, std::string> RocksEngine::getProperty(
 }
 
 nebula::cpp2::ErrorCode RocksEngine::compact() {
+  if (FLAGS_rocksdb_drop_expired_files) {
+    dropExpiredFiles();
+  }
   rocksdb::CompactRangeOptions options;
   options.change_level = FLAGS_rocksdb_compact_change_level;
   options.target_level = FLAGS_rocksdb_compact_target_level;
@@ -537,6 +570,64 @@ nebula::cpp2::ErrorCode RocksEngine::compact() {
   }
 }
 
+size_t RocksEngine::dropExpiredFiles() {
+  if (cfFactory_ == nullptr) {
+    return 0;
+  }
+  rocksdb::TablePropertiesCollection props;
+  auto status = db_->GetPropertiesOfAllTables(&props);
+  if (!status.ok()) {
+    LOG(WARNING) << "Get the table properties failed: " << status.ToString();
+    return 0;
+  }
+  std::vector<rocksdb::LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  std::sort(files.begin(), files.end(), [](const auto& a, const auto& b) {
+    return a.smallestkey < b.smallestkey;
+  });
+
+  // Split the files of all levels into the groups overlapping each other, a group is dropped if
+  // all of its files are expired
+  std::vector<rocksdb::Slice> bounds;
+  bounds.reserve(files.size() * 2);
+  std::vector<rocksdb::RangePtr> ranges;
+  size_t numDropped = 0;
+  size_t begin = 0;
+  while (begin < files.size()) {
+    // The file with the largest key in the group
+    size_t last = begin;
+    bool expired = true;
+    size_t end = begin;
+    for (; end < files.size() && (end == begin || files[end].smallestkey <= files[last].largestkey);
+         ++end) {
+      if (files[end].largestkey > files[last].largestkey) {
+        last = end;
+      }
+      auto it = props.find(files[end].db_path + files[end].name);
+      expired = expired && it != props.end() && it->second->num_range_deletions == 0 &&
+                cfFactory_->expired(*it->second);
+    }
+    if (expired) {
+      bounds.emplace_back(files[begin].smallestkey);
+      bounds.emplace_back(files[last].largestkey);
+      ranges.emplace_back(&bounds[bounds.size() - 2], &bounds.back());
+      numDropped += end - begin;
+    }
+    begin = end;
+  }
+  if (ranges.empty()) {
+    return 0;
+  }
+  status = rocksdb::DeleteFilesInRanges(
+      db_.get(), db_->DefaultColumnFamily(), ranges.data(), ranges.size(), true);
+  if (!status.ok()) {
+    LOG(WARNING) << "Drop the expired files failed: " << status.ToString();
+    return 0;
+  }
+  LOG(INFO) << "Dropped " << numDropped << " expired files of space " << spaceId_;
+  return numDropped;
+}
+
 nebula::cpp2::ErrorCode RocksEngine::flush() {
   rocksdb::FlushOptions options;
   rocksdb::Status status = db_->Flush(options);
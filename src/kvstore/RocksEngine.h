@@ -15,6 +15,7 @@
 
 #include "common/base/Base.h"
 #include "common/utils/NebulaKeyUtils.h"
+#include "kvstore/CompactionFilter.h"
 #include "kvstore/KVEngine.h"
 #include "kvstore/KVIterator.h"
 #include "kvstore/RocksEngineConfig.h"
@@ -128,6 +129,20 @@ class RocksPrefixIter : public KVIterator {
     iter_ = std::move(iter);
   }
 
+  bool seekPrefix(const std::string& prefix) override {
+    if (!iter_) {
+      return false;
+    }
+    prefix_ = rocksdb::Slice(prefix);
+    if (!scratch_.empty()) {
+      // The upper bound in the read options points to upperBound_, which is moved along
+      scratch_ = NebulaKeyUtils::lastKey(prefix, 128);
+      upperBound_ = rocksdb::Slice(scratch_);
+    }
+    iter_->Seek(prefix_);
+    return true;
+  }
+
  protected:
   std::unique_ptr<rocksdb::Iterator> iter_{nullptr};
   rocksdb::Slice prefix_;
@@ -240,7 +255,7 @@ class RocksEngine : public KVEngine {
               const std::string& dataPath,
               const std::string& walPath = "",
               std::shared_ptr<rocksdb::MergeOperator> mergeOp = nullptr,
-              std::shared_ptr<rocksdb::CompactionFilterFactory> cfFactory = nullptr,
+              std::shared_ptr<KVCompactionFilterFactory> cfFactory = nullptr,
               bool readonly = false);
 
   ~RocksEngine() {
@@ -531,6 +546,15 @@ class RocksEngine : public KVEngine {
    */
   nebula::cpp2::ErrorCode compact() override;
 
+  /**
+   * @brief Drop the sst files whose entries are all expired, see KVCompactionFilterFactory. The
+   * files overlapping each other are dropped all together or not at all, so no older version of a
+   * key dropped would show up again.
+   *
+   * @return size_t Number of files dropped
+   */
+  size_t dropExpiredFiles();
+
   /**
    * @brief Flush data in memtable into sst
    *
@@ -599,6 +623,7 @@ class RocksEngine : public KVEngine {
   std::string dataPath_;
   std::string walPath_;
   std::unique_ptr<rocksdb::DB> db_{nullptr};
+  std::shared_ptr<KVCompactionFilterFactory> cfFactory_;
   std::string backupPath_;
   std::unique_ptr<rocksdb::BackupEngine> backupDb_{nullptr};
   int32_t partsNum_ = -1;
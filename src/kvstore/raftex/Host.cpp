@@ -19,6 +19,13 @@
 DEFINE_uint32(max_appendlog_batch_size,
               128,
               "The max number of logs in each appendLog request batch");
+DEFINE_uint64(max_appendlog_batch_bytes,
+              4 * 1024 * 1024,
+              "The max size of the logs in each appendLog request batch, the size of a batch "
+              "adapts to the round trip time of the peer below it");
+DEFINE_uint32(max_appendlog_inflight_batches,
+              4,
+              "The max number of appendLog request batches in flight to a peer");
 DEFINE_uint32(max_outstanding_requests, 1024, "The max number of outstanding appendLog requests");
 DEFINE_int32(raft_rpc_timeout_ms, 1000, "rpc timeout for raft client");
 DEFINE_int32(pause_host_time_factor,
@@ -39,7 +46,8 @@ Host::Host(const HostAddr& addr, std::shared_ptr<RaftPart> part, bool isLearner)
       isLearner_(isLearner),
       idStr_(folly::stringPrintf(
           "%s[Host: %s:%d] ", part_->idStr_.c_str(), addr_.host.c_str(), addr_.port)),
-      cachingPromise_(folly::SharedPromise<cpp2::AppendLogResponse>()) {}
+      cachingPromise_(folly::SharedPromise<cpp2::AppendLogResponse>()),
+      batchBytes_(FLAGS_max_appendlog_batch_bytes) {}
 
 void Host::waitForStop() {
   std::unique_lock<std::mutex> g(lock_);
@@ -98,7 +106,8 @@ folly::Future<cpp2::AppendLogResponse> Host::appendLogs(folly::EventBase* eb,
   VLOG(4) << idStr_ << "Entering Host::appendLogs()";
 
   auto ret = folly::Future<cpp2::AppendLogResponse>::makeEmpty();
-  std::shared_ptr<cpp2::AppendLogRequest> req;
+  std::vector<std::shared_ptr<cpp2::AppendLogRequest>> reqs;
+  uint64_t window = 0;
   {
     std::lock_guard<std::mutex> g(lock_);
 
@@ -107,15 +116,9 @@ folly::Future<cpp2::AppendLogResponse> Host::appendLogs(folly::EventBase* eb,
     if (UNLIKELY(sendingSnapshot_)) {
       VLOG_EVERY_N(2, 1000) << idStr_ << "The target host is waiting for a snapshot";
       res = nebula::cpp2::ErrorCode::E_RAFT_WAITING_SNAPSHOT;
-    } else if (requestOnGoing_) {
-      // buffer incoming request to pendingReq_
-      if (cachingPromise_.size() <= FLAGS_max_outstanding_requests) {
-        pendingReq_ = std::make_tuple(term, logId, committedLogId);
-        return cachingPromise_.getFuture();
-      } else {
-        VLOG_EVERY_N(2, 1000) << idStr_ << "Too many requests are waiting, return error";
-        res = nebula::cpp2::ErrorCode::E_RAFT_TOO_MANY_REQUESTS;
-      }
+    } else if (requestOnGoing_ && cachingPromise_.size() > FLAGS_max_outstanding_requests) {
+      VLOG_EVERY_N(2, 1000) << idStr_ << "Too many requests are waiting, return error";
+      res = nebula::cpp2::ErrorCode::E_RAFT_TOO_MANY_REQUESTS;
     }
 
     if (res != nebula::cpp2::ErrorCode::SUCCEEDED) {
@@ -125,9 +128,6 @@ folly::Future<cpp2::AppendLogResponse> Host::appendLogs(folly::EventBase* eb,
       return r;
     }
 
-    VLOG(4) << idStr_ << "About to send the AppendLog request";
-
-    // No request is ongoing, let's send a new request
     if (UNLIKELY(lastLogIdSent_ == 0 && lastLogTermSent_ == 0)) {
       lastLogIdSent_ = prevLogId;
       lastLogTermSent_ = prevLogTerm;
@@ -139,48 +139,119 @@ folly::Future<cpp2::AppendLogResponse> Host::appendLogs(folly::EventBase* eb,
     logIdToSend_ = logId;
     committedLogId_ = committedLogId;
 
-    auto result = prepareAppendLogRequest();
-    if (ok(result)) {
-      VLOG_IF(1, FLAGS_trace_raft) << idStr_ << "Sending the pending request in the queue"
-                                   << ", from " << lastLogIdSent_ + 1 << " to " << logIdToSend_;
-      req = std::move(value(result));
-      pendingReq_ = std::make_tuple(0, 0, 0);
-      promise_ = std::move(cachingPromise_);
-      cachingPromise_ = folly::SharedPromise<cpp2::AppendLogResponse>();
+    if (promiseLogId_ == kNoPromise) {
+      // Nothing is waited for, the logs up to logId are waited for by promise_
+      promise_ = folly::SharedPromise<cpp2::AppendLogResponse>();
+      promiseLogId_ = logIdToSend_;
       ret = promise_.getFuture();
-      requestOnGoing_ = true;
     } else {
+      // promise_ is waiting for the earlier logs, the logs up to logId will be waited for by
+      // cachingPromise_ once promise_ is fulfilled
+      ret = cachingPromise_.getFuture();
+    }
+    requestOnGoing_ = true;
+
+    // When there are batches in flight, the new logs are sent as soon as the window has room
+    auto code = prepareWindow(reqs, numInFlight_ == 0);
+    if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
       // target host is waiting for a snapshot or wal not found
       cpp2::AppendLogResponse r;
-      r.error_code_ref() = error(result);
-      return r;
+      r.error_code_ref() = code;
+      setResponse(r);
+      return ret;
     }
+    window = window_;
   }
 
-  // Get a new promise
-  appendLogsInternal(eb, std::move(req));
-
+  for (auto& req : reqs) {
+    appendLogsInternal(eb, std::move(req), window);
+  }
   return ret;
 }
 
 void Host::setResponse(const cpp2::AppendLogResponse& r) {
   CHECK(!lock_.try_lock());
-  promise_.setValue(r);
+  if (promiseLogId_ != kNoPromise) {
+    promise_.setValue(r);
+    promiseLogId_ = kNoPromise;
+  }
   cachingPromise_.setValue(r);
   cachingPromise_ = folly::SharedPromise<cpp2::AppendLogResponse>();
-  pendingReq_ = std::make_tuple(0, 0, 0);
+  // The responses of the requests still in flight are ignored
+  window_++;
+  numInFlight_ = 0;
   requestOnGoing_ = false;
   noMoreRequestCV_.notify_all();
 }
 
-void Host::appendLogsInternal(folly::EventBase* eb, std::shared_ptr<cpp2::AppendLogRequest> req) {
+void Host::fulfillPromises(const cpp2::AppendLogResponse& resp) {
+  CHECK(!lock_.try_lock());
+  while (promiseLogId_ != kNoPromise && lastLogIdSent_ >= promiseLogId_) {
+    promise_.setValue(resp);
+    if (cachingPromise_.size() == 0) {
+      promiseLogId_ = kNoPromise;
+      break;
+    }
+    // The requests cached while promise_ was waited for are for the logs up to logIdToSend_
+    promise_ = std::move(cachingPromise_);
+    cachingPromise_ = folly::SharedPromise<cpp2::AppendLogResponse>();
+    promiseLogId_ = logIdToSend_;
+  }
+}
+
+nebula::cpp2::ErrorCode Host::prepareWindow(
+    std::vector<std::shared_ptr<cpp2::AppendLogRequest>>& reqs, bool sendIfNoLogs) {
+  CHECK(!lock_.try_lock());
+  if (numInFlight_ == 0) {
+    // Start a new window from the last log acknowledged
+    lastLogIdInFlight_ = lastLogIdSent_;
+    lastLogTermInFlight_ = lastLogTermSent_;
+  }
+  size_t maxInFlight = std::max<size_t>(1, FLAGS_max_appendlog_inflight_batches);
+  while (numInFlight_ < maxInFlight && lastLogIdInFlight_ < logIdToSend_) {
+    auto result = prepareAppendLogRequest();
+    if (!ok(result)) {
+      return error(result);
+    }
+    reqs.emplace_back(std::move(value(result)));
+    numInFlight_++;
+  }
+  if (reqs.empty() && numInFlight_ == 0 && sendIfNoLogs) {
+    // Nothing new to the peer, the request only carries the committed log id
+    auto result = prepareAppendLogRequest();
+    if (!ok(result)) {
+      return error(result);
+    }
+    reqs.emplace_back(std::move(value(result)));
+    numInFlight_++;
+  }
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
+}
+
+void Host::adjustBatchBytes(int64_t rttUs, size_t bytes) {
+  CHECK(!lock_.try_lock());
+  // A batch should come back well within the rpc timeout, halve the budget when a batch takes
+  // more than a quarter of the timeout, and double it when a full batch comes back in time
+  static constexpr size_t kMinBatchBytes = 64 * 1024;
+  size_t maxBytes = std::max<size_t>(kMinBatchBytes, FLAGS_max_appendlog_batch_bytes);
+  if (rttUs * 4 > FLAGS_raft_rpc_timeout_ms * 1000L) {
+    batchBytes_ = std::max(kMinBatchBytes, batchBytes_ / 2);
+  } else if (bytes >= batchBytes_) {
+    batchBytes_ = std::min(maxBytes, batchBytes_ * 2);
+  }
+}
+
+void Host::appendLogsInternal(folly::EventBase* eb,
+                              std::shared_ptr<cpp2::AppendLogRequest> req,
+                              uint64_t window) {
   using TransportException = apache::thrift::transport::TTransportException;
   auto beforeRpcUs = time::WallClock::fastNowInMicroSec();
   sendAppendLogRequest(eb, req)
       .via(eb)
-      .thenValue([eb, beforeRpcUs, self = shared_from_this()](cpp2::AppendLogResponse&& resp) {
-        stats::StatsManager::addValue(kAppendLogLatencyUs,
-                                      time::WallClock::fastNowInMicroSec() - beforeRpcUs);
+      .thenValue([eb, beforeRpcUs, req, window, self = shared_from_this()](
+                     cpp2::AppendLogResponse&& resp) {
+        auto rttUs = time::WallClock::fastNowInMicroSec() - beforeRpcUs;
+        stats::StatsManager::addValue(kAppendLogLatencyUs, rttUs);
         VLOG_IF(1, FLAGS_trace_raft)
             << self->idStr_ << "AppendLogResponse "
             << "code " << apache::thrift::util::enumNameSafe(resp.get_error_code()) << ", currTerm "
@@ -193,9 +264,15 @@ void Host::appendLogsInternal(folly::EventBase* eb, std::shared_ptr<cpp2::Append
           case nebula::cpp2::ErrorCode::E_RAFT_LOG_STALE: {
             VLOG(3) << self->idStr_ << "AppendLog request sent successfully";
 
-            std::shared_ptr<cpp2::AppendLogRequest> newReq;
+            std::vector<std::shared_ptr<cpp2::AppendLogRequest>> newReqs;
+            uint64_t newWindow = 0;
             {
               std::lock_guard<std::mutex> g(self->lock_);
+              if (window != self->window_) {
+                VLOG(3) << self->idStr_ << "Ignore the response of a request sent before reset";
+                return;
+              }
+              self->numInFlight_--;
               auto res = self->canAppendLog();
               if (res != nebula::cpp2::ErrorCode::SUCCEEDED) {
                 cpp2::AppendLogResponse r;
@@ -204,32 +281,52 @@ void Host::appendLogsInternal(folly::EventBase* eb, std::shared_ptr<cpp2::Append
                 return;
               }
               // Host is working
-              self->lastLogIdSent_ = resp.get_last_matched_log_id();
-              self->lastLogTermSent_ = resp.get_last_matched_log_term();
-              self->followerCommittedLogId_ = resp.get_committed_log_id();
-              if (self->lastLogIdSent_ < self->logIdToSend_) {
-                // More to send
-                VLOG(3) << self->idStr_ << "There are more logs to send";
-                auto result = self->prepareAppendLogRequest();
-                if (ok(result)) {
-                  newReq = std::move(value(result));
-                } else {
-                  cpp2::AppendLogResponse r;
-                  r.error_code_ref() = error(result);
-                  self->setResponse(r);
-                  return;
+              size_t bytes = 0;
+              for (const auto& log : req->get_log_str_list()) {
+                bytes += log.get_log_str().computeChainDataLength();
+              }
+              self->adjustBatchBytes(rttUs, bytes);
+
+              auto lastId = req->get_last_log_id_sent() +
+                            static_cast<LogID>(req->get_log_str_list().size());
+              if (resp.get_error_code() == nebula::cpp2::ErrorCode::SUCCEEDED &&
+                  resp.get_last_matched_log_id() == lastId) {
+                // The batches of a window may be acknowledged out of order, only move forward
+                if (lastId > self->lastLogIdSent_) {
+                  self->lastLogIdSent_ = lastId;
+                  self->lastLogTermSent_ = resp.get_last_matched_log_term();
                 }
               } else {
-                // resp.get_last_matched_log_id() >= self->logIdToSend_
-                // All logs up to logIdToSend_ has been sent, fulfill the promise
-                self->promise_.setValue(resp);
-                // Check if there are any pending request:
-                // Either send pending request if any, or set Host to vacant
-                newReq = self->getPendingReqIfAny(self);
+                // The peer doesn't have the logs the window is built on, e.g. a batch arrived
+                // before the previous one, resend from the log it matched
+                VLOG_IF(1, FLAGS_trace_raft)
+                    << self->idStr_ << "Restart the window from " << resp.get_last_matched_log_id()
+                    << ", " << self->numInFlight_ << " batches in flight are dropped";
+                self->window_++;
+                self->numInFlight_ = 0;
+                self->lastLogIdSent_ = resp.get_last_matched_log_id();
+                self->lastLogTermSent_ = resp.get_last_matched_log_term();
               }
+              self->followerCommittedLogId_ = resp.get_committed_log_id();
+
+              // Fulfill the promises of the logs acknowledged, and keep the window full
+              self->fulfillPromises(resp);
+              auto code = self->prepareWindow(newReqs, false);
+              if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+                cpp2::AppendLogResponse r;
+                r.error_code_ref() = code;
+                self->setResponse(r);
+                return;
+              }
+              if (self->numInFlight_ == 0) {
+                // All logs up to logIdToSend_ have been acknowledged, set Host to vacant
+                self->requestOnGoing_ = false;
+                self->noMoreRequestCV_.notify_all();
+              }
+              newWindow = self->window_;
             }
-            if (newReq) {
-              self->appendLogsInternal(eb, newReq);
+            for (auto& newReq : newReqs) {
+              self->appendLogsInternal(eb, std::move(newReq), newWindow);
             }
             return;
           }
@@ -242,14 +339,16 @@ void Host::appendLogsInternal(folly::EventBase* eb, std::shared_ptr<cpp2::Append
                                   << ")";
             {
               std::lock_guard<std::mutex> g(self->lock_);
-              self->setResponse(resp);
+              if (window == self->window_) {
+                self->setResponse(resp);
+              }
             }
             return;
           }
         }
       })
       .thenError(folly::tag_t<TransportException>{},
-                 [self = shared_from_this(), req](TransportException&& ex) {
+                 [self = shared_from_this(), req, window](TransportException&& ex) {
                    VLOG(4) << self->idStr_ << ex.what();
                    cpp2::AppendLogResponse r;
                    r.error_code_ref() = nebula::cpp2::ErrorCode::E_RAFT_RPC_EXCEPTION;
@@ -266,28 +365,33 @@ void Host::appendLogsInternal(folly::EventBase* eb, std::shared_ptr<cpp2::Append
                            << self->logIdToSend_ << ", logs size "
                            << req->get_log_str_list().size();
                      }
-                     self->setResponse(r);
+                     if (window == self->window_) {
+                       self->setResponse(r);
+                     }
                    }
                    // a new raft log or heartbeat will trigger another appendLogs in Host
                    return;
                  })
-      .thenError(folly::tag_t<std::exception>{}, [self = shared_from_this()](std::exception&& ex) {
-        VLOG(4) << self->idStr_ << ex.what();
-        cpp2::AppendLogResponse r;
-        r.error_code_ref() = nebula::cpp2::ErrorCode::E_RAFT_RPC_EXCEPTION;
-        {
-          std::lock_guard<std::mutex> g(self->lock_);
-          self->setResponse(r);
-        }
-        // a new raft log or heartbeat will trigger another appendLogs in Host
-        return;
-      });
+      .thenError(folly::tag_t<std::exception>{},
+                 [self = shared_from_this(), window](std::exception&& ex) {
+                   VLOG(4) << self->idStr_ << ex.what();
+                   cpp2::AppendLogResponse r;
+                   r.error_code_ref() = nebula::cpp2::ErrorCode::E_RAFT_RPC_EXCEPTION;
+                   {
+                     std::lock_guard<std::mutex> g(self->lock_);
+                     if (window == self->window_) {
+                       self->setResponse(r);
+                     }
+                   }
+                   // a new raft log or heartbeat will trigger another appendLogs in Host
+                   return;
+                 });
 }
 
 ErrorOr<nebula::cpp2::ErrorCode, std::shared_ptr<cpp2::AppendLogRequest>>
 Host::prepareAppendLogRequest() {
   CHECK(!lock_.try_lock());
-  VLOG(3) << idStr_ << "Prepare AppendLogs request from Log " << lastLogIdSent_ + 1 << " to "
+  VLOG(3) << idStr_ << "Prepare AppendLogs request from Log " << lastLogIdInFlight_ + 1 << " to "
           << logIdToSend_;
 
   auto makeReq = [this]() -> std::shared_ptr<cpp2::AppendLogRequest> {
@@ -298,46 +402,57 @@ Host::prepareAppendLogRequest() {
     req->committed_log_id_ref() = committedLogId_;
     req->leader_addr_ref() = part_->address().host;
     req->leader_port_ref() = part_->address().port;
-    req->last_log_term_sent_ref() = lastLogTermSent_;
-    req->last_log_id_sent_ref() = lastLogIdSent_;
+    req->last_log_term_sent_ref() = lastLogTermInFlight_;
+    req->last_log_id_sent_ref() = lastLogIdInFlight_;
     return req;
   };
 
-  // We need to use lastLogIdSent_ + 1 to check whether need to send snapshot
-  if (UNLIKELY(lastLogIdSent_ + 1 < part_->wal()->firstLogId())) {
+  // We need to use lastLogIdInFlight_ + 1 to check whether need to send snapshot
+  if (UNLIKELY(lastLogIdInFlight_ + 1 < part_->wal()->firstLogId())) {
     return startSendSnapshot();
   }
 
-  if (lastLogIdSent_ == logIdToSend_) {
+  if (lastLogIdInFlight_ >= logIdToSend_) {
     auto req = makeReq();
     return req;
   }
 
-  if (lastLogIdSent_ + 1 > part_->wal()->lastLogId()) {
+  if (lastLogIdInFlight_ + 1 > part_->wal()->lastLogId()) {
     VLOG_IF(1, FLAGS_trace_raft) << idStr_ << "My lastLogId in wal is " << part_->wal()->lastLogId()
-                                 << ", but you are seeking " << lastLogIdSent_ + 1
+                                 << ", but you are seeking " << lastLogIdInFlight_ + 1
                                  << ", so i have nothing to send, logIdToSend_ = " << logIdToSend_;
     return nebula::cpp2::ErrorCode::E_RAFT_NO_WAL_FOUND;
   }
 
-  auto it = part_->wal()->iterator(lastLogIdSent_ + 1, logIdToSend_);
+  auto it = part_->wal()->iterator(lastLogIdInFlight_ + 1, logIdToSend_);
   if (it->valid()) {
     auto req = makeReq();
     std::vector<cpp2::RaftLogEntry> logs;
-    for (size_t cnt = 0; it->valid() && cnt < FLAGS_max_appendlog_batch_size; ++(*it), ++cnt) {
+    size_t bytes = 0;
+    // The batch is bounded by the number of logs and by the adaptive byte budget, but at least
+    // one log is sent
+    for (size_t cnt = 0;
+         it->valid() && cnt < FLAGS_max_appendlog_batch_size && (cnt == 0 || bytes < batchBytes_);
+         ++(*it), ++cnt) {
       cpp2::RaftLogEntry entry;
       entry.cluster_ref() = it->logSource();
-      entry.log_str_ref() = it->logMsg().toString();
+      // Shared with the wal and the requests to the other peers, not copied
+      entry.log_str_ref() = it->logBuf();
       entry.log_term_ref() = it->logTerm();
+      bytes += entry.get_log_str().computeChainDataLength();
       logs.emplace_back(std::move(entry));
     }
-    // the last log entry's id is (lastLogIdSent_ + cnt), when iterator is invalid and last log
+    // the last log entry's id is (lastLogIdInFlight_ + cnt), when iterator is invalid and last log
     // entry's id is not logIdToSend_, which means the log has been rollbacked
-    if (!it->valid() && (lastLogIdSent_ + static_cast<int64_t>(logs.size()) != logIdToSend_)) {
+    if (!it->valid() &&
+        (lastLogIdInFlight_ + static_cast<int64_t>(logs.size()) != logIdToSend_)) {
       VLOG_IF(1, FLAGS_trace_raft)
           << idStr_ << "Can't find log in wal, logIdToSend_ = " << logIdToSend_;
       return nebula::cpp2::ErrorCode::E_RAFT_NO_WAL_FOUND;
     }
+    // The next batch in the window follows this one
+    lastLogIdInFlight_ += logs.size();
+    lastLogTermInFlight_ = logs.back().get_log_term();
     req->log_str_list_ref() = std::move(logs);
     return req;
   } else {
@@ -490,46 +605,5 @@ folly::Future<cpp2::HeartbeatResponse> Host::sendHeartbeatRequest(
   return client->future_heartbeat(*req);
 }
 
-bool Host::noRequest() const {
-  CHECK(!lock_.try_lock());
-  static auto emptyTup = std::make_tuple(0, 0, 0);
-  return pendingReq_ == emptyTup;
-}
-
-std::shared_ptr<cpp2::AppendLogRequest> Host::getPendingReqIfAny(std::shared_ptr<Host> self) {
-  CHECK(!self->lock_.try_lock());
-  CHECK(self->requestOnGoing_) << self->idStr_;
-
-  // Check if there are any pending request to send
-  if (self->noRequest()) {
-    self->requestOnGoing_ = false;
-    self->noMoreRequestCV_.notify_all();
-    return nullptr;
-  }
-
-  // there is pending request
-  auto& tup = self->pendingReq_;
-  self->logTermToSend_ = std::get<0>(tup);
-  self->logIdToSend_ = std::get<1>(tup);
-  self->committedLogId_ = std::get<2>(tup);
-
-  VLOG_IF(1, FLAGS_trace_raft) << self->idStr_ << "Sending the pending request in the queue"
-                               << ", from " << self->lastLogIdSent_ + 1 << " to "
-                               << self->logIdToSend_;
-  self->pendingReq_ = std::make_tuple(0, 0, 0);
-  self->promise_ = std::move(self->cachingPromise_);
-  self->cachingPromise_ = folly::SharedPromise<cpp2::AppendLogResponse>();
-
-  auto result = self->prepareAppendLogRequest();
-  if (ok(result)) {
-    return value(result);
-  } else {
-    cpp2::AppendLogResponse r;
-    r.error_code_ref() = error(result);
-    self->setResponse(r);
-    return nullptr;
-  }
-}
-
 }  // namespace raftex
 }  // namespace nebula
@@ -27,6 +27,11 @@ class RaftPart;
 /**
  * @brief Host is a class to monitor how many log has been sent to a raft peer. It will send logs or
  * start election to the remote peer by rpc
+ *
+ * The logs are sent in a window of up to `--max_appendlog_inflight_batches` batches in flight, so a
+ * peer with a long round trip time is not limited to one batch per round trip. When the peer
+ * doesn't accept a batch, e.g. it arrived before the previous one, the window is restarted from
+ * the log the peer matched.
  */
 class Host final : public std::enable_shared_from_this<Host> {
   friend class RaftPart;
@@ -89,6 +94,8 @@ class Host final : public std::enable_shared_from_this<Host> {
     logTermToSend_ = 0;
     lastLogIdSent_ = 0;
     lastLogTermSent_ = 0;
+    lastLogIdInFlight_ = 0;
+    lastLogTermInFlight_ = 0;
     committedLogId_ = 0;
     sendingSnapshot_ = false;
     followerCommittedLogId_ = 0;
@@ -191,8 +198,12 @@ class Host final : public std::enable_shared_from_this<Host> {
    *
    * @param eb The eventbase to send rpc
    * @param req The rpc request
+   * @param window The window the request is sent in, the response is ignored if the window has
+   * been reset since
    */
-  void appendLogsInternal(folly::EventBase* eb, std::shared_ptr<cpp2::AppendLogRequest> req);
+  void appendLogsInternal(folly::EventBase* eb,
+                          std::shared_ptr<cpp2::AppendLogRequest> req,
+                          uint64_t window);
 
   folly::Future<cpp2::HeartbeatResponse> sendHeartbeatRequest(
       folly::EventBase* eb, std::shared_ptr<cpp2::HeartbeatRequest> req);
@@ -206,16 +217,31 @@ class Host final : public std::enable_shared_from_this<Host> {
   prepareAppendLogRequest();
 
   /**
-   * @brief Begin to start snapshot when we don't have the log in wal file
+   * @brief Build the batches following the ones in flight, until the window of
+   * `--max_appendlog_inflight_batches` batches is full or all logs up to logIdToSend_ are in flight
    *
+   * @param reqs The requests to send
+   * @param sendIfNoLogs Whether to send a request without logs when nothing is in flight, which
+   * carries the committed log id to the peer
    * @return nebula::cpp2::ErrorCode
    */
-  nebula::cpp2::ErrorCode startSendSnapshot();
+  nebula::cpp2::ErrorCode prepareWindow(std::vector<std::shared_ptr<cpp2::AppendLogRequest>>& reqs,
+                                        bool sendIfNoLogs);
 
   /**
-   * @brief Return true if there isn't a request in flight
+   * @brief Adapt the byte budget of a batch to the round trip time of a batch of the size
+   *
+   * @param rttUs Round trip time of the batch
+   * @param bytes Size of the logs in the batch
    */
-  bool noRequest() const;
+  void adjustBatchBytes(int64_t rttUs, size_t bytes);
+
+  /**
+   * @brief Begin to start snapshot when we don't have the log in wal file
+   *
+   * @return nebula::cpp2::ErrorCode
+   */
+  nebula::cpp2::ErrorCode startSendSnapshot();
 
   /**
    * @brief Notify the RaftPart the result of sending logs to peers
@@ -224,6 +250,13 @@ class Host final : public std::enable_shared_from_this<Host> {
    */
   void setResponse(const cpp2::AppendLogResponse& resp);
 
+  /**
+   * @brief Fulfill the promises waiting for the logs acknowledged by the peer
+   *
+   * @param resp RPC response
+   */
+  void fulfillPromises(const cpp2::AppendLogResponse& resp);
+
   void setLastHeartbeatTime(int64_t time) {
     lastHeartbeatTime_ = time;
   }
@@ -232,18 +265,8 @@ class Host final : public std::enable_shared_from_this<Host> {
     return lastHeartbeatTime_;
   }
 
-  /**
-   * @brief If there are more logs to send, build the append log request
-   *
-   * @param self Shared ptr of Host itself
-   * @return std::shared_ptr<cpp2::AppendLogRequest> The request if there are logs to send, return
-   * nullptr there are none
-   */
-  std::shared_ptr<cpp2::AppendLogRequest> getPendingReqIfAny(std::shared_ptr<Host> self);
-
  private:
-  // <term, logId, committedLogId>
-  using Request = std::tuple<TermID, LogID, LogID>;
+  static constexpr LogID kNoPromise = -1;
 
   std::shared_ptr<RaftPart> part_;
   const HostAddr addr_;
@@ -267,19 +290,30 @@ class Host final : public std::enable_shared_from_this<Host> {
   bool sendingSnapshot_{false};
 
   std::condition_variable noMoreRequestCV_;
+  // Fulfilled when the logs up to promiseLogId_ are acknowledged, kNoPromise if nothing waits
   folly::SharedPromise<cpp2::AppendLogResponse> promise_;
+  LogID promiseLogId_{kNoPromise};
+  // Waited for by the appendLogs called while promise_ is waited for
   folly::SharedPromise<cpp2::AppendLogResponse> cachingPromise_;
 
-  Request pendingReq_{0, 0, 0};
-
   // These logId and term pointing to the latest log we need to send
   LogID logIdToSend_{0};
   TermID logTermToSend_{0};
 
-  // The previous log before this batch
+  // The last log acknowledged by the peer
   LogID lastLogIdSent_{0};
   TermID lastLogTermSent_{0};
 
+  // The last log of the batches in flight, the next batch starts after it
+  LogID lastLogIdInFlight_{0};
+  TermID lastLogTermInFlight_{0};
+  // Number of the batches in flight in the current window
+  size_t numInFlight_{0};
+  // Bumped when the window is reset, the responses of the batches sent before are ignored
+  uint64_t window_{0};
+  // The byte budget of a batch, adapted to the round trip time
+  size_t batchBytes_;
+
   LogID committedLogId_{0};
 
   // CommittedLogId of follower
@@ -12,7 +12,14 @@ namespace nebula {
 namespace raftex {
 
 RaftLogIterator::RaftLogIterator(LogID firstLogId, std::vector<cpp2::RaftLogEntry> logEntries)
-    : idx_(0), firstLogId_(firstLogId), logEntries_(std::move(logEntries)) {}
+    : idx_(0), firstLogId_(firstLogId), logEntries_(std::move(logEntries)) {
+  // The message is received in one buffer mostly, make sure it's contiguous for logMsg()
+  for (auto& entry : logEntries_) {
+    if (entry.get_log_str().isChained()) {
+      entry.log_str_ref()->coalesce();
+    }
+  }
+}
 
 RaftLogIterator& RaftLogIterator::operator++() {
   ++idx_;
@@ -40,7 +47,13 @@ ClusterID RaftLogIterator::logSource() const {
 
 folly::StringPiece RaftLogIterator::logMsg() const {
   DCHECK(valid());
-  return logEntries_.at(idx_).get_log_str();
+  const auto& buf = logEntries_.at(idx_).get_log_str();
+  return folly::StringPiece(reinterpret_cast<const char*>(buf.data()), buf.length());
+}
+
+folly::IOBuf RaftLogIterator::logBuf() const {
+  DCHECK(valid());
+  return logEntries_.at(idx_).get_log_str().cloneAsValue();
 }
 
 }  // namespace raftex
@@ -58,6 +58,12 @@ class RaftLogIterator final : public LogIterator {
    */
   folly::StringPiece logMsg() const override;
 
+  /**
+   * @brief Return the log message pointed by current iterator, which shares the buffer of the
+   * request
+   */
+  folly::IOBuf logBuf() const override;
+
  private:
   size_t idx_;
   const LogID firstLogId_;
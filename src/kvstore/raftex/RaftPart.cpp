@@ -39,6 +39,7 @@ DECLARE_int32(wal_ttl);
 DECLARE_int64(wal_file_size);
 DECLARE_int32(wal_buffer_size);
 DECLARE_bool(wal_sync);
+DECLARE_bool(wal_group_commit);
 
 namespace nebula {
 namespace raftex {
@@ -358,6 +359,9 @@ RaftPart::RaftPart(
   policy.fileSize = FLAGS_wal_file_size;
   policy.bufferSize = FLAGS_wal_buffer_size;
   policy.sync = FLAGS_wal_sync;
+  if (FLAGS_wal_sync && FLAGS_wal_group_commit) {
+    policy.journal = wal::WalJournal::getJournal(walRoot);
+  }
   FileBasedWalInfo info;
   info.idStr_ = idStr_;
   info.spaceId_ = spaceId_;
@@ -17,6 +17,8 @@
 
 DECLARE_uint32(raft_heartbeat_interval_secs);
 DECLARE_uint32(max_batch_size);
+DECLARE_uint32(max_appendlog_batch_size);
+DECLARE_uint32(max_appendlog_inflight_batches);
 
 namespace nebula {
 namespace raftex {
@@ -131,6 +133,37 @@ TEST(LogAppend, MultiThreadAppend) {
   finishRaft(services, copies, workers, leader);
 }
 
+TEST(LogAppend, PipelinedAppend) {
+  fs::TempDir walRoot("/tmp/pipelined_append.XXXXXX");
+  std::shared_ptr<thread::GenericThreadPool> workers;
+  std::vector<std::string> wals;
+  std::vector<HostAddr> allHosts;
+  std::vector<std::shared_ptr<RaftexService>> services;
+  std::vector<std::shared_ptr<test::TestShard>> copies;
+
+  // Small batches, so the logs are sent to each follower in many batches in flight
+  FLAGS_max_appendlog_batch_size = 3;
+  FLAGS_max_appendlog_inflight_batches = 8;
+  SCOPE_EXIT {
+    FLAGS_max_appendlog_batch_size = 128;
+    FLAGS_max_appendlog_inflight_batches = 4;
+  };
+
+  std::shared_ptr<test::TestShard> leader;
+  setupRaft(3, walRoot, workers, wals, allHosts, services, copies, leader);
+
+  // Check all hosts agree on the same leader
+  checkLeadership(copies, leader);
+
+  std::vector<std::string> msgs;
+  appendLogs(0, 99, leader, msgs);
+  checkConsensus(copies, 0, 99, msgs);
+  appendLogs(100, 299, leader, msgs, true);
+  checkConsensus(copies, 0, 299, msgs);
+
+  finishRaft(services, copies, workers, leader);
+}
+
 }  // namespace raftex
 }  // namespace nebula
 
@@ -21,6 +21,7 @@ extern stats::CounterId kTransferLeaderLatencyUs;
 extern stats::CounterId kNumStartElect;
 extern stats::CounterId kNumGrantVotes;
 extern stats::CounterId kNumSendSnapshot;
+extern stats::CounterId kNumWritesMerged;
 
 void initKVStats();
 
@@ -5,6 +5,7 @@
 
 #include <gtest/gtest.h>
 #include <rocksdb/db.h>
+#include <rocksdb/sst_file_writer.h>
 #include <thrift/lib/cpp/concurrency/ThreadManager.h>
 
 #include <iostream>
@@ -1113,6 +1114,132 @@ TEST(NebulaStoreTest, AtomicOpBatchTest) {
   }
 }
 
+TEST(NebulaStoreTest, MergedWriteTest) {
+  auto partMan = std::make_unique<MemPartManager>();
+  auto ioThreadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
+  // space id : 1 , part id : 0
+  partMan->partsMap_[1][0] = PartHosts();
+
+  fs::TempDir rootPath("/tmp/nebula_store_test.XXXXXX");
+  std::vector<std::string> paths;
+  paths.emplace_back(folly::stringPrintf("%s/disk1", rootPath.path()));
+
+  KVOptions options;
+  options.dataPaths_ = std::move(paths);
+  options.partMan_ = std::move(partMan);
+  HostAddr local = {"", 0};
+  auto store =
+      std::make_unique<NebulaStore>(std::move(options), ioThreadPool, local, getHandlers());
+  store->init();
+  sleep(FLAGS_raft_heartbeat_interval_secs);
+
+  // The requests sent concurrently are merged into fewer logs
+  const int32_t kNumThreads = 8;
+  const int32_t kNumRequests = 100;
+  auto write = [&](int32_t t, bool remove) {
+    std::vector<folly::SemiFuture<nebula::cpp2::ErrorCode>> futures;
+    for (int32_t i = 0; i < kNumRequests; i++) {
+      auto key = folly::stringPrintf("key_%d_%03d", t, i);
+      auto [promise, future] = folly::makePromiseContract<nebula::cpp2::ErrorCode>();
+      auto cb = [p = std::move(promise)](nebula::cpp2::ErrorCode code) mutable {
+        p.setValue(code);
+      };
+      if (!remove) {
+        std::vector<KV> kvs;
+        kvs.emplace_back(key, folly::stringPrintf("val_%d_%03d", t, i));
+        store->asyncMultiPut(1, 0, std::move(kvs), std::move(cb));
+      } else if (i % 2 == 0) {
+        std::vector<std::string> keys{key};
+        store->asyncMultiRemove(1, 0, std::move(keys), std::move(cb));
+      } else {
+        continue;
+      }
+      futures.emplace_back(std::move(future));
+    }
+    for (auto& code : folly::collectAll(futures).get()) {
+      EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, code.value());
+    }
+  };
+  auto check = [&](bool removed) {
+    std::vector<std::pair<std::string, std::string>> expected, result;
+    for (int32_t t = 0; t < kNumThreads; t++) {
+      for (int32_t i = 0; i < kNumRequests; i++) {
+        if (!removed || i % 2 != 0) {
+          expected.emplace_back(folly::stringPrintf("key_%d_%03d", t, i),
+                                folly::stringPrintf("val_%d_%03d", t, i));
+        }
+      }
+    }
+    std::unique_ptr<kvstore::KVIterator> iter;
+    auto ret = store->prefix(1, 0, "key_", &iter);
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, ret);
+    while (iter->valid()) {
+      result.emplace_back(iter->key(), iter->val());
+      iter->next();
+    }
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(expected, result);
+  };
+  for (bool remove : {false, true}) {
+    std::vector<std::thread> threads;
+    for (int32_t t = 0; t < kNumThreads; t++) {
+      threads.emplace_back(write, t, remove);
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    check(remove);
+  }
+}
+
+TEST(NebulaStoreTest, IngestNotifyTest) {
+  auto partMan = std::make_unique<MemPartManager>();
+  auto ioThreadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
+  // space id : 1 , part id : 1, 2
+  partMan->partsMap_[1][1] = PartHosts();
+  partMan->partsMap_[1][2] = PartHosts();
+
+  fs::TempDir rootPath("/tmp/nebula_store_test.XXXXXX");
+  KVOptions options;
+  options.dataPaths_ = {folly::stringPrintf("%s/disk1", rootPath.path())};
+  options.partMan_ = std::move(partMan);
+  HostAddr local = {"", 0};
+  auto store =
+      std::make_unique<NebulaStore>(std::move(options), ioThreadPool, local, getHandlers());
+  store->init();
+  sleep(FLAGS_raft_heartbeat_interval_secs);
+
+  // The parts whose data is all changed
+  std::mutex lock;
+  std::vector<PartitionID> changed;
+  for (PartitionID partId = 1; partId <= 2; partId++) {
+    auto part = nebula::value(store->part(1, partId));
+    part->registerOnCommitted([&](const Part::CallbackOptions& opt,
+                                  const std::vector<std::string>&,
+                                  bool all) {
+      if (all) {
+        std::lock_guard<std::mutex> guard(lock);
+        changed.emplace_back(opt.partId);
+      }
+    });
+  }
+
+  // Only part 1 has the sst files downloaded
+  auto downloadPath = folly::stringPrintf("%s/disk1/nebula/1/download/1", rootPath.path());
+  ASSERT_TRUE(fs::FileUtils::makeDir(downloadPath));
+  rocksdb::SstFileWriter writer(rocksdb::EnvOptions(), rocksdb::Options());
+  ASSERT_TRUE(writer.Open(folly::stringPrintf("%s/data.sst", downloadPath.c_str())).ok());
+  ASSERT_TRUE(writer.Put(NebulaKeyUtils::tagKey(8, 1, "vertex", 1), "v").ok());
+  ASSERT_TRUE(writer.Finish().ok());
+
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, store->ingest(1));
+  EXPECT_EQ(std::vector<PartitionID>{1}, changed);
+  std::string val;
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED,
+            store->get(1, 1, NebulaKeyUtils::tagKey(8, 1, "vertex", 1), &val));
+  EXPECT_EQ("v", val);
+}
+
 TEST(NebulaStoreTest, RemoveInvalidSpaceTest) {
   auto partMan = std::make_unique<MemPartManager>();
   auto ioThreadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
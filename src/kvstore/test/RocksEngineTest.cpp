@@ -130,6 +130,42 @@ TEST_P(RocksEngineTest, PrefixTest) {
   checkPrefix("key_c", 20, 20);
 }
 
+TEST_P(RocksEngineTest, SeekPrefixTest) {
+  fs::TempDir rootPath("/tmp/rocksdb_engine_SeekPrefixTest.XXXXXX");
+  auto engine = std::make_unique<RocksEngine>(0, kDefaultVIdLen, rootPath.path());
+  std::vector<KV> data;
+  for (int32_t i = 0; i < 10; i++) {
+    data.emplace_back(folly::stringPrintf("key_a_%d", i), folly::stringPrintf("val_%d", i));
+  }
+  for (int32_t i = 20; i < 40; i++) {
+    data.emplace_back(folly::stringPrintf("key_c_%d", i), folly::stringPrintf("val_%d", i));
+  }
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->multiPut(std::move(data)));
+  if (flush_) {
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->flush());
+  }
+
+  // The prefixes should outlive the iterator
+  std::vector<std::string> prefixes = {"key_a", "key_b", "key_c", "key_d"};
+  std::vector<std::pair<int32_t, int32_t>> expected = {{0, 10}, {0, 0}, {20, 20}, {0, 0}};
+  std::unique_ptr<KVIterator> iter;
+  EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, engine->prefix(prefixes.front(), &iter));
+  for (size_t i = 0; i < prefixes.size(); i++) {
+    if (i > 0) {
+      ASSERT_TRUE(iter->seekPrefix(prefixes[i]));
+    }
+    auto expectedFrom = expected[i].first;
+    int32_t num = 0;
+    for (; iter->valid(); iter->next()) {
+      EXPECT_EQ(folly::stringPrintf("%s_%d", prefixes[i].c_str(), expectedFrom), iter->key());
+      EXPECT_EQ(folly::stringPrintf("val_%d", expectedFrom), iter->val());
+      expectedFrom++;
+      num++;
+    }
+    EXPECT_EQ(expected[i].second, num);
+  }
+}
+
 TEST_P(RocksEngineTest, RemoveTest) {
   fs::TempDir rootPath("/tmp/rocksdb_engine_RemoveTest.XXXXXX");
   auto engine = std::make_unique<RocksEngine>(0, kDefaultVIdLen, rootPath.path());
@@ -6,6 +6,7 @@
 #ifndef WAL_ATOMICLOGBUFFER_H_
 #define WAL_ATOMICLOGBUFFER_H_
 
+#include <folly/io/IOBuf.h>
 #include <folly/lang/Aligned.h>
 #include <gtest/gtest_prod.h>
 
@@ -18,7 +19,8 @@ namespace wal {
 constexpr int32_t kMaxLength = 64;
 
 /**
- * @brief Wal record in each Node, it is wrapper calls of wal log
+ * @brief Wal record in each Node, it is wrapper calls of wal log. The message is kept in a
+ * refcounted buffer, which is shared with the AppendLog requests to the peers instead of copied.
  */
 struct Record {
   Record() = default;
@@ -27,15 +29,29 @@ struct Record {
   Record& operator=(Record&& record) noexcept = default;
 
   Record(ClusterID clusterId, TermID termId, folly::StringPiece msg)
-      : clusterId_(clusterId), termId_(termId), msg_(msg.toString()) {}
+      : clusterId_(clusterId),
+        termId_(termId),
+        msg_(folly::IOBuf::COPY_BUFFER, msg.data(), msg.size()) {}
+
+  Record(ClusterID clusterId, TermID termId, folly::IOBuf msg)
+      : clusterId_(clusterId), termId_(termId), msg_(std::move(msg)) {
+    if (msg_.isChained()) {
+      msg_.coalesce();
+    }
+  }
 
   int32_t size() const {
-    return sizeof(ClusterID) + sizeof(TermID) + msg_.size();
+    return sizeof(ClusterID) + sizeof(TermID) + msg_.length();
+  }
+
+  folly::StringPiece msg() const {
+    return folly::StringPiece(reinterpret_cast<const char*>(msg_.data()), msg_.length());
   }
 
   ClusterID clusterId_;
   TermID termId_;
-  std::string msg_;
+  // Never chained
+  folly::IOBuf msg_;
 };
 
 /**
@@ -177,7 +193,15 @@ class AtomicLogBuffer : public std::enable_shared_from_this<AtomicLogBuffer> {
      * @brief Return the log message pointed by current iterator
      */
     folly::StringPiece logMsg() const override {
-      return record()->msg_;
+      return record()->msg();
+    }
+
+    /**
+     * @brief Return the log message pointed by current iterator, which shares the buffer of the
+     * record
+     */
+    folly::IOBuf logBuf() const override {
+      return record()->msg_.cloneAsValue();
     }
 
    private:
@@ -271,6 +295,18 @@ class AtomicLogBuffer : public std::enable_shared_from_this<AtomicLogBuffer> {
     push(logId, Record(clusterId, termId, msg));
   }
 
+  /**
+   * @brief Add a wal log to current buffer, the buffer of message is shared
+   *
+   * @param logId Log id
+   * @param termId Log term
+   * @param clusterId Cluster id of log
+   * @param msg Log message
+   */
+  void push(LogID logId, TermID termId, ClusterID clusterId, folly::IOBuf msg) {
+    push(logId, Record(clusterId, termId, std::move(msg)));
+  }
+
   /**
    * @brief Add the wal record into current buffer
    *
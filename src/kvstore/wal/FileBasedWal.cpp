@@ -5,6 +5,7 @@
 
 #include "kvstore/wal/FileBasedWal.h"
 
+#include <folly/ScopeGuard.h>
 #include <utime.h>
 
 #include "common/base/Base.h"
@@ -33,8 +34,13 @@ std::shared_ptr<FileBasedWal> FileBasedWal::getWal(const folly::StringPiece dir,
                                                    FileBasedWalPolicy policy,
                                                    PreProcessor preProcessor,
                                                    std::shared_ptr<kvstore::DiskManager> diskMan) {
-  return std::shared_ptr<FileBasedWal>(
+  auto wal = std::shared_ptr<FileBasedWal>(
       new FileBasedWal(dir, std::move(info), std::move(policy), std::move(preProcessor), diskMan));
+  if (wal->policy_.journal != nullptr) {
+    // Replayed after constructed, since reading the wal files needs shared_from_this()
+    wal->replayJournal();
+  }
+  return wal;
 }
 
 FileBasedWal::FileBasedWal(const folly::StringPiece dir,
@@ -267,7 +273,8 @@ void FileBasedWal::closeCurrFile() {
     return;
   }
 
-  if (!policy_.sync) {
+  // The logs are synced by batch or not synced at all, unless they are synced through the journal
+  if (policy_.journal == nullptr) {
     if (::fsync(currFd_) == -1) {
       LOG(WARNING) << "sync wal \"" << currInfo_->path() << "\" failed, error: " << strerror(errno);
     }
@@ -442,14 +449,20 @@ void FileBasedWal::scanLastWal(WalFileInfoPtr info, LogID firstId) {
 bool FileBasedWal::appendLogInternal(LogID id,
                                      TermID term,
                                      ClusterID cluster,
-                                     folly::StringPiece msg) {
+                                     folly::IOBuf buf,
+                                     std::string* records,
+                                     bool preProcess) {
+  if (buf.isChained()) {
+    buf.coalesce();
+  }
+  folly::StringPiece msg(reinterpret_cast<const char*>(buf.data()), buf.length());
   if (lastLogId_ != 0 && firstLogId_ != 0 && id != lastLogId_ + 1) {
     VLOG(3) << idStr_ << "There is a gap in the log id. The last log id is " << lastLogId_
             << ", and the id being appended is " << id;
     return false;
   }
 
-  if (!preProcessor_(id, term, cluster, msg)) {
+  if (preProcess && !preProcessor_(id, term, cluster, msg)) {
     VLOG(3) << idStr_ << "Pre process failed for log " << id;
     return false;
   }
@@ -483,8 +496,9 @@ bool FileBasedWal::appendLogInternal(LogID id,
                << ", error:" << strerror(errno);
   }
 
-  if (policy_.sync && ::fsync(currFd_) == -1) {
-    LOG(WARNING) << "sync wal \"" << currInfo_->path() << "\" failed, error: " << strerror(errno);
+  if (records != nullptr) {
+    WalJournal::encode(
+        spaceId_, partId_, WalJournal::Type::kAppend, id, term, cluster, msg, *records);
   }
   currInfo_->setSize(currInfo_->size() + strBuf.size());
   currInfo_->setLastId(id);
@@ -496,7 +510,7 @@ bool FileBasedWal::appendLogInternal(LogID id,
     firstLogId_ = id;
   }
 
-  logBuffer_->push(id, term, cluster, msg);
+  logBuffer_->push(id, term, cluster, std::move(buf));
   return true;
 }
 
@@ -505,10 +519,16 @@ bool FileBasedWal::appendLog(LogID id, TermID term, ClusterID cluster, std::stri
     VLOG_EVERY_N(2, 1000) << idStr_ << "Failed to appendLogs because of no more space";
     return false;
   }
-  if (!appendLogInternal(id, term, cluster, folly::StringPiece(msg))) {
+  std::string records;
+  if (!appendLogInternal(id,
+                         term,
+                         cluster,
+                         std::move(*folly::IOBuf::fromString(std::move(msg))),
+                         policy_.journal != nullptr ? &records : nullptr)) {
     VLOG(3) << "Failed to append log for logId " << id;
     return false;
   }
+  syncAppended(std::move(records));
   return true;
 }
 
@@ -517,16 +537,103 @@ bool FileBasedWal::appendLogs(LogIterator& iter) {
     VLOG_EVERY_N(2, 1000) << idStr_ << "Failed to appendLogs because of no more space";
     return false;
   }
+  // The logs are synced once for the batch
+  std::string records;
+  auto* journaled = policy_.journal != nullptr ? &records : nullptr;
+  bool appended = false;
+  SCOPE_EXIT {
+    if (appended) {
+      syncAppended(std::move(records));
+    }
+  };
   for (; iter.valid(); ++iter) {
-    if (!appendLogInternal(iter.logId(), iter.logTerm(), iter.logSource(), iter.logMsg())) {
+    if (!appendLogInternal(
+            iter.logId(), iter.logTerm(), iter.logSource(), iter.logBuf(), journaled)) {
       VLOG(3) << idStr_ << "Failed to append log for logId " << iter.logId();
       return false;
     }
+    appended = true;
   }
 
   return true;
 }
 
+void FileBasedWal::syncAppended(std::string records) {
+  if (!policy_.sync) {
+    return;
+  }
+  if (policy_.journal != nullptr) {
+    policy_.journal->commit(std::move(records));
+  } else if (currFd_ >= 0 && ::fsync(currFd_) == -1) {
+    LOG(WARNING) << "sync wal \"" << currInfo_->path() << "\" failed, error: " << strerror(errno);
+  }
+}
+
+void FileBasedWal::journal(WalJournal::Type type, LogID id) {
+  if (policy_.journal == nullptr) {
+    return;
+  }
+  std::string records;
+  WalJournal::encode(spaceId_, partId_, type, id, 0, 0, "", records);
+  policy_.journal->commit(std::move(records));
+}
+
+void FileBasedWal::replayJournal() {
+  auto records = policy_.journal->takeRecords(spaceId_, partId_);
+  if (records.empty()) {
+    return;
+  }
+  // The journal has all changes of the wal since the wal files were synced last time, so replaying
+  // them in order brings the wal to the latest state, whatever has been synced to the wal files
+  size_t numAppended = 0;
+  for (auto& record : records) {
+    switch (record.type) {
+      case WalJournal::Type::kAppend: {
+        if (firstLogId_ != 0 && record.id < firstLogId_) {
+          // The log has been cleaned from the wal files, which is not journaled
+          continue;
+        }
+        if (record.id <= lastLogId_ && lastLogId_ != 0) {
+          if (getLogTerm(record.id) == record.term) {
+            // The same log is in the wal file
+            continue;
+          }
+          if (!rollbackToLogInternal(record.id - 1)) {
+            resetInternal();
+          }
+        }
+        if (!appendLogInternal(record.id,
+                               record.term,
+                               record.cluster,
+                               std::move(*folly::IOBuf::fromString(std::move(record.msg))),
+                               nullptr,
+                               false)) {
+          LOG(WARNING) << idStr_ << "Failed to replay log " << record.id << " from journal";
+          continue;
+        }
+        numAppended++;
+        break;
+      }
+      case WalJournal::Type::kRollback: {
+        if (record.id < lastLogId_) {
+          rollbackToLogInternal(record.id);
+        }
+        break;
+      }
+      case WalJournal::Type::kReset: {
+        resetInternal();
+        break;
+      }
+      case WalJournal::Type::kDrop: {
+        // Never loaded
+        break;
+      }
+    }
+  }
+  LOG(INFO) << idStr_ << "Replayed " << records.size() << " journal records, " << numAppended
+            << " logs recovered, lastLogId " << lastLogId_ << ", lastLogTerm " << lastLogTerm_;
+}
+
 std::unique_ptr<LogIterator> FileBasedWal::iterator(LogID firstLogId, LogID lastLogId) {
   auto iter = logBuffer_->iterator(firstLogId, lastLogId);
   if (iter->valid()) {
@@ -567,6 +674,14 @@ bool FileBasedWal::linkCurrentWAL(const char* newPath) {
 }
 
 bool FileBasedWal::rollbackToLog(LogID id) {
+  if (!rollbackToLogInternal(id)) {
+    return false;
+  }
+  journal(WalJournal::Type::kRollback, id);
+  return true;
+}
+
+bool FileBasedWal::rollbackToLogInternal(LogID id) {
   if (id < firstLogId_ - 1 || id > lastLogId_) {
     VLOG(4) << idStr_ << "Rollback target id " << id << " is not in the range of [" << firstLogId_
             << "," << lastLogId_ << "] of WAL";
@@ -620,6 +735,12 @@ bool FileBasedWal::rollbackToLog(LogID id) {
 }
 
 bool FileBasedWal::reset() {
+  resetInternal();
+  journal(WalJournal::Type::kReset, 0);
+  return true;
+}
+
+void FileBasedWal::resetInternal() {
   closeCurrFile();
   logBuffer_->reset();
   {
@@ -634,7 +755,6 @@ bool FileBasedWal::reset() {
   }
   lastLogId_ = firstLogId_ = 0;
   lastLogTerm_ = 0;
-  return true;
 }
 
 void FileBasedWal::cleanWAL() {
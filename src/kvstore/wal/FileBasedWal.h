@@ -15,6 +15,7 @@
 #include "kvstore/wal/AtomicLogBuffer.h"
 #include "kvstore/wal/Wal.h"
 #include "kvstore/wal/WalFileInfo.h"
+#include "kvstore/wal/WalJournal.h"
 
 namespace nebula {
 namespace wal {
@@ -29,6 +30,10 @@ struct FileBasedWalPolicy {
 
   // Whether fsync needs to be called every write
   bool sync = false;
+
+  // The journal to sync the logs together with the other parts on the disk instead of syncing the
+  // wal files, only used when sync is true
+  std::shared_ptr<WalJournal> journal;
 };
 
 struct FileBasedWalInfo {
@@ -244,10 +249,46 @@ class FileBasedWal final : public Wal, public std::enable_shared_from_this<FileB
    * @param id Log id to append
    * @param term Log term to append
    * @param cluster Cluster id in log to append
-   * @param msg Log messgage to append
+   * @param msg Log messgage to append, the buffer is kept by the log buffer without copying
+   * @param records The journal records to append the log to, nullptr if not journaled
+   * @param preProcess Whether to pre-process the log, which is skipped when replaying
    * @return Whether append succeed
    */
-  bool appendLogInternal(LogID id, TermID term, ClusterID cluster, folly::StringPiece msg);
+  bool appendLogInternal(LogID id,
+                         TermID term,
+                         ClusterID cluster,
+                         folly::IOBuf msg,
+                         std::string* records = nullptr,
+                         bool preProcess = true);
+
+  /**
+   * @brief Make the logs appended durable, by committing them to the journal if there is, or by
+   * syncing the current wal file
+   *
+   * @param records The journal records of the logs appended
+   */
+  void syncAppended(std::string records);
+
+  /**
+   * @brief The actual implementation of rollbackToLog(), without journaling
+   */
+  bool rollbackToLogInternal(LogID id);
+
+  /**
+   * @brief The actual implementation of reset(), without journaling
+   */
+  void resetInternal();
+
+  /**
+   * @brief Commit a rollback or reset of the wal to the journal
+   */
+  void journal(WalJournal::Type type, LogID id);
+
+  /**
+   * @brief Replay the records of this part in the journal, to recover the logs which were not
+   * synced to the wal files
+   */
+  void replayJournal();
 
  private:
   using WalFiles = std::map<LogID, WalFileInfoPtr>;
@@ -0,0 +1,288 @@
+/* Copyright (c) 2023 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "kvstore/wal/WalJournal.h"
+
+#include <folly/FileUtil.h>
+#include <unistd.h>
+
+#include "common/fs/FileUtils.h"
+
+DEFINE_bool(wal_group_commit,
+            false,
+            "Whether to sync the wal logs of all parts on a disk together through a shared "
+            "journal, only takes effect when wal_sync is true");
+DEFINE_int64(wal_journal_file_size,
+             64 * 1024 * 1024,
+             "The size of a wal journal file, the older journal files are removed when a new one "
+             "is created");
+DECLARE_bool(wal_sync);
+
+namespace nebula {
+namespace wal {
+
+using nebula::fs::FileUtils;
+
+namespace {
+
+// space, part, type, log id, term, length, cluster, and the length again after the message
+constexpr size_t kHeadSize = sizeof(GraphSpaceID) + sizeof(PartitionID) + sizeof(int8_t) +
+                             sizeof(LogID) + sizeof(TermID) + sizeof(int32_t) + sizeof(ClusterID);
+constexpr size_t kFootSize = sizeof(int32_t);
+
+template <typename T>
+T readField(const char* data, size_t& pos) {
+  T t;
+  memcpy(&t, data + pos, sizeof(T));
+  pos += sizeof(T);
+  return t;
+}
+
+std::string fileName(int64_t seq) {
+  return folly::stringPrintf("%019ld.journal", seq);
+}
+
+}  // namespace
+
+WalJournal::WalJournal(const std::string& dir) : dir_(dir) {
+  if (FileUtils::fileType(dir_.c_str()) == fs::FileType::NOTEXIST) {
+    if (!FileUtils::makeDir(dir_)) {
+      LOG(FATAL) << "MakeDIR " << dir_ << " failed";
+    }
+  }
+  load();
+  openFile();
+}
+
+WalJournal::~WalJournal() {
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+}
+
+// static
+std::shared_ptr<WalJournal> WalJournal::getJournal(folly::StringPiece walDir) {
+  static std::mutex journalsLock;
+  static std::unordered_map<std::string, std::weak_ptr<WalJournal>> journals;
+  auto dir = journalDir(walDir);
+  std::lock_guard<std::mutex> guard(journalsLock);
+  auto journal = journals[dir].lock();
+  if (journal == nullptr) {
+    journal = std::make_shared<WalJournal>(dir);
+    journals[dir] = journal;
+  }
+  return journal;
+}
+
+// static
+std::string WalJournal::journalDir(folly::StringPiece walDir) {
+  auto dir = walDir;
+  while (dir.size() > 1 && dir.endsWith('/')) {
+    dir.subtract(1);
+  }
+  for (int i = 0; i < 3; i++) {
+    auto pos = dir.rfind('/');
+    if (pos == folly::StringPiece::npos) {
+      // Not in the layout of the data path, keep the journal with the wal
+      return FileUtils::joinPath(walDir, "journal");
+    }
+    dir = dir.subpiece(0, pos);
+  }
+  return FileUtils::joinPath(dir, "wal_journal");
+}
+
+// static
+void WalJournal::dropPart(folly::StringPiece walDir, GraphSpaceID spaceId, PartitionID partId) {
+  if (!FLAGS_wal_sync || !FLAGS_wal_group_commit) {
+    return;
+  }
+  getJournal(walDir)->drop(spaceId, partId);
+}
+
+// static
+void WalJournal::encode(GraphSpaceID spaceId,
+                        PartitionID partId,
+                        Type type,
+                        LogID id,
+                        TermID term,
+                        ClusterID cluster,
+                        folly::StringPiece msg,
+                        std::string& buf) {
+  auto t = static_cast<int8_t>(type);
+  int32_t len = msg.size();
+  buf.reserve(buf.size() + kHeadSize + msg.size() + kFootSize);
+  buf.append(reinterpret_cast<const char*>(&spaceId), sizeof(GraphSpaceID));
+  buf.append(reinterpret_cast<const char*>(&partId), sizeof(PartitionID));
+  buf.append(reinterpret_cast<const char*>(&t), sizeof(int8_t));
+  buf.append(reinterpret_cast<const char*>(&id), sizeof(LogID));
+  buf.append(reinterpret_cast<const char*>(&term), sizeof(TermID));
+  buf.append(reinterpret_cast<const char*>(&len), sizeof(int32_t));
+  buf.append(reinterpret_cast<const char*>(&cluster), sizeof(ClusterID));
+  buf.append(msg.data(), msg.size());
+  buf.append(reinterpret_cast<const char*>(&len), sizeof(int32_t));
+}
+
+void WalJournal::load() {
+  // The file name is "<seq>.journal", which sorts the files in the order they are created
+  auto files = FileUtils::listAllFilesInDir(dir_.c_str(), false, "*.journal");
+  std::sort(files.begin(), files.end());
+  size_t numRecords = 0;
+  for (const auto& fn : files) {
+    auto path = FileUtils::joinPath(dir_, fn);
+    oldFiles_.emplace_back(path);
+    try {
+      fileSeq_ = std::max(fileSeq_, folly::to<int64_t>(fn.substr(0, fn.find('.'))));
+    } catch (const std::exception& ex) {
+      LOG(WARNING) << "Ignore bad file name \"" << fn << "\"";
+      continue;
+    }
+    std::string content;
+    if (!folly::readFile(path.c_str(), content)) {
+      LOG(FATAL) << "Failed to read the wal journal \"" << path << "\" (errno " << errno
+                 << "): " << strerror(errno);
+    }
+    size_t pos = 0;
+    while (pos + kHeadSize <= content.size()) {
+      auto* data = content.data();
+      auto spaceId = readField<GraphSpaceID>(data, pos);
+      auto partId = readField<PartitionID>(data, pos);
+      Record record;
+      record.type = static_cast<Type>(readField<int8_t>(data, pos));
+      record.id = readField<LogID>(data, pos);
+      record.term = readField<TermID>(data, pos);
+      auto head = readField<int32_t>(data, pos);
+      record.cluster = readField<ClusterID>(data, pos);
+      if (head < 0 || pos + head + kFootSize > content.size()) {
+        break;
+      }
+      record.msg.assign(data + pos, head);
+      pos += head;
+      auto foot = readField<int32_t>(data, pos);
+      if (head != foot) {
+        LOG(WARNING) << "Message size doesn't match: " << head << " != " << foot;
+        break;
+      }
+      if (record.type == Type::kDrop) {
+        records_.erase(partKey(spaceId, partId));
+        continue;
+      }
+      records_[partKey(spaceId, partId)].emplace_back(std::move(record));
+      numRecords++;
+    }
+    if (pos != content.size()) {
+      // The tail was not synced before crashed, these records were never committed
+      LOG(WARNING) << "Ignore the incomplete tail of the wal journal \"" << path
+                   << "\" from offset " << pos;
+    }
+  }
+  LOG(INFO) << "Loaded " << numRecords << " records of " << records_.size()
+            << " parts from the wal journal in " << dir_;
+}
+
+void WalJournal::openFile() {
+  auto path = FileUtils::joinPath(dir_, fileName(++fileSeq_));
+  fd_ = ::open(path.c_str(), O_CREAT | O_EXCL | O_WRONLY | O_APPEND | O_CLOEXEC, 0644);
+  if (fd_ < 0) {
+    LOG(FATAL) << "Failed to create the wal journal \"" << path << "\" (errno " << errno
+               << "): " << strerror(errno);
+  }
+  fileSize_ = 0;
+}
+
+void WalJournal::commit(std::string records) {
+  std::unique_lock<std::mutex> guard(lock_);
+  pending_.append(records);
+  auto seq = ++appendedSeq_;
+  while (syncedSeq_ < seq) {
+    if (syncing_) {
+      cv_.wait(guard);
+      continue;
+    }
+    // Lead a group, the records pending are written and synced together
+    syncing_ = true;
+    std::string batch;
+    batch.swap(pending_);
+    auto batchSeq = appendedSeq_;
+    guard.unlock();
+
+    if (folly::writeFull(fd_, batch.data(), batch.size()) != static_cast<ssize_t>(batch.size())) {
+      LOG(FATAL) << "Failed to write the wal journal in " << dir_ << " (errno " << errno
+                 << "): " << strerror(errno);
+    }
+    if (::fdatasync(fd_) == -1) {
+      LOG(WARNING) << "sync wal journal in " << dir_ << " failed, error: " << strerror(errno);
+    }
+    fileSize_ += batch.size();
+    if (fileSize_ >= static_cast<size_t>(FLAGS_wal_journal_file_size)) {
+      rollOver();
+    }
+
+    guard.lock();
+    syncing_ = false;
+    syncedSeq_ = batchSeq;
+    cv_.notify_all();
+  }
+}
+
+void WalJournal::rollOver() {
+  oldFiles_.emplace_back(FileUtils::joinPath(dir_, fileName(fileSeq_)));
+  ::close(fd_);
+  openFile();
+
+  // The records not replayed yet would be lost with the older files, so keep them in the new file
+  std::string untaken;
+  {
+    std::lock_guard<std::mutex> guard(recordsLock_);
+    for (const auto& [key, records] : records_) {
+      for (const auto& r : records) {
+        encode(key >> 32, key & 0xFFFFFFFF, r.type, r.id, r.term, r.cluster, r.msg, untaken);
+      }
+    }
+  }
+  if (folly::writeFull(fd_, untaken.data(), untaken.size()) !=
+      static_cast<ssize_t>(untaken.size())) {
+    LOG(FATAL) << "Failed to write the wal journal in " << dir_ << " (errno " << errno
+               << "): " << strerror(errno);
+  }
+  fileSize_ += untaken.size();
+
+  // The wal files of the parts written before are synced with the filesystem, so the logs in the
+  // older journal files are durable on their own
+  if (::syncfs(fd_) == -1) {
+    LOG(WARNING) << "sync the filesystem of wal journal in " << dir_
+                 << " failed, error: " << strerror(errno);
+    return;
+  }
+  for (const auto& path : oldFiles_) {
+    VLOG(2) << "Removing the wal journal \"" << path << "\"";
+    unlink(path.c_str());
+  }
+  oldFiles_.clear();
+}
+
+std::vector<WalJournal::Record> WalJournal::takeRecords(GraphSpaceID spaceId,
+                                                        PartitionID partId) {
+  std::lock_guard<std::mutex> guard(recordsLock_);
+  auto it = records_.find(partKey(spaceId, partId));
+  if (it == records_.end()) {
+    return {};
+  }
+  auto records = std::move(it->second);
+  records_.erase(it);
+  return records;
+}
+
+void WalJournal::drop(GraphSpaceID spaceId, PartitionID partId) {
+  {
+    std::lock_guard<std::mutex> guard(recordsLock_);
+    records_.erase(partKey(spaceId, partId));
+  }
+  std::string records;
+  encode(spaceId, partId, Type::kDrop, 0, 0, 0, "", records);
+  commit(std::move(records));
+}
+
+}  // namespace wal
+}  // namespace nebula
@@ -0,0 +1,165 @@
+/* Copyright (c) 2023 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef WAL_WALJOURNAL_H_
+#define WAL_WALJOURNAL_H_
+
+#include <condition_variable>
+
+#include "common/base/Base.h"
+#include "common/thrift/ThriftTypes.h"
+
+namespace nebula {
+namespace wal {
+
+/**
+ * @brief WalJournal is the log shared by the wals of all parts on one disk, which is group
+ * committed.
+ *
+ * With `--wal_sync` and `--wal_group_commit`, a FileBasedWal writes its own files without fsync,
+ * and appends the same logs to the journal of its disk. The records appended concurrently by the
+ * parts are written and synced at once by one of the appending threads, so the parts on a disk
+ * pay for one fsync instead of one each. The journal is replayed into the wal of each part when it
+ * is opened, and a journal file is removed once the filesystem is synced after it's rolled over.
+ */
+class WalJournal final {
+ public:
+  enum class Type : int8_t {
+    kAppend = 0,
+    // Rollback to the log id
+    kRollback = 1,
+    kReset = 2,
+    // The part is removed, its records before are dropped
+    kDrop = 3,
+  };
+
+  struct Record {
+    Type type;
+    LogID id;
+    TermID term;
+    ClusterID cluster;
+    std::string msg;
+  };
+
+  /**
+   * @brief Open the journal in the directory. The records in the existing journal files are
+   * loaded, and the new records are appended to a new file.
+   *
+   * @param dir
+   */
+  explicit WalJournal(const std::string& dir);
+
+  ~WalJournal();
+
+  /**
+   * @brief Return the journal shared by the wals on the same disk as the wal in `walDir`
+   *
+   * @param walDir Directory of the wal of a part
+   * @return std::shared_ptr<WalJournal>
+   */
+  static std::shared_ptr<WalJournal> getJournal(folly::StringPiece walDir);
+
+  /**
+   * @brief Return the directory of the journal of the wal in `walDir`. The wal of a part is in
+   * "<path>/nebula/<space>/wal/<part>", or "<path>/<space>/<part>/wal" for a listener, so the
+   * journal is in "<path>/nebula/wal_journal", or "<path>/wal_journal".
+   */
+  static std::string journalDir(folly::StringPiece walDir);
+
+  /**
+   * @brief Drop the records of a removed part from the journal of its wal, if the wals are group
+   * committed. Otherwise the records of a part which is never opened again are kept forever.
+   *
+   * @param walDir Directory of the wal of the part
+   * @param spaceId
+   * @param partId
+   */
+  static void dropPart(folly::StringPiece walDir, GraphSpaceID spaceId, PartitionID partId);
+
+  /**
+   * @brief Encode a record of the part and append it to `buf`
+   */
+  static void encode(GraphSpaceID spaceId,
+                     PartitionID partId,
+                     Type type,
+                     LogID id,
+                     TermID term,
+                     ClusterID cluster,
+                     folly::StringPiece msg,
+                     std::string& buf);
+
+  /**
+   * @brief Append the encoded records, and wait until they are synced with the records appended
+   * concurrently by the other parts. This method is thread-safe.
+   *
+   * @param records
+   */
+  void commit(std::string records);
+
+  /**
+   * @brief Take the records of a part loaded on opening the journal, in the order they were
+   * appended. The records of a part are only returned once.
+   *
+   * @param spaceId
+   * @param partId
+   * @return std::vector<Record>
+   */
+  std::vector<Record> takeRecords(GraphSpaceID spaceId, PartitionID partId);
+
+  /**
+   * @brief Drop the records of a part loaded, and commit a record to drop the ones in the journal
+   * files when they are loaded again
+   *
+   * @param spaceId
+   * @param partId
+   */
+  void drop(GraphSpaceID spaceId, PartitionID partId);
+
+ private:
+  static uint64_t partKey(GraphSpaceID spaceId, PartitionID partId) {
+    return (static_cast<uint64_t>(spaceId) << 32) | static_cast<uint32_t>(partId);
+  }
+
+  /**
+   * @brief Load the records in the journal files
+   */
+  void load();
+
+  /**
+   * @brief Open a new journal file to append to
+   */
+  void openFile();
+
+  /**
+   * @brief Switch to a new journal file. The records not taken yet are copied to the new file, and
+   * the older files are removed after the filesystem is synced. Only called by the thread syncing.
+   */
+  void rollOver();
+
+  const std::string dir_;
+
+  std::mutex lock_;
+  std::condition_variable cv_;
+  // The records waiting for the next sync
+  std::string pending_;
+  uint64_t appendedSeq_{0};
+  uint64_t syncedSeq_{0};
+  bool syncing_{false};
+
+  // The journal file appended to, only accessed by the thread syncing
+  int32_t fd_{-1};
+  int64_t fileSeq_{0};
+  size_t fileSize_{0};
+  // The older journal files, to be removed on the next rollover
+  std::vector<std::string> oldFiles_;
+
+  std::mutex recordsLock_;
+  // The loaded records not taken yet, by the part
+  std::unordered_map<uint64_t, std::vector<Record>> records_;
+};
+
+}  // namespace wal
+}  // namespace nebula
+#endif  // WAL_WALJOURNAL_H_
@@ -41,6 +41,25 @@ TEST(AtomicLogBufferTest, ReadWriteTest) {
   }
 }
 
+TEST(AtomicLogBufferTest, SharedBufferTest) {
+  auto logBuffer = AtomicLogBuffer::instance();
+  std::vector<const uint8_t*> data;
+  for (LogID logId = 0; logId < 100L; logId++) {
+    auto buf = folly::IOBuf::copyBuffer(folly::stringPrintf("str_%ld", logId));
+    data.emplace_back(buf->data());
+    logBuffer->push(logId, 0, 0, std::move(*buf));
+  }
+  checkIterator(logBuffer, 0, 99, 100);
+  auto iter = logBuffer->iterator(0, 99);
+  for (; iter->valid(); ++(*iter)) {
+    // The buffer pushed is shared instead of copied
+    auto buf = iter->logBuf();
+    EXPECT_EQ(data[iter->logId()], buf.data());
+    EXPECT_EQ(folly::stringPrintf("str_%ld", iter->logId()),
+              folly::StringPiece(reinterpret_cast<const char*>(buf.data()), buf.length()));
+  }
+}
+
 TEST(AtomicLogBufferTest, OverflowTest) {
   auto logBuffer = AtomicLogBuffer::instance(128);
   for (LogID logId = 0; logId < 1000L; logId++) {
@@ -90,12 +109,12 @@ TEST(AtomicLogBufferTest, SingleWriterMultiReadersTest) {
           CHECK_NOTNULL(rec);
           auto expected = folly::stringPrintf("str_%ld", num);
           EXPECT_EQ(num, logId);
-          EXPECT_EQ(expected.size(), rec->msg_.size())
+          EXPECT_EQ(expected.size(), rec->msg().size())
               << "wp " << wp << ", start " << start << ", logId " << logId << ", end " << end
               << ", curr node " << node->firstLogId_ << ", pos " << node->pos_ << ", curr index "
               << iter->currIndex() << ", head lastLogId " << logBuffer->lastLogId();
-          EXPECT_EQ(expected, rec->msg_)
-              << "expected size " << expected.size() << ", actual size " << rec->msg_.size();
+          EXPECT_EQ(expected, rec->msg())
+              << "expected size " << expected.size() << ", actual size " << rec->msg().size();
           num++;
         }
       }
@@ -602,6 +602,190 @@ TEST(FileBasedWal, getLogTermTest) {
   EXPECT_EQ(10, wal->getLogTerm(10));
 }
 
+TEST(FileBasedWal, JournalReplayTest) {
+  TempDir rootDir("/tmp/testWal.XXXXXX");
+  auto journalDir = FileUtils::joinPath(rootDir.path(), "journal");
+  auto walDir1 = FileUtils::joinPath(rootDir.path(), "1");
+  auto walDir2 = FileUtils::joinPath(rootDir.path(), "2");
+  FileBasedWalInfo info1{"", 1, 1};
+  FileBasedWalInfo info2{"", 1, 2};
+  FileBasedWalPolicy policy;
+  policy.fileSize = 1024L * 1024L;
+  policy.bufferSize = 1024L * 1024L;
+  policy.sync = true;
+  auto openWal = [&](const std::string& dir, const FileBasedWalInfo& info) {
+    return FileBasedWal::getWal(
+        dir, info, policy, [](LogID, TermID, ClusterID, folly::StringPiece) { return true; });
+  };
+
+  policy.journal = std::make_shared<WalJournal>(journalDir);
+  auto wal1 = openWal(walDir1, info1);
+  auto wal2 = openWal(walDir2, info2);
+  for (int i = 1; i <= 1000; i++) {
+    ASSERT_TRUE(wal1->appendLog(i, 1, 0, folly::stringPrintf(kLongMsg, i)));
+  }
+  ASSERT_TRUE(wal1->rollbackToLog(800));
+  for (int i = 801; i <= 1200; i++) {
+    ASSERT_TRUE(wal1->appendLog(i, 2, 0, folly::stringPrintf(kLongMsg, i)));
+  }
+  for (int i = 1; i <= 50; i++) {
+    ASSERT_TRUE(wal2->appendLog(i, 1, 0, folly::stringPrintf(kLongMsg, i)));
+  }
+  // Such as a snapshot is received
+  ASSERT_TRUE(wal2->reset());
+  for (int i = 100; i <= 110; i++) {
+    ASSERT_TRUE(wal2->appendLog(i, 3, 0, folly::stringPrintf(kLongMsg, i)));
+  }
+  wal1.reset();
+  wal2.reset();
+  policy.journal.reset();
+
+  auto check = [&](int round) {
+    policy.journal = std::make_shared<WalJournal>(journalDir);
+    wal1 = openWal(walDir1, info1);
+    wal2 = openWal(walDir2, info2);
+    EXPECT_EQ(1, wal1->firstLogId()) << "round " << round;
+    EXPECT_EQ(1200, wal1->lastLogId()) << "round " << round;
+    EXPECT_EQ(2, wal1->lastLogTerm()) << "round " << round;
+    EXPECT_EQ(1, wal1->getLogTerm(800)) << "round " << round;
+    EXPECT_EQ(2, wal1->getLogTerm(801)) << "round " << round;
+    auto it = wal1->iterator(1, 1200);
+    LogID id = 1;
+    for (; it->valid(); ++(*it), ++id) {
+      ASSERT_EQ(id, it->logId());
+      ASSERT_EQ(folly::stringPrintf(kLongMsg, id), it->logMsg());
+    }
+    EXPECT_EQ(1201, id);
+    EXPECT_EQ(100, wal2->firstLogId()) << "round " << round;
+    EXPECT_EQ(110, wal2->lastLogId()) << "round " << round;
+    EXPECT_EQ(3, wal2->lastLogTerm()) << "round " << round;
+    wal1.reset();
+    wal2.reset();
+    policy.journal.reset();
+  };
+
+  // The wal files are intact
+  check(1);
+  // The wal files are lost since they were not synced, the logs are recovered from the journal
+  ASSERT_TRUE(FileUtils::remove(walDir1.c_str(), true));
+  ASSERT_TRUE(FileUtils::remove(walDir2.c_str(), true));
+  check(2);
+}
+
+TEST(FileBasedWal, JournalGroupCommitTest) {
+  TempDir rootDir("/tmp/testWal.XXXXXX");
+  auto journalDir = FileUtils::joinPath(rootDir.path(), "journal");
+  FileBasedWalPolicy policy;
+  policy.sync = true;
+  policy.journal = std::make_shared<WalJournal>(journalDir);
+
+  constexpr int kParts = 8;
+  constexpr int kLogs = 200;
+  auto openWal = [&](PartitionID partId) {
+    FileBasedWalInfo info{"", 1, partId};
+    return FileBasedWal::getWal(FileUtils::joinPath(rootDir.path(), std::to_string(partId)),
+                                info,
+                                policy,
+                                [](LogID, TermID, ClusterID, folly::StringPiece) { return true; });
+  };
+  std::vector<std::thread> threads;
+  for (int part = 1; part <= kParts; part++) {
+    threads.emplace_back([&, part]() {
+      auto wal = openWal(part);
+      for (int i = 1; i <= kLogs; i++) {
+        ASSERT_TRUE(wal->appendLog(i, 1, 0, folly::stringPrintf("%d-%d", part, i)));
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  policy.journal.reset();
+
+  for (int part = 1; part <= kParts; part++) {
+    auto walDir = FileUtils::joinPath(rootDir.path(), std::to_string(part));
+    ASSERT_TRUE(FileUtils::remove(walDir.c_str(), true));
+  }
+  policy.journal = std::make_shared<WalJournal>(journalDir);
+  for (int part = 1; part <= kParts; part++) {
+    auto wal = openWal(part);
+    ASSERT_EQ(kLogs, wal->lastLogId());
+    auto it = wal->iterator(1, kLogs);
+    LogID id = 1;
+    for (; it->valid(); ++(*it), ++id) {
+      ASSERT_EQ(folly::stringPrintf("%d-%ld", part, id), it->logMsg());
+    }
+    EXPECT_EQ(kLogs + 1, id);
+  }
+}
+
+TEST(FileBasedWal, JournalCleanWalTest) {
+  TempDir rootDir("/tmp/testWal.XXXXXX");
+  auto journalDir = FileUtils::joinPath(rootDir.path(), "journal");
+  auto walDir = FileUtils::joinPath(rootDir.path(), "1");
+  FileBasedWalInfo info{"", 1, 1};
+  FileBasedWalPolicy policy;
+  policy.fileSize = 1024 * 10;
+  policy.sync = true;
+  auto openWal = [&]() {
+    return FileBasedWal::getWal(
+        walDir, info, policy, [](LogID, TermID, ClusterID, folly::StringPiece) { return true; });
+  };
+
+  policy.journal = std::make_shared<WalJournal>(journalDir);
+  auto wal = openWal();
+  for (int i = 1; i <= 1000; i++) {
+    ASSERT_TRUE(wal->appendLog(i, 1, 0, folly::stringPrintf(kLongMsg, i)));
+  }
+  // Cleaning the wal files is not journaled
+  wal->cleanWAL(500);
+  auto firstLogId = wal->firstLogId();
+  ASSERT_GT(firstLogId, 1);
+  wal.reset();
+  policy.journal.reset();
+
+  // The records of the logs cleaned are ignored instead of rolling back the wal
+  policy.journal = std::make_shared<WalJournal>(journalDir);
+  wal = openWal();
+  EXPECT_EQ(firstLogId, wal->firstLogId());
+  EXPECT_EQ(1000, wal->lastLogId());
+  EXPECT_EQ(1, wal->lastLogTerm());
+}
+
+TEST(FileBasedWal, JournalDropTest) {
+  TempDir rootDir("/tmp/testWal.XXXXXX");
+  auto journalDir = FileUtils::joinPath(rootDir.path(), "journal");
+  FileBasedWalPolicy policy;
+  policy.sync = true;
+  auto openWal = [&](PartitionID partId) {
+    FileBasedWalInfo info{"", 1, partId};
+    return FileBasedWal::getWal(FileUtils::joinPath(rootDir.path(), std::to_string(partId)),
+                                info,
+                                policy,
+                                [](LogID, TermID, ClusterID, folly::StringPiece) { return true; });
+  };
+
+  policy.journal = std::make_shared<WalJournal>(journalDir);
+  auto wal1 = openWal(1);
+  auto wal2 = openWal(2);
+  for (int i = 1; i <= 100; i++) {
+    ASSERT_TRUE(wal1->appendLog(i, 1, 0, folly::stringPrintf(kLongMsg, i)));
+    ASSERT_TRUE(wal2->appendLog(i, 1, 0, folly::stringPrintf(kLongMsg, i)));
+  }
+  wal1.reset();
+  wal2.reset();
+  policy.journal.reset();
+
+  // Such as part 1 is removed before it is opened again
+  auto journal = std::make_shared<WalJournal>(journalDir);
+  journal->drop(1, 1);
+  journal.reset();
+
+  journal = std::make_shared<WalJournal>(journalDir);
+  EXPECT_TRUE(journal->takeRecords(1, 1).empty());
+  EXPECT_EQ(100, journal->takeRecords(1, 2).size());
+}
+
 }  // namespace wal
 }  // namespace nebula
 
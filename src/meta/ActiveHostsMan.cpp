@@ -271,5 +271,21 @@ void LastUpdateTimeMan::update(kvstore::BatchHolder* batchHolder, const int64_t
                    MetaKeyUtils::lastUpdateTimeVal(timeInMilliSec));
 }
 
+void LastUpdateTimeMan::update(std::vector<kvstore::KV>& data,
+                               const int64_t timeInMilliSec,
+                               GraphSpaceID spaceId) {
+  update(data, timeInMilliSec);
+  data.emplace_back(MetaKeyUtils::spaceLastUpdateTimeKey(spaceId),
+                    MetaKeyUtils::lastUpdateTimeVal(timeInMilliSec));
+}
+
+void LastUpdateTimeMan::update(kvstore::BatchHolder* batchHolder,
+                               const int64_t timeInMilliSec,
+                               GraphSpaceID spaceId) {
+  update(batchHolder, timeInMilliSec);
+  batchHolder->put(MetaKeyUtils::spaceLastUpdateTimeKey(spaceId),
+                   MetaKeyUtils::lastUpdateTimeVal(timeInMilliSec));
+}
+
 }  // namespace meta
 }  // namespace nebula
@@ -218,6 +218,16 @@ class LastUpdateTimeMan final {
 
   static void update(kvstore::BatchHolder* batchHolder, const int64_t timeInMilliSec);
 
+  // Update the last update time of the space as well, on the changes of its schemas, indexes
+  // or listeners
+  static void update(std::vector<kvstore::KV>& data,
+                     const int64_t timeInMilliSec,
+                     GraphSpaceID spaceId);
+
+  static void update(kvstore::BatchHolder* batchHolder,
+                     const int64_t timeInMilliSec,
+                     GraphSpaceID spaceId);
+
  protected:
   LastUpdateTimeMan() = default;
 };
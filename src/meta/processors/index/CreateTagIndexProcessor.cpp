@@ -232,7 +232,7 @@ void CreateTagIndexProcessor::process(const cpp2::CreateTagIndexReq& req) {
   LOG(INFO) << "Create Tag Index " << indexName << ", tagIndex " << tagIndex;
   resp_.id_ref() = to(tagIndex, EntryType::INDEX);
   auto timeInMilliSec = time::WallClock::fastNowInMilliSec();
-  LastUpdateTimeMan::update(data, timeInMilliSec);
+  LastUpdateTimeMan::update(data, timeInMilliSec, space);
   auto result = doSyncPut(std::move(data));
   handleErrorCode(result);
   onFinished();
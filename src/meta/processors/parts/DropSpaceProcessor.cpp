@@ -146,6 +146,9 @@ void DropSpaceProcessor::process(const cpp2::DropSpaceReq& req) {
     jobIter->next();
   }
 
+  // 9. Delete the last update time of the space
+  batchHolder->remove(MetaKeyUtils::spaceLastUpdateTimeKey(spaceId));
+
   auto timeInMilliSec = time::WallClock::fastNowInMilliSec();
   LastUpdateTimeMan::update(batchHolder.get(), timeInMilliSec);
   auto batch = encodeBatchValue(std::move(batchHolder)->getBatch());
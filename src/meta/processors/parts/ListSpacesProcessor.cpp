@@ -33,8 +33,26 @@ void ListSpacesProcessor::process(const cpp2::ListSpacesReq&) {
     iter->next();
   }
 
+  // The clients reload the spaces whose update time changed only
+  auto timeRet = doPrefix(MetaKeyUtils::spaceLastUpdateTimePrefix());
+  if (!nebula::ok(timeRet)) {
+    auto retCode = nebula::error(timeRet);
+    LOG(INFO) << "List spaces failed, error " << apache::thrift::util::enumNameSafe(retCode);
+    handleErrorCode(retCode);
+    onFinished();
+    return;
+  }
+  std::unordered_map<GraphSpaceID, int64_t> updateTimes;
+  auto timeIter = nebula::value(timeRet).get();
+  while (timeIter->valid()) {
+    updateTimes.emplace(MetaKeyUtils::parseSpaceLastUpdateTimeSpace(timeIter->key()),
+                        MetaKeyUtils::parseLastUpdateTimeVal(timeIter->val()));
+    timeIter->next();
+  }
+
   handleErrorCode(nebula::cpp2::ErrorCode::SUCCEEDED);
   resp_.spaces_ref() = std::move(spaces);
+  resp_.space_update_times_ref() = std::move(updateTimes);
   onFinished();
 }
 
@@ -1192,6 +1192,56 @@ TEST(ProcessorTest, DropTagTest) {
   }
 }
 
+TEST(ProcessorTest, SpaceUpdateTimeTest) {
+  fs::TempDir rootPath("/tmp/SpaceUpdateTimeTest.XXXXXX");
+  auto kv = MockCluster::initMetaKV(rootPath.path());
+  TestUtils::assembleSpace(kv.get(), 1, 1, 1, 1, true);
+  TestUtils::assembleSpace(kv.get(), 2, 1, 1, 1, true);
+
+  auto listSpaces = [&kv]() {
+    cpp2::ListSpacesReq req;
+    auto* processor = ListSpacesProcessor::instance(kv.get());
+    auto f = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(f).get();
+    EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, resp.get_code());
+    EXPECT_EQ(2, resp.get_spaces().size());
+    return resp.get_space_update_times();
+  };
+  // No schema has been created
+  ASSERT_TRUE(listSpaces().empty());
+
+  // Only the time of the space whose schemas changed is updated
+  {
+    cpp2::CreateTagReq req;
+    req.space_id_ref() = 1;
+    req.tag_name_ref() = "tag_0";
+    auto* processor = CreateTagProcessor::instance(kv.get());
+    auto f = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(f).get();
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, resp.get_code());
+  }
+  auto times = listSpaces();
+  ASSERT_EQ(1, times.size());
+  ASSERT_EQ(1, times.count(1));
+  auto createTime = times[1];
+
+  {
+    cpp2::DropTagReq req;
+    req.space_id_ref() = 1;
+    req.tag_name_ref() = "tag_0";
+    auto* processor = DropTagProcessor::instance(kv.get());
+    auto f = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(f).get();
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, resp.get_code());
+  }
+  times = listSpaces();
+  ASSERT_EQ(1, times.size());
+  ASSERT_LE(createTime, times[1]);
+}
+
 TEST(ProcessorTest, DropEdgeTest) {
   fs::TempDir rootPath("/tmp/DropEdgeTest.XXXXXX");
   auto kv = MockCluster::initMetaKV(rootPath.path());
@@ -36,14 +36,7 @@ bool CommonUtils::checkDataExpiredForTTL(const meta::NebulaSchemaProvider* schem
     return false;
   }
 
-  int64_t now;
-  // The unit of ttl expiration unit is controlled by user, we just use a gflag here.
-  if (!FLAGS_ttl_use_ms) {
-    now = std::time(nullptr);
-  } else {
-    auto t = std::chrono::system_clock::now();
-    now = std::chrono::duration_cast<std::chrono::milliseconds>(t.time_since_epoch()).count();
-  }
+  auto now = ttlNow();
 
   // if the value is not INT type (sush as NULL), it will never expire.
   // TODO (sky) : DateTime
@@ -54,6 +47,15 @@ bool CommonUtils::checkDataExpiredForTTL(const meta::NebulaSchemaProvider* schem
   return false;
 }
 
+int64_t CommonUtils::ttlNow() {
+  // The unit of ttl expiration unit is controlled by user, we just use a gflag here.
+  if (!FLAGS_ttl_use_ms) {
+    return std::time(nullptr);
+  }
+  auto t = std::chrono::system_clock::now();
+  return std::chrono::duration_cast<std::chrono::milliseconds>(t.time_since_epoch()).count();
+}
+
 std::pair<bool, std::pair<int64_t, std::string>> CommonUtils::ttlProps(
     const meta::NebulaSchemaProvider* schema) {
   DCHECK(schema != nullptr);
@@ -10,7 +10,6 @@
 
 #include "codec/RowReaderWrapper.h"
 #include "common/base/Base.h"
-#include "common/base/ConcurrentLRUCache.h"
 #include "common/meta/IndexManager.h"
 #include "common/meta/SchemaManager.h"
 #include "common/stats/StatsManager.h"
@@ -18,6 +17,7 @@
 #include "interface/gen-cpp2/storage_types.h"
 #include "kvstore/KVEngine.h"
 #include "kvstore/KVStore.h"
+#include "storage/query/EdgeCache.h"
 
 namespace nebula {
 namespace storage {
@@ -51,7 +51,6 @@ enum class IndexState {
   FINISHED,  // The part is building index successfully.
 };
 
-using VertexCache = ConcurrentLRUCache<std::pair<VertexID, TagID>, std::string>;
 using IndexKey = std::tuple<GraphSpaceID, PartitionID>;
 using IndexGuard = folly::ConcurrentHashMap<IndexKey, IndexState>;
 
@@ -79,6 +78,8 @@ class StorageEnv {
   TransactionManager* txnMan_{nullptr};
   std::unique_ptr<VerticesMemLock> verticesML_{nullptr};
   std::unique_ptr<EdgesMemLock> edgesML_{nullptr};
+  // The cache of the edges of the vertices expanded, nullptr if disabled
+  std::unique_ptr<EdgeCache> edgeCache_{nullptr};
   std::unique_ptr<kvstore::KVEngine> adminStore_{nullptr};
   int32_t adminSeqId_{0};
 
@@ -171,6 +172,8 @@ class PlanContext {
   GraphSpaceID spaceId_;
   SessionID sessionId_;
   ExecutionPlanID planId_;
+  // The sessions and the plans of all the queries if the request is merged by the client
+  std::vector<std::pair<SessionID, ExecutionPlanID>> mergedPlans_;
   size_t vIdLen_;
   bool isIntId_;
 
@@ -219,11 +222,19 @@ struct RuntimeContext {
   }
 
   bool isPlanKilled() {
-    if (env() == nullptr) {
+    if (env() == nullptr || env()->metaClient_ == nullptr) {
       return false;
     }
-    return env()->metaClient_ &&
-           env()->metaClient_->checkIsPlanKilled(planContext_->sessionId_, planContext_->planId_);
+    auto* metaClient = env()->metaClient_;
+    const auto& mergedPlans = planContext_->mergedPlans_;
+    if (mergedPlans.empty()) {
+      return metaClient->checkIsPlanKilled(planContext_->sessionId_, planContext_->planId_);
+    }
+    // The rows of the other queries are still wanted, the ones of a killed query are dropped by
+    // its caller
+    return std::all_of(mergedPlans.begin(), mergedPlans.end(), [metaClient](const auto& plan) {
+      return metaClient->checkIsPlanKilled(plan.first, plan.second);
+    });
   }
 
   PlanContext* planContext_;
@@ -270,6 +281,11 @@ class CommonUtils final {
                                      const std::string& ttlCol,
                                      int64_t ttlDuration);
 
+  /**
+   * @brief Current time in the unit of the ttl, i.e. seconds or milliseconds by --ttl_use_ms
+   */
+  static int64_t ttlNow();
+
   static std::pair<bool, std::pair<int64_t, std::string>> ttlProps(
       const meta::NebulaSchemaProvider* schema);
 
@@ -15,20 +15,86 @@
 #include "kvstore/CompactionFilter.h"
 #include "storage/CommonUtils.h"
 #include "storage/StorageFlags.h"
-
-DEFINE_int32(min_level_for_custom_filter,
-             0,
-             "Minimal level compaction which will go through custom compaction filter");
+#include "storage/exec/QueryUtils.h"
 
 namespace nebula {
 namespace storage {
 
+/**
+ * @brief The schemas and the ttl of the tags and edges of a space, looked up once in a compaction
+ * or a sst file instead of once for each row
+ */
+class CompactionSchemaCache final {
+ public:
+  struct Entry {
+    // The latest schema, nullptr if the tag or edge is dropped
+    std::shared_ptr<const meta::NebulaSchemaProvider> schema;
+    bool hasTtl{false};
+    int64_t ttlDuration{0};
+    std::string ttlCol;
+    // The schemas of the versions the rows are written in
+    std::unordered_map<SchemaVer, std::shared_ptr<const meta::NebulaSchemaProvider>> versions;
+  };
+
+  CompactionSchemaCache(meta::SchemaManager* schemaMan, GraphSpaceID spaceId)
+      : schemaMan_(schemaMan), spaceId_(spaceId) {}
+
+  /**
+   * @brief Return the entry of a tag, or an edge type if `isEdge`
+   */
+  Entry& get(bool isEdge, int32_t id) {
+    auto key = (static_cast<uint64_t>(isEdge) << 32) | static_cast<uint32_t>(id);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      return it->second;
+    }
+    auto& entry = entries_[key];
+    entry.schema =
+        isEdge ? schemaMan_->getEdgeSchema(spaceId_, id) : schemaMan_->getTagSchema(spaceId_, id);
+    if (entry.schema != nullptr) {
+      auto ttl = CommonUtils::ttlProps(entry.schema.get());
+      entry.hasTtl = ttl.first;
+      entry.ttlDuration = ttl.second.first;
+      entry.ttlCol = std::move(ttl.second.second);
+    }
+    return entry;
+  }
+
+  /**
+   * @brief Return the reader of a row of the tag or edge type, which is null if the row is bad
+   */
+  RowReaderWrapper reader(Entry& entry, bool isEdge, int32_t id, folly::StringPiece row) {
+    SchemaVer schemaVer;
+    int32_t readerVer;
+    RowReaderWrapper::getVersions(row, schemaVer, readerVer);
+    if (schemaVer < 0) {
+      return RowReaderWrapper();
+    }
+    auto it = entry.versions.find(schemaVer);
+    if (it == entry.versions.end()) {
+      auto schema = isEdge ? schemaMan_->getEdgeSchema(spaceId_, id, schemaVer)
+                           : schemaMan_->getTagSchema(spaceId_, id, schemaVer);
+      it = entry.versions.emplace(schemaVer, std::move(schema)).first;
+    }
+    if (it->second == nullptr) {
+      return RowReaderWrapper();
+    }
+    return RowReaderWrapper(it->second.get(), row, readerVer);
+  }
+
+ private:
+  meta::SchemaManager* schemaMan_;
+  GraphSpaceID spaceId_;
+  std::unordered_map<uint64_t, Entry> entries_;
+};
+
 class StorageCompactionFilter final : public kvstore::KVFilter {
  public:
   StorageCompactionFilter(meta::SchemaManager* schemaMan,
                           meta::IndexManager* indexMan,
+                          GraphSpaceID spaceId,
                           size_t vIdLen)
-      : schemaMan_(schemaMan), indexMan_(indexMan), vIdLen_(vIdLen) {
+      : schemaMan_(schemaMan), indexMan_(indexMan), vIdLen_(vIdLen), schemas_(schemaMan, spaceId) {
     CHECK_NOTNULL(schemaMan_);
   }
 
@@ -63,17 +129,17 @@ class StorageCompactionFilter final : public kvstore::KVFilter {
                 const folly::StringPiece& key,
                 const folly::StringPiece& val) const {
     auto tagId = NebulaKeyUtils::getTagId(vIdLen_, key);
-    auto schema = schemaMan_->getTagSchema(spaceId, tagId);
-    if (!schema) {
+    auto& entry = schemas_.get(false, tagId);
+    if (!entry.schema) {
       VLOG(3) << "Space " << spaceId << ", Tag " << tagId << " invalid";
       return false;
     }
-    auto reader = RowReaderWrapper::getTagPropReader(schemaMan_, spaceId, tagId, val);
+    auto reader = schemas_.reader(entry, false, tagId, val);
     if (reader == nullptr) {
       VLOG(3) << "Remove the bad format vertex";
       return false;
     }
-    if (ttlExpired(schema.get(), reader.get())) {
+    if (ttlExpired(entry, reader.get())) {
       VLOG(3) << "Ttl expired";
       return false;
     }
@@ -88,17 +154,17 @@ class StorageCompactionFilter final : public kvstore::KVFilter {
       VLOG(3) << "Invalid reverse edge key";
       return false;
     }
-    auto schema = schemaMan_->getEdgeSchema(spaceId, std::abs(edgeType));
-    if (!schema) {
+    auto& entry = schemas_.get(true, std::abs(edgeType));
+    if (!entry.schema) {
       VLOG(3) << "Space " << spaceId << ", EdgeType " << edgeType << " invalid";
       return false;
     }
-    auto reader = RowReaderWrapper::getEdgePropReader(schemaMan_, spaceId, std::abs(edgeType), val);
+    auto reader = schemas_.reader(entry, true, std::abs(edgeType), val);
     if (reader == nullptr) {
       VLOG(3) << "Remove the bad format edge!";
       return false;
     }
-    if (ttlExpired(schema.get(), reader.get())) {
+    if (ttlExpired(entry, reader.get())) {
       VLOG(3) << "Ttl expired";
       return false;
     }
@@ -107,28 +173,23 @@ class StorageCompactionFilter final : public kvstore::KVFilter {
 
   bool lockValid(GraphSpaceID spaceId, const folly::StringPiece& key) const {
     auto edgeType = NebulaKeyUtils::getEdgeType(vIdLen_, key);
-    auto schema = schemaMan_->getEdgeSchema(spaceId, std::abs(edgeType));
-    if (!schema) {
+    if (!schemas_.get(true, std::abs(edgeType)).schema) {
       VLOG(3) << "Space " << spaceId << ", EdgeType " << edgeType << " invalid";
       return false;
     }
     return true;
   }
 
-  // TODO(panda) Optimize the method in the future
-  bool ttlExpired(const meta::NebulaSchemaProvider* schema,
+  bool ttlExpired(const CompactionSchemaCache::Entry& entry,
                   nebula::RowReaderWrapper* reader) const {
-    if (schema == nullptr) {
-      return true;
-    }
-    auto ttl = CommonUtils::ttlProps(schema);
     // Only support the specified ttl_col mode
     // Not specifying or non-positive ttl_duration behaves like ttl_duration =
     // infinity
-    if (!ttl.first) {
+    if (!entry.hasTtl) {
       return false;
     }
-    return CommonUtils::checkDataExpiredForTTL(schema, reader, ttl.second.second, ttl.second.first);
+    return CommonUtils::checkDataExpiredForTTL(
+        entry.schema.get(), reader, entry.ttlCol, entry.ttlDuration);
   }
 
   bool ttlExpired(const meta::NebulaSchemaProvider* schema, const Value& v) const {
@@ -183,6 +244,173 @@ class StorageCompactionFilter final : public kvstore::KVFilter {
   meta::SchemaManager* schemaMan_ = nullptr;
   meta::IndexManager* indexMan_ = nullptr;
   size_t vIdLen_;
+  // A filter is only used by one compaction at a time
+  mutable CompactionSchemaCache schemas_;
+};
+
+/**
+ * @brief Table properties of the ttl of the rows in a sst file, used to drop the files whose rows
+ * are all expired without decoding them.
+ */
+struct TtlTableProperties {
+  // Max expiration time of the rows in the unit of the ttl
+  static constexpr const char* kMaxExpireTime = "nebula.ttl.max_expire_time";
+  // Number of the entries never expire, e.g. the rows without ttl, the deletions, the indexes
+  static constexpr const char* kNumNeverExpire = "nebula.ttl.num_never_expire";
+  // The ttl of the tags and edges the expiration time is computed with, so a file is not dropped
+  // if the ttl of them is extended later, encoded as [isEdge, id, duration, col length, col]...
+  static constexpr const char* kTtls = "nebula.ttl.ttls";
+
+  struct Ttl {
+    bool isEdge;
+    int32_t id;
+    int64_t duration;
+    std::string col;
+  };
+
+  static std::string encode(const std::vector<Ttl>& ttls) {
+    std::string str;
+    for (const auto& ttl : ttls) {
+      int32_t len = ttl.col.size();
+      str.append(1, static_cast<char>(ttl.isEdge))
+          .append(reinterpret_cast<const char*>(&ttl.id), sizeof(int32_t))
+          .append(reinterpret_cast<const char*>(&ttl.duration), sizeof(int64_t))
+          .append(reinterpret_cast<const char*>(&len), sizeof(int32_t))
+          .append(ttl.col);
+    }
+    return str;
+  }
+
+  static std::optional<std::vector<Ttl>> decode(folly::StringPiece str) {
+    constexpr size_t kHeadSize = 1 + sizeof(int32_t) + sizeof(int64_t) + sizeof(int32_t);
+    std::vector<Ttl> ttls;
+    while (!str.empty()) {
+      if (str.size() < kHeadSize) {
+        return std::nullopt;
+      }
+      Ttl ttl;
+      ttl.isEdge = str[0] != 0;
+      ttl.id = readInt<int32_t>(str.data() + 1, sizeof(int32_t));
+      ttl.duration = readInt<int64_t>(str.data() + 1 + sizeof(int32_t), sizeof(int64_t));
+      auto len = readInt<int32_t>(str.data() + kHeadSize - sizeof(int32_t), sizeof(int32_t));
+      str.advance(kHeadSize);
+      if (len < 0 || str.size() < static_cast<size_t>(len)) {
+        return std::nullopt;
+      }
+      ttl.col = str.subpiece(0, len).toString();
+      str.advance(len);
+      ttls.emplace_back(std::move(ttl));
+    }
+    return ttls;
+  }
+};
+
+/**
+ * @brief Collect the TtlTableProperties of a sst file
+ */
+class StorageTtlPropertiesCollector final : public rocksdb::TablePropertiesCollector {
+ public:
+  StorageTtlPropertiesCollector(meta::SchemaManager* schemaMan,
+                                GraphSpaceID spaceId,
+                                size_t vIdLen)
+      : vIdLen_(vIdLen), schemas_(schemaMan, spaceId) {}
+
+  rocksdb::Status AddUserKey(const rocksdb::Slice& key,
+                             const rocksdb::Slice& value,
+                             rocksdb::EntryType type,
+                             rocksdb::SequenceNumber,
+                             uint64_t) override {
+    std::optional<int64_t> expire;
+    if (type == rocksdb::kEntryPut) {
+      expire = expireTime(folly::StringPiece(key.data(), key.size()),
+                          folly::StringPiece(value.data(), value.size()));
+    }
+    if (expire.has_value()) {
+      maxExpireTime_ = std::max(maxExpireTime_, *expire);
+    } else {
+      numNeverExpire_++;
+    }
+    return rocksdb::Status::OK();
+  }
+
+  rocksdb::Status Finish(rocksdb::UserCollectedProperties* props) override {
+    props->emplace(TtlTableProperties::kMaxExpireTime, folly::to<std::string>(maxExpireTime_));
+    props->emplace(TtlTableProperties::kNumNeverExpire, folly::to<std::string>(numNeverExpire_));
+    std::vector<TtlTableProperties::Ttl> ttls;
+    for (const auto& [key, ttl] : ttls_) {
+      ttls.emplace_back(TtlTableProperties::Ttl{
+          static_cast<bool>(key >> 32), static_cast<int32_t>(key), ttl.first, ttl.second});
+    }
+    props->emplace(TtlTableProperties::kTtls, TtlTableProperties::encode(ttls));
+    return rocksdb::Status::OK();
+  }
+
+  rocksdb::UserCollectedProperties GetReadableProperties() const override {
+    return {{TtlTableProperties::kMaxExpireTime, folly::to<std::string>(maxExpireTime_)},
+            {TtlTableProperties::kNumNeverExpire, folly::to<std::string>(numNeverExpire_)}};
+  }
+
+  const char* Name() const override {
+    return "StorageTtlPropertiesCollector";
+  }
+
+ private:
+  // Expiration time of a tag or edge row, nullopt if it never expires
+  std::optional<int64_t> expireTime(folly::StringPiece key, folly::StringPiece val) {
+    bool isEdge = false;
+    int32_t id = 0;
+    if (NebulaKeyUtils::isTag(vIdLen_, key)) {
+      id = NebulaKeyUtils::getTagId(vIdLen_, key);
+    } else if (NebulaKeyUtils::isEdge(vIdLen_, key)) {
+      isEdge = true;
+      id = std::abs(NebulaKeyUtils::getEdgeType(vIdLen_, key));
+    } else {
+      return std::nullopt;
+    }
+    auto& entry = schemas_.get(isEdge, id);
+    if (!entry.hasTtl) {
+      return std::nullopt;
+    }
+    auto reader = schemas_.reader(entry, isEdge, id, val);
+    if (reader == nullptr) {
+      return std::nullopt;
+    }
+    auto v = QueryUtils::readValue(reader.get(), entry.ttlCol, entry.schema.get());
+    if (!v.ok() || !v.value().isInt()) {
+      return std::nullopt;
+    }
+    auto ttlKey = (static_cast<uint64_t>(isEdge) << 32) | static_cast<uint32_t>(id);
+    ttls_.emplace(ttlKey, std::make_pair(entry.ttlDuration, entry.ttlCol));
+    return v.value().getInt() + entry.ttlDuration;
+  }
+
+  size_t vIdLen_;
+  CompactionSchemaCache schemas_;
+  int64_t maxExpireTime_{std::numeric_limits<int64_t>::min()};
+  uint64_t numNeverExpire_{0};
+  std::map<uint64_t, std::pair<int64_t, std::string>> ttls_;
+};
+
+class StorageTtlPropertiesCollectorFactory final : public rocksdb::TablePropertiesCollectorFactory {
+ public:
+  StorageTtlPropertiesCollectorFactory(meta::SchemaManager* schemaMan,
+                                       GraphSpaceID spaceId,
+                                       size_t vIdLen)
+      : schemaMan_(schemaMan), spaceId_(spaceId), vIdLen_(vIdLen) {}
+
+  rocksdb::TablePropertiesCollector* CreateTablePropertiesCollector(
+      rocksdb::TablePropertiesCollectorFactory::Context) override {
+    return new StorageTtlPropertiesCollector(schemaMan_, spaceId_, vIdLen_);
+  }
+
+  const char* Name() const override {
+    return "StorageTtlPropertiesCollectorFactory";
+  }
+
+ private:
+  meta::SchemaManager* schemaMan_;
+  GraphSpaceID spaceId_;
+  size_t vIdLen_;
 };
 
 class StorageCompactionFilterFactory final : public kvstore::KVCompactionFilterFactory {
@@ -194,10 +422,42 @@ class StorageCompactionFilterFactory final : public kvstore::KVCompactionFilterF
       : KVCompactionFilterFactory(spaceId),
         schemaMan_(schemaMan),
         indexMan_(indexMan),
+        spaceId_(spaceId),
         vIdLen_(vIdLen) {}
 
   std::unique_ptr<kvstore::KVFilter> createKVFilter() override {
-    return std::make_unique<StorageCompactionFilter>(schemaMan_, indexMan_, vIdLen_);
+    return std::make_unique<StorageCompactionFilter>(schemaMan_, indexMan_, spaceId_, vIdLen_);
+  }
+
+  std::shared_ptr<rocksdb::TablePropertiesCollectorFactory> createTablePropertiesCollectorFactory()
+      override {
+    return std::make_shared<StorageTtlPropertiesCollectorFactory>(schemaMan_, spaceId_, vIdLen_);
+  }
+
+  bool expired(const rocksdb::TableProperties& props) const override {
+    const auto& collected = props.user_collected_properties;
+    auto maxExpire = collected.find(TtlTableProperties::kMaxExpireTime);
+    auto numNeverExpire = collected.find(TtlTableProperties::kNumNeverExpire);
+    auto ttlsIt = collected.find(TtlTableProperties::kTtls);
+    if (maxExpire == collected.end() || numNeverExpire == collected.end() ||
+        ttlsIt == collected.end() || numNeverExpire->second != "0") {
+      return false;
+    }
+    auto ttls = TtlTableProperties::decode(ttlsIt->second);
+    if (!ttls.has_value() || ttls->empty()) {
+      return false;
+    }
+    // The rows may live longer if the ttl is changed since the file is written
+    CompactionSchemaCache schemas(schemaMan_, spaceId_);
+    for (const auto& ttl : *ttls) {
+      auto& entry = schemas.get(ttl.isEdge, ttl.id);
+      if (entry.schema != nullptr &&
+          (!entry.hasTtl || entry.ttlCol != ttl.col || entry.ttlDuration > ttl.duration)) {
+        return false;
+      }
+    }
+    auto expireTime = folly::tryTo<int64_t>(maxExpire->second);
+    return expireTime.hasValue() && CommonUtils::ttlNow() > expireTime.value();
   }
 
   const char* Name() const override {
@@ -207,6 +467,7 @@ class StorageCompactionFilterFactory final : public kvstore::KVCompactionFilterF
  private:
   meta::SchemaManager* schemaMan_ = nullptr;
   meta::IndexManager* indexMan_ = nullptr;
+  GraphSpaceID spaceId_;
   size_t vIdLen_;
 };
 
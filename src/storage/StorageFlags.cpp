@@ -42,9 +42,43 @@ DEFINE_bool(trace_toss, false, "output verbose log of toss");
 
 DEFINE_int32(max_edge_returned_per_vertex, INT_MAX, "Max edge number returned searching vertex");
 
+DEFINE_bool(enable_sorted_neighbor_scan,
+            true,
+            "whether to scan the neighbors of the vertices of a part in the key order, and reuse "
+            "the iterator of each edge type across the vertices");
+
+DEFINE_uint32(index_scan_base_batch_size,
+              256,
+              "max number of base data fetched with one multiGet when an index scan needs to "
+              "access the base data, 1 means fetching them one by one");
+
 DEFINE_bool(query_concurrently,
             false,
             "whether to run query of each part concurrently, only lookup and "
             "go are supported");
 
+DEFINE_int32(query_morsel_size,
+             256,
+             "number of vertices of a part scanned as one unit of work when a query runs "
+             "concurrently, a big part is split into several ones scanned by different threads");
+
+DEFINE_int32(query_workers_per_request,
+             0,
+             "max number of threads a request is run on concurrently, 0 means up to the number "
+             "of reader handlers");
+
 DEFINE_bool(use_vertex_key, false, "whether allow insert or query the vertex key");
+
+DEFINE_uint32(memory_lock_wait_ms,
+              0,
+              "how long a mutation waits for the vertices or edges locked by the others, it fails "
+              "with a data conflict at once if 0");
+
+DEFINE_int32(min_level_for_custom_filter,
+             0,
+             "Minimal level compaction which will go through custom compaction filter");
+
+DEFINE_int32(edge_cache_capacity_mb,
+             0,
+             "capacity of the cache of the edges of the vertices expanded, which keeps the edges "
+             "of a vertex in an edge type together, 0 means disabled");
@@ -32,8 +32,22 @@ DECLARE_bool(trace_toss);
 
 DECLARE_int32(max_edge_returned_per_vertex);
 
+DECLARE_bool(enable_sorted_neighbor_scan);
+
+DECLARE_uint32(index_scan_base_batch_size);
+
 DECLARE_bool(query_concurrently);
 
+DECLARE_int32(query_morsel_size);
+
+DECLARE_int32(query_workers_per_request);
+
 DECLARE_bool(use_vertex_key);
 
+DECLARE_uint32(memory_lock_wait_ms);
+
+DECLARE_int32(min_level_for_custom_filter);
+
+DECLARE_int32(edge_cache_capacity_mb);
+
 #endif  // STORAGE_STORAGEFLAGS_H_
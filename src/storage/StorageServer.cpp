@@ -29,6 +29,7 @@
 #include "storage/http/StorageHttpAdminHandler.h"
 #include "storage/http/StorageHttpPropertyHandler.h"
 #include "storage/http/StorageHttpStatsHandler.h"
+#include "storage/stats/StorageStats.h"
 #include "storage/transaction/TransactionManager.h"
 #include "version/Version.h"
 #include "webservice/Router.h"
@@ -276,8 +277,15 @@ bool StorageServer::start() {
   env_->rebuildIndexGuard_ = std::make_unique<IndexGuard>();
   env_->metaClient_ = metaClient_.get();
 
-  env_->verticesML_ = std::make_unique<VerticesMemLock>();
-  env_->edgesML_ = std::make_unique<EdgesMemLock>();
+  auto lockWait = std::chrono::milliseconds(FLAGS_memory_lock_wait_ms);
+  env_->verticesML_ = std::make_unique<VerticesMemLock>(lockWait, kNumMemoryLockConflicts);
+  env_->edgesML_ = std::make_unique<EdgesMemLock>(lockWait, kNumMemoryLockConflicts);
+  if (FLAGS_edge_cache_capacity_mb > 0) {
+    LOG(INFO) << "Init edge cache";
+    env_->edgeCache_ = std::make_unique<EdgeCache>(
+        static_cast<size_t>(FLAGS_edge_cache_capacity_mb) * 1024 * 1024);
+    env_->edgeCache_->attach(static_cast<kvstore::NebulaStore*>(kvstore_.get()), schemaMan_.get());
+  }
   env_->adminStore_ = getAdminStoreInstance();
   env_->adminSeqId_ = getAdminStoreSeqId();
   if (env_->adminSeqId_ < 0) {
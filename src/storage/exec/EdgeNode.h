@@ -9,6 +9,7 @@
 #include "common/base/Base.h"
 #include "storage/exec/RelNode.h"
 #include "storage/exec/StorageIterator.h"
+#include "storage/stats/StorageStats.h"
 
 namespace nebula {
 namespace storage {
@@ -192,6 +193,15 @@ class SingleEdgeNode final : public EdgeNode<VertexID> {
     name_ = "SingleEdgeNode";
   }
 
+  ~SingleEdgeNode() override {
+    if (cacheHits_ > 0) {
+      stats::StatsManager::addValue(kNumEdgeCacheHits, cacheHits_);
+    }
+    if (cacheMisses_ > 0) {
+      stats::StatsManager::addValue(kNumEdgeCacheMisses, cacheMisses_);
+    }
+  }
+
   SingleEdgeIterator* iter() {
     return iter_.get();
   }
@@ -224,10 +234,21 @@ class SingleEdgeNode final : public EdgeNode<VertexID> {
 
     VLOG(1) << "partId " << partId << ", vId " << vId << ", edgeType " << edgeType_
             << ", prop size " << props_->size();
-    std::unique_ptr<kvstore::KVIterator> iter;
     prefix_ = NebulaKeyUtils::edgePrefix(context_->vIdLen(), partId, vId, edgeType_);
-    ret = context_->env()->kvstore_->prefix(context_->spaceId(), partId, prefix_, &iter);
-    if (ret == nebula::cpp2::ErrorCode::SUCCEEDED && iter && iter->valid()) {
+    std::unique_ptr<kvstore::KVIterator> iter;
+    auto* cache = context_->env()->edgeCache_.get();
+    if (cache != nullptr) {
+      ret = readThroughCache(cache, partId, &iter);
+    } else {
+      if (reusable_ && iter_ != nullptr && partId == partId_ && iter_->reset(prefix_)) {
+        // Seek the iterator of the last vertex in the same part forward
+        return nebula::cpp2::ErrorCode::SUCCEEDED;
+      }
+      ret = context_->env()->kvstore_->prefix(context_->spaceId(), partId, prefix_, &iter);
+    }
+    // The iterator is kept even if there is no edge when it's reusable
+    if (ret == nebula::cpp2::ErrorCode::SUCCEEDED && iter && (reusable_ || iter->valid())) {
+      partId_ = partId;
       if (!skipDecode_) {
         iter_.reset(new SingleEdgeIterator(context_, std::move(iter), edgeType_, schemas_, &ttl_));
       } else {
@@ -239,9 +260,55 @@ class SingleEdgeNode final : public EdgeNode<VertexID> {
     return ret;
   }
 
+  // Reuse the iterator across the vertices of the same part, which is cheaper if the vertices are
+  // executed in the key order
+  void setReusable(bool reusable) {
+    reusable_ = reusable;
+  }
+
  private:
+  // Read the edges under prefix_ from the cache, or from the engine and cache them. The edges too
+  // many to cache are still read in one pass, but not cached.
+  nebula::cpp2::ErrorCode readThroughCache(EdgeCache* cache,
+                                           PartitionID partId,
+                                           std::unique_ptr<kvstore::KVIterator>* iter) {
+    auto spaceId = context_->spaceId();
+    auto rows = cache->get(spaceId, prefix_);
+    if (rows != nullptr) {
+      cacheHits_++;
+      iter->reset(new EdgeCache::Iterator(std::move(rows)));
+      return nebula::cpp2::ErrorCode::SUCCEEDED;
+    }
+    cacheMisses_++;
+    auto ticket = cache->ticket(spaceId, prefix_);
+    std::unique_ptr<kvstore::KVIterator> kvIter;
+    auto ret = context_->env()->kvstore_->prefix(spaceId, partId, prefix_, &kvIter);
+    if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return ret;
+    }
+    auto loaded = std::make_shared<EdgeCache::Rows>();
+    size_t bytes = 0;
+    for (; kvIter->valid(); kvIter->next()) {
+      auto key = kvIter->key();
+      auto val = kvIter->val();
+      bytes += key.size() + val.size();
+      if (bytes > cache->maxEntryBytes()) {
+        iter->reset(new EdgeCache::Iterator(std::move(loaded), std::move(kvIter)));
+        return nebula::cpp2::ErrorCode::SUCCEEDED;
+      }
+      loaded->emplace_back(key.str(), val.str());
+    }
+    cache->insert(spaceId, prefix_, loaded, ticket);
+    iter->reset(new EdgeCache::Iterator(std::move(loaded)));
+    return nebula::cpp2::ErrorCode::SUCCEEDED;
+  }
+
   std::unique_ptr<SingleEdgeIterator> iter_;
   std::string prefix_;
+  bool reusable_{false};
+  PartitionID partId_{0};
+  size_t cacheHits_{0};
+  size_t cacheMisses_{0};
 };
 
 }  // namespace storage
@@ -7,6 +7,7 @@
 #define STORAGE_EXEC_FILTERNODE_H_
 
 #include "common/base/Base.h"
+#include "common/expression/CompiledExpression.h"
 #include "common/expression/Expression.h"
 #include "storage/context/StorageExpressionContext.h"
 #include "storage/exec/HashJoinNode.h"
@@ -47,6 +48,13 @@ class FilterNode : public IterateNode<T> {
         filterExp_(exp),
         tagFilterExp_(tagFilterExp) {
     IterateNode<T>::name_ = "FilterNode";
+    // The filters are evaluated for each tag or edge, so compile them in advance
+    if (filterExp_ != nullptr) {
+      compiledFilter_ = CompiledExpression::compile(filterExp_);
+    }
+    if (tagFilterExp_ != nullptr) {
+      compiledTagFilter_ = CompiledExpression::compile(tagFilterExp_);
+    }
   }
 
   nebula::cpp2::ErrorCode doExecute(PartitionID partId, const T& vId) override {
@@ -90,8 +98,12 @@ class FilterNode : public IterateNode<T> {
     }
   }
 
+  const Value& eval(Expression* exp, CompiledExpression* compiled) {
+    return compiled != nullptr ? compiled->eval(*expCtx_) : exp->eval(*expCtx_);
+  }
+
   bool checkTagOnly() {
-    auto result = filterExp_->eval(*expCtx_);
+    auto result = eval(filterExp_, compiledFilter_.get());
     // NULL is always false
     auto ret = result.toBool();
     return ret.isBool() && ret.getBool();
@@ -101,14 +113,14 @@ class FilterNode : public IterateNode<T> {
   bool checkTagAndEdge() {
     expCtx_->reset(this->reader(), this->key().str());
     if (tagFilterExp_ != nullptr) {
-      auto res = tagFilterExp_->eval(*expCtx_);
+      auto res = eval(tagFilterExp_, compiledTagFilter_.get());
       if (!res.isBool() || !res.getBool()) {
         context_->resultStat_ = ResultStatus::TAG_FILTER_OUT;
         return false;
       }
     }
     // result is false when filter out
-    auto result = filterExp_->eval(*expCtx_);
+    auto result = eval(filterExp_, compiledFilter_.get());
     // NULL is always false
     auto ret = result.toBool();
     return ret.isBool() && ret.getBool();
@@ -119,6 +131,8 @@ class FilterNode : public IterateNode<T> {
   StorageExpressionContext* expCtx_;
   Expression* filterExp_{nullptr};
   Expression* tagFilterExp_{nullptr};
+  std::unique_ptr<CompiledExpression> compiledFilter_;
+  std::unique_ptr<CompiledExpression> compiledTagFilter_;
   FilterMode mode_{FilterMode::TAG_AND_EDGE};
   int32_t callCheck{0};
 };
@@ -79,16 +79,14 @@ Row IndexEdgeScanNode::decodeFromIndex(folly::StringPiece key) {
   return Row(std::move(values));
 }
 
-nebula::cpp2::ErrorCode IndexEdgeScanNode::getBaseData(folly::StringPiece key,
-                                                       std::pair<std::string, std::string>& kv) {
+std::string IndexEdgeScanNode::getBaseKey(folly::StringPiece key) {
   auto vIdLen = context_->vIdLen();
-  kv.first = NebulaKeyUtils::edgeKey(vIdLen,
-                                     partId_,
-                                     IndexKeyUtils::getIndexSrcId(vIdLen, key).str(),
-                                     context_->edgeType_,
-                                     IndexKeyUtils::getIndexRank(vIdLen, key),
-                                     IndexKeyUtils::getIndexDstId(vIdLen, key).str());
-  return kvstore_->get(context_->spaceId(), partId_, kv.first, &kv.second);
+  return NebulaKeyUtils::edgeKey(vIdLen,
+                                 partId_,
+                                 IndexKeyUtils::getIndexSrcId(vIdLen, key).str(),
+                                 context_->edgeType_,
+                                 IndexKeyUtils::getIndexRank(vIdLen, key),
+                                 IndexKeyUtils::getIndexDstId(vIdLen, key).str());
 }
 
 Map<std::string, Value> IndexEdgeScanNode::decodeFromBase(const std::string& key,
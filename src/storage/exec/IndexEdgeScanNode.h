@@ -31,8 +31,7 @@ class IndexEdgeScanNode : public IndexScanNode {
 
  private:
   Row decodeFromIndex(folly::StringPiece key) override;
-  nebula::cpp2::ErrorCode getBaseData(folly::StringPiece key,
-                                      std::pair<std::string, std::string>& kv) override;
+  std::string getBaseKey(folly::StringPiece key) override;
   Map<std::string, Value> decodeFromBase(const std::string& key, const std::string& value) override;
 
   using EdgeSchemas = std::vector<std::shared_ptr<const nebula::meta::NebulaSchemaProvider>>;
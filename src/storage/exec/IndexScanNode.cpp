@@ -4,6 +4,8 @@
  */
 #include "storage/exec/IndexScanNode.h"
 
+#include "storage/StorageFlags.h"
+
 namespace nebula {
 namespace storage {
 // Define of Path
@@ -424,7 +426,32 @@ nebula::cpp2::ErrorCode IndexScanNode::doExecute(PartitionID partId) {
 }
 
 IndexNode::Result IndexScanNode::doNext() {
-  for (; iter_ && iter_->valid(); iter_->next()) {
+  while (rows_.empty()) {
+    if (!iter_ || !iter_->valid()) {
+      return Result();
+    }
+    auto ret = fetchBatch();
+    if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      return Result(ret);
+    }
+  }
+  Row row = std::move(rows_.front());
+  rows_.pop_front();
+  return Result(std::move(row));
+}
+
+nebula::cpp2::ErrorCode IndexScanNode::fetchBatch() {
+  // The hits in index order, the ones decoded from index have no base key
+  struct Hit {
+    std::string baseKey;
+    bool compatible;
+    Row row;
+  };
+  std::vector<Hit> hits;
+  std::vector<std::string> keys;
+  // Bound the rows buffered, including the ones decoded from index, so that a LIMIT above still
+  // stops the scan early
+  for (; iter_->valid() && hits.size() < batchSize_; iter_->next()) {
     if (!checkTTL()) {
       continue;
     }
@@ -434,27 +461,48 @@ IndexNode::Result IndexScanNode::doNext() {
     }
     bool compatible = q == QualifiedStrategy::COMPATIBLE;
     if (compatible && !needAccessBase_) {
-      auto key = iter_->key().toString();
-      iter_->next();
-      Row row = decodeFromIndex(key);
-      return Result(std::move(row));
+      hits.emplace_back(Hit{"", true, decodeFromIndex(iter_->key())});
+      continue;
+    }
+    keys.emplace_back(getBaseKey(iter_->key()));
+    hits.emplace_back(Hit{keys.back(), compatible, Row()});
+  }
+  if (!hits.empty()) {
+    batchSize_ = std::min<size_t>(batchSize_ * 2, std::max(FLAGS_index_scan_base_batch_size, 1U));
+  }
+
+  std::vector<std::string> values;
+  std::vector<Status> status;
+  if (!keys.empty()) {
+    auto ret = kvstore_->multiGet(spaceId_, partId_, keys, &values);
+    if (ret.first != nebula::cpp2::ErrorCode::SUCCEEDED &&
+        ret.first != nebula::cpp2::ErrorCode::E_PARTIAL_RESULT) {
+      return ret.first;
+    }
+    status = std::move(ret.second);
+  }
+
+  size_t i = 0;
+  for (auto& hit : hits) {
+    if (hit.baseKey.empty()) {
+      rows_.emplace_back(std::move(hit.row));
+      continue;
     }
-    std::pair<std::string, std::string> kv;
-    auto ret = getBaseData(iter_->key(), kv);
-    if (ret == nebula::cpp2::ErrorCode::SUCCEEDED) {  // do nothing
-    } else if (ret == nebula::cpp2::ErrorCode::E_KEY_NOT_FOUND) {
+    auto idx = i++;
+    if (!status[idx].ok()) {
+      if (status[idx].code() != Status::Code::kKeyNotFound) {
+        return nebula::cpp2::ErrorCode::E_UNKNOWN;
+      }
       if (LIKELY(!fatalOnBaseNotFound_)) {
         LOG(WARNING) << "base data not found";
       } else {
         LOG(FATAL) << "base data not found";
       }
       continue;
-    } else {
-      return Result(ret);
     }
-    Map<std::string, Value> rowData = decodeFromBase(kv.first, kv.second);
-    if (!compatible) {
-      q = path_->qualified(rowData);
+    Map<std::string, Value> rowData = decodeFromBase(hit.baseKey, values[idx]);
+    if (!hit.compatible) {
+      auto q = path_->qualified(rowData);
       CHECK(q != QualifiedStrategy::UNCERTAIN);
       if (q == QualifiedStrategy::INCOMPATIBLE) {
         continue;
@@ -464,10 +512,9 @@ IndexNode::Result IndexScanNode::doNext() {
     for (auto& col : requiredColumns_) {
       row.emplace_back(std::move(rowData.at(col)));
     }
-    iter_->next();
-    return Result(std::move(row));
+    rows_.emplace_back(std::move(row));
   }
-  return Result();
+  return nebula::cpp2::ErrorCode::SUCCEEDED;
 }
 
 bool IndexScanNode::checkTTL() {
@@ -486,6 +533,8 @@ bool IndexScanNode::checkTTL() {
 
 nebula::cpp2::ErrorCode IndexScanNode::resetIter(PartitionID partId) {
   path_->resetPart(partId);
+  rows_.clear();
+  batchSize_ = 1;
   nebula::cpp2::ErrorCode ret = nebula::cpp2::ErrorCode::SUCCEEDED;
   if (path_->isRange()) {
     auto rangePath = dynamic_cast<RangePath*>(path_.get());
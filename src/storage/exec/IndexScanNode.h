@@ -7,6 +7,7 @@
 #include <gtest/gtest_prod.h>
 
 #include <cstring>
+#include <deque>
 #include <functional>
 
 #include "common/base/Base.h"
@@ -99,14 +100,12 @@ class IndexScanNode : public IndexNode {
   virtual Row decodeFromIndex(folly::StringPiece key) = 0;
 
   /**
-   * @brief get the base data key-value according to index key
+   * @brief get the base data key according to index key
    *
    * @param key index key
-   * @param kv base data key-value
-   * @return nebula::cpp2::ErrorCode
+   * @return std::string
    */
-  virtual nebula::cpp2::ErrorCode getBaseData(folly::StringPiece key,
-                                              std::pair<std::string, std::string>& kv) = 0;
+  virtual std::string getBaseKey(folly::StringPiece key) = 0;
 
   /**
    * @brief decode all props from base data key-value.
@@ -135,6 +134,14 @@ class IndexScanNode : public IndexNode {
    * @see Path
    */
   nebula::cpp2::ErrorCode resetIter(PartitionID partId);
+
+  /**
+   * @brief Scan the index until a batch of hits needing base data is collected, fetch their base
+   * data with one multiGet, and buffer the qualified rows in `rows_`.
+   *
+   * @return nebula::cpp2::ErrorCode
+   */
+  nebula::cpp2::ErrorCode fetchBatch();
   PartitionID partId_;
   /**
    * @brief index_ in this Node to access
@@ -173,6 +180,15 @@ class IndexScanNode : public IndexNode {
   bool needAccessBase_{false};
   bool fatalOnBaseNotFound_{false};
   Map<std::string, size_t> colPosMap_;
+  /**
+   * @brief rows fetched by `fetchBatch` but not returned yet
+   */
+  std::deque<Row> rows_;
+  /**
+   * @brief number of base data to fetch in the next batch. It starts from 1 and doubles up to
+   * `--index_scan_base_batch_size`, so that a scan with a small limit doesn't read ahead too much
+   */
+  size_t batchSize_{1};
 };
 class QualifiedStrategy {
  public:
@@ -52,13 +52,11 @@ IndexVertexScanNode::IndexVertexScanNode(RuntimeContext* context,
   return IndexScanNode::init(ctx);
 }
 
-nebula::cpp2::ErrorCode IndexVertexScanNode::getBaseData(folly::StringPiece key,
-                                                         std::pair<std::string, std::string>& kv) {
-  kv.first = NebulaKeyUtils::tagKey(context_->vIdLen(),
-                                    partId_,
-                                    key.subpiece(key.size() - context_->vIdLen()).toString(),
-                                    context_->tagId_);
-  return kvstore_->get(context_->spaceId(), partId_, kv.first, &kv.second);
+std::string IndexVertexScanNode::getBaseKey(folly::StringPiece key) {
+  return NebulaKeyUtils::tagKey(context_->vIdLen(),
+                                partId_,
+                                key.subpiece(key.size() - context_->vIdLen()).toString(),
+                                context_->tagId_);
 }
 
 Row IndexVertexScanNode::decodeFromIndex(folly::StringPiece key) {
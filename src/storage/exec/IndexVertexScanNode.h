@@ -34,8 +34,7 @@ class IndexVertexScanNode final : public IndexScanNode {
   std::unique_ptr<IndexNode> copy() override;
 
  private:
-  nebula::cpp2::ErrorCode getBaseData(folly::StringPiece key,
-                                      std::pair<std::string, std::string>& kv) override;
+  std::string getBaseKey(folly::StringPiece key) override;
   Row decodeFromIndex(folly::StringPiece key) override;
   Map<std::string, Value> decodeFromBase(const std::string& key, const std::string& value) override;
 
@@ -124,6 +124,24 @@ class SingleEdgeIterator : public StorageIterator {
     return edgeType_;
   }
 
+  /**
+   * @brief Reuse the iterator to scan the edges with another prefix
+   *
+   * @return Whether the underlying kvstore iterator supports it
+   */
+  virtual bool reset(const std::string& prefix) {
+    reader_.reset();
+    if (!iter_->seekPrefix(prefix)) {
+      return false;
+    }
+    lastRank_ = 0;
+    lastDstId_ = "";
+    while (iter_->valid() && !check()) {
+      iter_->next();
+    }
+    return true;
+  }
+
  protected:
   /**
    * @brief return true when the value iter to a valid edge value
@@ -176,6 +194,10 @@ class SingleEdgeKeyIterator : public SingleEdgeIterator {
     DLOG(FATAL) << "This iterator should not read value";
     return nullptr;
   }
+
+  bool reset(const std::string& prefix) override {
+    return iter_->seekPrefix(prefix);
+  }
 };
 
 /**
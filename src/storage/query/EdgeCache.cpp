@@ -0,0 +1,155 @@
+/* Copyright (c) 2023 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "storage/query/EdgeCache.h"
+
+#include <folly/hash/Hash.h>
+
+#include "common/meta/SchemaManager.h"
+#include "common/utils/NebulaKeyUtils.h"
+#include "kvstore/NebulaStore.h"
+
+namespace nebula {
+namespace storage {
+
+EdgeCache::EdgeCache(size_t capacity) : shardCapacity_(capacity / kNumShards) {}
+
+// static
+std::string EdgeCache::cacheKey(GraphSpaceID spaceId, folly::StringPiece prefix) {
+  std::string key;
+  key.reserve(sizeof(GraphSpaceID) + prefix.size());
+  key.append(reinterpret_cast<const char*>(&spaceId), sizeof(GraphSpaceID))
+      .append(prefix.data(), prefix.size());
+  return key;
+}
+
+// static
+size_t EdgeCache::shardOf(folly::StringPiece key) {
+  return folly::hash::twang_mix64(std::hash<folly::StringPiece>()(key)) >> (64 - kShardBits);
+}
+
+// static
+void EdgeCache::erase(Shard& shard, std::list<Entry>::iterator it) {
+  shard.bytes -= it->bytes;
+  shard.index.erase(it->key);
+  shard.lru.erase(it);
+}
+
+std::shared_ptr<const EdgeCache::Rows> EdgeCache::get(GraphSpaceID spaceId,
+                                                      const std::string& prefix) {
+  auto key = cacheKey(spaceId, prefix);
+  auto& shard = *shards_[shardOf(key)];
+  std::lock_guard<std::mutex> guard(shard.lock);
+  auto it = shard.index.find(key);
+  if (it == shard.index.end()) {
+    return nullptr;
+  }
+  shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+  return it->second->rows;
+}
+
+uint64_t EdgeCache::ticket(GraphSpaceID spaceId, const std::string& prefix) {
+  auto& shard = *shards_[shardOf(cacheKey(spaceId, prefix))];
+  std::lock_guard<std::mutex> guard(shard.lock);
+  return shard.version;
+}
+
+bool EdgeCache::insert(GraphSpaceID spaceId,
+                       const std::string& prefix,
+                       std::shared_ptr<const Rows> rows,
+                       uint64_t ticket) {
+  auto key = cacheKey(spaceId, prefix);
+  size_t bytes = key.size();
+  for (const auto& row : *rows) {
+    bytes += row.first.size() + row.second.size();
+  }
+  if (bytes > maxEntryBytes()) {
+    return false;
+  }
+  auto& shard = *shards_[shardOf(key)];
+  std::lock_guard<std::mutex> guard(shard.lock);
+  if (shard.version != ticket) {
+    // The rows may be read before a write committed since the ticket
+    return false;
+  }
+  auto it = shard.index.find(key);
+  if (it != shard.index.end()) {
+    erase(shard, it->second);
+  }
+  while (!shard.lru.empty() && shard.bytes + bytes > shardCapacity_) {
+    erase(shard, std::prev(shard.lru.end()));
+  }
+  shard.lru.push_front(Entry{std::move(key), std::move(rows), bytes});
+  shard.index.emplace(shard.lru.front().key, shard.lru.begin());
+  shard.bytes += bytes;
+  return true;
+}
+
+void EdgeCache::invalidate(GraphSpaceID spaceId,
+                           PartitionID partId,
+                           size_t vIdLen,
+                           const std::vector<std::string>& keys,
+                           bool all) {
+  if (all) {
+    for (auto& s : shards_) {
+      auto& shard = *s;
+      std::lock_guard<std::mutex> guard(shard.lock);
+      shard.version++;
+      for (auto it = shard.lru.begin(); it != shard.lru.end();) {
+        auto curr = it++;
+        folly::StringPiece key = curr->key;
+        auto space = *reinterpret_cast<const GraphSpaceID*>(key.data());
+        key.advance(sizeof(GraphSpaceID));
+        if (space == spaceId && NebulaKeyUtils::getPart(key) == partId) {
+          erase(shard, curr);
+        }
+      }
+    }
+    return;
+  }
+  auto prefixLen = sizeof(PartitionID) + vIdLen + sizeof(EdgeType);
+  for (const auto& k : keys) {
+    if (!NebulaKeyUtils::isEdge(vIdLen, k) && !NebulaKeyUtils::isLock(vIdLen, k)) {
+      continue;
+    }
+    auto key = cacheKey(spaceId, folly::StringPiece(k).subpiece(0, prefixLen));
+    auto& shard = *shards_[shardOf(key)];
+    std::lock_guard<std::mutex> guard(shard.lock);
+    shard.version++;
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+      erase(shard, it->second);
+    }
+  }
+}
+
+void EdgeCache::attach(kvstore::NebulaStore* store, meta::SchemaManager* schemaMan) {
+  auto onNewPart = [this, schemaMan](std::shared_ptr<kvstore::Part>& part) {
+    auto vIdLen = schemaMan->getSpaceVidLen(part->spaceId());
+    // Drop the whole part on each commit if the edge keys can't be recognized
+    size_t len = vIdLen.ok() ? vIdLen.value() : 0;
+    // The edges cached of a part removed before are stale
+    invalidate(part->spaceId(), part->partitionId(), len, {}, true);
+    part->registerOnCommitted([this, len](const kvstore::Part::CallbackOptions& opt,
+                                          const std::vector<std::string>& keys,
+                                          bool all) {
+      invalidate(opt.spaceId, opt.partId, len, keys, all || len == 0);
+    });
+  };
+  std::vector<std::pair<GraphSpaceID, PartitionID>> existParts;
+  store->registerOnNewPartAdded("EdgeCache", onNewPart, existParts);
+}
+
+size_t EdgeCache::size() {
+  size_t size = 0;
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> guard(shard->lock);
+    size += shard->lru.size();
+  }
+  return size;
+}
+
+}  // namespace storage
+}  // namespace nebula
@@ -0,0 +1,179 @@
+/* Copyright (c) 2023 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef STORAGE_QUERY_EDGECACHE_H_
+#define STORAGE_QUERY_EDGECACHE_H_
+
+#include <folly/lang/Aligned.h>
+
+#include <list>
+
+#include "common/base/Base.h"
+#include "common/thrift/ThriftTypes.h"
+#include "kvstore/KVIterator.h"
+
+namespace nebula {
+namespace meta {
+class SchemaManager;
+}  // namespace meta
+namespace kvstore {
+class NebulaStore;
+}  // namespace kvstore
+namespace storage {
+
+/**
+ * @brief EdgeCache keeps the edges of a vertex in one edge type, i.e. all rows under an edge prefix
+ * of a part, for the vertices expanded over and over such as the supernodes.
+ *
+ * The cache is split into shards by the prefix, each is a LRU bounded by bytes. It's kept coherent
+ * with the engine by the raft apply of each part (see Part::registerOnCommitted): the prefixes of
+ * the edge keys committed are invalidated, and a whole part is dropped when its data is replaced.
+ * A reader takes a ticket of the shard before scanning the engine, and the rows are only cached if
+ * nothing in the shard is invalidated since then, so a scan racing with a write never caches the
+ * rows before the write.
+ */
+class EdgeCache final {
+ public:
+  using Rows = std::vector<std::pair<std::string, std::string>>;
+
+  /**
+   * @param capacity Max bytes of the rows cached
+   */
+  explicit EdgeCache(size_t capacity);
+
+  /**
+   * @brief Return the rows cached under the edge prefix, or nullptr if missed
+   *
+   * @param spaceId
+   * @param prefix Edge prefix of a vertex and an edge type
+   */
+  std::shared_ptr<const Rows> get(GraphSpaceID spaceId, const std::string& prefix);
+
+  /**
+   * @brief Return the ticket to insert the rows under the prefix, which must be taken before
+   * reading the rows from the engine
+   */
+  uint64_t ticket(GraphSpaceID spaceId, const std::string& prefix);
+
+  /**
+   * @brief Cache the rows read under the prefix, it's skipped if the shard is invalidated after
+   * the ticket is taken.
+   *
+   * @return Whether the rows are cached
+   */
+  bool insert(GraphSpaceID spaceId,
+              const std::string& prefix,
+              std::shared_ptr<const Rows> rows,
+              uint64_t ticket);
+
+  /**
+   * @brief Max bytes of the rows of a prefix to cache, a bigger one would flush too much of a shard
+   */
+  size_t maxEntryBytes() const {
+    return shardCapacity_ / 4;
+  }
+
+  /**
+   * @brief Invalidate the edge prefixes of the keys committed to a part, or all prefixes of the
+   * part if `all` is true
+   *
+   * @param spaceId
+   * @param partId
+   * @param vIdLen Vertex id length of the space
+   * @param keys Keys committed, which are not edge keys are ignored
+   * @param all
+   */
+  void invalidate(GraphSpaceID spaceId,
+                  PartitionID partId,
+                  size_t vIdLen,
+                  const std::vector<std::string>& keys,
+                  bool all);
+
+  /**
+   * @brief Invalidate the edges cached by the raft apply of each part of the store, on both leader
+   * and followers, including the parts added later
+   *
+   * @param store
+   * @param schemaMan Used to get the vertex id length of the spaces
+   */
+  void attach(kvstore::NebulaStore* store, meta::SchemaManager* schemaMan);
+
+  size_t size();
+
+  /**
+   * @brief Iterator over the rows cached, which keeps the rows alive. It goes on with `tail` after
+   * the rows if given, which is used for the rows too many to cache.
+   */
+  class Iterator final : public kvstore::KVIterator {
+   public:
+    explicit Iterator(std::shared_ptr<const Rows> rows,
+                      std::unique_ptr<kvstore::KVIterator> tail = nullptr)
+        : rows_(std::move(rows)), tail_(std::move(tail)) {}
+
+    bool valid() const override {
+      return idx_ < rows_->size() || (tail_ != nullptr && tail_->valid());
+    }
+
+    void next() override {
+      if (idx_ < rows_->size()) {
+        ++idx_;
+      } else {
+        tail_->next();
+      }
+    }
+
+    void prev() override {
+      DCHECK(tail_ == nullptr);
+      --idx_;
+    }
+
+    folly::StringPiece key() const override {
+      return idx_ < rows_->size() ? folly::StringPiece((*rows_)[idx_].first) : tail_->key();
+    }
+
+    folly::StringPiece val() const override {
+      return idx_ < rows_->size() ? folly::StringPiece((*rows_)[idx_].second) : tail_->val();
+    }
+
+   private:
+    std::shared_ptr<const Rows> rows_;
+    std::unique_ptr<kvstore::KVIterator> tail_;
+    size_t idx_{0};
+  };
+
+ private:
+  struct Entry {
+    std::string key;
+    std::shared_ptr<const Rows> rows;
+    size_t bytes;
+  };
+
+  struct Shard {
+    std::mutex lock;
+    // The most recently used in front
+    std::list<Entry> lru;
+    std::unordered_map<folly::StringPiece, std::list<Entry>::iterator> index;
+    size_t bytes{0};
+    // Bumped on every invalidation in the shard
+    uint64_t version{0};
+  };
+
+  static constexpr size_t kShardBits = 6;
+  static constexpr size_t kNumShards = 1 << kShardBits;
+
+  static std::string cacheKey(GraphSpaceID spaceId, folly::StringPiece prefix);
+
+  static size_t shardOf(folly::StringPiece key);
+
+  // Remove the entry, the shard lock must be held
+  static void erase(Shard& shard, std::list<Entry>::iterator it);
+
+  const size_t shardCapacity_;
+  std::array<folly::cacheline_aligned<Shard>, kNumShards> shards_;
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif  // STORAGE_QUERY_EDGECACHE_H_
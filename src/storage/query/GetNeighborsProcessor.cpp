@@ -5,6 +5,8 @@
 
 #include "storage/query/GetNeighborsProcessor.h"
 
+#include <folly/ScopeGuard.h>
+
 #include "common/memory/MemoryTracker.h"
 #include "storage/StorageFlags.h"
 #include "storage/exec/AggregateNode.h"
@@ -14,6 +16,7 @@
 #include "storage/exec/HashJoinNode.h"
 #include "storage/exec/MultiTagNode.h"
 #include "storage/exec/TagNode.h"
+#include "storage/query/MorselScheduler.h"
 
 namespace nebula {
 namespace storage {
@@ -44,6 +47,12 @@ void GetNeighborsProcessor::doProcess(const cpp2::GetNeighborsRequest& req) {
   }
   this->planContext_ = std::make_unique<PlanContext>(
       this->env_, spaceId_, this->spaceVidLen_, this->isIntId_, req.common_ref());
+  if (req.merged_commons_ref().has_value()) {
+    for (const auto& common : *req.merged_commons_ref()) {
+      this->planContext_->mergedPlans_.emplace_back(common.session_id_ref().value_or(0),
+                                                    common.plan_id_ref().value_or(0));
+    }
+  }
 
   // build TagContext and EdgeContext
   retCode = checkAndBuildContexts(req);
@@ -85,7 +94,8 @@ void GetNeighborsProcessor::runInSingleThread(const cpp2::GetNeighborsRequest& r
   for (const auto& partEntry : req.get_parts()) {
     contexts_.front().resultStat_ = ResultStatus::NORMAL;
     auto partId = partEntry.first;
-    for (const auto& vid : partEntry.second) {
+    for (const auto* vidPtr : scanOrder(partEntry.second)) {
+      const auto& vid = *vidPtr;
       auto vId = vid.getStr();
 
       if (!NebulaKeyUtils::isValidVidLen(spaceVidLen_, vId)) {
@@ -117,41 +127,74 @@ void GetNeighborsProcessor::runInMultipleThread(const cpp2::GetNeighborsRequest&
                                                 int64_t limit,
                                                 bool random) {
   memory::MemoryCheckOffGuard offGuard;
-  for (size_t i = 0; i < req.get_parts().size(); i++) {
+  // Split the vertices of each part into morsels in the scan order, so that a big part is scanned
+  // by several workers, and each worker still scans forward in a morsel
+  size_t morselSize = std::max(FLAGS_query_morsel_size, 1);
+  for (const auto& [partId, vids] : req.get_parts()) {
+    auto order = scanOrder(vids);
+    for (size_t begin = 0; begin < order.size(); begin += morselSize) {
+      auto end = std::min(order.size(), begin + morselSize);
+      Morsel morsel;
+      morsel.partId = partId;
+      morsel.vids.reserve(end - begin);
+      for (auto i = begin; i < end; ++i) {
+        morsel.vids.emplace_back(*order[i]);
+      }
+      morsels_.emplace_back(std::move(morsel));
+    }
+  }
+  auto numWorkers = MorselScheduler::admit(morsels_.size());
+  for (size_t i = 0; i < numWorkers; i++) {
     nebula::DataSet result = resultDataSet_;
     results_.emplace_back(std::move(result));
     contexts_.emplace_back(RuntimeContext(planContext_.get()));
     expCtxs_.emplace_back(StorageExpressionContext(spaceVidLen_, isIntId_));
   }
-  size_t i = 0;
-  std::vector<folly::Future<std::pair<nebula::cpp2::ErrorCode, PartitionID>>> futures;
-  for (const auto& [partId, vids] : req.get_parts()) {
-    futures.emplace_back(
-        runInExecutor(&contexts_[i], &expCtxs_[i], &results_[i], partId, vids, limit, random));
-    i++;
+  for (size_t i = 0; i < numWorkers; i++) {
+    plans_.emplace_back(buildPlan(&contexts_[i], &expCtxs_[i], &results_[i], limit, random));
   }
 
-  folly::collectAll(futures)
-      .via(executor_)
-      .thenTry([this](auto&& t) mutable {
+  MorselScheduler::run(executor_,
+                       morsels_.size(),
+                       numWorkers,
+                       MorselScheduler::Priority::kInteractive,
+                       [this](size_t worker, size_t idx) { runMorsel(worker, idx); })
+      .thenTry([this](folly::Try<folly::Unit>&& t) mutable {
         memory::MemoryCheckGuard guard;
-        CHECK(!t.hasException());
-        const auto& tries = t.value();
-        size_t sum = 0;
-        for (size_t j = 0; j < tries.size(); j++) {
-          if (tries[j].hasException()) {
-            onError();
-            return;
+        if (t.hasException()) {
+          if (t.hasException<std::bad_alloc>()) {
+            memoryExceeded_ = true;
+          }
+          onError();
+          return;
+        }
+        // A part fails with its first error, and none of its rows are returned then
+        std::unordered_map<PartitionID, nebula::cpp2::ErrorCode> failedParts;
+        for (const auto& morsel : morsels_) {
+          if (morsel.code != nebula::cpp2::ErrorCode::SUCCEEDED) {
+            failedParts.emplace(morsel.partId, morsel.code);
           }
-          sum += results_[j].size();
+        }
+        for (const auto& [partId, code] : failedParts) {
+          handleErrorCode(code, spaceId_, partId);
+        }
+        size_t sum = 0;
+        for (const auto& morsel : morsels_) {
+          sum += morsel.end - morsel.begin;
         }
         resultDataSet_.rows.reserve(sum);
-        for (size_t j = 0; j < tries.size(); j++) {
-          const auto& [code, partId] = tries[j].value();
-          if (code != nebula::cpp2::ErrorCode::SUCCEEDED) {
-            handleErrorCode(code, spaceId_, partId);
-          } else {
-            resultDataSet_.append(std::move(results_[j]));
+        for (const auto& morsel : morsels_) {
+          if (failedParts.find(morsel.partId) != failedParts.end()) {
+            continue;
+          }
+          auto& rows = results_[morsel.worker].rows;
+          resultDataSet_.rows.insert(resultDataSet_.rows.end(),
+                                     std::make_move_iterator(rows.begin() + morsel.begin),
+                                     std::make_move_iterator(rows.begin() + morsel.end));
+        }
+        if (UNLIKELY(profileDetailFlag_)) {
+          for (const auto& plan : plans_) {
+            profilePlan(plan);
           }
         }
         this->onProcessFinished();
@@ -163,46 +206,54 @@ void GetNeighborsProcessor::runInMultipleThread(const cpp2::GetNeighborsRequest&
       });
 }
 
-folly::Future<std::pair<nebula::cpp2::ErrorCode, PartitionID>> GetNeighborsProcessor::runInExecutor(
-    RuntimeContext* context,
-    StorageExpressionContext* expCtx,
-    nebula::DataSet* result,
-    PartitionID partId,
-    const std::vector<nebula::Value>& vids,
-    int64_t limit,
-    bool random) {
-  return folly::via(
-             executor_,
-             [this, context, expCtx, result, partId, input = std::move(vids), limit, random]() {
-               memory::MemoryCheckGuard guard;
-               if (memoryExceeded_) {
-                 return std::make_pair(nebula::cpp2::ErrorCode::E_STORAGE_MEMORY_EXCEEDED, partId);
-               }
-               auto plan = buildPlan(context, expCtx, result, limit, random);
-               for (const auto& vid : input) {
-                 auto vId = vid.getStr();
-
-                 if (!NebulaKeyUtils::isValidVidLen(spaceVidLen_, vId)) {
-                   LOG(INFO) << "Space " << spaceId_ << ", vertex length invalid, "
-                             << " space vid len: " << spaceVidLen_ << ",  vid is " << vId;
-                   return std::make_pair(nebula::cpp2::ErrorCode::E_INVALID_VID, partId);
-                 }
-
-                 // the first column of each row would be the vertex id
-                 auto ret = plan.go(partId, vId);
-                 if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
-                   return std::make_pair(ret, partId);
-                 }
-               }
-               if (UNLIKELY(this->profileDetailFlag_)) {
-                 profilePlan(plan);
-               }
-               return std::make_pair(nebula::cpp2::ErrorCode::SUCCEEDED, partId);
-             })
-      .thenError(folly::tag_t<std::bad_alloc>{}, [this, partId](const std::bad_alloc&) {
-        memoryExceeded_ = true;
-        return std::make_pair(nebula::cpp2::ErrorCode::E_STORAGE_MEMORY_EXCEEDED, partId);
-      });
+void GetNeighborsProcessor::runMorsel(size_t worker, size_t idx) {
+  memory::MemoryCheckGuard guard;
+  auto& morsel = morsels_[idx];
+  auto& rows = results_[worker].rows;
+  morsel.worker = worker;
+  morsel.begin = rows.size();
+  SCOPE_EXIT {
+    morsel.end = rows.size();
+  };
+  if (memoryExceeded_) {
+    morsel.code = nebula::cpp2::ErrorCode::E_STORAGE_MEMORY_EXCEEDED;
+    return;
+  }
+  contexts_[worker].resultStat_ = ResultStatus::NORMAL;
+  for (const auto& vid : morsel.vids) {
+    const auto& vId = vid.getStr();
+    if (!NebulaKeyUtils::isValidVidLen(spaceVidLen_, vId)) {
+      LOG(INFO) << "Space " << spaceId_ << ", vertex length invalid, "
+                << " space vid len: " << spaceVidLen_ << ",  vid is " << vId;
+      morsel.code = nebula::cpp2::ErrorCode::E_INVALID_VID;
+      return;
+    }
+
+    // the first column of each row would be the vertex id
+    auto ret = plans_[worker].go(morsel.partId, vId);
+    if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+      morsel.code = ret;
+      return;
+    }
+  }
+}
+
+// static
+std::vector<const Value*> GetNeighborsProcessor::scanOrder(const std::vector<Value>& vids) {
+  std::vector<const Value*> order;
+  order.reserve(vids.size());
+  for (const auto& vid : vids) {
+    order.emplace_back(&vid);
+  }
+  if (FLAGS_enable_sorted_neighbor_scan &&
+      std::all_of(vids.begin(), vids.end(), [](const auto& vid) { return vid.isStr(); })) {
+    // The vertex id is the prefix of the edge key, so the edges are scanned in the key order,
+    // and the iterator of each edge type only seeks forward
+    std::sort(order.begin(), order.end(), [](const Value* lhs, const Value* rhs) {
+      return lhs->getStr() < rhs->getStr();
+    });
+  }
+  return order;
 }
 
 StoragePlan<VertexID> GetNeighborsProcessor::buildPlan(RuntimeContext* context,
@@ -249,6 +300,7 @@ StoragePlan<VertexID> GetNeighborsProcessor::buildPlan(RuntimeContext* context,
   std::vector<SingleEdgeNode*> edges;
   for (const auto& ec : edgeContext_.propContexts_) {
     auto edge = std::make_unique<SingleEdgeNode>(context, &edgeContext_, ec.first, &ec.second);
+    edge->setReusable(FLAGS_enable_sorted_neighbor_scan);
     edges.emplace_back(edge.get());
     plan.addNode(std::move(edge));
   }
@@ -47,6 +47,9 @@ class GetNeighborsProcessor
       : QueryBaseProcessor<cpp2::GetNeighborsRequest, cpp2::GetNeighborsResponse>(
             env, counters, executor) {}
 
+  // The order to scan the vertices of a part, which is the key order if the sorted scan is enabled
+  static std::vector<const Value*> scanOrder(const std::vector<Value>& vids);
+
   StoragePlan<VertexID> buildPlan(RuntimeContext* context,
                                   StorageExpressionContext* expCtx,
                                   nebula::DataSet* result,
@@ -73,19 +76,28 @@ class GetNeighborsProcessor
   void runInSingleThread(const cpp2::GetNeighborsRequest& req, int64_t limit, bool random);
   void runInMultipleThread(const cpp2::GetNeighborsRequest& req, int64_t limit, bool random);
 
-  folly::Future<std::pair<nebula::cpp2::ErrorCode, PartitionID>> runInExecutor(
-      RuntimeContext* context,
-      StorageExpressionContext* expCtx,
-      nebula::DataSet* result,
-      PartitionID partId,
-      const std::vector<nebula::Value>& vids,
-      int64_t limit,
-      bool random);
+  // Scan the vertices of a morsel with the plan of the worker
+  void runMorsel(size_t worker, size_t idx);
 
  private:
   std::vector<RuntimeContext> contexts_;
   std::vector<StorageExpressionContext> expCtxs_;
   std::vector<nebula::DataSet> results_;
+
+  // A slice of the vertices of a part, scanned by one worker when running concurrently
+  struct Morsel {
+    PartitionID partId;
+    // Copied, the request doesn't outlive doProcess while the morsels are scanned asynchronously
+    std::vector<Value> vids;
+    nebula::cpp2::ErrorCode code{nebula::cpp2::ErrorCode::SUCCEEDED};
+    // The rows of the morsel are results_[worker].rows[begin, end)
+    size_t worker{0};
+    size_t begin{0};
+    size_t end{0};
+  };
+  std::vector<Morsel> morsels_;
+  // The plan of each worker
+  std::vector<StoragePlan<VertexID>> plans_;
 };
 
 }  // namespace storage
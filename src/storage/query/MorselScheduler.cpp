@@ -0,0 +1,116 @@
+/* Copyright (c) 2023 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#include "storage/query/MorselScheduler.h"
+
+#include <folly/executors/ExecutorWithPriority.h>
+
+#include "storage/StorageFlags.h"
+
+namespace nebula {
+namespace storage {
+
+namespace {
+
+// The workers of all requests running or queued on the executors
+std::atomic<int64_t> gNumWorkers{0};
+
+struct MorselState {
+  folly::Executor::KeepAlive<> executor;
+  size_t numMorsels;
+  std::function<void(size_t, size_t)> work;
+  std::atomic<size_t> next{0};
+  std::atomic<size_t> numWorkers{0};
+  std::atomic<bool> failed{false};
+  folly::exception_wrapper error;
+  folly::Promise<folly::Unit> promise;
+};
+
+void schedule(std::shared_ptr<MorselState> state, size_t worker) {
+  auto* executor = state->executor.get();
+  executor->add([state = std::move(state), worker]() mutable {
+    auto morsel = state->next.fetch_add(1);
+    if (morsel < state->numMorsels && !state->failed.load()) {
+      try {
+        state->work(worker, morsel);
+      } catch (...) {
+        if (!state->failed.exchange(true)) {
+          state->error = folly::exception_wrapper(std::current_exception());
+        }
+      }
+      // Re-queue instead of looping, so that the tasks of the other requests get their turns
+      schedule(std::move(state), worker);
+      return;
+    }
+    gNumWorkers--;
+    if (--state->numWorkers == 0) {
+      if (state->failed.load()) {
+        state->promise.setException(std::move(state->error));
+      } else {
+        state->promise.setValue();
+      }
+    }
+  });
+}
+
+}  // namespace
+
+// static
+folly::Future<folly::Unit> MorselScheduler::run(folly::Executor* executor,
+                                                size_t numMorsels,
+                                                size_t numWorkers,
+                                                Priority priority,
+                                                std::function<void(size_t, size_t)> work) {
+  if (numMorsels == 0) {
+    return folly::makeFuture();
+  }
+  if (executor == nullptr) {
+    return folly::makeFutureWith([numMorsels, work = std::move(work)]() {
+      for (size_t i = 0; i < numMorsels; i++) {
+        work(0, i);
+      }
+    });
+  }
+  DCHECK_GT(numWorkers, 0);
+  numWorkers = std::min(numWorkers, numMorsels);
+  auto state = std::make_shared<MorselState>();
+  state->executor = MorselScheduler::executor(executor, priority);
+  state->numMorsels = numMorsels;
+  state->work = std::move(work);
+  state->numWorkers = numWorkers;
+  auto future = state->promise.getFuture();
+  gNumWorkers += numWorkers;
+  for (size_t i = 0; i < numWorkers; i++) {
+    schedule(state, i);
+  }
+  return future;
+}
+
+// static
+size_t MorselScheduler::admit(size_t numMorsels) {
+  if (numMorsels == 0) {
+    return 0;
+  }
+  int64_t limit = FLAGS_query_workers_per_request > 0 ? FLAGS_query_workers_per_request
+                                                       : FLAGS_reader_handlers;
+  int64_t idle = FLAGS_reader_handlers - gNumWorkers.load();
+  auto numWorkers = std::max<int64_t>(1, std::min(limit, idle));
+  return std::min<size_t>(numWorkers, numMorsels);
+}
+
+// static
+folly::Executor::KeepAlive<> MorselScheduler::executor(folly::Executor* executor,
+                                                       Priority priority) {
+  auto keepAlive = folly::getKeepAliveToken(executor);
+  if (executor->getNumPriorities() <= 1) {
+    // addWithPriority is not supported
+    return keepAlive;
+  }
+  auto pri = priority == Priority::kScan ? folly::Executor::LO_PRI : folly::Executor::MID_PRI;
+  return folly::ExecutorWithPriority::create(std::move(keepAlive), pri);
+}
+
+}  // namespace storage
+}  // namespace nebula
@@ -0,0 +1,71 @@
+/* Copyright (c) 2023 vesoft inc. All rights reserved.
+ *
+ * This source code is licensed under Apache 2.0 License.
+ */
+
+#ifndef STORAGE_QUERY_MORSELSCHEDULER_H_
+#define STORAGE_QUERY_MORSELSCHEDULER_H_
+
+#include <folly/Executor.h>
+#include <folly/futures/Future.h>
+
+#include "common/base/Base.h"
+
+namespace nebula {
+namespace storage {
+
+/**
+ * @brief MorselScheduler runs the morsels of one request, i.e. the small slices of its work such as
+ * a range of the vertices of a part, on the storage executor.
+ *
+ * Up to `numWorkers` workers claim the morsels in order from a shared counter, so a worker which
+ * finishes early takes over the morsels a slow one has not reached, and a big part no longer pins
+ * one thread while the others idle. Each worker re-queues itself after every morsel, so that the
+ * morsels of the other requests interleave with the ones of a heavy request.
+ */
+class MorselScheduler final {
+ public:
+  enum class Priority : int8_t {
+    // Point queries such as GetNeighbors, scheduled as the other requests
+    kInteractive,
+    // Full scans, scheduled behind the others if the executor supports priorities
+    kScan,
+  };
+
+  /**
+   * @brief Run `work(worker, morsel)` for each morsel in [0, numMorsels) by `numWorkers` workers.
+   * The morsels of a worker run one by one, and the worker id is in [0, numWorkers).
+   *
+   * @param executor Executor to run on, running directly if nullptr
+   * @param numMorsels
+   * @param numWorkers
+   * @param priority
+   * @param work
+   * @return folly::Future<folly::Unit> Fulfilled when all morsels are done, or with the first
+   * exception thrown by `work`, the morsels not claimed yet are skipped then.
+   */
+  static folly::Future<folly::Unit> run(folly::Executor* executor,
+                                        size_t numMorsels,
+                                        size_t numWorkers,
+                                        Priority priority,
+                                        std::function<void(size_t, size_t)> work);
+
+  /**
+   * @brief Number of workers admitted for a request of `numMorsels` morsels. It's bounded by
+   * `--query_workers_per_request` and by the reader handlers left idle by the running workers of
+   * all requests, but at least one worker is admitted for a non-empty request.
+   */
+  static size_t admit(size_t numMorsels);
+
+  /**
+   * @brief The executor which schedules the tasks with the priority
+   */
+  static folly::Executor::KeepAlive<> executor(folly::Executor* executor, Priority priority);
+
+ private:
+  MorselScheduler() = delete;
+};
+
+}  // namespace storage
+}  // namespace nebula
+#endif  // STORAGE_QUERY_MORSELSCHEDULER_H_
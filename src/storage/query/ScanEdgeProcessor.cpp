@@ -9,6 +9,7 @@
 #include "common/utils/NebulaKeyUtils.h"
 #include "storage/StorageFlags.h"
 #include "storage/exec/QueryUtils.h"
+#include "storage/query/MorselScheduler.h"
 
 namespace nebula {
 namespace storage {
@@ -129,21 +130,23 @@ folly::Future<std::pair<nebula::cpp2::ErrorCode, PartitionID>> ScanEdgeProcessor
     PartitionID partId,
     Cursor cursor,
     StorageExpressionContext* expCtx) {
-  return folly::via(executor_,
-                    [this, context, result, cursors, partId, input = std::move(cursor), expCtx]() {
-                      memory::MemoryCheckGuard guard;
-                      if (memoryExceeded_) {
-                        return std::make_pair(nebula::cpp2::ErrorCode::E_STORAGE_MEMORY_EXCEEDED,
-                                              partId);
-                      }
-                      auto plan = buildPlan(context, result, cursors, expCtx);
-
-                      auto ret = plan.go(partId, input);
-                      if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
-                        return std::make_pair(ret, partId);
-                      }
-                      return std::make_pair(nebula::cpp2::ErrorCode::SUCCEEDED, partId);
-                    })
+  // The scans give way to the interactive queries
+  auto executor = MorselScheduler::executor(executor_, MorselScheduler::Priority::kScan);
+  return folly::via(
+             std::move(executor),
+             [this, context, result, cursors, partId, input = std::move(cursor), expCtx]() {
+               memory::MemoryCheckGuard guard;
+               if (memoryExceeded_) {
+                 return std::make_pair(nebula::cpp2::ErrorCode::E_STORAGE_MEMORY_EXCEEDED, partId);
+               }
+               auto plan = buildPlan(context, result, cursors, expCtx);
+
+               auto ret = plan.go(partId, input);
+               if (ret != nebula::cpp2::ErrorCode::SUCCEEDED) {
+                 return std::make_pair(ret, partId);
+               }
+               return std::make_pair(nebula::cpp2::ErrorCode::SUCCEEDED, partId);
+             })
       .thenError(folly::tag_t<std::bad_alloc>{}, [this, partId](const std::bad_alloc&) {
         memoryExceeded_ = true;
         return std::make_pair(nebula::cpp2::ErrorCode::E_STORAGE_MEMORY_EXCEEDED, partId);
@@ -11,6 +11,7 @@
 #include "common/utils/NebulaKeyUtils.h"
 #include "storage/StorageFlags.h"
 #include "storage/exec/QueryUtils.h"
+#include "storage/query/MorselScheduler.h"
 
 namespace nebula {
 namespace storage {
@@ -129,8 +130,10 @@ folly::Future<std::pair<nebula::cpp2::ErrorCode, PartitionID>> ScanVertexProcess
     PartitionID partId,
     Cursor cursor,
     StorageExpressionContext* expCtx) {
+  // The scans give way to the interactive queries
+  auto executor = MorselScheduler::executor(executor_, MorselScheduler::Priority::kScan);
   return folly::via(
-             executor_,
+             std::move(executor),
              [this, context, result, cursorsOfPart, partId, input = std::move(cursor), expCtx]() {
                memory::MemoryCheckGuard guard;
                if (memoryExceeded_) {
@@ -13,6 +13,9 @@ stats::CounterId kNumVerticesInserted;
 stats::CounterId kNumEdgesDeleted;
 stats::CounterId kNumTagsDeleted;
 stats::CounterId kNumVerticesDeleted;
+stats::CounterId kNumMemoryLockConflicts;
+stats::CounterId kNumEdgeCacheHits;
+stats::CounterId kNumEdgeCacheMisses;
 
 void initStorageStats() {
   kNumEdgesInserted = stats::StatsManager::registerStats("num_edges_inserted", "rate, sum");
@@ -20,6 +23,10 @@ void initStorageStats() {
   kNumEdgesDeleted = stats::StatsManager::registerStats("num_edges_deleted", "rate, sum");
   kNumTagsDeleted = stats::StatsManager::registerStats("num_tags_deleted", "rate, sum");
   kNumVerticesDeleted = stats::StatsManager::registerStats("num_vertices_deleted", "rate, sum");
+  kNumMemoryLockConflicts =
+      stats::StatsManager::registerStats("num_memory_lock_conflicts", "rate, sum");
+  kNumEdgeCacheHits = stats::StatsManager::registerStats("num_edge_cache_hits", "rate, sum");
+  kNumEdgeCacheMisses = stats::StatsManager::registerStats("num_edge_cache_misses", "rate, sum");
 
 #ifndef BUILD_STANDALONE
   initMetaClientStats();
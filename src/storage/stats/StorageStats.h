@@ -15,6 +15,9 @@ extern stats::CounterId kNumVerticesInserted;
 extern stats::CounterId kNumEdgesDeleted;
 extern stats::CounterId kNumTagsDeleted;
 extern stats::CounterId kNumVerticesDeleted;
+extern stats::CounterId kNumMemoryLockConflicts;
+extern stats::CounterId kNumEdgeCacheHits;
+extern stats::CounterId kNumEdgeCacheMisses;
 
 /**
  * @brief Init storage statistic points for storage/meta client/kv
@@ -15,6 +15,7 @@
 #include "mock/MockCluster.h"
 #include "mock/MockData.h"
 #include "storage/CommonUtils.h"
+#include "storage/CompactionFilter.h"
 #include "storage/test/QueryTestUtils.h"
 #include "storage/test/TestUtils.h"
 
@@ -236,6 +237,75 @@ TEST(CompactionFilterTest, TTLFilterDataExpiredTest) {
   FLAGS_mock_ttl_col = false;
 }
 
+TEST(CompactionFilterTest, TTLTablePropertiesTest) {
+  FLAGS_mock_ttl_col = true;
+  FLAGS_mock_ttl_duration = 1;
+
+  fs::TempDir rootPath("/tmp/CompactionFilterTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path(), HostAddr("", 0), 1, true, false, {}, true);
+  auto* env = cluster.storageEnv_.get();
+  auto parts = cluster.getTotalParts();
+
+  GraphSpaceID spaceId = 1;
+  auto status = env->schemaMan_->getSpaceVidLen(spaceId);
+  ASSERT_TRUE(status.ok());
+  auto spaceVidLen = status.value();
+  ASSERT_TRUE(QueryTestUtils::mockVertexData(env, parts));
+
+  // Collect the players rows as if they are in one file
+  StorageTtlPropertiesCollector collector(env->schemaMan_, spaceId, spaceVidLen);
+  for (int part = 1; part <= parts; part++) {
+    std::unique_ptr<kvstore::KVIterator> iter;
+    auto ret = env->kvstore_->prefix(spaceId, part, NebulaKeyUtils::tagPrefix(part), &iter);
+    ASSERT_EQ(ret, nebula::cpp2::ErrorCode::SUCCEEDED);
+    for (; iter->valid(); iter->next()) {
+      if (NebulaKeyUtils::getTagId(spaceVidLen, iter->key()) == 1) {
+        auto key = iter->key();
+        auto val = iter->val();
+        collector.AddUserKey(rocksdb::Slice(key.data(), key.size()),
+                             rocksdb::Slice(val.data(), val.size()),
+                             rocksdb::kEntryPut,
+                             0,
+                             0);
+      }
+    }
+  }
+  rocksdb::TableProperties props;
+  ASSERT_TRUE(collector.Finish(&props.user_collected_properties).ok());
+  auto& collected = props.user_collected_properties;
+  EXPECT_EQ("0", collected[TtlTableProperties::kNumNeverExpire]);
+  auto ttls = TtlTableProperties::decode(collected[TtlTableProperties::kTtls]);
+  ASSERT_TRUE(ttls.has_value());
+  ASSERT_EQ(1, ttls->size());
+  EXPECT_FALSE((*ttls)[0].isEdge);
+  EXPECT_EQ(1, (*ttls)[0].id);
+  EXPECT_EQ(FLAGS_mock_ttl_duration, (*ttls)[0].duration);
+  EXPECT_EQ("insertTime", (*ttls)[0].col);
+
+  StorageCompactionFilterFactory factory(env->schemaMan_, env->indexMan_, spaceId, spaceVidLen);
+  EXPECT_FALSE(factory.expired(props));
+  // wait ttl data Expire
+  sleep(FLAGS_mock_ttl_duration + 1);
+  EXPECT_TRUE(factory.expired(props));
+
+  {
+    // Any entry never expires keeps the file
+    auto copy = props;
+    copy.user_collected_properties[TtlTableProperties::kNumNeverExpire] = "1";
+    EXPECT_FALSE(factory.expired(copy));
+  }
+  {
+    // The ttl is longer than the one the file is collected with
+    auto copy = props;
+    (*ttls)[0].duration = 0;
+    copy.user_collected_properties[TtlTableProperties::kTtls] = TtlTableProperties::encode(*ttls);
+    EXPECT_FALSE(factory.expired(copy));
+  }
+
+  FLAGS_mock_ttl_col = false;
+}
+
 TEST(CompactionFilterTest, TTLFilterDataNotExpiredTest) {
   FLAGS_mock_ttl_col = true;
   FLAGS_mock_ttl_duration = 1800;
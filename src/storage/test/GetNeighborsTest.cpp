@@ -5,6 +5,7 @@
 
 #include <gtest/gtest.h>
 
+#include "clients/storage/RequestCoalescer.h"
 #include "common/base/Base.h"
 #include "common/fs/TempDir.h"
 #include "storage/query/GetNeighborsProcessor.h"
@@ -2088,6 +2089,293 @@ TEST(GetNeighborsTest, FilterTest) {
   }
 }
 
+TEST(GetNeighborsTest, CoalescingTest) {
+  fs::TempDir rootPath("/tmp/GetNeighborsTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  auto totalParts = cluster.getTotalParts();
+  ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+  ASSERT_EQ(true, QueryTestUtils::mockEdgeData(env, totalParts));
+  auto threadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
+  using Traits = CoalescingTraits<cpp2::GetNeighborsRequest, cpp2::GetNeighborsResponse>;
+
+  TagID player = 1;
+  EdgeType serve = 101;
+  std::vector<EdgeType> over = {serve};
+  std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+  std::vector<std::pair<EdgeType, std::vector<std::string>>> edges;
+  tags.emplace_back(player, std::vector<std::string>{"name", "age"});
+  edges.emplace_back(serve, std::vector<std::string>{"teamName", "startYear", "endYear"});
+  std::vector<std::vector<VertexID>> vertices = {{"Tim Duncan", "Tony Parker"},
+                                                 {"Tony Parker", "LeBron James", "Not Exist"},
+                                                 {"Tim Duncan", "Tim Duncan"}};
+  std::vector<cpp2::GetNeighborsRequest> requests;
+  for (const auto& vids : vertices) {
+    requests.emplace_back(QueryTestUtils::buildRequest(totalParts, vids, over, tags, edges));
+    auto common = requests.back().common_ref().value_or(cpp2::RequestCommon());
+    common.session_id_ref() = 1;
+    common.plan_id_ref() = 1;
+    requests.back().common_ref() = std::move(common);
+  }
+
+  auto getNeighbors = [&](const cpp2::GetNeighborsRequest& request) {
+    auto* processor = GetNeighborsProcessor::instance(env, nullptr, threadPool.get());
+    auto fut = processor->getFuture();
+    processor->process(request);
+    return std::move(fut).get();
+  };
+  auto sortedRows = [](const cpp2::GetNeighborsResponse& resp) {
+    auto rows = resp.get_vertices()->rows;
+    std::sort(rows.begin(), rows.end());
+    return rows;
+  };
+
+  {
+    LOG(INFO) << "Merge";
+    // The requests of the same query with the same spec are merged
+    for (const auto& req : requests) {
+      ASSERT_EQ(Traits::key(requests.front()), Traits::key(req));
+    }
+    auto merged = Traits::merge(requests);
+    ASSERT_EQ(7, Traits::numRows(merged));
+    ASSERT_FALSE(merged.merged_commons_ref().has_value());
+    auto resps = Traits::demux(getNeighbors(merged), requests);
+    ASSERT_EQ(requests.size(), resps.size());
+    for (size_t i = 0; i < requests.size(); ++i) {
+      auto expected = getNeighbors(requests[i]);
+      ASSERT_EQ(0, resps[i].get_result().get_failed_parts().size());
+      ASSERT_EQ(expected.get_vertices()->colNames, resps[i].get_vertices()->colNames);
+      ASSERT_EQ(sortedRows(expected), sortedRows(resps[i]));
+    }
+  }
+  {
+    LOG(INFO) << "Split";
+    auto merged = Traits::merge(requests);
+    auto batches = Traits::split(merged, 2);
+    ASSERT_EQ(4, batches.size());
+    std::vector<cpp2::GetNeighborsResponse> resps;
+    for (const auto& batch : batches) {
+      ASSERT_LE(Traits::numRows(batch), 2);
+      resps.emplace_back(getNeighbors(batch));
+    }
+    auto combined = Traits::combine(std::move(resps));
+    ASSERT_EQ(0, combined.get_result().get_failed_parts().size());
+    ASSERT_EQ(sortedRows(getNeighbors(merged)), sortedRows(combined));
+  }
+  {
+    LOG(INFO) << "DifferentSpec";
+    auto req = requests.front();
+    (*req.traverse_spec_ref()).limit_ref() = 1;
+    ASSERT_NE(Traits::key(requests.front()), Traits::key(req));
+  }
+  {
+    LOG(INFO) << "DifferentQuery";
+    // The requests of different queries are merged, and the merged request carries all of them
+    auto others = requests;
+    others[1].common_ref()->session_id_ref() = 2;
+    others[2].common_ref()->plan_id_ref() = 2;
+    others[2].common_ref()->profile_detail_ref() = true;
+    for (const auto& req : others) {
+      ASSERT_EQ(Traits::key(requests.front()), Traits::key(req));
+    }
+    auto merged = Traits::merge(others);
+    ASSERT_TRUE(merged.merged_commons_ref().has_value());
+    const auto& commons = *merged.merged_commons_ref();
+    ASSERT_EQ(3, commons.size());
+    EXPECT_EQ(1, *commons[0].session_id_ref());
+    EXPECT_EQ(1, *commons[0].plan_id_ref());
+    EXPECT_EQ(2, *commons[1].session_id_ref());
+    EXPECT_EQ(1, *commons[1].plan_id_ref());
+    EXPECT_EQ(1, *commons[2].session_id_ref());
+    EXPECT_EQ(2, *commons[2].plan_id_ref());
+    EXPECT_TRUE(merged.get_common()->profile_detail_ref().value_or(false));
+
+    auto resps = Traits::demux(getNeighbors(merged), others);
+    for (size_t i = 0; i < others.size(); ++i) {
+      ASSERT_EQ(0, resps[i].get_result().get_failed_parts().size());
+      ASSERT_EQ(sortedRows(getNeighbors(requests[i])), sortedRows(resps[i]));
+    }
+  }
+}
+
+TEST(GetNeighborsTest, SortedScanTest) {
+  fs::TempDir rootPath("/tmp/GetNeighborsTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  auto totalParts = cluster.getTotalParts();
+  ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+  ASSERT_EQ(true, QueryTestUtils::mockEdgeData(env, totalParts));
+  auto threadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
+
+  TagID player = 1;
+  EdgeType serve = 101;
+  EdgeType teammate = 102;
+  std::vector<VertexID> vertices;
+  for (const auto& p : mock::MockData::players_) {
+    vertices.emplace_back(p.name_);
+  }
+  vertices.emplace_back("Not Exist");
+  std::vector<EdgeType> over = {serve, -serve, teammate};
+  std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+  std::vector<std::pair<EdgeType, std::vector<std::string>>> edges;
+  tags.emplace_back(player, std::vector<std::string>{"name", "age"});
+  edges.emplace_back(serve, std::vector<std::string>{"teamName", "startYear"});
+  edges.emplace_back(-serve, std::vector<std::string>{"playerName", "endYear"});
+  edges.emplace_back(teammate, std::vector<std::string>{"teamName", "startYear"});
+  auto req = QueryTestUtils::buildRequest(totalParts, vertices, over, tags, edges);
+
+  auto getNeighbors = [&](bool sorted, bool concurrently) {
+    FLAGS_enable_sorted_neighbor_scan = sorted;
+    FLAGS_query_concurrently = concurrently;
+    auto* processor = GetNeighborsProcessor::instance(env, nullptr, threadPool.get());
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+    EXPECT_EQ(0, (*resp.result_ref()).failed_parts.size());
+    auto rows = resp.get_vertices()->rows;
+    std::sort(rows.begin(), rows.end());
+    return rows;
+  };
+
+  auto expected = getNeighbors(false, false);
+  ASSERT_LE(mock::MockData::players_.size(), expected.size());
+  // The vertices are scanned in the key order, and the iterators are reused
+  ASSERT_EQ(expected, getNeighbors(true, false));
+  ASSERT_EQ(expected, getNeighbors(true, true));
+  FLAGS_enable_sorted_neighbor_scan = true;
+  FLAGS_query_concurrently = false;
+}
+
+TEST(GetNeighborsTest, MorselTest) {
+  fs::TempDir rootPath("/tmp/GetNeighborsTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  auto totalParts = cluster.getTotalParts();
+  ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+  ASSERT_EQ(true, QueryTestUtils::mockEdgeData(env, totalParts));
+  auto threadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
+
+  TagID player = 1;
+  EdgeType serve = 101;
+  std::vector<VertexID> vertices;
+  for (const auto& p : mock::MockData::players_) {
+    vertices.emplace_back(p.name_);
+  }
+  std::vector<EdgeType> over = {serve};
+  std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+  std::vector<std::pair<EdgeType, std::vector<std::string>>> edges;
+  tags.emplace_back(player, std::vector<std::string>{"name", "age"});
+  edges.emplace_back(serve, std::vector<std::string>{"teamName", "startYear"});
+  auto req = QueryTestUtils::buildRequest(totalParts, vertices, over, tags, edges);
+
+  auto getNeighbors = [&](bool concurrently, int32_t morselSize, int32_t numWorkers) {
+    FLAGS_query_concurrently = concurrently;
+    FLAGS_query_morsel_size = morselSize;
+    FLAGS_query_workers_per_request = numWorkers;
+    auto* processor = GetNeighborsProcessor::instance(env, nullptr, threadPool.get());
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+    EXPECT_EQ(0, (*resp.result_ref()).failed_parts.size());
+    auto rows = resp.get_vertices()->rows;
+    std::sort(rows.begin(), rows.end());
+    return rows;
+  };
+
+  auto morselSize = FLAGS_query_morsel_size;
+  auto expected = getNeighbors(false, morselSize, 0);
+  ASSERT_EQ(mock::MockData::players_.size(), expected.size());
+  // The parts are split into morsels of a single vertex, claimed by the workers
+  ASSERT_EQ(expected, getNeighbors(true, 1, 0));
+  ASSERT_EQ(expected, getNeighbors(true, 1, 1));
+  ASSERT_EQ(expected, getNeighbors(true, 3, 2));
+  ASSERT_EQ(expected, getNeighbors(true, morselSize, 0));
+  FLAGS_query_concurrently = false;
+  FLAGS_query_morsel_size = morselSize;
+  FLAGS_query_workers_per_request = 0;
+}
+
+TEST(GetNeighborsTest, EdgeCacheTest) {
+  fs::TempDir rootPath("/tmp/GetNeighborsTest.XXXXXX");
+  mock::MockCluster cluster;
+  cluster.initStorageKV(rootPath.path());
+  auto* env = cluster.storageEnv_.get();
+  auto totalParts = cluster.getTotalParts();
+  ASSERT_EQ(true, QueryTestUtils::mockVertexData(env, totalParts));
+  ASSERT_EQ(true, QueryTestUtils::mockEdgeData(env, totalParts));
+  auto threadPool = std::make_shared<folly::IOThreadPoolExecutor>(4);
+
+  GraphSpaceID spaceId = 1;
+  TagID player = 1;
+  EdgeType serve = 101;
+  EdgeType teammate = 102;
+  std::vector<VertexID> vertices;
+  for (const auto& p : mock::MockData::players_) {
+    vertices.emplace_back(p.name_);
+  }
+  std::vector<EdgeType> over = {serve, -serve, teammate};
+  std::vector<std::pair<TagID, std::vector<std::string>>> tags;
+  std::vector<std::pair<EdgeType, std::vector<std::string>>> edges;
+  tags.emplace_back(player, std::vector<std::string>{"name", "age"});
+  edges.emplace_back(serve, std::vector<std::string>{"teamName", "startYear"});
+  edges.emplace_back(-serve, std::vector<std::string>{"playerName", "endYear"});
+  edges.emplace_back(teammate, std::vector<std::string>{"teamName", "startYear"});
+  auto req = QueryTestUtils::buildRequest(totalParts, vertices, over, tags, edges);
+
+  auto cache = std::make_unique<EdgeCache>(64 * 1024 * 1024);
+  cache->attach(static_cast<kvstore::NebulaStore*>(env->kvstore_), env->schemaMan_);
+  auto getNeighbors = [&](bool cached) {
+    if (cached) {
+      env->edgeCache_ = std::move(cache);
+    } else if (env->edgeCache_ != nullptr) {
+      cache = std::move(env->edgeCache_);
+    }
+    auto* processor = GetNeighborsProcessor::instance(env, nullptr, threadPool.get());
+    auto fut = processor->getFuture();
+    processor->process(req);
+    auto resp = std::move(fut).get();
+    EXPECT_EQ(0, (*resp.result_ref()).failed_parts.size());
+    auto rows = resp.get_vertices()->rows;
+    std::sort(rows.begin(), rows.end());
+    return rows;
+  };
+
+  auto expected = getNeighbors(false);
+  // Cached by the first one, and read from the cache by the second one
+  ASSERT_EQ(expected, getNeighbors(true));
+  ASSERT_LT(0, env->edgeCache_->size());
+  ASSERT_EQ(expected, getNeighbors(true));
+
+  {
+    // Remove the edges of a vertex, the edges cached are invalidated by the raft apply
+    VertexID vId = "Tim Duncan";
+    auto vIdLen = env->schemaMan_->getSpaceVidLen(spaceId).value();
+    PartitionID partId = (std::hash<std::string>()(vId) % totalParts) + 1;
+    auto prefix = NebulaKeyUtils::edgePrefix(vIdLen, partId, vId, serve);
+    std::unique_ptr<kvstore::KVIterator> iter;
+    ASSERT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED,
+              env->kvstore_->prefix(spaceId, partId, prefix, &iter));
+    std::vector<std::string> keys;
+    for (; iter->valid(); iter->next()) {
+      keys.emplace_back(iter->key().str());
+    }
+    ASSERT_FALSE(keys.empty());
+    folly::Baton<true, std::atomic> baton;
+    env->kvstore_->asyncMultiRemove(
+        spaceId, partId, std::move(keys), [&baton](nebula::cpp2::ErrorCode code) {
+          EXPECT_EQ(nebula::cpp2::ErrorCode::SUCCEEDED, code);
+          baton.post();
+        });
+    baton.wait();
+  }
+  auto removed = getNeighbors(false);
+  ASSERT_NE(expected, removed);
+  ASSERT_EQ(removed, getNeighbors(true));
+}
+
 }  // namespace storage
 }  // namespace nebula
 
@@ -21,6 +21,7 @@
 #include "common/utils/NebulaKeyUtils.h"
 #include "kvstore/KVEngine.h"
 #include "kvstore/KVIterator.h"
+#include "storage/StorageFlags.h"
 #include "storage/exec/IndexDedupNode.h"
 #include "storage/exec/IndexEdgeScanNode.h"
 #include "storage/exec/IndexLimitNode.h"
@@ -474,6 +475,92 @@ TEST_F(IndexScanTest, Base) {
   }  // End of Case 2
 }
 
+TEST_F(IndexScanTest, BaseBatch) {
+  auto rows = R"(
+    int | int
+    1   | 0
+    2   | 1
+    1   | 2
+    1   | 3
+    2   | 4
+    1   | 5
+    1   | 6
+    1   | 7
+    2   | 8
+    1   | 9
+  )"_row;
+  auto schema = R"(
+    a   | int  ||false
+    b   | int  ||false
+  )"_schema;
+  auto indices = R"(
+    TAG(t,1)
+    (i1,2):a
+  )"_index(schema);
+  bool hasNullableCol = schema->hasNullableCol();
+  auto kv = encodeTag(rows, 1, schema, indices);
+  auto kvstore = std::make_unique<MockKVStore>();
+  for (auto& iter : kv) {
+    for (auto& item : iter) {
+      kvstore->put(item.first, item.second);
+    }
+  }
+  auto scan = [&](uint32_t batchSize) {
+    FLAGS_index_scan_base_batch_size = batchSize;
+    std::vector<ColumnHint> columnHints{
+        makeColumnHint("a", Value(1))  // a=1
+    };
+    auto context = makeContext(1, 0);
+    auto scanNode = std::make_unique<IndexVertexScanNode>(
+        context.get(), 2, columnHints, kvstore.get(), hasNullableCol);
+    IndexScanTestHelper helper;
+    helper.setIndex(scanNode.get(), indices[0]);
+    helper.setTag(scanNode.get(), schema);
+    InitContext initCtx;
+    // b is not in the index, so the base data is fetched
+    initCtx.requiredColumns = {kVid, "b"};
+    scanNode->init(initCtx);
+    std::vector<Row> result;
+    // Execute twice to check the batch is reset
+    for (int i = 0; i < 2; i++) {
+      scanNode->execute(0);
+      while (true) {
+        auto res = scanNode->next();
+        EXPECT_TRUE(res.success());
+        if (!res.hasData()) {
+          break;
+        }
+        auto row = std::move(res).row();
+        result.emplace_back(
+            Row(std::vector<Value>{row[initCtx.retColMap[kVid]], row[initCtx.retColMap["b"]]}));
+      }
+    }
+    return result;
+  };
+  auto expect = R"(
+    string | int
+    0   | 0
+    2   | 2
+    3   | 3
+    5   | 5
+    6   | 6
+    7   | 7
+    9   | 9
+    0   | 0
+    2   | 2
+    3   | 3
+    5   | 5
+    6   | 6
+    7   | 7
+    9   | 9
+  )"_row;
+  auto batchSize = FLAGS_index_scan_base_batch_size;
+  for (uint32_t size : {1, 2, 3, 256}) {
+    EXPECT_EQ(expect, scan(size)) << "batch size " << size;
+  }
+  FLAGS_index_scan_base_batch_size = batchSize;
+}
+
 TEST_F(IndexScanTest, Vertex) {
   auto rows = R"(
     int | int
@@ -5,6 +5,9 @@
 
 #include <gtest/gtest.h>
 
+#include <random>
+#include <thread>
+
 #include "common/base/Base.h"
 #include "common/utils/MemoryLockWrapper.h"
 
@@ -122,6 +125,66 @@ TEST_F(MemoryLockTest, DedupTest) {
   EXPECT_EQ(0, mlock.size());
 }
 
+TEST_F(MemoryLockTest, WaitTest) {
+  MemoryLockCore<std::string> mlock(std::chrono::milliseconds(5000));
+  {
+    // The batch waits for the key held until it's unlocked
+    auto* lk1 = new LockGuard(&mlock, "2");
+    EXPECT_TRUE(*lk1);
+    std::thread t([lk1] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      delete lk1;
+    });
+    std::vector<std::string> keys{"1", "2", "3"};
+    LockGuard lk2(&mlock, keys);
+    EXPECT_TRUE(lk2);
+    EXPECT_EQ(3, mlock.size());
+    t.join();
+  }
+  EXPECT_EQ(0, mlock.size());
+  {
+    // A key duplicated in the batch fails at once instead of waiting for itself
+    std::vector<std::string> keys{"1", "1"};
+    LockGuard lk(&mlock, keys);
+    EXPECT_FALSE(lk);
+    EXPECT_EQ(0, mlock.size());
+  }
+  {
+    // The batches with the keys in different orders don't deadlock
+    std::vector<std::string> keys;
+    for (int i = 0; i < 100; i++) {
+      keys.emplace_back(folly::to<std::string>(i));
+    }
+    std::atomic<int> numLocked{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+      threads.emplace_back([&, t] {
+        auto shuffled = keys;
+        std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(t));
+        for (int i = 0; i < 10; i++) {
+          LockGuard lk(&mlock, shuffled);
+          if (lk) {
+            numLocked++;
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    EXPECT_EQ(80, numLocked);
+  }
+  EXPECT_EQ(0, mlock.size());
+  {
+    // Fails when the key is still held after the timeout
+    MemoryLockCore<std::string> lock(std::chrono::milliseconds(10));
+    EXPECT_TRUE(lock.try_lock("1"));
+    EXPECT_FALSE(lock.try_lock("1"));
+    lock.unlock("1");
+    EXPECT_TRUE(lock.try_lock("1"));
+  }
+}
+
 }  // namespace storage
 }  // namespace nebula
 